@@ -29,8 +29,52 @@
 
 #include <slang.h>
 
+#include <atomic>
+#include <vector>
+
 namespace Falcor
 {
+    namespace
+    {
+        /** Blob holding kernel code that was not produced by the shader compiler (e.g. loaded from the program cache).
+        */
+        class CodeBlob : public ID3DBlob
+        {
+        public:
+            CodeBlob(const void* pCode, size_t size)
+                : mData(static_cast<const uint8_t*>(pCode), static_cast<const uint8_t*>(pCode) + size)
+            {}
+
+            HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+            {
+                if (riid == __uuidof(IUnknown) || riid == __uuidof(ID3DBlob))
+                {
+                    AddRef();
+                    *ppvObject = this;
+                    return S_OK;
+                }
+                *ppvObject = nullptr;
+                return E_NOINTERFACE;
+            }
+
+            ULONG STDMETHODCALLTYPE AddRef() override { return ++mRefCount; }
+
+            ULONG STDMETHODCALLTYPE Release() override
+            {
+                ULONG refCount = --mRefCount;
+                if (refCount == 0) delete this;
+                return refCount;
+            }
+
+            LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return mData.data(); }
+            SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return mData.size(); }
+
+        private:
+            std::vector<uint8_t> mData;
+            std::atomic<ULONG> mRefCount{0};
+        };
+    }
+
     struct ShaderData
     {
         ID3DBlobPtr pBlob;
@@ -67,6 +111,11 @@ namespace Falcor
         return succeeded;
     }
 
+    void Shader::initFromCode(const void* pCode, size_t size)
+    {
+        mpPrivateData->pBlob = new CodeBlob(pCode, size);
+    }
+
     ID3DBlobPtr Shader::getD3DBlob() const
     {
         return mpPrivateData->pBlob;
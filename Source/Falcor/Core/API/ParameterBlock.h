@@ -88,6 +88,22 @@ namespace Falcor
             return getRootVar()[name];
         }
 
+        /** Get a shader variable that points at the field with the given `name`.
+            This is an alias for `getRootVar()[name]`.
+        */
+        ShaderVar operator[](const ShaderVarName& name) const
+        {
+            return getRootVar()[name];
+        }
+
+        /** Get a shader variable that points at the field referenced by `handle`.
+            This is an alias for `getRootVar()[handle]`.
+        */
+        ShaderVar operator[](const ShaderVarHandle& handle) const
+        {
+            return getRootVar()[handle];
+        }
+
         /** Get a shader variable that points at the field/element with the given `index`.
             This is an alias for `getRootVar()[index]`.
         */
@@ -337,6 +337,23 @@ namespace Falcor
             return pShader->init(linkedSlangEntryPoint, entryPointName, flags, log) ? pShader : nullptr;
         }
 
+#ifdef FALCOR_D3D12
+        /** Create a shader object from previously compiled kernel code.
+            \param[in] type The Type of the shader
+            \param[in] entryPointName The name of the entry point.
+            \param[in] pCode Compiled kernel code. The data is copied.
+            \param[in] size Size of the kernel code in bytes.
+            \return A new shader object.
+        */
+        static SharedPtr createFromCode(ShaderType type, std::string const& entryPointName, const void* pCode, size_t size)
+        {
+            SharedPtr pShader = SharedPtr(new Shader(type));
+            pShader->mEntryPointName = entryPointName;
+            pShader->initFromCode(pCode, size);
+            return pShader;
+        }
+#endif
+
         virtual ~Shader();
 
         /** Get the shader Type
@@ -359,6 +376,9 @@ namespace Falcor
     protected:
         // API handle depends on the shader Type, so it stored be stored as part of the private data
         bool init(ComPtr<slang::IComponentType> linkedSlangEntryPoint, const std::string& entryPointName, CompilerFlags flags, std::string& log);
+#ifdef FALCOR_D3D12
+        void initFromCode(const void* pCode, size_t size);
+#endif
         Shader(ShaderType Type);
         ShaderType mType;
         std::string mEntryPointName;
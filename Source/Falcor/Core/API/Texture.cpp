@@ -158,16 +158,10 @@ namespace Falcor
         }
         else
         {
-            Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(fullPath, kTopDown);
+            Bitmap::UniqueConstPtr pBitmap = loadBitmapFromFile(fullPath);
             if (pBitmap)
             {
-                ResourceFormat texFormat = pBitmap->getFormat();
-                if (loadAsSrgb)
-                {
-                    texFormat = linearToSrgbFormat(texFormat);
-                }
-
-                pTex = Texture::create2D(pBitmap->getWidth(), pBitmap->getHeight(), texFormat, 1, generateMipLevels ? Texture::kMaxPossible : 1, pBitmap->getData(), bindFlags);
+                pTex = createFromBitmap(*pBitmap, generateMipLevels, loadAsSrgb, bindFlags);
             }
         }
 
@@ -179,6 +173,22 @@ namespace Falcor
         return pTex;
     }
 
+    Texture::SharedPtr Texture::createFromBitmap(const Bitmap& bitmap, bool generateMipLevels, bool loadAsSrgb, Texture::BindFlags bindFlags)
+    {
+        ResourceFormat texFormat = bitmap.getFormat();
+        if (loadAsSrgb)
+        {
+            texFormat = linearToSrgbFormat(texFormat);
+        }
+
+        return Texture::create2D(bitmap.getWidth(), bitmap.getHeight(), texFormat, 1, generateMipLevels ? Texture::kMaxPossible : 1, bitmap.getData(), bindFlags);
+    }
+
+    Bitmap::UniqueConstPtr Texture::loadBitmapFromFile(const std::filesystem::path& path)
+    {
+        return Bitmap::createFromFile(path, kTopDown);
+    }
+
     Texture::Texture(uint32_t width, uint32_t height, uint32_t depth, uint32_t arraySize, uint32_t mipLevels, uint32_t sampleCount, ResourceFormat format, Type type, BindFlags bindFlags)
         : Resource(type, bindFlags, 0), mWidth(width), mHeight(height), mDepth(depth), mMipLevels(mipLevels), mSampleCount(sampleCount), mArraySize(arraySize), mFormat(format)
     {
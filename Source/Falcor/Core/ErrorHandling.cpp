@@ -39,6 +39,7 @@ namespace Falcor
     void reportError(const std::string& msg)
     {
         logError(msg);
+        Logger::flush();
 
         if (sShowMessageBoxOnError)
         {
@@ -66,6 +67,7 @@ namespace Falcor
     void reportErrorAndAllowRetry(const std::string& msg)
     {
         logError(msg);
+        Logger::flush();
 
         if (sShowMessageBoxOnError)
         {
@@ -0,0 +1,95 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Platform/MemoryMappedFile.h"
+#include <algorithm>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Falcor
+{
+    bool MemoryMappedFile::open(const std::filesystem::path& path, AccessHint accessHint)
+    {
+        close();
+
+        mFile = ::open(path.c_str(), O_RDONLY);
+        if (mFile == kInvalidHandle) return false;
+
+        struct stat st;
+        if (::fstat((int)mFile, &st) != 0)
+        {
+            close();
+            return false;
+        }
+        mSize = (size_t)st.st_size;
+
+        // Empty files cannot be mapped but are still valid.
+        if (mSize == 0) return true;
+
+        void* pData = ::mmap(nullptr, mSize, PROT_READ, MAP_SHARED, (int)mFile, 0);
+        if (pData == MAP_FAILED)
+        {
+            close();
+            return false;
+        }
+        mpData = pData;
+
+        int advice = MADV_NORMAL;
+        if (accessHint == AccessHint::SequentialScan) advice = MADV_SEQUENTIAL;
+        else if (accessHint == AccessHint::RandomAccess) advice = MADV_RANDOM;
+        ::madvise(mpData, mSize, advice);
+
+        return true;
+    }
+
+    void MemoryMappedFile::close()
+    {
+        if (mpData) ::munmap(mpData, mSize);
+        if (mFile != kInvalidHandle) ::close((int)mFile);
+        mpData = nullptr;
+        mFile = kInvalidHandle;
+        mSize = 0;
+    }
+
+    void MemoryMappedFile::prefetch(size_t offset, size_t size) const
+    {
+        if (!mpData || offset >= mSize) return;
+        // madvise requires a page aligned address.
+        size_t pageSize = getPageSize();
+        size_t alignedOffset = offset - offset % pageSize;
+        size_t alignedSize = std::min(size, mSize - offset) + (offset - alignedOffset);
+        ::madvise(static_cast<uint8_t*>(mpData) + alignedOffset, alignedSize, MADV_WILLNEED);
+    }
+
+    size_t MemoryMappedFile::getPageSize()
+    {
+        return (size_t)::sysconf(_SC_PAGESIZE);
+    }
+}
@@ -0,0 +1,108 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Utility class for read-only memory mapping of files.
+        The mapping is valid for the lifetime of the object. Mapped memory is paged in on first access,
+        which allows reading large files without allocating intermediate buffers.
+    */
+    class FALCOR_API MemoryMappedFile
+    {
+    public:
+        /** Access hint passed to the OS when mapping the file.
+        */
+        enum class AccessHint
+        {
+            Normal,         ///< No particular access pattern.
+            SequentialScan, ///< Data is accessed mostly sequentially.
+            RandomAccess,   ///< Data is accessed in random order.
+        };
+
+        MemoryMappedFile() = default;
+
+        /** Create a memory mapped file and map the entire file.
+            Use isOpen() to check if the file was successfully mapped.
+            \param[in] path File path.
+            \param[in] accessHint Access hint.
+        */
+        MemoryMappedFile(const std::filesystem::path& path, AccessHint accessHint = AccessHint::Normal);
+
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        /** Open and map a file. Closes any previously opened file.
+            \param[in] path File path.
+            \param[in] accessHint Access hint.
+            \return Returns true if the file was successfully mapped.
+        */
+        bool open(const std::filesystem::path& path, AccessHint accessHint = AccessHint::Normal);
+
+        /** Unmap and close the file.
+        */
+        void close();
+
+        /** Check if a file is currently mapped.
+        */
+        bool isOpen() const { return mFile != kInvalidHandle; }
+
+        /** Get the size of the mapped file in bytes.
+        */
+        size_t getSize() const { return mSize; }
+
+        /** Get a pointer to the mapped data.
+        */
+        const void* getData() const { return mpData; }
+
+        /** Hint the OS that a range of the file will be accessed soon.
+            This is used to start paging in data before it is touched.
+            \param[in] offset Byte offset into the file.
+            \param[in] size Size of the range in bytes.
+        */
+        void prefetch(size_t offset, size_t size) const;
+
+        /** Get the page size of the system.
+        */
+        static size_t getPageSize();
+
+    private:
+        using Handle = intptr_t;                        ///< Native file handle: HANDLE on Windows, file descriptor on Linux.
+        static constexpr Handle kInvalidHandle = -1;    ///< Equal to INVALID_HANDLE_VALUE on Windows and an invalid file descriptor on Linux.
+
+        Handle mFile = kInvalidHandle;
+        Handle mMapping = 0;                            ///< File mapping object. Only used on Windows.
+        size_t mSize = 0;
+        void* mpData = nullptr;
+    };
+}
@@ -30,9 +30,11 @@
 #include "Utils/StringUtils.h"
 #include "Utils/StringFormatters.h"
 #include <zlib.h>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <mutex>
+#include <random>
 
 
 namespace Falcor
@@ -285,6 +287,24 @@ namespace Falcor
         return name;
     }
 
+    std::filesystem::path getTempFilePathFor(const std::filesystem::path& path, const std::string& extension)
+    {
+        static const uint64_t processToken = std::random_device()() | (uint64_t(std::random_device()()) << 32);
+        static std::atomic<uint64_t> counter{ 0 };
+        auto tempPath = path;
+        tempPath += fmt::format(".{:016x}.{}{}", processToken, counter++, extension);
+        return tempPath;
+    }
+
+    bool moveFileIntoPlace(const std::filesystem::path& tempPath, const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (!ec) return true;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
     std::string readFile(const std::filesystem::path& path)
     {
         std::ifstream ifs(path, std::ios::binary);
@@ -210,6 +210,25 @@ namespace Falcor
     */
     FALCOR_API std::filesystem::path getTempFilePath();
 
+    /** Generates a unique path for writing a file that is moved into place with moveFileIntoPlace() once complete.
+        The path is in the same directory as the destination, so the move is atomic.
+        Names are unique across threads and processes writing to the same directory.
+        \param[in] path Destination path.
+        \param[in] extension Extension appended to the temporary file name.
+        \return Path to unique temporary file.
+    */
+    FALCOR_API std::filesystem::path getTempFilePathFor(const std::filesystem::path& path, const std::string& extension = ".tmp");
+
+    /** Atomically replace a file with a completely written temporary file, so readers never observe partial files.
+        This is intended for content-addressed caches: if another process has written the same file in the meantime,
+        keeping either copy is equivalent. If the move fails, e.g., on Windows when the destination is open in another
+        process, the temporary file is removed and the destination is left unchanged.
+        \param[in] tempPath Path of the temporary file, see getTempFilePathFor().
+        \param[in] path Destination path.
+        \return True if the file was moved into place.
+    */
+    FALCOR_API bool moveFileIntoPlace(const std::filesystem::path& tempPath, const std::filesystem::path& path);
+
     /** Create a junction (soft link).
         \param[in] link Link path.
         \param[in] target Target path.
@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Platform/MemoryMappedFile.h"
+#include <algorithm>
+
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+
+namespace Falcor
+{
+    bool MemoryMappedFile::open(const std::filesystem::path& path, AccessHint accessHint)
+    {
+        close();
+
+        DWORD flags = FILE_ATTRIBUTE_NORMAL;
+        if (accessHint == AccessHint::SequentialScan) flags |= FILE_FLAG_SEQUENTIAL_SCAN;
+        else if (accessHint == AccessHint::RandomAccess) flags |= FILE_FLAG_RANDOM_ACCESS;
+
+        HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, flags, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        mFile = reinterpret_cast<Handle>(file);
+
+        LARGE_INTEGER size;
+        if (!::GetFileSizeEx(file, &size))
+        {
+            close();
+            return false;
+        }
+        mSize = (size_t)size.QuadPart;
+
+        // Empty files cannot be mapped but are still valid.
+        if (mSize == 0) return true;
+
+        HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr)
+        {
+            close();
+            return false;
+        }
+        mMapping = reinterpret_cast<Handle>(mapping);
+
+        mpData = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (mpData == nullptr)
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    void MemoryMappedFile::close()
+    {
+        if (mpData) ::UnmapViewOfFile(mpData);
+        if (mMapping) ::CloseHandle(reinterpret_cast<HANDLE>(mMapping));
+        if (mFile != kInvalidHandle) ::CloseHandle(reinterpret_cast<HANDLE>(mFile));
+        mpData = nullptr;
+        mMapping = 0;
+        mFile = kInvalidHandle;
+        mSize = 0;
+    }
+
+    void MemoryMappedFile::prefetch(size_t offset, size_t size) const
+    {
+        if (!mpData || offset >= mSize) return;
+        WIN32_MEMORY_RANGE_ENTRY entry;
+        entry.VirtualAddress = static_cast<uint8_t*>(mpData) + offset;
+        entry.NumberOfBytes = std::min(size, mSize - offset);
+        ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &entry, 0);
+    }
+
+    size_t MemoryMappedFile::getPageSize()
+    {
+        SYSTEM_INFO info;
+        ::GetSystemInfo(&info);
+        return (size_t)info.dwAllocationGranularity;
+    }
+}
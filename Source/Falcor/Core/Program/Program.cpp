@@ -30,14 +30,21 @@
 #include "Core/Platform/OS.h"
 #include "Core/API/Device.h"
 #include "Core/API/ParameterBlock.h"
+#include "Utils/CryptoUtils.h"
 #include "Utils/StringUtils.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/CpuTimer.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
 #include <slang.h>
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <mutex>
 #include <set>
+#include <type_traits>
 
 namespace Falcor
 {
@@ -50,6 +57,131 @@ namespace Falcor
     static Program::DefineList sGlobalDefineList;
     static bool sGenerateDebugInfo;
     static Program::ForcedCompilerFlags sForcedCompilerFlags;
+    static std::once_flag sProgramCacheInitFlag;
+    static ProgramCache::SharedPtr sProgramCache;
+    static std::mutex sCompilationStatsMutex;
+
+    namespace
+    {
+        /** Helper for hashing compilation inputs into a program cache key.
+            All values are prefixed by their size so that adjacent values can't alias.
+        */
+        class CacheKeyBuilder
+        {
+        public:
+            void add(const void* data, size_t size)
+            {
+                mSHA1.update(&size, sizeof(size));
+                mSHA1.update(data, size);
+            }
+
+            void add(std::string_view str) { add(str.data(), str.size()); }
+
+            template<typename T>
+            void addValue(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                add(&value, sizeof(T));
+            }
+
+            ProgramCache::Key finalize() { return mSHA1.finalize(); }
+
+        private:
+            SHA1 mSHA1;
+        };
+
+        /** Get the hash of a file's contents.
+            Hashes are memoized by modification time, as most programs share the same include files.
+        */
+        SHA1::MD getFileHash(const std::string& path, time_t modifiedTime)
+        {
+            static std::mutex mutex;
+            static std::unordered_map<std::string, std::pair<time_t, SHA1::MD>> hashes;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                auto it = hashes.find(path);
+                if (it != hashes.end() && it->second.first == modifiedTime) return it->second.second;
+            }
+
+            std::ifstream ifs(path, std::ios::binary);
+            std::string contents((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+            SHA1::MD hash = SHA1::compute(contents.data(), contents.size());
+
+            std::lock_guard<std::mutex> lock(mutex);
+            hashes[path] = { modifiedTime, hash };
+            return hash;
+        }
+    }
+
+    namespace
+    {
+        /** Slang global session used by the current thread, if it is compiling programs concurrently.
+        */
+        thread_local slang::IGlobalSession* tSlangGlobalSession = nullptr;
+
+        /** Pool of Slang global sessions used for compiling programs on worker threads.
+            Slang sessions must not be used from multiple threads at the same time. Each thread compiling
+            programs concurrently therefore uses its own global session. Creating a global session is
+            expensive (it loads the Slang standard library), so sessions are kept for reuse.
+        */
+        class SlangGlobalSessionPool
+        {
+        public:
+            static SlangGlobalSessionPool& get()
+            {
+                static SlangGlobalSessionPool sPool;
+                return sPool;
+            }
+
+            slang::IGlobalSession* acquire()
+            {
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (!mSessions.empty())
+                    {
+                        auto pSession = mSessions.back();
+                        mSessions.pop_back();
+                        return pSession;
+                    }
+                }
+                slang::IGlobalSession* pSession = nullptr;
+                slang::createGlobalSession(&pSession);
+                return pSession;
+            }
+
+            void release(slang::IGlobalSession* pSession)
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mSessions.push_back(pSession);
+            }
+
+        private:
+            std::mutex mMutex;
+            std::vector<slang::IGlobalSession*> mSessions;
+        };
+
+        /** Assigns a pooled Slang global session to the current thread for the lifetime of the object.
+        */
+        class ScopedSlangGlobalSession
+        {
+        public:
+            ScopedSlangGlobalSession()
+                : mpPrevSession(tSlangGlobalSession)
+            {
+                tSlangGlobalSession = SlangGlobalSessionPool::get().acquire();
+            }
+
+            ~ScopedSlangGlobalSession()
+            {
+                SlangGlobalSessionPool::get().release(tSlangGlobalSession);
+                tSlangGlobalSession = mpPrevSession;
+            }
+
+        private:
+            slang::IGlobalSession* mpPrevSession;
+        };
+    }
 
     Program::Desc applyForcedCompilerFlags(Program::Desc desc)
     {
@@ -436,6 +568,7 @@ namespace Falcor
 
     slang::IGlobalSession* getSlangGlobalSession()
     {
+        if (tSlangGlobalSession) return tSlangGlobalSession;
         static slang::IGlobalSession* pSlangGlobalSession = createSlangGlobalSession();
         return pSlangGlobalSession;
     }
@@ -493,7 +626,8 @@ namespace Falcor
     }
 
     SlangCompileRequest* Program::createSlangCompileRequest(
-        const DefineList& defineList) const
+        const DefineList& defineList,
+        std::string& log) const
     {
         slang::IGlobalSession* pSlangGlobalSession = getSlangGlobalSession();
         FALCOR_ASSERT(pSlangGlobalSession);
@@ -522,7 +656,7 @@ namespace Falcor
 
         if (targetDesc.profile == SLANG_PROFILE_UNKNOWN)
         {
-            reportError("Can't find Slang profile for shader model " + mDesc.mShaderModel);
+            log += "Can't find Slang profile for shader model " + mDesc.mShaderModel + "\n";
             return nullptr;
         }
 
@@ -564,7 +698,7 @@ namespace Falcor
         }
 
         // Add program specific defines.
-        for (const auto& shaderDefine : getDefineList())
+        for (const auto& shaderDefine : defineList)
         {
             addSlangDefine(shaderDefine.first.c_str(), shaderDefine.second.c_str());
         }
@@ -658,7 +792,7 @@ namespace Falcor
                 std::filesystem::path fullPath;
                 if (!findFileInShaderDirectories(path, fullPath))
                 {
-                    reportError("Can't find file " + path.string());
+                    log += "Can't find file " + path.string() + "\n";
                     spDestroyCompileRequest(pSlangRequest);
                     return nullptr;
                 }
@@ -740,6 +874,26 @@ namespace Falcor
         ProgramVersion const* pVersion,
         ProgramVars    const* pVars,
         std::string         & log) const
+    {
+        // Global-scope specialization parameters apply to all the entry points
+        // in a `Program`. We will collect the arguments for global specialization
+        // parameters here, using the global `ProgramVars`.
+        //
+        ParameterBlock::SpecializationArgs specializationArgs;
+#ifdef FALCOR_D3D12
+        if (pVars) pVars->collectSpecializationArgs(specializationArgs);
+#endif
+
+        LinkedKernels linked;
+        if (!linkProgramKernels(pVersion, specializationArgs, linked, log)) return nullptr;
+        return finalizeProgramKernels(pVersion, linked, log);
+    }
+
+    bool Program::linkProgramKernels(
+        ProgramVersion const*                       pVersion,
+        ParameterBlock::SpecializationArgs const&   specializationArgs,
+        LinkedKernels&                              linked,
+        std::string&                                log) const
     {
         CpuTimer timer;
         timer.update();
@@ -748,14 +902,7 @@ namespace Falcor
         auto pSlangSession = pSlangGlobalScope->getSession();
 
 #ifdef FALCOR_D3D12
-        // Global-scope specialization parameters apply to all the entry points
-        // in a `Program`. We will collect the arguments for global specialization
-        // parameters here, using the global `ProgramVars`.
-        //
-        ParameterBlock::SpecializationArgs specializationArgs;
-        pVars->collectSpecializationArgs(specializationArgs);
-
-        // Next we instruct Slang to specialize the global scope based on
+        // Instruct Slang to specialize the global scope based on
         // the global specialization arguments.
         //
         ComPtr<slang::IComponentType> pSpecializedSlangGlobalScope = doSlangSpecialization(
@@ -764,7 +911,7 @@ namespace Falcor
             log);
         if (!pSpecializedSlangGlobalScope)
         {
-            return nullptr;
+            return false;
         }
 #else
         slang::IComponentType* pSpecializedSlangGlobalScope = pSlangGlobalScope;
@@ -846,14 +993,13 @@ namespace Falcor
             if (auto typeConformanceComponentList = createTypeConformanceComponentList(typeConformances))
                 typeConformancesCompositeComponents.emplace_back(*typeConformanceComponentList);
             else
-                return nullptr;
+                return false;
         }
 
         // Create a `IComponentType` for each entry point.
         uint32_t allEntryPointCount = uint32_t(mDesc.mEntryPoints.size());
 
         std::vector<ComPtr<slang::IComponentType>> pTypeConformanceSpecializedEntryPoints;
-        std::vector<slang::IComponentType*> pTypeConformanceSpecializedEntryPointsRawPtr;
         std::vector<ComPtr<slang::IComponentType>> pLinkedEntryPoints;
 
         for (uint32_t ee = 0; ee < allEntryPointCount; ++ee)
@@ -877,7 +1023,7 @@ namespace Falcor
                 if (SLANG_FAILED(res))
                 {
                     log += "Slang call createCompositeComponentType() failed.\n";
-                    return nullptr;
+                    return false;
                 }
             }
             else
@@ -885,7 +1031,6 @@ namespace Falcor
                 pTypeComformanceSpecializedEntryPoint = pSlangEntryPoint;
             }
             pTypeConformanceSpecializedEntryPoints.push_back(pTypeComformanceSpecializedEntryPoint);
-            pTypeConformanceSpecializedEntryPointsRawPtr.push_back(pTypeComformanceSpecializedEntryPoint.get());
 
             ComPtr<slang::IComponentType> pLinkedSlangEntryPoint;
             {
@@ -899,7 +1044,7 @@ namespace Falcor
                 if (SLANG_FAILED(res))
                 {
                     log += "Slang call createCompositeComponentType() failed.\n";
-                    return nullptr;
+                    return false;
                 }
             }
             pLinkedEntryPoints.push_back(pLinkedSlangEntryPoint);
@@ -977,13 +1122,51 @@ namespace Falcor
             if (SLANG_FAILED(res))
             {
                 log += "Slang call createCompositeComponentType() failed.\n";
-                return nullptr;
+                return false;
             }
         }
 
         ProgramReflection::SharedPtr pReflector;
         doSlangReflection(pVersion, pSpecializedSlangProgram, pLinkedEntryPoints, pReflector, log);
 
+#ifdef FALCOR_D3D12
+        // Kernels are looked up in the persistent program cache before invoking the downstream compiler.
+        // The GFX backend generates code internally when creating pipelines, so the cache is only used with D3D12.
+        const auto& pCache = getProgramCache();
+        bool useCache = pCache && pVersion->getCacheKey() && !is_set(mDesc.getCompilerFlags(), Shader::CompilerFlags::DumpIntermediates);
+
+        auto getKernelCacheKey = [&](uint32_t entryPointIndex)
+        {
+            const auto& entryPointDesc = mDesc.mEntryPoints[entryPointIndex];
+
+            CacheKeyBuilder builder;
+            builder.addValue(*pVersion->getCacheKey());
+
+            builder.addValue(specializationArgs.size());
+            for (const auto& specializationArg : specializationArgs)
+            {
+                builder.add(specializationArg.type->getName());
+            }
+
+            builder.add(entryPointDesc.name);
+            builder.add(entryPointDesc.exportName);
+            builder.addValue(entryPointDesc.stage);
+            builder.addValue(entryPointDesc.sourceIndex);
+
+            TypeConformanceList typeConformances = mTypeConformanceList;
+            typeConformances.add(mDesc.mGroups[entryPointDesc.groupIndex].typeConformances);
+            builder.addValue(typeConformances.size());
+            for (const auto& [typeConformance, id] : typeConformances)
+            {
+                builder.add(typeConformance.mTypeName);
+                builder.add(typeConformance.mInterfaceName);
+                builder.addValue(id);
+            }
+
+            return builder.finalize();
+        };
+#endif
+
         // Create Shader objects for each entry point and cache them here.
         std::vector<Shader::SharedPtr> allShaders;
         for (uint32_t i = 0; i < allEntryPointCount; i++)
@@ -991,12 +1174,59 @@ namespace Falcor
             auto pLinkedEntryPoint = pLinkedEntryPoints[i];
             auto entryPointDesc = mDesc.mEntryPoints[i];
 
-            Shader::SharedPtr shader = Shader::create(pLinkedEntryPoint, entryPointDesc.stage, entryPointDesc.exportName, mDesc.getCompilerFlags(), log);
-            if (!shader) return nullptr;
+            Shader::SharedPtr shader;
+#ifdef FALCOR_D3D12
+            std::optional<ProgramCache::Key> kernelKey;
+            if (useCache)
+            {
+                kernelKey = getKernelCacheKey(i);
+                if (auto entry = pCache->read(*kernelKey))
+                {
+                    log += entry->diagnostics;
+                    shader = Shader::createFromCode(entryPointDesc.stage, entryPointDesc.exportName, entry->code.data(), entry->code.size());
+                }
+            }
+#endif
+            if (!shader)
+            {
+                std::string shaderLog;
+                shader = Shader::create(pLinkedEntryPoint, entryPointDesc.stage, entryPointDesc.exportName, mDesc.getCompilerFlags(), shaderLog);
+                log += shaderLog;
+                if (!shader) return false;
+
+#ifdef FALCOR_D3D12
+                if (kernelKey)
+                {
+                    auto blobData = shader->getBlobData();
+                    ProgramCache::Entry entry;
+                    entry.code.assign(static_cast<const uint8_t*>(blobData.data), static_cast<const uint8_t*>(blobData.data) + blobData.size);
+                    entry.diagnostics = std::move(shaderLog);
+                    pCache->write(*kernelKey, entry);
+                }
+#endif
+            }
 
             allShaders.push_back(std::move(shader));
         }
 
+        linked.pSpecializedSlangGlobalScope = pSpecializedSlangGlobalScope;
+        linked.pTypeConformanceSpecializedEntryPoints = std::move(pTypeConformanceSpecializedEntryPoints);
+        linked.pReflector = pReflector;
+        linked.shaders = std::move(allShaders);
+
+        timer.update();
+        linked.time = timer.delta();
+        return true;
+    }
+
+    ProgramKernels::SharedPtr Program::finalizeProgramKernels(
+        ProgramVersion const*   pVersion,
+        LinkedKernels const&    linked,
+        std::string&            log) const
+    {
+        CpuTimer timer;
+        timer.update();
+
         // In order to construct the `ProgramKernels` we need to extract
         // the kernels for each entry-point group.
         //
@@ -1018,28 +1248,36 @@ namespace Falcor
             std::vector<Shader::SharedPtr> shaders;
             for (auto entryPointIndex : entryPointGroupDesc.entryPoints)
             {
-                shaders.push_back(allShaders[entryPointIndex]);
+                shaders.push_back(linked.shaders[entryPointIndex]);
             }
-            auto pGroupReflector = pReflector->getEntryPointGroup(gg);
+            auto pGroupReflector = linked.pReflector->getEntryPointGroup(gg);
             auto pEntryPointGroupKernels = createEntryPointGroupKernels(shaders, pGroupReflector);
             entryPointGroups.push_back(pEntryPointGroupKernels);
         }
 
+        std::vector<slang::IComponentType*> pTypeConformanceSpecializedEntryPointsRawPtr;
+        for (const auto& pEntryPoint : linked.pTypeConformanceSpecializedEntryPoints)
+        {
+            pTypeConformanceSpecializedEntryPointsRawPtr.push_back(pEntryPoint.get());
+        }
+
         auto descStr = getProgramDescString();
         ProgramKernels::SharedPtr pProgramKernels = createProgramKernels(
             pVersion,
-            pSpecializedSlangGlobalScope,
+            linked.pSpecializedSlangGlobalScope,
             pTypeConformanceSpecializedEntryPointsRawPtr,
-            pReflector,
+            linked.pReflector,
             entryPointGroups,
             log,
             descStr);
 
         timer.update();
-        double time = timer.delta();
+        double time = linked.time + timer.delta();
+        std::unique_lock<std::mutex> statsLock(sCompilationStatsMutex);
         sCompilationStats.programKernelsCount++;
         sCompilationStats.programKernelsTotalTime += time;
         sCompilationStats.programKernelsMaxTime = std::max(sCompilationStats.programKernelsMaxTime, time);
+        statsLock.unlock();
         logDebug("Created program kernels in {:.3f} s: {}", time, descStr);
 
         return pProgramKernels;
@@ -1064,13 +1302,76 @@ namespace Falcor
             name);
     }
 
+    ProgramCache::Key Program::computeCacheKey(const DefineList& defineList, SlangCompileRequest* pSlangRequest) const
+    {
+        CacheKeyBuilder builder;
+
+        // Compiler version and target.
+        builder.add(spGetBuildTagString());
+        slang::TargetDesc targetDesc;
+        const char* targetMacroName = "";
+        setUpSlangCompilationTarget(targetDesc, targetMacroName);
+        builder.addValue(targetDesc.format);
+        builder.add(mDesc.mShaderModel);
+
+        // Compiler options.
+        builder.addValue(mDesc.getCompilerFlags());
+        builder.addValue(sGenerateDebugInfo);
+        builder.addValue(mDesc.mCompilerArguments.size());
+        for (const auto& arg : mDesc.mCompilerArguments) builder.add(arg);
+
+        // Defines.
+        auto addDefines = [&builder](const DefineList& defineList)
+        {
+            builder.addValue(defineList.size());
+            for (const auto& [name, value] : defineList)
+            {
+                builder.add(name);
+                builder.add(value);
+            }
+        };
+        addDefines(sGlobalDefineList);
+        addDefines(defineList);
+
+        // Sources. Source files are identified by path here, their contents are covered by the dependencies below.
+        builder.addValue(mDesc.mSources.size());
+        for (const auto& src : mDesc.mSources)
+        {
+            builder.addValue(src.getType());
+            builder.addValue(src.source.createTranslationUnit);
+            builder.add(src.source.moduleName);
+            if (src.getType() == ShaderModule::Type::File)
+            {
+                builder.add(src.source.filePath.string());
+            }
+            else
+            {
+                builder.add(src.source.modulePath);
+                builder.add(src.source.str);
+            }
+        }
+
+        // Contents of all files referenced by the program, including transitive includes.
+        int depFileCount = spGetDependencyFileCount(pSlangRequest);
+        builder.addValue(depFileCount);
+        for (int ii = 0; ii < depFileCount; ++ii)
+        {
+            std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
+            builder.add(depFilePath);
+            builder.addValue(getFileHash(depFilePath, mFileTimeMap[depFilePath]));
+        }
+
+        return builder.finalize();
+    }
+
     ProgramVersion::SharedPtr Program::preprocessAndCreateProgramVersion(
+        const DefineList& defineList,
         std::string& log) const
     {
         CpuTimer timer;
         timer.update();
 
-        auto pSlangRequest = createSlangCompileRequest(mDefineList);
+        auto pSlangRequest = createSlangCompileRequest(defineList, log);
         if (pSlangRequest == nullptr) return nullptr;
 
         SlangResult slangResult = spCompile(pSlangRequest);
@@ -1123,6 +1424,10 @@ namespace Falcor
             mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
         }
 
+        // Hash all inputs so that kernels can be looked up in the program cache.
+        std::optional<ProgramCache::Key> cacheKey;
+        if (getProgramCache()) cacheKey = computeCacheKey(defineList, pSlangRequest);
+
         // Note: the `ProgramReflection` needs to be able to refer back to the
         // `ProgramVersion`, but the `ProgramVersion` can't be initialized
         // until we have its reflection. We cut that dependency knot by
@@ -1158,16 +1463,19 @@ namespace Falcor
 
         auto descStr = getProgramDescString();
         pVersion->init(
-            mDefineList,
+            defineList,
             pReflector,
             descStr,
-            pSlangEntryPoints);
+            pSlangEntryPoints,
+            cacheKey);
 
         timer.update();
         double time = timer.delta();
+        std::unique_lock<std::mutex> statsLock(sCompilationStatsMutex);
         sCompilationStats.programVersionCount++;
         sCompilationStats.programVersionTotalTime += time;
         sCompilationStats.programVersionMaxTime = std::max(sCompilationStats.programVersionMaxTime, time);
+        statsLock.unlock();
         logDebug("Created program version in {:.3f} s: {}", timer.delta(), descStr);
 
         return pVersion;
@@ -1186,7 +1494,7 @@ namespace Falcor
         {
             // Create the program
             std::string log;
-            auto pVersion = preprocessAndCreateProgramVersion(log);
+            auto pVersion = preprocessAndCreateProgramVersion(mDefineList, log);
 
             if (pVersion == nullptr)
             {
@@ -1209,6 +1517,127 @@ namespace Falcor
         }
     }
 
+    void Program::compileVersions(const std::vector<std::pair<SharedPtr, DefineList>>& versions)
+    {
+        // Group the requested versions by program. Versions of the same program are compiled sequentially,
+        // as compiling a version updates the file dependencies tracked by the program.
+        struct Job
+        {
+            SharedPtr pProgram;
+            std::vector<DefineList> defineLists;
+            std::vector<ProgramVersion::SharedPtr> versions;
+            std::vector<std::optional<LinkedKernels>> kernels;
+            std::vector<std::string> logs;
+        };
+
+        std::vector<Job> jobs;
+        std::map<const Program*, size_t> jobIndices;
+        for (const auto& [pProgram, defineList] : versions)
+        {
+            FALCOR_ASSERT(pProgram);
+            if (pProgram->mProgramVersions.find(defineList) != pProgram->mProgramVersions.end()) continue;
+
+            auto [it, inserted] = jobIndices.try_emplace(pProgram.get(), jobs.size());
+            if (inserted) jobs.push_back({ pProgram });
+            auto& defineLists = jobs[it->second].defineLists;
+            if (std::find(defineLists.begin(), defineLists.end(), defineList) == defineLists.end()) defineLists.push_back(defineList);
+        }
+        if (jobs.empty()) return;
+
+        CpuTimer timer;
+        timer.update();
+
+        auto compileJob = [&jobs](size_t jobIndex)
+        {
+            auto& job = jobs[jobIndex];
+            for (const auto& defineList : job.defineLists)
+            {
+                std::string log;
+                ProgramVersion::SharedPtr pVersion;
+                std::optional<LinkedKernels> linked;
+                try
+                {
+                    pVersion = job.pProgram->preprocessAndCreateProgramVersion(defineList, log);
+
+                    // Without global specialization parameters the kernels don't depend on the
+                    // bound variables, so their code can be generated here as well.
+                    if (pVersion && pVersion->getSlangGlobalScope()->getSpecializationParamCount() == 0)
+                    {
+                        linked.emplace();
+                        if (!job.pProgram->linkProgramKernels(pVersion.get(), {}, *linked, log)) linked.reset();
+                    }
+                }
+                catch (const std::exception& e)
+                {
+                    log += e.what();
+                }
+                job.versions.push_back(pVersion);
+                job.kernels.push_back(std::move(linked));
+                job.logs.push_back(std::move(log));
+            }
+        };
+
+#ifdef FALCOR_D3D12
+        Threading::parallelFor(size_t(0), jobs.size(), [&](size_t jobIndex)
+        {
+            ScopedSlangGlobalSession session;
+            compileJob(jobIndex);
+        }, 1);
+#else
+        // With GFX, programs are compiled with the global Slang session the device was created with, which can't be shared across threads.
+        for (size_t jobIndex = 0; jobIndex < jobs.size(); jobIndex++) compileJob(jobIndex);
+#endif
+
+        // Store the compiled versions. Programs are not thread-safe, so this happens on the calling thread.
+        size_t versionCount = 0;
+        for (auto& job : jobs)
+        {
+            for (size_t i = 0; i < job.defineLists.size(); i++)
+            {
+                const auto& pVersion = job.versions[i];
+                if (pVersion)
+                {
+                    if (!job.logs[i].empty()) logWarning("Warnings in program:\n" + job.pProgram->getProgramDescString() + "\n" + job.logs[i]);
+                    job.pProgram->mProgramVersions[job.defineLists[i]] = pVersion;
+                    versionCount++;
+
+                    // Store the kernels under the specialization key for an empty set of specialization arguments.
+                    if (job.kernels[i])
+                    {
+                        try
+                        {
+                            std::string log;
+                            if (auto pKernels = job.pProgram->finalizeProgramKernels(pVersion.get(), *job.kernels[i], log)) pVersion->mpKernels[""] = pKernels;
+                        }
+                        catch (const std::exception&)
+                        {
+                            // Errors are reported when the kernels are created again on first use.
+                        }
+                    }
+                }
+                else
+                {
+                    // Errors are reported when the version is compiled again on first use.
+                    logDebug("Failed to compile program version, deferring to first use: {}", job.pProgram->getProgramDescString());
+                }
+            }
+        }
+
+        timer.update();
+        logDebug("Compiled {} program versions of {} programs in {:.3f} s.", versionCount, jobs.size(), timer.delta());
+    }
+
+    void Program::compilePendingPrograms()
+    {
+        std::vector<std::pair<SharedPtr, DefineList>> versions;
+        for (const auto& pWeakProgram : sProgramsForReload)
+        {
+            auto pProgram = pWeakProgram.lock();
+            if (pProgram && pProgram->mLinkRequired) versions.emplace_back(pProgram, pProgram->mDefineList);
+        }
+        compileVersions(versions);
+    }
+
     void Program::reset()
     {
         mpActiveVersion = nullptr;
@@ -1306,6 +1735,19 @@ namespace Falcor
 
     Program::ForcedCompilerFlags Program::getForcedCompilerFlags() { return sForcedCompilerFlags; }
 
+    void Program::setProgramCache(const ProgramCache::SharedPtr& pCache)
+    {
+        // Mark the default cache as initialized so it isn't created on top of the explicitly set one.
+        std::call_once(sProgramCacheInitFlag, []() {});
+        sProgramCache = pCache;
+    }
+
+    const ProgramCache::SharedPtr& Program::getProgramCache()
+    {
+        std::call_once(sProgramCacheInitFlag, []() { sProgramCache = ProgramCache::create(); });
+        return sProgramCache;
+    }
+
     FALCOR_SCRIPT_BINDING(Program)
     {
         pybind11::class_<Program, Program::SharedPtr>(m, "Program");
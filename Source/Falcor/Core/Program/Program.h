@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "ProgramVersion.h"
+#include "ProgramCache.h"
 #include "Core/Macros.h"
 #include "Core/API/Shader.h"
 #include <filesystem>
@@ -329,6 +330,32 @@ namespace Falcor
         */
         static bool isGenerateDebugInfoEnabled();
 
+        /** Set the persistent cache used for storing compiled kernels across runs.
+            \param[in] pCache Program cache, or nullptr to disable caching.
+        */
+        static void setProgramCache(const ProgramCache::SharedPtr& pCache);
+
+        /** Get the persistent program cache.
+            Unless set explicitly, a cache in the default location is created on first use.
+            \return Returns the program cache, or nullptr if caching is disabled.
+        */
+        static const ProgramCache::SharedPtr& getProgramCache();
+
+        /** Compile program versions concurrently on the worker threads.
+            Each entry specifies a program and the program defines to compile it with. Versions that were
+            already compiled are skipped. The compiled versions are stored in their programs, so subsequent
+            calls to getActiveVersion() with the same defines return without compiling.
+            Compilation errors are not reported here. Failed versions are compiled again on first use,
+            which reports the errors as usual.
+            \param[in] versions List of programs and defines to compile.
+        */
+        static void compileVersions(const std::vector<std::pair<SharedPtr, DefineList>>& versions);
+
+        /** Concurrently compile the active version of all programs that need to be linked.
+            This is useful after creating or reconfiguring many programs at once, e.g. when compiling a render graph.
+        */
+        static void compilePendingPrograms();
+
         /** Sets compiler flags that will always be forced on and forced off on each program.
             If a flag is in both groups, it results in being forced on.
             \param[in] forceOn Flags to be forced on.
@@ -367,7 +394,8 @@ namespace Falcor
         bool link() const;
 
         SlangCompileRequest* createSlangCompileRequest(
-            DefineList  const& defineList) const;
+            DefineList  const& defineList,
+            std::string      & log) const;
 
         virtual void setUpSlangCompilationTarget(
             slang::TargetDesc&  ioTargetDesc,
@@ -380,13 +408,47 @@ namespace Falcor
             ProgramReflection::SharedPtr&               pReflector,
             std::string&                                log) const;
 
-        ProgramVersion::SharedPtr preprocessAndCreateProgramVersion(std::string& log) const;
+        /** Compute the program cache key over all inputs to the compilation of a program version.
+            \param[in] defineList Program defines the version is compiled with.
+            \param[in] pSlangRequest Completed compile request, used to enumerate all files the program depends on.
+        */
+        ProgramCache::Key computeCacheKey(const DefineList& defineList, SlangCompileRequest* pSlangRequest) const;
+
+        ProgramVersion::SharedPtr preprocessAndCreateProgramVersion(const DefineList& defineList, std::string& log) const;
 
         ProgramKernels::SharedPtr preprocessAndCreateProgramKernels(
             ProgramVersion const* pVersion,
             ProgramVars    const* pVars,
             std::string         & log) const;
 
+        /** Result of specializing, linking and generating code for the kernels of a program version.
+        */
+        struct LinkedKernels
+        {
+            ComPtr<slang::IComponentType> pSpecializedSlangGlobalScope;
+            std::vector<ComPtr<slang::IComponentType>> pTypeConformanceSpecializedEntryPoints;
+            ProgramReflection::SharedPtr pReflector;
+            std::vector<Shader::SharedPtr> shaders;     ///< Shaders for all entry points.
+            double time = 0.0;                          ///< Time spent in seconds.
+        };
+
+        /** Specialize and link the kernels of a program version and generate their code.
+            This is the expensive part of creating program kernels. It does not modify the program and
+            can run concurrently for different programs.
+        */
+        bool linkProgramKernels(
+            ProgramVersion const*                           pVersion,
+            std::vector<slang::SpecializationArg> const&    specializationArgs,
+            LinkedKernels&                                  linked,
+            std::string&                                    log) const;
+
+        /** Create the program kernels from the result of linkProgramKernels().
+        */
+        ProgramKernels::SharedPtr finalizeProgramKernels(
+            ProgramVersion const*   pVersion,
+            LinkedKernels const&    linked,
+            std::string&            log) const;
+
         virtual EntryPointGroupKernels::SharedPtr createEntryPointGroupKernels(
             const std::vector<Shader::SharedPtr>& shaders,
             EntryPointGroupReflection::SharedPtr const& pReflector) const;
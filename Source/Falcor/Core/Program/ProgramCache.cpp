@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ProgramCache.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current cache entry version.
+            This needs to be incremented every time the entry format or the key computation changes!
+        */
+        const uint32_t kVersion = 1;
+
+        /** Program cache directory (subdirectory in the application data directory).
+        */
+        const std::string kDirectory = "NVIDIA/Falcor/ProgramCache";
+
+        const std::string kEntryExtension = ".bin";
+        const std::string kTempExtension = ".tmp";
+
+        /** Temporary files older than this are left over from crashed processes and removed on eviction.
+        */
+        const auto kStaleTempFileAge = std::chrono::hours(1);
+
+        const char* kMagic = "FalcorP$";
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t diagnosticsSize{};
+            uint64_t codeSize{};
+            ProgramCache::Key key{};
+            uint32_t reserved{};
+
+            bool isValid(const ProgramCache::Key& expectedKey) const
+            {
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion && key == expectedKey;
+            }
+        };
+
+        static_assert(sizeof(Header) == 48);
+
+        bool isEntryFile(const std::filesystem::directory_entry& entry)
+        {
+            std::error_code ec;
+            return entry.is_regular_file(ec) && entry.path().extension() == kEntryExtension;
+        }
+
+        bool isTempFile(const std::filesystem::directory_entry& entry)
+        {
+            std::error_code ec;
+            return entry.is_regular_file(ec) && entry.path().extension() == kTempExtension;
+        }
+    }
+
+    ProgramCache::SharedPtr ProgramCache::create(const std::filesystem::path& directory, uint64_t maxSize)
+    {
+        return SharedPtr(new ProgramCache(directory, maxSize));
+    }
+
+    ProgramCache::ProgramCache(const std::filesystem::path& directory, uint64_t maxSize)
+        : mDirectory(directory)
+        , mMaxSize(maxSize)
+    {
+    }
+
+    std::filesystem::path ProgramCache::getDefaultDirectory()
+    {
+        return getAppDataDirectory() / kDirectory;
+    }
+
+    std::optional<ProgramCache::Entry> ProgramCache::read(const Key& key)
+    {
+        auto path = getEntryPath(key);
+
+        auto readEntry = [&]() -> std::optional<Entry>
+        {
+            std::ifstream fs(path, std::ios_base::binary);
+            if (!fs.good()) return {};
+
+            Header header;
+            fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!fs.good() || !header.isValid(key)) return {};
+
+            // Validate the size before allocating anything.
+            std::error_code ec;
+            uint64_t fileSize = std::filesystem::file_size(path, ec);
+            if (ec || fileSize != sizeof(Header) + header.codeSize + header.diagnosticsSize) return {};
+
+            Entry entry;
+            entry.code.resize(header.codeSize);
+            entry.diagnostics.resize(header.diagnosticsSize);
+            fs.read(reinterpret_cast<char*>(entry.code.data()), entry.code.size());
+            fs.read(entry.diagnostics.data(), entry.diagnostics.size());
+            if (!fs.good()) return {};
+
+            return entry;
+        };
+
+        auto entry = readEntry();
+        if (!entry)
+        {
+            mMissCount++;
+            return {};
+        }
+
+        // Mark the entry as most recently used. This may fail if another process is replacing it, which is harmless.
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+        mHitCount++;
+        return entry;
+    }
+
+    void ProgramCache::write(const Key& key, const Entry& entry)
+    {
+        auto path = getEntryPath(key);
+        auto tempPath = getTempFilePathFor(path, kTempExtension);
+
+        std::error_code ec;
+        std::filesystem::create_directories(mDirectory, ec);
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+        header.version = kVersion;
+        header.diagnosticsSize = (uint32_t)entry.diagnostics.size();
+        header.codeSize = entry.code.size();
+        header.key = key;
+
+        {
+            std::ofstream fs(tempPath, std::ios_base::binary);
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(entry.code.data()), entry.code.size());
+            fs.write(entry.diagnostics.data(), entry.diagnostics.size());
+            if (!fs.good())
+            {
+                fs.close();
+                std::filesystem::remove(tempPath, ec);
+                logWarning("Failed to write program cache entry '{}'.", path);
+                return;
+            }
+        }
+
+        if (!moveFileIntoPlace(tempPath, path)) return;
+
+        mWriteCount++;
+
+        bool needsEviction = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mSize) mSize = getSize();
+            else *mSize += sizeof(Header) + header.codeSize + header.diagnosticsSize;
+            needsEviction = *mSize > mMaxSize;
+        }
+
+        // Evict down to a fraction of the maximum size to amortize the cost of scanning the directory.
+        if (needsEviction) evict(mMaxSize / 4 * 3);
+    }
+
+    void ProgramCache::evict(uint64_t targetSize)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        struct FileInfo
+        {
+            std::filesystem::path path;
+            std::filesystem::file_time_type time;
+            uint64_t size;
+        };
+
+        std::vector<FileInfo> files;
+        uint64_t totalSize = 0;
+        auto now = std::filesystem::file_time_type::clock::now();
+
+        std::error_code ec;
+        for (const auto& dirEntry : std::filesystem::directory_iterator(mDirectory, ec))
+        {
+            std::error_code entryEc;
+            auto time = dirEntry.last_write_time(entryEc);
+            if (entryEc) continue;
+
+            if (isTempFile(dirEntry))
+            {
+                if (now - time > kStaleTempFileAge) std::filesystem::remove(dirEntry.path(), entryEc);
+                continue;
+            }
+            if (!isEntryFile(dirEntry)) continue;
+
+            uint64_t size = dirEntry.file_size(entryEc);
+            if (entryEc) continue;
+
+            files.push_back({ dirEntry.path(), time, size });
+            totalSize += size;
+        }
+
+        // Remove least recently used entries first.
+        std::sort(files.begin(), files.end(), [](const FileInfo& a, const FileInfo& b) { return a.time < b.time; });
+
+        for (const auto& file : files)
+        {
+            if (totalSize <= targetSize) break;
+            // Removal fails if the file is in use by another process. In that case it is recently used and we move on.
+            if (std::filesystem::remove(file.path, ec))
+            {
+                totalSize -= file.size;
+                mEvictionCount++;
+            }
+        }
+
+        mSize = totalSize;
+    }
+
+    void ProgramCache::clear()
+    {
+        evict(0);
+    }
+
+    uint64_t ProgramCache::getSize() const
+    {
+        uint64_t totalSize = 0;
+        std::error_code ec;
+        for (const auto& dirEntry : std::filesystem::directory_iterator(mDirectory, ec))
+        {
+            std::error_code entryEc;
+            if (!isEntryFile(dirEntry)) continue;
+            uint64_t size = dirEntry.file_size(entryEc);
+            if (!entryEc) totalSize += size;
+        }
+        return totalSize;
+    }
+
+    std::filesystem::path ProgramCache::getEntryPath(const Key& key) const
+    {
+        return mDirectory / (SHA1::toHexString(key) + kEntryExtension);
+    }
+
+    ProgramCache::Stats ProgramCache::getStats() const
+    {
+        Stats stats;
+        stats.hitCount = mHitCount;
+        stats.missCount = mMissCount;
+        stats.writeCount = mWriteCount;
+        stats.evictionCount = mEvictionCount;
+        return stats;
+    }
+
+    void ProgramCache::resetStats()
+    {
+        mHitCount = 0;
+        mMissCount = 0;
+        mWriteCount = 0;
+        mEvictionCount = 0;
+    }
+}
@@ -0,0 +1,144 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/CryptoUtils.h"
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+    /** Persistent on-disk cache of compiled shader kernels.
+
+        Entries are content addressed: the key is a hash over everything that affects
+        the generated code (source files including all transitive includes, defines,
+        type conformances, compiler flags, target and compiler version).
+        The key is computed by `Program`, the cache itself only stores opaque blobs.
+
+        Each entry is stored as a separate file in the cache directory. Entries are
+        written to a temporary file and atomically renamed into place, so multiple
+        processes can share a cache directory without locking. Readers never observe
+        partially written entries. The least recently used entries are evicted when
+        the total size exceeds the configured maximum.
+    */
+    class FALCOR_API ProgramCache
+    {
+    public:
+        using SharedPtr = std::shared_ptr<ProgramCache>;
+        using Key = SHA1::MD;
+
+        static constexpr uint64_t kDefaultMaxSize = 1ull << 30; ///< Default maximum cache size (1 GB).
+
+        /** Cached kernel.
+        */
+        struct Entry
+        {
+            std::vector<uint8_t> code;  ///< Compiled target code.
+            std::string diagnostics;    ///< Compiler diagnostics emitted while generating the code.
+        };
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;      ///< Number of lookups that returned an entry.
+            uint64_t missCount = 0;     ///< Number of lookups that did not find a valid entry.
+            uint64_t writeCount = 0;    ///< Number of entries written.
+            uint64_t evictionCount = 0; ///< Number of entries removed by eviction.
+        };
+
+        /** Create a program cache.
+            The directory is created on the first write.
+            \param[in] directory Cache directory.
+            \param[in] maxSize Maximum total size of all cache entries in bytes.
+            \return New object.
+        */
+        static SharedPtr create(const std::filesystem::path& directory = getDefaultDirectory(), uint64_t maxSize = kDefaultMaxSize);
+
+        /** Get the default cache directory (subdirectory in the application data directory).
+        */
+        static std::filesystem::path getDefaultDirectory();
+
+        /** Look up an entry.
+            On success the entry is marked as most recently used.
+            \param[in] key Entry key.
+            \return The cached entry, or an empty optional if no valid entry exists.
+        */
+        std::optional<Entry> read(const Key& key);
+
+        /** Store an entry.
+            Failure to write the entry is not an error, the cache is simply not updated.
+            \param[in] key Entry key.
+            \param[in] entry Entry to store.
+        */
+        void write(const Key& key, const Entry& entry);
+
+        /** Remove least recently used entries until the total size is at most the given size.
+            \param[in] targetSize Target size in bytes.
+        */
+        void evict(uint64_t targetSize);
+
+        /** Remove all entries.
+        */
+        void clear();
+
+        /** Get the total size of all entries currently stored in the cache directory.
+        */
+        uint64_t getSize() const;
+
+        const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+        uint64_t getMaxSize() const { return mMaxSize; }
+        void setMaxSize(uint64_t maxSize) { mMaxSize = maxSize; }
+
+        /** Get the path of the file storing the entry with the given key.
+        */
+        std::filesystem::path getEntryPath(const Key& key) const;
+
+        Stats getStats() const;
+        void resetStats();
+
+    private:
+        ProgramCache(const std::filesystem::path& directory, uint64_t maxSize);
+
+        std::filesystem::path mDirectory;
+        std::atomic<uint64_t> mMaxSize;
+
+        std::mutex mMutex;                  ///< Protects the size estimate and serializes eviction.
+        std::optional<uint64_t> mSize;      ///< Estimated total size of the cache, initialized on first write.
+
+        std::atomic<uint64_t> mHitCount{0};
+        std::atomic<uint64_t> mMissCount{0};
+        std::atomic<uint64_t> mWriteCount{0};
+        std::atomic<uint64_t> mEvictionCount{0};
+    };
+}
@@ -32,6 +32,8 @@
 
 #include <slang.h>
 
+#include <algorithm>
+#include <limits>
 #include <map>
 
 using namespace slang;
@@ -1539,6 +1541,16 @@ namespace Falcor
         mMembers.push_back(pVar);
 
         auto pFieldType = pVar->getType();
+
+        // Keep the members with uniform data sorted by offset for findMemberByOffset().
+        auto uniformOffset = pVar->getBindLocation().getUniform();
+        if (uniformOffset.isValid() && pFieldType->getByteSize() > 0)
+        {
+            std::pair<size_t, int32_t> entry(uniformOffset.getByteOffset(), memberIndex);
+            auto it = std::upper_bound(mUniformOffsetToIndex.begin(), mUniformOffsetToIndex.end(), entry, [](const auto& a, const auto& b) { return a.first < b.first; });
+            mUniformOffsetToIndex.insert(it, entry);
+        }
+
         auto fieldRangeCount = pFieldType->getResourceRangeCount();
         for (uint32_t rr = 0; rr < fieldRangeCount; ++rr)
         {
@@ -1603,6 +1615,9 @@ namespace Falcor
         }
         auto memberIndex = addMemberIgnoringNameConflicts(pVar, ioBuildState);
         mNameToIndex[pVar->getName()] = memberIndex;
+
+        std::pair<uint64_t, int32_t> entry(ShaderVarName::hash(pVar->getName()), memberIndex);
+        mNameHashToIndex.insert(std::upper_bound(mNameHashToIndex.begin(), mNameHashToIndex.end(), entry), entry);
         return memberIndex;
     }
 
@@ -2046,21 +2061,21 @@ namespace Falcor
 
     TypedShaderVarOffset ReflectionStructType::findMemberByOffset(size_t offset) const
     {
-        for (auto pMember : mMembers)
+        // Members don't overlap, so only the last member starting at or before the offset can contain it.
+        auto it = std::upper_bound(mUniformOffsetToIndex.begin(), mUniformOffsetToIndex.end(), offset, [](size_t value, const auto& entry) { return value < entry.first; });
+        if (it != mUniformOffsetToIndex.begin())
         {
+            const auto& pMember = mMembers[std::prev(it)->second];
             auto memberOffset = pMember->getBindLocation();
             auto memberUniformOffset = memberOffset.getUniform().getByteOffset();
             auto pMemberType = pMember->getType();
-            auto memberByteSize = pMember->getType()->getByteSize();
+            auto memberByteSize = pMemberType->getByteSize();
 
-            if (offset >= memberUniformOffset)
+            if (offset < memberUniformOffset + memberByteSize)
             {
-                if (offset < memberUniformOffset + memberByteSize)
-                {
-                    return TypedShaderVarOffset(
-                        pMemberType.get(),
-                        memberOffset);
-                }
+                return TypedShaderVarOffset(
+                    pMemberType.get(),
+                    memberOffset);
             }
         }
 
@@ -2080,6 +2095,19 @@ namespace Falcor
         return nullptr;
     }
 
+    ReflectionVar::SharedConstPtr ReflectionType::findMember(const ShaderVarName& name) const
+    {
+        if (auto pStructType = asStructType())
+        {
+            int32_t fieldIndex = pStructType->getMemberIndex(name);
+            if (fieldIndex == ReflectionStructType::kInvalidMemberIndex) return nullptr;
+
+            return pStructType->getMember(fieldIndex);
+        }
+
+        return nullptr;
+    }
+
     int32_t ReflectionStructType::getMemberIndex(const std::string& name) const
     {
         auto it = mNameToIndex.find(name);
@@ -2087,6 +2115,17 @@ namespace Falcor
         return it->second;
     }
 
+    int32_t ReflectionStructType::getMemberIndex(const ShaderVarName& name) const
+    {
+        auto it = std::lower_bound(mNameHashToIndex.begin(), mNameHashToIndex.end(), std::make_pair(name.getHash(), std::numeric_limits<int32_t>::min()));
+        for (; it != mNameHashToIndex.end() && it->first == name.getHash(); ++it)
+        {
+            // Compare the names to rule out hash collisions.
+            if (mMembers[it->second]->getName() == name.getName()) return it->second;
+        }
+        return kInvalidMemberIndex;
+    }
+
     const ReflectionVar::SharedConstPtr& ReflectionStructType::getMember(const std::string& name) const
     {
         static ReflectionVar::SharedConstPtr pNull;
@@ -29,6 +29,7 @@
 #include "Core/Assert.h"
 #include "Core/Macros.h"
 #include "Core/API/ShaderResourceType.h"
+#include "Core/Program/ShaderVarName.h"
 #include "Utils/Math/Vector.h"
 #if FALCOR_HAS_D3D12
 #include "Core/API/Shared/D3D12DescriptorSet.h"
@@ -667,6 +668,12 @@ namespace Falcor
         */
         std::shared_ptr<const ReflectionVar> findMember(const std::string& name) const;
 
+        /** Find a field/member of this type with the given `name`, using its precomputed hash.
+
+        If this type doesn't have fields/members, or doesn't have a field/member matching `name`, then returns null.
+        */
+        std::shared_ptr<const ReflectionVar> findMember(const ShaderVarName& name) const;
+
         /** Get the (type and) offset of a field/member with the given `name`.
 
         If this type doesn't have fields/members, or doesn't have a field/member matching `name`,
@@ -849,6 +856,12 @@ namespace Falcor
         */
         int32_t getMemberIndex(const std::string& name) const;
 
+        /** Get the index of a member, using the precomputed hash of the name.
+
+        Returns `kInvalidMemberIndex` if no such member exists.
+        */
+        int32_t getMemberIndex(const ShaderVarName& name) const;
+
         /** Find a member based on a byte offset.
         */
         TypedShaderVarOffset findMemberByOffset(size_t offset) const;
@@ -888,6 +901,8 @@ namespace Falcor
             slang::TypeLayoutReflection*    pSlangTypeLayout);
         std::vector<std::shared_ptr<const ReflectionVar>> mMembers;   // Struct members
         std::unordered_map<std::string, int32_t> mNameToIndex; // Translates from a name to an index in mMembers
+        std::vector<std::pair<uint64_t, int32_t>> mNameHashToIndex; // Translates from a name hash to an index in mMembers, sorted by hash
+        std::vector<std::pair<size_t, int32_t>> mUniformOffsetToIndex; // Members with uniform data sorted by byte offset, for findMemberByOffset()
         std::string mName;
     };
 
@@ -1394,6 +1409,11 @@ namespace Falcor
             return getElementType()->findMember(name);
         }
 
+        std::shared_ptr<const ReflectionVar> findMember(const ShaderVarName& name) const
+        {
+            return getElementType()->findMember(name);
+        }
+
     protected:
         ParameterBlockReflection(
             ProgramVersion const* pProgramVersion);
@@ -203,13 +203,15 @@ namespace Falcor
         const DefineList&                                   defineList,
         const ProgramReflection::SharedPtr&                 pReflector,
         const std::string&                                  name,
-        std::vector<ComPtr<slang::IComponentType>> const&   pSlangEntryPoints)
+        std::vector<ComPtr<slang::IComponentType>> const&   pSlangEntryPoints,
+        const std::optional<ProgramCache::Key>&             cacheKey)
     {
         FALCOR_ASSERT(pReflector);
         mDefines = defineList;
         mpReflector = pReflector;
         mName = name;
         mpSlangEntryPoints = pSlangEntryPoints;
+        mCacheKey = cacheKey;
     }
 
     ProgramVersion::SharedPtr ProgramVersion::createEmpty(Program* pProgram, slang::IComponentType* pSlangGlobalScope)
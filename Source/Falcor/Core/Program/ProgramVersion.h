@@ -27,10 +27,12 @@
  **************************************************************************/
 #pragma once
 #include "ProgramReflection.h"
+#include "ProgramCache.h"
 #include "Core/Macros.h"
 #include "Core/API/Shader.h"
 #include "Core/API/Handles.h"
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -244,6 +246,11 @@ namespace Falcor
         */
         ProgramKernels::SharedConstPtr getKernels(ProgramVars const* pVars) const;
 
+        /** Get the key identifying all inputs to this program version in the program cache.
+            \return The key, or an empty optional if the program cache was disabled when the version was created.
+        */
+        const std::optional<ProgramCache::Key>& getCacheKey() const { return mCacheKey; }
+
         slang::ISession* getSlangSession() const;
         slang::IComponentType* getSlangGlobalScope() const;
         slang::IComponentType* getSlangEntryPoint(uint32_t index) const;
@@ -260,7 +267,8 @@ namespace Falcor
             const DefineList&                                   defineList,
             const ProgramReflection::SharedPtr&                 pReflector,
             const std::string&                                  name,
-            std::vector<ComPtr<slang::IComponentType>> const&   pSlangEntryPoints);
+            std::vector<ComPtr<slang::IComponentType>> const&   pSlangEntryPoints,
+            const std::optional<ProgramCache::Key>&             cacheKey);
 
         std::shared_ptr<Program>        mpProgram;
         DefineList                      mDefines;
@@ -268,6 +276,7 @@ namespace Falcor
         std::string                     mName;
         ComPtr<slang::IComponentType>   mpSlangGlobalScope;
         std::vector<ComPtr<slang::IComponentType>> mpSlangEntryPoints;
+        std::optional<ProgramCache::Key> mCacheKey;
 
         // Cached version of compiled kernels for this program version
         mutable std::unordered_map<std::string, ProgramKernels::SharedPtr> mpKernels;
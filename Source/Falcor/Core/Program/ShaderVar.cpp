@@ -28,6 +28,8 @@
 #include "ShaderVar.h"
 #include "Core/API/ParameterBlock.h"
 
+#include <algorithm>
+
 namespace Falcor
 {
     ShaderVar::ShaderVar() : mpBlock(nullptr) {}
@@ -70,6 +72,33 @@ namespace Falcor
         return ShaderVar();
     }
 
+    ShaderVar ShaderVar::findMember(const ShaderVarName& name) const
+    {
+        if (!isValid()) return *this;
+        auto pType = getType();
+
+        // Implicitly dereference constant buffers and parameter blocks, see findMember(const std::string&).
+        if (auto pResourceType = pType->asResourceType())
+        {
+            switch (pResourceType->getType())
+            {
+            case ReflectionResourceType::Type::ConstantBuffer:
+                return getParameterBlock()->getRootVar().findMember(name);
+            default:
+                break;
+            }
+        }
+
+        if (auto pMember = pType->findMember(name))
+        {
+            // Need to apply the offsets from member
+            TypedShaderVarOffset newOffset = TypedShaderVarOffset(pMember->getType().get(), mOffset + pMember->getBindLocation());
+            return ShaderVar(mpBlock, newOffset);
+        }
+
+        return ShaderVar();
+    }
+
     ShaderVar ShaderVar::findMember(uint32_t index) const
     {
         if (!isValid()) return *this;
@@ -117,6 +146,50 @@ namespace Falcor
         return result;
     }
 
+    ShaderVar ShaderVar::operator[](const ShaderVarName& name) const
+    {
+        auto result = findMember(name);
+        if (!result.isValid() && isValid())
+        {
+            reportError(fmt::format("No member named '{}' found.\n", name.getName()));
+        }
+        return result;
+    }
+
+    ShaderVar ShaderVar::operator[](const ShaderVarHandle& handle) const
+    {
+        if (!isValid()) return *this;
+        auto pType = getType();
+
+        // Implicitly dereference constant buffers and parameter blocks, see findMember(const std::string&).
+        if (auto pResourceType = pType->asResourceType())
+        {
+            switch (pResourceType->getType())
+            {
+            case ReflectionResourceType::Type::ConstantBuffer:
+                return getParameterBlock()->getRootVar()[handle];
+            default:
+                break;
+            }
+        }
+
+        const ShaderVarHandle::Resolution* pResolution = handle.resolve(pType);
+        if (!pResolution)
+        {
+            std::string path;
+            for (const auto& name : handle.getPath()) path += (path.empty() ? "" : ".") + std::string(name.getName());
+            reportError(fmt::format("No member named '{}' found.\n", path));
+            return ShaderVar();
+        }
+
+        TypedShaderVarOffset newOffset = TypedShaderVarOffset(pResolution->offset.getType().get(), mOffset + pResolution->offset);
+        ShaderVar result(mpBlock, newOffset);
+
+        // Look up the members behind a constant buffer or parameter block by name.
+        for (size_t i = pResolution->count; i < handle.mPath.size() && result.isValid(); ++i) result = result[handle.mPath[i]];
+        return result;
+    }
+
     ShaderVar ShaderVar::operator[](const char* name) const
     {
         // #SHADER_VAR we can use std::string_view to do lookups into the map
@@ -428,4 +501,30 @@ namespace Falcor
         return (uint8_t*)(mpBlock->getRawData()) + mOffset.getUniform().getByteOffset();
     }
 
+    const ShaderVarHandle::Resolution* ShaderVarHandle::resolve(const ReflectionType::SharedConstPtr& pType) const
+    {
+        // A matching address refers to the same type as long as the cached type is alive.
+        for (const auto& resolution : mResolutions)
+        {
+            if (resolution.pType == pType.get() && !resolution.pTypeRef.expired()) return &resolution;
+        }
+
+        // Resolve members until the path ends or reaches a value that isn't a struct, e.g., a constant buffer.
+        TypedShaderVarOffset offset = pType->getZeroOffset();
+        size_t count = 0;
+        for (; count < mPath.size(); ++count)
+        {
+            if (!offset.getType()->asStructType()) break;
+            auto pMember = offset.getType()->findMember(mPath[count]);
+            if (!pMember) return nullptr;
+            offset = TypedShaderVarOffset(pMember->getType().get(), offset + pMember->getBindLocation());
+        }
+        if (count == 0) return nullptr;
+
+        // Discard resolutions for types that have been destroyed, e.g., by recompiling a program.
+        mResolutions.erase(std::remove_if(mResolutions.begin(), mResolutions.end(), [](const Resolution& r) { return r.pTypeRef.expired(); }), mResolutions.end());
+        mResolutions.push_back({ pType.get(), pType, offset, count });
+        return &mResolutions.back();
+    }
+
 }
@@ -34,8 +34,10 @@
 #include "Core/API/ResourceViews.h"
 #include "Core/API/RtAccelerationStructure.h"
 #include "Utils/Math/Vector.h"
+#include <initializer_list>
 #include <memory>
 #include <string>
+#include <vector>
 #include <cstddef>
 
 namespace Falcor
@@ -43,6 +45,7 @@ namespace Falcor
     class ParameterBlock;
     template<typename T>
     class ParameterBlockSharedPtr;
+    class ShaderVarHandle;
 
     /** A "pointer" to a shader variable stored in some parameter block.
 
@@ -134,6 +137,20 @@ namespace Falcor
         */
         ShaderVar operator[](const std::string& name) const;
 
+        /** Get a shader variable pointer to a sub-field.
+
+            Same as `operator[](const std::string&)`, but the member is looked up by the precomputed hash of the name.
+        */
+        ShaderVar operator[](const ShaderVarName& name) const;
+
+        /** Get a shader variable pointer to a sub-field, using a cached lookup.
+
+            The member path of the handle is resolved on first use and the result is reused as long as this shader variable
+            points at a value of the same type. See `ShaderVarHandle`.
+            Logs an error and returns an invalid `ShaderVar` if the member path can't be resolved.
+        */
+        ShaderVar operator[](const ShaderVarHandle& handle) const;
+
         /** Get a shader variable pointer to an element or sub-field.
 
             This operation is valid in two cases:
@@ -154,6 +171,13 @@ namespace Falcor
         */
         ShaderVar findMember(const std::string& name) const;
 
+        /** Try to get a variable for a member/field, using the precomputed hash of the name.
+
+        Unlike `operator[]`, a `findMember` operation does not
+        log an error if a member of the given name cannot be found.
+        */
+        ShaderVar findMember(const ShaderVarName& name) const;
+
         /** Try to get a variable for a member/field, by index.
 
         Unlike `operator[]`, a `findMember` operation does not
@@ -396,6 +420,63 @@ namespace Falcor
 
         template<typename T> bool setImpl(const T& val) const;
     };
+
+    /** A cached lookup of a shader variable by member path.
+
+    Looking up members by name with `operator[]` hashes the name and searches the members of the struct type on
+    every call. For variables that are set every frame, a `ShaderVarHandle` resolves its member path once per struct
+    type and caches the offset of the member relative to that type:
+
+        // Created once, e.g., as a member of a render pass.
+        ShaderVarHandle mFrameCountHandle{ ShaderVarName("CB"), ShaderVarName("gFrameCount") };
+        ...
+        var[mFrameCountHandle] = frameCount;
+
+    Offsets are cached per reflection type, i.e., per program version, so a handle can be shared by several programs.
+    For example, the scene applies its handles to the variables of every render pass it is bound to. Applying the handle
+    to a new type (e.g., after the program is recompiled) resolves the path for that type. The handle does not keep
+    the reflection data alive, and offsets cached for destroyed types are discarded when a new type is resolved.
+
+    If the path passes through a constant buffer or parameter block, only the part up to it is cached, and the
+    remaining members are looked up by name hash.
+
+    Handles update their cache when used, so a handle must not be used from multiple threads concurrently.
+    */
+    class FALCOR_API ShaderVarHandle
+    {
+    public:
+        /** Create a handle for a single member.
+        */
+        explicit ShaderVarHandle(const ShaderVarName& name) : mPath({ name }) {}
+
+        /** Create a handle for a path of nested members.
+        */
+        ShaderVarHandle(std::initializer_list<ShaderVarName> path) : mPath(path) {}
+
+        /** Get the member path of the handle.
+        */
+        const std::vector<ShaderVarName>& getPath() const { return mPath; }
+
+    private:
+        friend struct ShaderVar;
+
+        struct Resolution
+        {
+            const ReflectionType* pType = nullptr;                  ///< Type the path was resolved in.
+            std::weak_ptr<const ReflectionType> pTypeRef;           ///< Reference to the type. Once it expires, the address may be reused by another type.
+            TypedShaderVarOffset offset;                            ///< Type and offset of the last resolved member, relative to the resolved type.
+            size_t count = 0;                                       ///< Number of members of the path resolved in the cached offset.
+        };
+
+        /** Get the resolution of the path in a struct type, resolving it if it isn't cached yet.
+            Returns nullptr if a member can't be found.
+        */
+        const Resolution* resolve(const ReflectionType::SharedConstPtr& pType) const;
+
+        std::vector<ShaderVarName> mPath;
+
+        mutable std::vector<Resolution> mResolutions;               ///< Cached resolutions, one per type the handle has been applied to.
+    };
 }
 
 #include "Core/API/ParameterBlock.h"
@@ -0,0 +1,72 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+namespace Falcor
+{
+    /** Name of a shader variable with a precomputed hash.
+
+        Looking up a member by `ShaderVarName` compares hashes instead of hashing the name string on every lookup.
+        When declared `constexpr`, the hash is computed at compile time:
+
+            constexpr ShaderVarName kCamera("camera");
+            pSceneBlock[kCamera] = ...;
+
+        The name is not copied, so the string must outlive the `ShaderVarName` (string literals always do).
+    */
+    class ShaderVarName
+    {
+    public:
+        constexpr explicit ShaderVarName(std::string_view name)
+            : mName(name)
+            , mHash(hash(name))
+        {}
+
+        constexpr std::string_view getName() const { return mName; }
+        constexpr uint64_t getHash() const { return mHash; }
+
+        /** Compute the 64-bit FNV-1 hash of a name.
+        */
+        static constexpr uint64_t hash(std::string_view name)
+        {
+            uint64_t h = UINT64_C(14695981039346656037);
+            for (char c : name)
+            {
+                h *= UINT64_C(1099511628211);
+                h ^= (uint8_t)c;
+            }
+            return h;
+        }
+
+    private:
+        std::string_view mName;
+        uint64_t mHash;
+    };
+}
@@ -28,6 +28,7 @@
 #include "RenderGraphCompiler.h"
 #include "RenderGraph.h"
 #include "RenderPasses/ResolvePass.h"
+#include "Core/Program/Program.h"
 #include "Utils/Algorithm/DirectedGraphTraversal.h"
 #include "Utils/StringUtils.h"
 
@@ -240,13 +241,6 @@ namespace Falcor
 
     void RenderGraphCompiler::allocateResources(ResourceCache* pResourceCache)
     {
-        // Build list to look up execution order index from the pass
-        std::unordered_map<RenderPass*, uint32_t> passToIndex;
-        for (size_t i = 0; i < mExecutionList.size(); i++)
-        {
-            passToIndex.emplace(mExecutionList[i].pPass.get(), uint32_t(i));
-        }
-
         for (size_t i = 0; i < mExecutionList.size(); i++)
         {
             uint32_t nodeIndex = mExecutionList[i].index;
@@ -308,9 +302,8 @@ namespace Falcor
                 std::string srcFieldName = mGraph.mNodeData[pEdge->getSourceNode()].name + '.' + edgeData.srcField;
                 std::string dstFieldName = mGraph.mNodeData[nodeIndex].name + '.' + dstField.getName();
 
-                const auto& pSrcPass = mGraph.mNodeData[pEdge->getSourceNode()].pPass.get();
-                const auto& srcReflection = mExecutionList[passToIndex.at(pSrcPass)].reflector;
-                pResourceCache->registerField(dstFieldName, dstField, passToIndex[pSrcPass], srcFieldName);
+                // The resource must stay alive until this pass has executed
+                pResourceCache->registerField(dstFieldName, dstField, uint32_t(i), srcFieldName);
             }
         }
 
@@ -420,7 +413,12 @@ namespace Falcor
                 }
             }
 
-            if (success) return;
+            if (success)
+            {
+                // Compile the programs created or reconfigured by the passes concurrently instead of one by one on first use.
+                Program::compilePendingPrograms();
+                return;
+            }
 
             // Retry
             bool changed = false;
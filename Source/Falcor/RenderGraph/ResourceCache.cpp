@@ -29,6 +29,9 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
+#include "Utils/StringUtils.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -116,78 +119,272 @@ namespace Falcor
         }
     }
 
-    Resource::SharedPtr createResourceForPass(const ResourceCache::DefaultProperties& params, const RenderPassReflection::Field& field, bool resolveBindFlags, const std::string& resourceName)
+    namespace
     {
-        uint32_t width = field.getWidth() ? field.getWidth() : params.dims.x;
-        uint32_t height = field.getHeight() ? field.getHeight() : params.dims.y;
-        uint32_t depth = field.getDepth() ? field.getDepth() : 1;
-        uint32_t sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
-        auto bindFlags = field.getBindFlags();
-        auto arraySize = field.getArraySize();
-        auto mipLevels = field.getMipCount();
+        /** Fully resolved creation properties of a graph resource.
+            Resources can share an allocation only if their descriptions are equal.
+        */
+        struct ResourceDesc
+        {
+            RenderPassReflection::Field::Type type = RenderPassReflection::Field::Type::Texture2D;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            uint32_t depth = 0;
+            uint32_t sampleCount = 0;
+            uint32_t arraySize = 0;
+            uint32_t mipLevels = 0;
+            ResourceFormat format = ResourceFormat::Unknown;
+            ResourceBindFlags bindFlags = ResourceBindFlags::None;
+
+            bool operator==(const ResourceDesc& other) const
+            {
+                return type == other.type && width == other.width && height == other.height && depth == other.depth &&
+                    sampleCount == other.sampleCount && arraySize == other.arraySize && mipLevels == other.mipLevels &&
+                    format == other.format && bindFlags == other.bindFlags;
+            }
 
-        ResourceFormat format = ResourceFormat::Unknown;
+            uint64_t getSizeInBytes() const
+            {
+                if (type == RenderPassReflection::Field::Type::RawBuffer) return width;
+
+                uint32_t mipCount = mipLevels;
+                if (mipCount == Texture::kMaxPossible)
+                {
+                    uint32_t dims = std::max(width, std::max(height, depth));
+                    mipCount = 1;
+                    while (dims >>= 1) mipCount++;
+                }
 
-        if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
+                uint64_t size = 0;
+                uint32_t w = width, h = height, d = depth;
+                uint32_t blockWidth = getFormatWidthCompressionRatio(format);
+                uint32_t blockHeight = getFormatHeightCompressionRatio(format);
+                for (uint32_t mip = 0; mip < mipCount; mip++)
+                {
+                    uint64_t blocks = uint64_t(div_round_up(w, blockWidth)) * div_round_up(h, blockHeight) * d;
+                    size += blocks * getFormatBytesPerBlock(format);
+                    w = std::max(w >> 1, 1u);
+                    h = std::max(h >> 1, 1u);
+                    d = std::max(d >> 1, 1u);
+                }
+
+                uint32_t faceCount = (type == RenderPassReflection::Field::Type::TextureCube) ? 6 : 1;
+                return size * arraySize * faceCount * sampleCount;
+            }
+        };
+
+        ResourceDesc resolveResourceDesc(const ResourceCache::DefaultProperties& params, const RenderPassReflection::Field& field, bool resolveBindFlags)
         {
-            format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
-            if (resolveBindFlags)
+            ResourceDesc desc;
+            desc.type = field.getType();
+            desc.width = field.getWidth() ? field.getWidth() : params.dims.x;
+            desc.height = field.getHeight() ? field.getHeight() : params.dims.y;
+            desc.depth = field.getDepth() ? field.getDepth() : 1;
+            desc.sampleCount = field.getSampleCount() ? field.getSampleCount() : 1;
+            desc.arraySize = field.getArraySize();
+            desc.mipLevels = field.getMipCount();
+            desc.bindFlags = field.getBindFlags();
+
+            if (field.getType() != RenderPassReflection::Field::Type::RawBuffer)
+            {
+                desc.format = field.getFormat() == ResourceFormat::Unknown ? params.format : field.getFormat();
+                if (resolveBindFlags)
+                {
+                    ResourceBindFlags mask = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
+                    bool isOutput = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Output);
+                    bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
+                    if (isOutput || isInternal) mask |= Resource::BindFlags::DepthStencil | Resource::BindFlags::RenderTarget;
+                    auto supported = getFormatBindFlags(desc.format);
+                    mask &= supported;
+                    desc.bindFlags |= mask;
+                }
+            }
+            else // RawBuffer
+            {
+                if (resolveBindFlags) desc.bindFlags = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
+            }
+
+            // Normalize properties that are ignored for the resource type, so they don't prevent resources from sharing an allocation
+            switch (desc.type)
             {
-                ResourceBindFlags mask = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
-                bool isOutput = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Output);
-                bool isInternal = is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal);
-                if (isOutput || isInternal) mask |= Resource::BindFlags::DepthStencil | Resource::BindFlags::RenderTarget;
-                auto supported = getFormatBindFlags(format);
-                mask &= supported;
-                bindFlags |= mask;
+            case RenderPassReflection::Field::Type::RawBuffer:
+                desc.height = desc.depth = desc.sampleCount = desc.arraySize = desc.mipLevels = 0;
+                break;
+            case RenderPassReflection::Field::Type::Texture1D:
+                desc.height = desc.depth = desc.sampleCount = 1;
+                break;
+            case RenderPassReflection::Field::Type::Texture2D:
+                desc.depth = 1;
+                if (desc.sampleCount > 1) desc.mipLevels = 1;
+                break;
+            case RenderPassReflection::Field::Type::Texture3D:
+                desc.sampleCount = desc.arraySize = 1;
+                break;
+            case RenderPassReflection::Field::Type::TextureCube:
+                desc.depth = desc.sampleCount = 1;
+                break;
             }
+            return desc;
         }
-        else // RawBuffer
+
+        Resource::SharedPtr createResource(const ResourceDesc& desc, const std::string& resourceName)
+        {
+            Resource::SharedPtr pResource;
+
+            switch (desc.type)
+            {
+            case RenderPassReflection::Field::Type::RawBuffer:
+                pResource = Buffer::create(desc.width, desc.bindFlags, Buffer::CpuAccess::None);
+                break;
+            case RenderPassReflection::Field::Type::Texture1D:
+                pResource = Texture::create1D(desc.width, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            case RenderPassReflection::Field::Type::Texture2D:
+                if (desc.sampleCount > 1)
+                {
+                    pResource = Texture::create2DMS(desc.width, desc.height, desc.format, desc.sampleCount, desc.arraySize, desc.bindFlags);
+                }
+                else
+                {
+                    pResource = Texture::create2D(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                }
+                break;
+            case RenderPassReflection::Field::Type::Texture3D:
+                pResource = Texture::create3D(desc.width, desc.height, desc.depth, desc.format, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            case RenderPassReflection::Field::Type::TextureCube:
+                pResource = Texture::createCube(desc.width, desc.height, desc.format, desc.arraySize, desc.mipLevels, nullptr, desc.bindFlags);
+                break;
+            default:
+                FALCOR_UNREACHABLE();
+                return nullptr;
+            }
+            pResource->setName(resourceName);
+            return pResource;
+        }
+
+        /** Check if a resource only needs to hold its data during the time points it is used at.
+            Graph outputs are read after execution, internal resources are commonly used for data carried over between frames and
+            persistent resources must keep their data, so none of them can share memory.
+        */
+        bool isTransient(const RenderPassReflection::Field& field, const std::pair<uint32_t, uint32_t>& lifetime)
         {
-            if (resolveBindFlags) bindFlags = Resource::BindFlags::UnorderedAccess | Resource::BindFlags::ShaderResource;
+            if (lifetime.second == uint32_t(-1)) return false;
+            if (is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Internal)) return false;
+            if (is_set(field.getFlags(), RenderPassReflection::Field::Flags::Persistent)) return false;
+            return true;
         }
-        Resource::SharedPtr pResource;
+    }
+
+    uint32_t ResourceCache::getAllocationIndex(const std::string& name) const
+    {
+        auto it = mNameToIndex.find(name);
+        return it != mNameToIndex.end() ? mResourceData[it->second].allocation : kInvalidAllocation;
+    }
 
-        switch (field.getType())
+    const ResourceCache::AllocationStats& ResourceCache::planAllocations(const DefaultProperties& params)
+    {
+        mStats = {};
+
+        std::vector<ResourceDesc> descs(mResourceData.size());
+        std::vector<uint32_t> transientResources;
+        for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
         {
-        case RenderPassReflection::Field::Type::RawBuffer:
-            pResource = Buffer::create(width, bindFlags, Buffer::CpuAccess::None);
-            break;
-        case RenderPassReflection::Field::Type::Texture1D:
-            pResource = Texture::create1D(width, format, arraySize, mipLevels, nullptr, bindFlags);
-            break;
-        case RenderPassReflection::Field::Type::Texture2D:
-            if (sampleCount > 1)
+            auto& data = mResourceData[i];
+            data.allocation = kInvalidAllocation;
+            if (!data.field.isValid()) continue;
+
+            descs[i] = resolveResourceDesc(params, data.field, data.resolveBindFlags);
+            mStats.resourceCount++;
+            mStats.requiredMemory += descs[i].getSizeInBytes();
+
+            if (mAliasingEnabled && isTransient(data.field, data.lifetime)) transientResources.push_back(i);
+            else
+            {
+                data.allocation = mStats.allocationCount++;
+                mStats.allocatedMemory += descs[i].getSizeInBytes();
+            }
+        }
+        mStats.transientCount = (uint32_t)transientResources.size();
+
+        // The lifetimes form an interval graph. Visiting the intervals in order of their start time and reusing any allocation
+        // whose last use ended before the start gives an optimal coloring, i.e. as many allocations as the maximum number of
+        // resources alive at the same time. Allocations are only shared between resources with identical descriptions.
+        std::stable_sort(transientResources.begin(), transientResources.end(), [this](uint32_t a, uint32_t b)
+            {
+                return mResourceData[a].lifetime.first < mResourceData[b].lifetime.first;
+            });
+
+        struct Allocation
+        {
+            uint32_t descIndex;     // Index of a resource with the allocation's description
+            uint32_t index;         // The allocation index
+            uint32_t lastUse;       // Last time point the allocation is used at
+        };
+        std::vector<Allocation> allocations;
+
+        for (uint32_t i : transientResources)
+        {
+            auto& data = mResourceData[i];
+
+            // Pick the compatible free allocation that was released last, this keeps the remaining allocations free for longer
+            Allocation* pBest = nullptr;
+            for (auto& a : allocations)
+            {
+                if (a.lastUse >= data.lifetime.first || !(descs[a.descIndex] == descs[i])) continue;
+                if (!pBest || a.lastUse > pBest->lastUse) pBest = &a;
+            }
+
+            if (pBest)
             {
-                pResource = Texture::create2DMS(width, height, format, sampleCount, arraySize, bindFlags);
+                pBest->lastUse = data.lifetime.second;
+                data.allocation = pBest->index;
             }
             else
             {
-                pResource = Texture::create2D(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
+                data.allocation = mStats.allocationCount++;
+                mStats.allocatedMemory += descs[i].getSizeInBytes();
+                allocations.push_back({ i, data.allocation, data.lifetime.second });
             }
-            break;
-        case RenderPassReflection::Field::Type::Texture3D:
-            pResource = Texture::create3D(width, height, depth, format, mipLevels, nullptr, bindFlags);
-            break;
-        case RenderPassReflection::Field::Type::TextureCube:
-            pResource = Texture::createCube(width, height, format, arraySize, mipLevels, nullptr, bindFlags);
-            break;
-        default:
-            FALCOR_UNREACHABLE();
-            return nullptr;
         }
-        pResource->setName(resourceName);
-        return pResource;
+
+        return mStats;
     }
 
     void ResourceCache::allocateResources(const DefaultProperties& params)
     {
-        for (auto& data : mResourceData)
+        planAllocations(params);
+
+        // Gather the resources backed by each allocation
+        std::vector<std::vector<uint32_t>> allocationResources(mStats.allocationCount);
+        for (uint32_t i = 0; i < (uint32_t)mResourceData.size(); i++)
         {
-            if ((data.pResource == nullptr) && (data.field.isValid()))
-            {
-                data.pResource = createResourceForPass(params, data.field, data.resolveBindFlags, data.name);
-            }
+            if (mResourceData[i].allocation != kInvalidAllocation) allocationResources[mResourceData[i].allocation].push_back(i);
+        }
+
+        for (const auto& resources : allocationResources)
+        {
+            FALCOR_ASSERT(!resources.empty());
+
+            // Keep the existing resource if all fields are already backed by it
+            const auto& pExisting = mResourceData[resources[0]].pResource;
+            bool upToDate = pExisting != nullptr;
+            for (uint32_t i : resources) upToDate = upToDate && mResourceData[i].pResource == pExisting;
+            if (upToDate) continue;
+
+            const auto& first = mResourceData[resources[0]];
+            std::vector<std::string> names;
+            for (uint32_t i : resources) names.push_back(mResourceData[i].name);
+
+            auto pResource = createResource(resolveResourceDesc(params, first.field, first.resolveBindFlags), joinStrings(names, ", "));
+            for (uint32_t i : resources) mResourceData[i].pResource = pResource;
+        }
+
+        if (mStats.getSavedMemory() > 0)
+        {
+            logInfo("ResourceCache: Packed {} transient resources into {} allocations. Graph resources use {} instead of {} ({} saved).",
+                mStats.transientCount, mStats.transientCount - (mStats.resourceCount - mStats.allocationCount),
+                formatByteSize(mStats.allocatedMemory), formatByteSize(mStats.requiredMemory), formatByteSize(mStats.getSavedMemory()));
         }
     }
 }
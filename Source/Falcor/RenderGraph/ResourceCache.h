@@ -55,6 +55,22 @@ namespace Falcor
             ResourceFormat format = ResourceFormat::Unknown;    ///< Format to use for texture creation
         };
 
+        /** Statistics about the memory used by resources owned by the cache.
+            Sizes are estimates computed from the resource dimensions and formats, ignoring alignment and padding.
+        */
+        struct AllocationStats
+        {
+            uint32_t resourceCount = 0;         ///< Number of graph resources (after merging aliased fields) requiring memory.
+            uint32_t transientCount = 0;        ///< Number of graph resources that were eligible for sharing memory with other resources.
+            uint32_t allocationCount = 0;       ///< Number of resources actually created.
+            uint64_t requiredMemory = 0;        ///< Memory in bytes needed if every graph resource had its own allocation.
+            uint64_t allocatedMemory = 0;       ///< Memory in bytes of the created resources.
+
+            uint64_t getSavedMemory() const { return requiredMemory - allocatedMemory; }
+        };
+
+        static const uint32_t kInvalidAllocation = uint32_t(-1);
+
         /** Add/Remove reference to a graph input resource not owned by the cache
             \param[in] name The resource's name
             \param[in] pResource The resource to register. If this is null, will unregister the resource
@@ -83,6 +99,34 @@ namespace Falcor
         */
         void allocateResources(const DefaultProperties& params);
 
+        /** Assign the registered fields to allocations without creating any resources.
+            Transient resources, i.e. resources which are not graph outputs, internal or persistent, are packed into shared allocations
+            when their lifetimes don't overlap and they resolve to the same type, dimensions, format and bind flags.
+            This is called by allocateResources() and can be used on its own to inspect the packing.
+            \param[in] params Default properties used for resolving unspecified field properties.
+            \return Statistics about the resulting allocations.
+        */
+        const AllocationStats& planAllocations(const DefaultProperties& params);
+
+        /** Get the allocation a field was assigned to by the last call to planAllocations() or allocateResources().
+            Fields sharing the same allocation index are backed by the same resource.
+            \param[in] name The field's name.
+            \return The allocation index, or kInvalidAllocation if the field is unknown or doesn't require a resource.
+        */
+        uint32_t getAllocationIndex(const std::string& name) const;
+
+        /** Get the statistics of the last call to planAllocations() or allocateResources().
+        */
+        const AllocationStats& getAllocationStats() const { return mStats; }
+
+        /** Enable/disable packing of transient resources into shared allocations. Enabled by default.
+        */
+        void setAliasingEnabled(bool enabled) { mAliasingEnabled = enabled; }
+
+        /** Check if packing of transient resources is enabled.
+        */
+        bool isAliasingEnabled() const { return mAliasingEnabled; }
+
         /** Clears all registered field/resource properties and allocated resources.
         */
         void reset();
@@ -97,6 +141,7 @@ namespace Falcor
             Resource::SharedPtr pResource;          // The resource
             bool resolveBindFlags;                  // Whether or not we should resolve the field's bind-flags before creating the resource
             std::string name;                       // Full name of the resource, including the pass name
+            uint32_t allocation = kInvalidAllocation; // Index of the allocation backing this resource
         };
 
         // Resources and properties for fields within (and therefore owned by) a render graph
@@ -105,6 +150,9 @@ namespace Falcor
 
         // References to output resources not to be allocated by the render graph
         ResourcesMap mExternalResources;
+
+        AllocationStats mStats;
+        bool mAliasingEnabled = true;
     };
 
 }
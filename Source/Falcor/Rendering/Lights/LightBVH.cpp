@@ -29,6 +29,7 @@
 #include "Core/Assert.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Timing/Profiler.h"
+#include <limits>
 
 namespace
 {
@@ -42,41 +43,139 @@ namespace Falcor
         return SharedPtr(new LightBVH(pLightCollection));
     }
 
-    // TODO: Only update the ones that moved.
     void LightBVH::refit(RenderContext* pRenderContext)
     {
         FALCOR_PROFILE("LightBVH::refit()");
 
         FALCOR_ASSERT(mIsValid);
+        refitNodes(pRenderContext, mpNodeIndicesBuffer, mPerDepthRefitEntryInfo);
+        mLightCollectionUpdateCount = mpLightCollection->getUpdateCount();
+    }
+
+    void LightBVH::refitChanged(RenderContext* pRenderContext)
+    {
+        FALCOR_PROFILE("LightBVH::refitChanged()");
+
+        FALCOR_ASSERT(mIsValid);
+
+        // The update status only describes the last update. If we missed an update, refit everything.
+        const uint64_t updateCount = mpLightCollection->getUpdateCount();
+        if (updateCount != mLightCollectionUpdateCount + 1)
+        {
+            refit(pRenderContext);
+            return;
+        }
+
+        const auto& lightsUpdateInfo = mpLightCollection->getUpdateStatus().lightsUpdateInfo;
+        const auto& meshLights = mpLightCollection->getMeshLights();
+        FALCOR_ASSERT(lightsUpdateInfo.size() == meshLights.size());
+
+        // Find the nodes on the paths from the root to the leaves holding changed triangles.
+        // The path to each triangle is given by its bitmask (0=left child, 1=right child at each depth).
+        // Note that the topology of the nodes on the CPU is valid even if the node attributes are out of date.
+        const uint64_t invalidBitmask = std::numeric_limits<uint64_t>::max();
+        std::vector<std::vector<uint32_t>> dirtyNodes(mPerDepthRefitEntryInfo.size()); // Internal nodes per depth, followed by leaf nodes.
+        size_t dirtyNodeCount = 0;
+        mIsNodeDirty.resize(mNodes.size(), 0);
+
+        for (size_t lightIdx = 0; lightIdx < meshLights.size(); ++lightIdx)
+        {
+            if (lightsUpdateInfo[lightIdx] == LightCollection::UpdateFlags::None) continue;
+
+            const auto& meshLight = meshLights[lightIdx];
+            for (uint32_t triIdx = meshLight.triangleOffset; triIdx < meshLight.triangleOffset + meshLight.triangleCount; ++triIdx)
+            {
+                const uint64_t bitmask = mTriangleBitmasks[triIdx];
+                if (bitmask == invalidBitmask) continue; // Triangle is not in the BVH.
+
+                uint32_t nodeIndex = 0;
+                for (uint32_t depth = 0;; ++depth)
+                {
+                    const bool isLeaf = mNodes[nodeIndex].isLeaf();
+                    if (!mIsNodeDirty[nodeIndex])
+                    {
+                        mIsNodeDirty[nodeIndex] = 1;
+                        dirtyNodes[isLeaf ? dirtyNodes.size() - 1 : depth].push_back(nodeIndex);
+                        dirtyNodeCount++;
+                    }
+                    if (isLeaf) break;
+
+                    FALCOR_ASSERT(depth < mBVHStats.treeHeight);
+                    nodeIndex = (bitmask >> depth) & 1 ? mNodes[nodeIndex].getInternalNode().rightChildIdx : nodeIndex + 1;
+                }
+            }
+        }
+
+        for (const auto& nodes : dirtyNodes)
+        {
+            for (uint32_t nodeIndex : nodes) mIsNodeDirty[nodeIndex] = 0;
+        }
+
+        // If most of the BVH is affected, a full refit is cheaper than uploading the node list.
+        if (dirtyNodeCount > mNodeIndices.size() / 2)
+        {
+            refit(pRenderContext);
+            return;
+        }
+
+        if (dirtyNodeCount > 0)
+        {
+            // Pack the node indices in the same layout as 'mpNodeIndicesBuffer'.
+            std::vector<uint32_t> nodeIndices;
+            std::vector<RefitEntryInfo> entryInfo(dirtyNodes.size());
+            nodeIndices.reserve(dirtyNodeCount);
+            for (size_t i = 0; i < dirtyNodes.size(); ++i)
+            {
+                entryInfo[i].offset = (uint32_t)nodeIndices.size();
+                entryInfo[i].count = (uint32_t)dirtyNodes[i].size();
+                nodeIndices.insert(nodeIndices.end(), dirtyNodes[i].begin(), dirtyNodes[i].end());
+            }
+
+            if (!mpDirtyNodeIndicesBuffer || mpDirtyNodeIndicesBuffer->getElementCount() < nodeIndices.size())
+            {
+                mpDirtyNodeIndicesBuffer = Buffer::createStructured(sizeof(uint32_t), (uint32_t)mNodeIndices.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr, false);
+                mpDirtyNodeIndicesBuffer->setName("LightBVH::mpDirtyNodeIndicesBuffer");
+            }
+            mpDirtyNodeIndicesBuffer->setBlob(nodeIndices.data(), 0, nodeIndices.size() * sizeof(uint32_t));
 
-        // Update all leaf nodes.
+            refitNodes(pRenderContext, mpDirtyNodeIndicesBuffer, entryInfo);
+        }
+
+        mLightCollectionUpdateCount = updateCount;
+    }
+
+    void LightBVH::refitNodes(RenderContext* pRenderContext, const Buffer::SharedPtr& pNodeIndicesBuffer, const std::vector<RefitEntryInfo>& entryInfo)
+    {
+        FALCOR_ASSERT(entryInfo.size() == mPerDepthRefitEntryInfo.size());
+
+        // Update leaf nodes.
+        if (entryInfo.back().count > 0)
         {
             auto var = mLeafUpdater->getVars()["CB"];
             mpLightCollection->setShaderData(var["gLights"]);
             setShaderData(var["gLightBVH"]);
-            var["gNodeIndices"] = mpNodeIndicesBuffer;
+            var["gNodeIndices"] = pNodeIndicesBuffer;
 
-            const uint32_t nodeCount = mPerDepthRefitEntryInfo.back().count;
-            FALCOR_ASSERT(nodeCount > 0);
-            var["gFirstNodeOffset"] = mPerDepthRefitEntryInfo.back().offset;
+            const uint32_t nodeCount = entryInfo.back().count;
+            var["gFirstNodeOffset"] = entryInfo.back().offset;
             var["gNodeCount"] = nodeCount;
 
             mLeafUpdater->execute(pRenderContext, nodeCount, 1, 1);
         }
 
-        // Update all internal nodes.
+        // Update internal nodes.
         {
             auto var = mInternalUpdater->getVars()["CB"];
             mpLightCollection->setShaderData(var["gLights"]);
             setShaderData(var["gLightBVH"]);
-            var["gNodeIndices"] = mpNodeIndicesBuffer;
+            var["gNodeIndices"] = pNodeIndicesBuffer;
 
             // Note that mBVHStats.treeHeight may be 0, in which case there is a single leaf and no internal nodes.
             for (int depth = (int)mBVHStats.treeHeight - 1; depth >= 0; --depth)
             {
-                const uint32_t nodeCount = mPerDepthRefitEntryInfo[depth].count;
-                FALCOR_ASSERT(nodeCount > 0);
-                var["gFirstNodeOffset"] = mPerDepthRefitEntryInfo[depth].offset;
+                const uint32_t nodeCount = entryInfo[depth].count;
+                if (nodeCount == 0) continue;
+                var["gFirstNodeOffset"] = entryInfo[depth].offset;
                 var["gNodeCount"] = nodeCount;
 
                 mInternalUpdater->execute(pRenderContext, nodeCount, 1, 1);
@@ -132,6 +231,8 @@ namespace Falcor
         mNodes.clear();
         mNodeIndices.clear();
         mPerDepthRefitEntryInfo.clear();
+        mTriangleBitmasks.clear();
+        mIsNodeDirty.clear();
         mMaxTriangleCountPerLeaf = 0;
         mBVHStats = BVHStats();
         mIsValid = false;
@@ -303,6 +404,10 @@ namespace Falcor
         FALCOR_ASSERT(mpTriangleBitmasksBuffer->getSize() >= triangleBitmasks.size() * sizeof(triangleBitmasks[0]));
         mpTriangleBitmasksBuffer->setBlob(triangleBitmasks.data(), 0, triangleBitmasks.size() * sizeof(triangleBitmasks[0]));
 
+        // Keep the bitmasks for partial refits.
+        mTriangleBitmasks = triangleBitmasks;
+        mLightCollectionUpdateCount = mpLightCollection->getUpdateCount();
+
         mIsCpuDataValid = true;
     }
 
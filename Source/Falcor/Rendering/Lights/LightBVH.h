@@ -86,6 +86,14 @@ namespace Falcor
         */
         void refit(RenderContext* pRenderContext);
 
+        /** Refit the BVH nodes affected by the last update of the light collection, without changing the hierarchy.
+            Only the nodes on the paths from the root to the leaves holding triangles of changed mesh lights are refit.
+            Falls back to a full refit if an update of the light collection was missed or if most of the BVH is affected.
+            The BVH needs to have been built before trying to refit it.
+            \param[in] pRenderContext The render context.
+        */
+        void refitChanged(RenderContext* pRenderContext);
+
         /** Perform a depth-first traversal of the BVH and run a function on each node.
             \param[in] evalInternal Function called on each internal node.
             \param[in] evalLeaf Function called on each leaf node.
@@ -145,6 +153,13 @@ namespace Falcor
             uint32_t count = 0;     ///< The number of nodes at each level.
         };
 
+        /** Run the refit kernels on a set of nodes.
+            \param[in] pRenderContext The render context.
+            \param[in] pNodeIndicesBuffer Buffer holding the node indices sorted by tree depth.
+            \param[in] entryInfo For each level the offset and count of internal nodes in the buffer; the last entry is for the leaf nodes.
+        */
+        void refitNodes(RenderContext* pRenderContext, const Buffer::SharedPtr& pNodeIndicesBuffer, const std::vector<RefitEntryInfo>& entryInfo);
+
         // Internal state
         const LightCollection::SharedConstPtr mpLightCollection;
 
@@ -156,6 +171,9 @@ namespace Falcor
         std::vector<uint32_t>                 mNodeIndices;             ///< Array of all node indices sorted by tree depth.
         std::vector<RefitEntryInfo>           mPerDepthRefitEntryInfo;  ///< Array containing for each level the number of internal nodes as well as the corresponding offset into 'mpNodeIndicesBuffer'; the very last entry contains the same data, but for all leaf nodes instead.
         uint32_t                              mMaxTriangleCountPerLeaf = 0; ///< After the BVH is built, this contains the maximum light count per leaf node.
+        std::vector<uint64_t>                 mTriangleBitmasks;        ///< CPU-side copy of the per triangle bit pattern retracing the tree traversal to reach the triangle. Used for finding the nodes to refit.
+        std::vector<uint8_t>                  mIsNodeDirty;             ///< Scratch flags per node used by refitChanged().
+        uint64_t                              mLightCollectionUpdateCount = 0; ///< Update count of the light collection the BVH was last built or refit for.
         BVHStats                              mBVHStats;
         bool                                  mIsValid = false;         ///< True when the BVH has been built.
         mutable bool                          mIsCpuDataValid = false;  ///< Indicates whether the CPU-side data matches the GPU buffers.
@@ -165,6 +183,7 @@ namespace Falcor
         Buffer::SharedPtr                     mpTriangleIndicesBuffer;  ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
         Buffer::SharedPtr                     mpTriangleBitmasksBuffer; ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child.
         Buffer::SharedPtr                     mpNodeIndicesBuffer;      ///< Buffer holding all node indices sorted by tree depth. This is used for BVH refit.
+        Buffer::SharedPtr                     mpDirtyNodeIndicesBuffer; ///< Buffer holding the indices of nodes to refit sorted by tree depth. This is used for partial BVH refit.
 
         friend LightBVHBuilder;
     };
@@ -30,8 +30,10 @@
 #include "Core/Errors.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/Threading.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include <algorithm>
+#include <array>
 
 namespace
 {
@@ -45,6 +47,17 @@ namespace
     const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
     const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
 
+    // BVHs over at least this many triangles are built in parallel.
+    const uint32_t kParallelBuildThreshold = 1 << 14;
+
+    // When building in parallel, the tree is split into roughly this many subtrees, each of at least kMinSubtreeTriangleCount triangles.
+    const uint32_t kTargetSubtreeCount = 256;
+    const uint32_t kMinSubtreeTriangleCount = 4096;
+    static_assert(kMinSubtreeTriangleCount >= kMaxLeafTriangleCount, "Subtrees must be larger than the largest leaf");
+
+    // Nodes with at least this many triangles evaluate the binned splits for each dimension in parallel.
+    const uint32_t kParallelBinningThreshold = 1 << 16;
+
     inline float safeACos(float v)
     {
         return std::acos(glm::clamp(v, -1.0f, 1.0f));
@@ -248,7 +261,10 @@ namespace Falcor
 
         // Create list of triangles that should be included in BVH.
         // For each triangle, precompute data we need for the build.
-        BuildingData data(bvh.mNodes);
+        std::vector<TriangleSortData> trianglesData;
+        std::vector<uint32_t> triangleIndices;
+        std::vector<uint64_t> triangleBitmasks;
+        BuildingData data(bvh.mNodes, trianglesData, triangleIndices, triangleBitmasks);
         data.trianglesData.reserve(triangles.size());
 
         for (size_t i = 0; i < triangles.size(); i++)
@@ -296,7 +312,14 @@ namespace Falcor
 
         // Build the tree.
         SplitHeuristicFunction splitFunc = getSplitFunction(mOptions.splitHeuristicSelection);
-        buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
+        if (data.trianglesData.size() < kParallelBuildThreshold)
+        {
+            buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
+        }
+        else
+        {
+            buildParallel(mOptions, splitFunc, data);
+        }
         FALCOR_ASSERT(!data.nodes.empty());
 
         size_t numValid = 0;
@@ -366,6 +389,16 @@ namespace Falcor
     {
         FALCOR_ASSERT(triangleRange.begin < triangleRange.end);
 
+        // Defer small subtrees to be built in parallel. A placeholder node is allocated at the position of the subtree root.
+        if (data.pSubtreeTasks && triangleRange.length() <= data.maxSubtreeTriangleCount)
+        {
+            FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
+            const uint32_t nodeIndex = (uint32_t)data.nodes.size();
+            data.nodes.push_back({});
+            data.pSubtreeTasks->push_back({ nodeIndex, bitmask, depth, triangleRange });
+            return nodeIndex;
+        }
+
         // Compute the AABB and total flux of the node.
         float nodeFlux = 0.f;
         AABB nodeBounds;
@@ -450,6 +483,79 @@ namespace Falcor
         }
     }
 
+    void LightBVHBuilder::buildParallel(const Options& options, const SplitHeuristicFunction& splitHeuristic, BuildingData& data)
+    {
+        // The tree is built in three steps:
+        // 1. The top of the tree is built serially. Subtrees below a size threshold are replaced by placeholder nodes.
+        // 2. The subtrees are built in parallel into separate node and triangle index lists.
+        //    This is safe as they operate on disjoint ranges of the triangle data and write disjoint bitmasks.
+        // 3. The top-level nodes and subtrees are stitched together in depth-first order and their indices are offset.
+        // The layout of the nodes and triangle indices is identical to the serial build.
+        const uint32_t triangleCount = static_cast<uint32_t>(data.trianglesData.size());
+
+        std::vector<PackedNode> topNodes;
+        std::vector<SubtreeTask> tasks;
+        {
+            BuildingData topData(topNodes, data.trianglesData, data.triangleIndices, data.triangleBitmasks);
+            topData.pSubtreeTasks = &tasks;
+            topData.maxSubtreeTriangleCount = std::max(kMinSubtreeTriangleCount, triangleCount / kTargetSubtreeCount);
+            buildInternal(options, splitHeuristic, 0ull, 0, Range(0, triangleCount), topData);
+        }
+        FALCOR_ASSERT(data.triangleIndices.empty()); // All leaves are in subtrees.
+
+        // Build the subtrees.
+        Threading::parallelFor<size_t>(0, tasks.size(), [&](size_t i)
+        {
+            SubtreeTask& task = tasks[i];
+            BuildingData subtreeData(task.nodes, data.trianglesData, task.triangleIndices, data.triangleBitmasks);
+            subtreeData.nodes.reserve(2 * task.triangleRange.length());
+            subtreeData.triangleIndices.reserve(task.triangleRange.length());
+            buildInternal(options, splitHeuristic, task.bitmask, task.depth, task.triangleRange, subtreeData);
+        });
+
+        // Stitch the top-level nodes and subtrees together.
+        // The top-level nodes are stored in depth-first order with each placeholder at the position of its subtree root.
+        std::vector<uint32_t> nodeIndices(topNodes.size());
+        std::vector<bool> isSubtree(topNodes.size(), false);
+        size_t taskIndex = 0;
+        for (uint32_t i = 0; i < topNodes.size(); i++)
+        {
+            nodeIndices[i] = static_cast<uint32_t>(data.nodes.size());
+
+            if (taskIndex < tasks.size() && tasks[taskIndex].nodeIndex == i)
+            {
+                const SubtreeTask& task = tasks[taskIndex++];
+                const uint32_t nodeOffset = static_cast<uint32_t>(data.nodes.size());
+                const uint32_t triangleOffset = static_cast<uint32_t>(data.triangleIndices.size());
+                isSubtree[i] = true;
+
+                for (PackedNode node : task.nodes)
+                {
+                    // Offset the triangle offset of leaves and the right child index of internal nodes.
+                    // Both are stored in the low bits of the first dword.
+                    node.data[0].x += node.isLeaf() ? triangleOffset : nodeOffset;
+                    data.nodes.push_back(node);
+                }
+                data.triangleIndices.insert(data.triangleIndices.end(), task.triangleIndices.begin(), task.triangleIndices.end());
+            }
+            else
+            {
+                FALCOR_ASSERT(!topNodes[i].isLeaf());
+                data.nodes.push_back(topNodes[i]);
+            }
+        }
+        FALCOR_ASSERT(taskIndex == tasks.size());
+        FALCOR_ASSERT(data.triangleIndices.size() == triangleCount);
+
+        // Remap the right child indices of the top-level internal nodes.
+        for (uint32_t i = 0; i < topNodes.size(); i++)
+        {
+            if (isSubtree[i]) continue;
+            PackedNode& node = data.nodes[nodeIndices[i]];
+            node.data[0].x = nodeIndices[node.data[0].x];
+        }
+    }
+
     float3 LightBVHBuilder::computeLightingConesInternal(const uint32_t nodeIndex, BuildingData& data, float& cosConeAngle)
     {
         if (!data.nodes[nodeIndex].isLeaf())
@@ -525,6 +631,40 @@ namespace Falcor
         return result;
     }
 
+    /** Evaluates the splits along the given dimensions and returns the cheapest one.
+        For large nodes the dimensions are evaluated in parallel. The results are compared in the order
+        the dimensions are given, so the selected split is the same as when evaluating them serially.
+        \param[in] triangleCount Number of triangles in the node.
+        \param[in] dimensions Dimensions to evaluate.
+        \param[in] binAlongDimension Function returning a (cost, split) pair for a dimension, or an infinite cost if there is no valid split.
+        \return The cheapest (cost, split) pair, or an infinite cost and invalid split if there is no valid split.
+    */
+    template<typename BinFunc>
+    static auto selectBestSplit(uint32_t triangleCount, std::initializer_list<uint32_t> dimensions, const BinFunc& binAlongDimension)
+    {
+        using SplitPair = decltype(binAlongDimension(0u));
+        std::array<SplitPair, 3> axisBestSplits;
+        FALCOR_ASSERT(dimensions.size() <= axisBestSplits.size());
+        const uint32_t* pDimensions = dimensions.begin();
+
+        if (triangleCount >= kParallelBinningThreshold && dimensions.size() > 1)
+        {
+            Threading::parallelFor<size_t>(0, dimensions.size(), [&](size_t i) { axisBestSplits[i] = binAlongDimension(pDimensions[i]); });
+        }
+        else
+        {
+            for (size_t i = 0; i < dimensions.size(); ++i) axisBestSplits[i] = binAlongDimension(pDimensions[i]);
+        }
+
+        SplitPair bestSplit;
+        bestSplit.first = std::numeric_limits<float>::infinity();
+        for (size_t i = 0; i < dimensions.size(); ++i)
+        {
+            if (axisBestSplits[i].first < bestSplit.first) bestSplit = axisBestSplits[i];
+        }
+        return bestSplit;
+    }
+
     /** Evaluates the SAH cost metric for a node.
         If the node is empty (invalid bounds), the cost evaluates to zero.
         See Eqn 15 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
@@ -558,15 +698,17 @@ namespace Falcor
         };
 
         FALCOR_ASSERT(parameters.binCount > 1);
-        std::vector<Bin> bins(parameters.binCount);
-        std::vector<float> costs(parameters.binCount - 1);
 
         /** Helper function that computes the best split along the given dimension using the SAH metric.
             The triangles are binned to n bins, storing only the aggregate parameters (triangle count and bounds).
             Then the cost metric is evaluated for each of the n-1 potential splits.
         */
-        const auto binAlongDimension = [&bins, &costs, &triangleRange, &data, &parameters, &overallBestSplit, &nodeBounds](uint32_t dimension)
+        const auto binAlongDimension = [&triangleRange, &data, &parameters, &nodeBounds](uint32_t dimension)
         {
+            const std::pair<float, SplitResult> noSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+            std::vector<Bin> bins(parameters.binCount);
+            std::vector<float> costs(parameters.binCount - 1);
+
             // Helper to compute the bin id for a given triangle.
             auto getBinId = [&](const TriangleSortData& td)
             {
@@ -578,9 +720,6 @@ namespace Falcor
                 return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
             };
 
-            // Reset the bins.
-            for (Bin& bin : bins) bin = Bin();
-
             // Fill the bins with all triangles.
             for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
             {
@@ -619,13 +758,9 @@ namespace Falcor
 
             // Early out if all lights fall on either side of the split.
             if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
-                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+                axisBestSplit.second.triangleIndex == triangleRange.end) return noSplit;
 
-            if (axisBestSplit.first < overallBestSplit.first)
-            {
-                overallBestSplit = axisBestSplit;
-                FALCOR_ASSERT(triangleRange.begin < overallBestSplit.second.triangleIndex && overallBestSplit.second.triangleIndex < triangleRange.end);
-            }
+            return axisBestSplit;
         };
 
         if (parameters.splitAlongLargest)
@@ -635,14 +770,11 @@ namespace Falcor
             uint32_t largestDimension = dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ?
                 2 : (dimensions[1] >= dimensions[0] && dimensions[1] >= dimensions[2] ? 1 : 0);
 
-            binAlongDimension(largestDimension);
+            overallBestSplit = selectBestSplit(triangleRange.length(), { largestDimension }, binAlongDimension);
         }
         else
         {
-            for (uint32_t dimension = 0; dimension < 3; ++dimension)
-            {
-                binAlongDimension(dimension);
-            }
+            overallBestSplit = selectBestSplit(triangleRange.length(), { 0, 1, 2 }, binAlongDimension);
         }
 
         // If we couldn't find a valid split, create leaf node immediately if possible or revert to equal splitting.
@@ -724,8 +856,6 @@ namespace Falcor
         };
 
         FALCOR_ASSERT(parameters.binCount > 1);
-        std::vector<Bin> bins(parameters.binCount);
-        std::vector<float> costs(parameters.binCount - 1);
 
         /** Helper function that computes the best split along the given dimension using the SAOH metric.
             The triangles are binned to n bins, storing only the aggregate parameters (triangle count, bounds, flux, and cone direction).
@@ -734,8 +864,12 @@ namespace Falcor
             the bounding cones are approximates based on the bins' bounding cones. This is less expensive,
             but also less precise than computing them directly from the triangles.
         */
-        const auto binAlongDimension = [&bins, &costs, &triangleRange, &data, &parameters, &overallBestSplit, &nodeBounds, largestDimension, dimensions](uint32_t dimension)
+        const auto binAlongDimension = [&triangleRange, &data, &parameters, &nodeBounds, largestDimension, dimensions](uint32_t dimension)
         {
+            const std::pair<float, SplitResult> noSplit = std::make_pair(std::numeric_limits<float>::infinity(), SplitResult());
+            std::vector<Bin> bins(parameters.binCount);
+            std::vector<float> costs(parameters.binCount - 1);
+
             // Helper to compute the bin id for a given triangle.
             auto getBinId = [&](const TriangleSortData& td)
             {
@@ -748,9 +882,6 @@ namespace Falcor
                 return std::min((uint32_t)((p - bmin) * scale), parameters.binCount - 1);
             };
 
-            // Reset the bins.
-            for (Bin& bin : bins) bin = Bin();
-
             // Fill the bins with all triangles.
             for (uint32_t i = triangleRange.begin; i < triangleRange.end; ++i)
             {
@@ -834,26 +965,19 @@ namespace Falcor
 
             // Early out if all lights fall on either side of the split.
             if (axisBestSplit.second.triangleIndex == triangleRange.begin ||
-                axisBestSplit.second.triangleIndex == triangleRange.end) return;
+                axisBestSplit.second.triangleIndex == triangleRange.end) return noSplit;
 
-            if (axisBestSplit.first < overallBestSplit.first)
-            {
-                overallBestSplit = axisBestSplit;
-                FALCOR_ASSERT(triangleRange.begin < overallBestSplit.second.triangleIndex && overallBestSplit.second.triangleIndex < triangleRange.end);
-            }
+            return axisBestSplit;
         };
 
         // Compute the best split.
         if (parameters.splitAlongLargest)
         {
-            binAlongDimension(largestDimension);
+            overallBestSplit = selectBestSplit(triangleRange.length(), { largestDimension }, binAlongDimension);
         }
         else
         {
-            for (uint32_t dimension = 0; dimension < 3; ++dimension)
-            {
-                binAlongDimension(dimension);
-            }
+            overallBestSplit = selectBestSplit(triangleRange.length(), { 0, 1, 2 }, binAlongDimension);
         }
 
         // If we couldn't find a valid split, create leaf node immediately if possible or revert to equal splitting.
@@ -123,15 +123,37 @@ namespace Falcor
             uint32_t triangleIndex = MeshLightData::kInvalidIndex; ///< Index into global triangle list.
         };
 
+        struct SubtreeTask;
+
+        /** Data used by the recursive build.
+            When building in parallel, each subtree has its own nodes and triangle indices,
+            while the triangle data and bitmasks are shared (subtrees operate on disjoint triangles).
+        */
         struct BuildingData
         {
             std::vector<PackedNode>& nodes;                 ///< BVH nodes generated by the builder.
-            std::vector<TriangleSortData> trianglesData;    ///< Compact list of triangles to include in build.
-            std::vector<uint32_t> triangleIndices;          ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
-            std::vector<uint64_t> triangleBitmasks;         ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
+            std::vector<TriangleSortData>& trianglesData;   ///< Compact list of triangles to include in build.
+            std::vector<uint32_t>& triangleIndices;         ///< Triangle indices sorted by leaf node. Each leaf node refers to a contiguous array of triangle indices.
+            std::vector<uint64_t>& triangleBitmasks;        ///< Array containing the per triangle bit pattern retracing the tree traversal to reach the triangle: 0=left child, 1=right child; this array gets filled in during the build process. Indexed by global triangle index.
             float currentNodeFlux = 0.f;                    ///< Used by computeSAOHSplit() as the leaf creation cost.
 
-            BuildingData(std::vector<PackedNode>& bvhNodes) : nodes(bvhNodes) {}
+            std::vector<SubtreeTask>* pSubtreeTasks = nullptr; ///< If set, subtrees with at most 'maxSubtreeTriangleCount' triangles are deferred to this list instead of being built.
+            uint32_t maxSubtreeTriangleCount = 0;
+
+            BuildingData(std::vector<PackedNode>& _nodes, std::vector<TriangleSortData>& _trianglesData, std::vector<uint32_t>& _triangleIndices, std::vector<uint64_t>& _triangleBitmasks)
+                : nodes(_nodes), trianglesData(_trianglesData), triangleIndices(_triangleIndices), triangleBitmasks(_triangleBitmasks) {}
+        };
+
+        /** Subtree deferred by buildInternal() to be built in parallel.
+        */
+        struct SubtreeTask
+        {
+            uint32_t nodeIndex;                             ///< Index of the placeholder node in the top-level tree.
+            uint64_t bitmask;                               ///< Bit pattern retracing the tree traversal to reach the subtree root.
+            uint32_t depth;                                 ///< Depth of the subtree root.
+            Range triangleRange;                            ///< Range of triangles in the subtree.
+            std::vector<PackedNode> nodes;                  ///< Nodes of the subtree. Child indices are relative to the subtree.
+            std::vector<uint32_t> triangleIndices;          ///< Triangle indices of the subtree. Leaf offsets are relative to the subtree.
         };
 
         /** Compute the split according to a specified heuristic.
@@ -158,6 +180,14 @@ namespace Falcor
         */
         uint32_t buildInternal(const Options& options, const SplitHeuristicFunction& splitHeuristic, uint64_t bitmask, uint32_t depth, const Range& triangleRange, BuildingData& data);
 
+        /** Parallel BVH build.
+            Builds the top of the tree serially and the subtrees below it in parallel.
+            The result is identical to calling buildInternal() for the root node.
+            \param[in] splitHeuristic The splitting heuristic to be used.
+            \param[in,out] data Prepared light data.
+        */
+        void buildParallel(const Options& options, const SplitHeuristicFunction& splitHeuristic, BuildingData& data);
+
         /** Recursive computation of lighting cones for all internal nodes.
             \param[in] nodeIndex Index of the current node.
             \param[in,out] data Updated node data.
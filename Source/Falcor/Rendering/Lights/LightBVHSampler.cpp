@@ -75,7 +75,7 @@ namespace Falcor
         }
         else if (needsRefit)
         {
-            mpBVH->refit(pRenderContext);
+            mpBVH->refitChanged(pRenderContext);
             samplerChanged = true;
         }
 
@@ -27,9 +27,13 @@
  **************************************************************************/
 #include "AnimatedVertexCache.h"
 #include "Animation.h"
+#include "Core/Renderer.h"
 #include "Core/API/RenderContext.h"
 #include "Scene/Scene.h"
+#include "Utils/Settings.h"
 #include "Utils/Timing/Profiler.h"
+#include <cstring>
+#include <optional>
 
 namespace Falcor
 {
@@ -39,6 +43,9 @@ namespace Falcor
         const std::string kUpdateCurveAABBsFilename = "Scene/Animation/UpdateCurveAABBs.slang";
         const std::string kUpdateCurvePolyTubeVerticesFilename = "Scene/Animation/UpdateCurvePolyTubeVertices.slang";
 
+        const uint32_t kStreamingSlotCount = 2; ///< Number of GPU buffers per streaming track.
+        const uint32_t kDefaultResidencyBudgetMB = 1024;
+
         InterpolationInfo calculateInterpolation(double time, const std::vector<double>& timeSamples, Animation::Behavior preInfinityBehavior, Animation::Behavior postInfinityBehavior)
         {
             if (!std::isfinite(time))
@@ -104,6 +111,10 @@ namespace Falcor
     {
         if (mCachedCurves.empty() && mCachedMeshes.empty()) return;
 
+        for (const auto& cache : mCachedCurves) mStreaming |= cache.isStreamed();
+        for (const auto& cache : mCachedMeshes) mStreaming |= cache.isStreamed();
+        mResidencyBudget = (size_t)gpFramework->getSettings().getOption<uint32_t>("vertexCache:residencyBudgetMB", kDefaultResidencyBudgetMB) << 20;
+
         if (!mCachedCurves.empty())
         {
             for (auto& cache : mCachedCurves)
@@ -137,6 +148,8 @@ namespace Falcor
 
             createMeshVertexUpdatePass();
         }
+
+        if (mStreaming) createStreamingTracks();
     }
 
     AnimatedVertexCache::UniquePtr AnimatedVertexCache::create(Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
@@ -148,6 +161,9 @@ namespace Falcor
     {
         if (!hasAnimations()) return false;
 
+        mPlayingForward = time >= mPrevTime;
+        mPrevTime = time;
+
         if (!mCachedCurves.empty())
         {
             double curveTime = mLoopAnimations ? std::fmod(time, mGlobalCurveAnimationLength) : time;
@@ -155,13 +171,29 @@ namespace Falcor
 
             if (mCurveLSSCount > 0)
             {
-                executeCurveLSSVertexUpdatePass(pRenderContext, interpolationInfo);
+                InterpolationInfo info = interpolationInfo;
+                if (mStreaming)
+                {
+                    info.keyframeIndices = makeResident(mCurveLSSTrack, info.keyframeIndices, [this](uint32_t slot, const std::vector<uint8_t>& data)
+                    {
+                        mpCurveVertexBuffers[slot]->setBlob(data.data(), 0, data.size());
+                    });
+                }
+                executeCurveLSSVertexUpdatePass(pRenderContext, info);
                 executeCurveLSSAABBUpdatePass(pRenderContext);
             }
 
             if (mCurvePolyTubeCount > 0)
             {
-                executeCurvePolyTubeVertexUpdatePass(pRenderContext, interpolationInfo);
+                InterpolationInfo info = interpolationInfo;
+                if (mStreaming)
+                {
+                    info.keyframeIndices = makeResident(mCurvePolyTubeTrack, info.keyframeIndices, [this](uint32_t slot, const std::vector<uint8_t>& data)
+                    {
+                        mpCurvePolyTubeVertexBuffers[slot]->setBlob(data.data(), 0, data.size());
+                    });
+                }
+                executeCurvePolyTubeVertexUpdatePass(pRenderContext, info);
             }
 
 
@@ -200,6 +232,89 @@ namespace Falcor
         return m;
     }
 
+    void AnimatedVertexCache::setResidencyBudget(size_t bytes)
+    {
+        mResidencyBudget = bytes;
+        if (mStreaming) createStreamingTracks();
+    }
+
+    void AnimatedVertexCache::createStreamingTracks()
+    {
+        FALCOR_ASSERT(mStreaming);
+
+        // All tracks keep the same number of keyframes resident, chosen such that the total fits into the budget.
+        size_t windowSize = 0;
+        if (mCurveLSSCount > 0) windowSize += mCurveVertexCount * sizeof(DynamicCurveVertexData);
+        if (mCurvePolyTubeCount > 0) windowSize += mCurvePolyTubeVertexCount * sizeof(DynamicCurveVertexData);
+        for (const auto& cache : mCachedMeshes) windowSize += cache.getVertexCount() * sizeof(PackedStaticVertexData);
+        uint32_t capacity = (uint32_t)std::min<size_t>(mResidencyBudget / std::max<size_t>(windowSize, 1), std::numeric_limits<uint32_t>::max());
+
+        auto createTrack = [&](StreamingTrack& track, uint32_t keyframeCount, KeyframeStreamer::LoadFunc loadFunc)
+        {
+            track.pStreamer = std::make_unique<KeyframeStreamer>(keyframeCount, capacity, std::move(loadFunc));
+            track.slotKeyframes = uint2(kInvalidKeyframe);
+        };
+
+        if (mCurveLSSCount > 0)
+        {
+            createTrack(mCurveLSSTrack, (uint32_t)mCurveKeyframeTimes.size(), [this](uint32_t keyframe, std::vector<uint8_t>& data)
+            {
+                loadCurveKeyframe(CurveTessellationMode::LinearSweptSphere, keyframe, data);
+            });
+        }
+
+        if (mCurvePolyTubeCount > 0)
+        {
+            createTrack(mCurvePolyTubeTrack, (uint32_t)mCurveKeyframeTimes.size(), [this](uint32_t keyframe, std::vector<uint8_t>& data)
+            {
+                loadCurveKeyframe(CurveTessellationMode::PolyTube, keyframe, data);
+            });
+        }
+
+        mMeshTracks.resize(mCachedMeshes.size());
+        for (size_t i = 0; i < mCachedMeshes.size(); i++)
+        {
+            createTrack(mMeshTracks[i], (uint32_t)mCachedMeshes[i].timeSamples.size(), [this, i](uint32_t keyframe, std::vector<uint8_t>& data)
+            {
+                const auto& cache = mCachedMeshes[i];
+                if (cache.isStreamed() && !cache.compressed)
+                {
+                    data.resize(cache.pKeyframeFile->getChunkSize(cache.keyframeChunks[keyframe]));
+                    cache.pKeyframeFile->readChunk(cache.keyframeChunks[keyframe], data.data());
+                }
+                else
+                {
+                    std::vector<PackedStaticVertexData> vertexData;
+                    cache.readKeyframe(keyframe, vertexData);
+                    data.resize(vertexData.size() * sizeof(PackedStaticVertexData));
+                    std::memcpy(data.data(), vertexData.data(), data.size());
+                }
+            });
+        }
+    }
+
+    uint2 AnimatedVertexCache::makeResident(StreamingTrack& track, uint2 keyframes, const UploadFunc& upload)
+    {
+        track.pStreamer->update(keyframes.x, keyframes.y, mPlayingForward, mLoopAnimations);
+
+        uint2 slots;
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            uint32_t keyframe = keyframes[i];
+            if (track.slotKeyframes.x == keyframe) slots[i] = 0;
+            else if (track.slotKeyframes.y == keyframe) slots[i] = 1;
+            else
+            {
+                // Upload to the slot that doesn't hold the other keyframe needed.
+                uint32_t slot = i == 0 ? (track.slotKeyframes.x == keyframes.y ? 1 : 0) : 1 - slots.x;
+                upload(slot, track.pStreamer->getKeyframe(keyframe));
+                track.slotKeyframes[slot] = keyframe;
+                slots[i] = slot;
+            }
+        }
+        return slots;
+    }
+
     // We create a merged list of all timestamps and generate new frames for curves where those timestamps are missing.
     // This can lead to fairly heavy overhead if we have cached curves with vastly different total length.
     // Currently, our assets have cached curves with the same list of timestamps.
@@ -217,6 +332,43 @@ namespace Falcor
         mGlobalCurveAnimationLength = mCurveKeyframeTimes.empty() ? 0 : mCurveKeyframeTimes.back();
     }
 
+    void AnimatedVertexCache::loadCurveKeyframe(CurveTessellationMode mode, uint32_t keyframe, std::vector<uint8_t>& data) const
+    {
+        uint32_t vertexCount = mode == CurveTessellationMode::LinearSweptSphere ? mCurveVertexCount : mCurvePolyTubeVertexCount;
+        data.resize(vertexCount * sizeof(DynamicCurveVertexData));
+        auto pDst = reinterpret_cast<DynamicCurveVertexData*>(data.data());
+
+        const double time = mCurveKeyframeTimes[keyframe];
+        std::vector<DynamicCurveVertexData> vertices;
+        std::vector<DynamicCurveVertexData> prevVertices;
+
+        for (const auto& cache : mCachedCurves)
+        {
+            if (cache.tessellationMode != mode) continue;
+
+            const auto& timeSamples = cache.timeSamples;
+            size_t k = std::lower_bound(timeSamples.begin(), timeSamples.end(), time) - timeSamples.begin();
+            k = std::min(k, timeSamples.size() - 1);
+
+            // Read the previous keyframe first so that compressed keyframes are decoded in increasing order.
+            const bool interpolate = k > 0 && timeSamples[k] != time;
+            if (interpolate) cache.readKeyframe(k - 1, prevVertices);
+            cache.readKeyframe(k, vertices);
+            if (interpolate)
+            {
+                // Linearly interpolate at the missing keyframe.
+                float t = float((time - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
+                for (size_t p = 0; p < vertices.size(); p++)
+                {
+                    vertices[p].position = lerp(prevVertices[p].position, vertices[p].position, t);
+                }
+            }
+
+            std::memcpy(pDst, vertices.data(), vertices.size() * sizeof(DynamicCurveVertexData));
+            pDst += vertices.size();
+        }
+    }
+
     void AnimatedVertexCache::bindCurveLSSBuffers()
     {
         // Compute curve vertex and index (segment) count.
@@ -226,14 +378,16 @@ namespace Falcor
         {
             if (mCachedCurves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere) continue;
 
-            mCurveVertexCount += (uint32_t)mCachedCurves[i].vertexData[0].size();
+            mCurveVertexCount += mCachedCurves[i].getVertexCount();
             mCurveIndexCount += (uint32_t)mCachedCurves[i].indexData.size();
         }
 
         // Create buffers for vertex positions in curve vertex caches.
+        // In streaming mode, only the two keyframes needed for interpolation are kept in GPU memory.
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurveVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        uint32_t bufferCount = mStreaming ? kStreamingSlotCount : (uint32_t)mCurveKeyframeTimes.size();
+        mpCurveVertexBuffers.resize(bufferCount);
+        for (uint32_t i = 0; i < bufferCount; i++)
         {
             mpCurveVertexBuffers[i] = Buffer::createStructured(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
             mpCurveVertexBuffers[i]->setName("AnimatedVertexCache::mpCurveVertexBuffers[" + std::to_string(i) + "]");
@@ -244,50 +398,27 @@ namespace Falcor
         mpPrevCurveVertexBuffer->setName("AnimatedVertexCache::mpPrevCurveVertexBuffer");
 
         // Initialize vertex buffers with cached positions.
-        uint32_t offset = 0;
-        for (size_t i = 0; i < mCachedCurves.size(); i++)
+        std::vector<uint8_t> keyframeData;
+        if (!mStreaming)
         {
-            if (mCachedCurves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere) continue;
-
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
             for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
             {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurveVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurveVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
+                loadCurveKeyframe(CurveTessellationMode::LinearSweptSphere, j, keyframeData);
+                mpCurveVertexBuffers[j]->setBlob(keyframeData.data(), 0, keyframeData.size());
             }
-
-            // Initialize it with positions at the first keyframe.
-            mpPrevCurveVertexBuffer->setBlob(mCachedCurves[i].vertexData[0].data(), offset, bufSize);
-
-            offset += bufSize;
         }
 
+        // Initialize it with positions at the first keyframe.
+        loadCurveKeyframe(CurveTessellationMode::LinearSweptSphere, 0, keyframeData);
+        mpPrevCurveVertexBuffer->setBlob(keyframeData.data(), 0, keyframeData.size());
+
         // Create curve index buffer.
         vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
         mpCurveIndexBuffer = Buffer::create(sizeof(uint32_t) * mCurveIndexCount, vbBindFlags);
         mpCurveIndexBuffer->setName("AnimatedVertexCache::mpCurveIndexBuffer");
 
         // Initialize index buffer.
-        offset = 0;
+        uint32_t offset = 0;
         std::vector<uint32_t> indexData(mCurveIndexCount);
         for (CurveID curveID{ 0 }; curveID.get() < (uint32_t)mCachedCurves.size(); ++curveID)
         {
@@ -321,7 +452,7 @@ namespace Falcor
             PerCurveMetadata curveMeta;
             curveMeta.indexCount = (uint32_t)cache.indexData.size();
             curveMeta.indexOffset = mCurvePolyTubeIndexCount;
-            curveMeta.vertexCount = (uint32_t)cache.vertexData[0].size();
+            curveMeta.vertexCount = cache.getVertexCount();
             curveMeta.vertexOffset = mCurvePolyTubeVertexCount;
             curveMetadata.push_back(curveMeta);
 
@@ -344,47 +475,25 @@ namespace Falcor
         mpCurvePolyTubeMeshMetadataBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeMeshMetadataBuffer");
 
         // Create buffers for vertex positions in curve vertex caches.
+        // In streaming mode, only the two keyframes needed for interpolation are kept in GPU memory.
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurvePolyTubeVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        uint32_t bufferCount = mStreaming ? kStreamingSlotCount : (uint32_t)mCurveKeyframeTimes.size();
+        mpCurvePolyTubeVertexBuffers.resize(bufferCount);
+        for (uint32_t i = 0; i < bufferCount; i++)
         {
             mpCurvePolyTubeVertexBuffers[i] = Buffer::createStructured(sizeof(DynamicCurveVertexData), mCurvePolyTubeVertexCount, vbBindFlags, Buffer::CpuAccess::None, nullptr, false);
             mpCurvePolyTubeVertexBuffers[i]->setName("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers[" + std::to_string(i) + "]");
         }
 
         // Initialize vertex buffers with cached positions.
-        uint32_t offset = 0;
-        for (size_t i = 0; i < mCachedCurves.size(); i++)
+        if (!mStreaming)
         {
-            if (mCachedCurves[i].tessellationMode != CurveTessellationMode::PolyTube) continue;
-
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
+            std::vector<uint8_t> keyframeData;
             for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
             {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
+                loadCurveKeyframe(CurveTessellationMode::PolyTube, j, keyframeData);
+                mpCurvePolyTubeVertexBuffers[j]->setBlob(keyframeData.data(), 0, keyframeData.size());
             }
-
-            offset += bufSize;
         }
 
         // Create curve strand index buffer.
@@ -393,7 +502,7 @@ namespace Falcor
         mpCurvePolyTubeStrandIndexBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeStrandIndexBuffer");
 
         // Initialize strand index buffer.
-        offset = 0;
+        uint32_t offset = 0;
         const uint32_t strandLastVertexIndex = 0xffffffff;
         std::vector<uint32_t> strandIndexData(mCurvePolyTubeVertexCount);
         for (uint32_t i = 0; i < (uint32_t)mCachedCurves.size(); i++)
@@ -435,38 +544,54 @@ namespace Falcor
         {
             mGlobalMeshAnimationLength = std::max(mGlobalMeshAnimationLength, cache.timeSamples.back());
             mMeshKeyframeCount += (uint32_t)cache.timeSamples.size();
-            mMaxMeshVertexCount = std::max((uint32_t)cache.vertexData.front().size(), mMaxMeshVertexCount);
+            mMaxMeshVertexCount = std::max(cache.getVertexCount(), mMaxMeshVertexCount);
         }
     }
 
     void AnimatedVertexCache::initMeshBuffers()
     {
-        mpMeshVertexBuffers.resize(mMeshKeyframeCount);
+        // In streaming mode, only the two keyframes needed for interpolation are kept in GPU memory for each mesh.
+        mpMeshVertexBuffers.resize(mStreaming ? mCachedMeshes.size() * kStreamingSlotCount : mMeshKeyframeCount);
         std::vector<PerMeshMetadata> meshMetadata;
         meshMetadata.reserve(mCachedMeshes.size());
 
         uint32_t keyframeOffset = 0;
         for (auto& cache : mCachedMeshes)
         {
-            FALCOR_ASSERT(cache.vertexData.front().size() == mpScene->getMesh(cache.meshID).vertexCount);
+            uint32_t vertexCount = cache.getVertexCount();
+            FALCOR_ASSERT(vertexCount == mpScene->getMesh(cache.meshID).vertexCount);
 
             PerMeshMetadata meta;
             meta.keyframeBufferOffset = keyframeOffset;
-            meta.vertexCount = (uint32_t)cache.vertexData.front().size();
+            meta.vertexCount = vertexCount;
             meta.sceneVbOffset = mpScene->getMesh(cache.meshID).vbOffset;
             meta.prevVbOffset = mpScene->getMesh(cache.meshID).prevVbOffset;
             meshMetadata.push_back(meta);
 
-            // Create vertex buffer for each keyframe on this mesh
-            for (size_t i = 0; i < cache.vertexData.size(); i++)
+            // Create vertex buffer for each keyframe (or slot) on this mesh
+            std::vector<PackedStaticVertexData> decoded;
+            std::optional<VertexCacheCodec::Decoder> decoder;
+            if (cache.compressed && !mStreaming) decoder = cache.createDecoder();
+
+            uint32_t bufferCount = mStreaming ? kStreamingSlotCount : (uint32_t)cache.getKeyframeCount();
+            for (uint32_t i = 0; i < bufferCount; i++)
             {
-                auto& data = cache.vertexData[i];
+                const void* pData = nullptr;
+                if (decoder)
+                {
+                    decoder->decode(i, decoded);
+                    pData = decoded.data();
+                }
+                else if (!mStreaming)
+                {
+                    pData = cache.vertexData[i].data();
+                }
                 size_t index = keyframeOffset + i;
-                mpMeshVertexBuffers[index] = Buffer::createStructured(sizeof(PackedStaticVertexData), (uint32_t)data.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, data.data(), false);
+                mpMeshVertexBuffers[index] = Buffer::createStructured(sizeof(PackedStaticVertexData), vertexCount, ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, pData, false);
                 mpMeshVertexBuffers[index]->setName("AnimatedVertexCache::mpMeshVertexBuffers[" + std::to_string(index) + "]");
             }
 
-            keyframeOffset += (uint32_t)cache.timeSamples.size();
+            keyframeOffset += bufferCount;
         }
 
         mpMeshMetadataBuffer = Buffer::createStructured(sizeof(PerMeshMetadata), (uint32_t)meshMetadata.size(), ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, meshMetadata.data(), false);
@@ -482,7 +607,7 @@ namespace Falcor
         FALCOR_ASSERT(!mCachedMeshes.empty());
 
         Program::DefineList defines;
-        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mMeshKeyframeCount));
+        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mpMeshVertexBuffers.size()));
         mpMeshVertexUpdatePass = ComputePass::create("Scene/Animation/UpdateMeshVertices.slang", "main", defines);
 
         // Bind data
@@ -500,14 +625,14 @@ namespace Falcor
         FALCOR_ASSERT(mCurveLSSCount > 0);
 
         Program::DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurveVertexBuffers.size()));
         mpCurveVertexUpdatePass = ComputePass::create(kUpdateCurveVerticesFilename, "main", defines);
 
         auto block = mpCurveVertexUpdatePass->getVars()["gCurveVertexUpdater"];
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurveVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
     }
 
     void AnimatedVertexCache::createCurveLSSAABBUpdatePass()
@@ -525,7 +650,7 @@ namespace Falcor
         FALCOR_ASSERT(mCurvePolyTubeCount > 0);
 
         Program::DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurvePolyTubeVertexBuffers.size()));
         mpCurvePolyTubeVertexUpdatePass = ComputePass::create(kUpdateCurvePolyTubeVerticesFilename, "main", defines);
 
         auto block = mpCurvePolyTubeVertexUpdatePass->getVars()["gCurvePolyTubeVertexUpdater"];
@@ -535,7 +660,7 @@ namespace Falcor
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurvePolyTubeVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
     }
 
 
@@ -550,6 +675,15 @@ namespace Falcor
         {
             auto postInfinityBehavior = mLoopAnimations ? Animation::Behavior::Cycle : Animation::Behavior::Constant;
             mMeshInterpolationInfo[i] = calculateInterpolation(t, mCachedMeshes[i].timeSamples, mPreInfinityBehavior, postInfinityBehavior);
+
+            if (mStreaming && !copyPrev)
+            {
+                // Refer to the slots holding the keyframes instead.
+                mMeshInterpolationInfo[i].keyframeIndices = makeResident(mMeshTracks[i], mMeshInterpolationInfo[i].keyframeIndices, [&](uint32_t slot, const std::vector<uint8_t>& data)
+                {
+                    mpMeshVertexBuffers[i * kStreamingSlotCount + slot]->setBlob(data.data(), 0, data.size());
+                });
+            }
         }
 
         mpMeshInterpolationBuffer->setBlob(mMeshInterpolationInfo.data(), 0, mpMeshInterpolationBuffer->getSize());
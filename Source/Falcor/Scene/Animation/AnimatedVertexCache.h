@@ -27,7 +27,11 @@
  **************************************************************************/
 #pragma once
 #include "Animation.h"
+#include "KeyframeStreamer.h"
+#include "VertexCacheCodec.h"
+#include "VertexCacheFile.h"
 #include "SharedTypes.slang"
+#include "Core/Assert.h"
 #include "Core/API/Buffer.h"
 #include "Scene/Curves/CurveConfig.h"
 #include "Scene/SceneTypes.slang"
@@ -36,15 +40,123 @@
 #include "RenderGraph/BasePasses/ComputePass.h"
 
 #include <algorithm>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <vector>
 
 namespace Falcor
 {
     class Scene;
 
-    struct CachedCurve
+    /** Keyframe storage of a vertex cache.
+        Keyframes are either held in memory, compressed in memory, or stored on disk (compressed or not).
+    */
+    template<typename VertexT>
+    struct CachedKeyframes
+    {
+        // vertexData[i][j] represents at the i-th keyframe, the cache data of the j-th vertex.
+        std::vector<std::vector<VertexT>> vertexData;
+
+        // Compressed keyframes. If set, vertexData is empty and the i-th keyframe is stored in compressedData[i] (or on disk).
+        bool compressed = false;
+        VertexCacheCodec::Params compressionParams;
+        std::vector<std::vector<uint8_t>> compressedData;
+
+        // Keyframes stored on disk. If set, vertexData and compressedData are empty and the i-th keyframe is stored in chunk keyframeChunks[i].
+        VertexCacheFile::SharedPtr pKeyframeFile;
+        std::vector<uint32_t> keyframeChunks;
+
+        /** Decoder kept across readKeyframe() calls.
+            It refers to its owner, so it is not copied or moved along with the keyframes but recreated on first use.
+        */
+        struct PersistentDecoder
+        {
+            std::mutex mutex;
+            std::optional<VertexCacheCodec::Decoder> decoder;
+
+            PersistentDecoder() = default;
+            PersistentDecoder(const PersistentDecoder&) {}
+            PersistentDecoder& operator=(const PersistentDecoder&) { std::lock_guard<std::mutex> lock(mutex); decoder.reset(); return *this; }
+        };
+        mutable PersistentDecoder persistentDecoder;
+
+        bool isStreamed() const { return pKeyframeFile != nullptr; }
+
+        size_t getKeyframeCount() const
+        {
+            if (isStreamed()) return keyframeChunks.size();
+            return compressed ? compressedData.size() : vertexData.size();
+        }
+
+        uint32_t getVertexCount() const
+        {
+            if (compressed) return compressionParams.vertexCount;
+            return isStreamed() ? (uint32_t)(pKeyframeFile->getChunkSize(keyframeChunks.front()) / sizeof(VertexT)) : (uint32_t)vertexData.front().size();
+        }
+
+        /** Compress the keyframes held in vertexData.
+        */
+        void compress()
+        {
+            FALCOR_ASSERT(!compressed && !isStreamed());
+            compressedData = VertexCacheCodec::compress(vertexData, compressionParams);
+            vertexData = {};
+            compressed = true;
+        }
+
+        /** Move the keyframes held in memory to a file.
+        */
+        void moveToFile(const VertexCacheFile::SharedPtr& pFile)
+        {
+            FALCOR_ASSERT(!isStreamed());
+            keyframeChunks.resize(getKeyframeCount());
+            for (size_t i = 0; i < keyframeChunks.size(); i++)
+            {
+                keyframeChunks[i] = compressed ? pFile->writeChunk(compressedData[i]) : pFile->writeChunk(vertexData[i]);
+            }
+            vertexData = {};
+            compressedData = {};
+            pKeyframeFile = pFile;
+        }
+
+        /** Create a decoder for compressed keyframes. The decoder refers to this object and must not outlive it.
+        */
+        VertexCacheCodec::Decoder createDecoder() const
+        {
+            FALCOR_ASSERT(compressed);
+            return VertexCacheCodec::Decoder(compressionParams, [this](uint32_t keyframe, std::vector<uint8_t>& data) { readCompressedKeyframe(keyframe, data); });
+        }
+
+        /** Read the compressed data of a keyframe.
+        */
+        void readCompressedKeyframe(size_t index, std::vector<uint8_t>& data) const
+        {
+            FALCOR_ASSERT(compressed);
+            if (isStreamed()) pKeyframeFile->readChunk(keyframeChunks[index], data);
+            else data = compressedData[index];
+        }
+
+        /** Read a keyframe. This is thread-safe.
+            Compressed keyframes are decoded with a persistent decoder, so reading keyframes in increasing order
+            only decodes the difference to the previously read keyframe.
+        */
+        void readKeyframe(size_t index, std::vector<VertexT>& data) const
+        {
+            if (compressed)
+            {
+                std::lock_guard<std::mutex> lock(persistentDecoder.mutex);
+                if (!persistentDecoder.decoder) persistentDecoder.decoder.emplace(createDecoder());
+                persistentDecoder.decoder->decode((uint32_t)index, data);
+            }
+            else if (isStreamed()) pKeyframeFile->readChunk(keyframeChunks[index], data);
+            else data = vertexData[index];
+        }
+    };
+
+    struct CachedCurve : CachedKeyframes<DynamicCurveVertexData>
     {
         static const uint32_t kInvalidID = std::numeric_limits<uint32_t>::max();
 
@@ -56,19 +168,13 @@ namespace Falcor
         // Shared among all frames.
         // We assume the topology doesn't change during animation.
         std::vector<uint32_t> indexData;
-
-        // vertexData[i][j] represents at the i-th keyframe, the cache data of the j-th vertex.
-        std::vector<std::vector<DynamicCurveVertexData>> vertexData;
     };
 
-    struct CachedMesh
+    struct CachedMesh : CachedKeyframes<PackedStaticVertexData>
     {
         MeshID meshID{ MeshID::kInvalidID }; ///< ID of the mesh this data is animating.
 
         std::vector<double> timeSamples;
-
-        // vertexData[i][j] represents at the i-th keyframe, the cache data of the j-th vertex.
-        std::vector<std::vector<PackedStaticVertexData>> vertexData;
     };
 
     class FALCOR_API AnimatedVertexCache
@@ -102,10 +208,51 @@ namespace Falcor
 
         uint64_t getMemoryUsageInBytes() const;
 
+        /** Check if keyframes are streamed. This is the case if any of the vertex caches stores its keyframes on disk.
+            In streaming mode, only the keyframes needed at the current time are kept in GPU memory, and a window of
+            keyframes around the current time is kept resident in host memory.
+        */
+        bool isStreaming() const { return mStreaming; }
+
+        /** Set the host memory budget for resident keyframes in streaming mode.
+            The window is at least two keyframes, even if this exceeds the budget.
+            \param[in] bytes Budget in bytes.
+        */
+        void setResidencyBudget(size_t bytes);
+
+        size_t getResidencyBudget() const { return mResidencyBudget; }
+
     private:
+        static const uint32_t kInvalidKeyframe = std::numeric_limits<uint32_t>::max();
+
+        /** Keyframes of a vertex cache (or group of caches sharing keyframes) in streaming mode.
+            The two keyframes needed for interpolation are uploaded to two GPU buffers (slots).
+        */
+        struct StreamingTrack
+        {
+            std::unique_ptr<KeyframeStreamer> pStreamer;
+            uint2 slotKeyframes = uint2(kInvalidKeyframe);  ///< Keyframe uploaded to each slot.
+        };
+
+        using UploadFunc = std::function<void(uint32_t slot, const std::vector<uint8_t>& data)>;
+
         AnimatedVertexCache(Scene* pScene, const Buffer::SharedPtr& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
 
+        void createStreamingTracks();
+
+        /** Make the keyframes needed at the current time resident in GPU memory.
+            \param[in] track Streaming track.
+            \param[in] keyframes Keyframes needed for interpolation.
+            \param[in] upload Function uploading keyframe data to a slot.
+            \return Slots holding the keyframes.
+        */
+        uint2 makeResident(StreamingTrack& track, uint2 keyframes, const UploadFunc& upload);
+
         void initCurveKeyframes();
+
+        /** Get the vertex data of all curves with the given tessellation mode at a keyframe, interpolating missing keyframes.
+        */
+        void loadCurveKeyframe(CurveTessellationMode mode, uint32_t keyframe, std::vector<uint8_t>& data) const;
         void bindCurveLSSBuffers();
         void bindCurvePolyTubeBuffers();
 
@@ -178,5 +325,15 @@ namespace Falcor
         std::vector<Buffer::SharedPtr> mpMeshVertexBuffers;
         Buffer::SharedPtr mpMeshInterpolationBuffer;
         Buffer::SharedPtr mpMeshMetadataBuffer;
+
+        // Keyframe streaming. Declared last so that pending loads finish before the caches are destroyed.
+        bool mStreaming = false;
+        size_t mResidencyBudget = 0;
+        double mPrevTime = 0.0;
+        bool mPlayingForward = true;
+
+        StreamingTrack mCurveLSSTrack;
+        StreamingTrack mCurvePolyTubeTrack;
+        std::vector<StreamingTrack> mMeshTracks;
     };
 }
@@ -27,11 +27,20 @@
  **************************************************************************/
 #include "Animation.h"
 #include "AnimationController.h"
+#include "KeyframeInterpolation.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Scene/Transform.h"
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/transform.hpp>
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FALCOR_ANIMATION_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_ANIMATION_SSE2 0
+#endif
 
 namespace Falcor
 {
@@ -39,6 +48,10 @@ namespace Falcor
     {
         const double kEpsilonTime = 1e-5f;
 
+        // Animations with at most this many keyframes are searched linearly using SIMD compares.
+        // Longer animations use binary search.
+        const size_t kMaxLinearSearchKeyframes = 64;
+
         const Gui::DropdownList kChannelLoopModeDropdown =
         {
             { (uint32_t)Animation::Behavior::Constant, "Constant" },
@@ -47,49 +60,12 @@ namespace Falcor
             { (uint32_t)Animation::Behavior::Oscillate, "Oscillate" },
         };
 
-        // Bezier form hermite spline
-        float3 interpolateHermite(const float3& p0, const float3& p1, const float3& p2, const float3& p3, float t)
-        {
-            float3 b0 = p1;
-            float3 b1 = p1 + (p2 - p0) * 0.5f / 3.f;
-            float3 b2 = p2 - (p3 - p1) * 0.5f / 3.f;
-            float3 b3 = p2;
-
-            float3 q0 = lerp(b0, b1, t);
-            float3 q1 = lerp(b1, b2, t);
-            float3 q2 = lerp(b2, b3, t);
-
-            float3 qq0 = lerp(q0, q1, t);
-            float3 qq1 = lerp(q1, q2, t);
-
-            return lerp(qq0, qq1, t);
-        }
-
-        // Bezier hermite slerp
-        glm::quat interpolateHermite(const glm::quat& r0, const glm::quat& r1, const glm::quat& r2, const glm::quat& r3, float t)
-        {
-            glm::quat b0 = r1;
-            glm::quat b1 = r1 + (r2 - r0) * 0.5f / 3.0f;
-            glm::quat b2 = r2 - (r3 - r1) * 0.5f / 3.0f;
-            glm::quat b3 = r2;
-
-            glm::quat q0 = slerp(b0, b1, t);
-            glm::quat q1 = slerp(b1, b2, t);
-            glm::quat q2 = slerp(b2, b3, t);
-
-            glm::quat qq0 = slerp(q0, q1, t);
-            glm::quat qq1 = slerp(q1, q2, t);
-
-            return slerp(qq0, qq1, t);
-        }
-
         // This function performs linear extrapolation when either t < 0 or t > 1
         Animation::Keyframe interpolateLinear(const Animation::Keyframe& k0, const Animation::Keyframe& k1, float t)
         {
+            auto pose = KeyframeInterpolation::interpolateLinear(KeyframeInterpolation::toPose(k0), KeyframeInterpolation::toPose(k1), t);
             Animation::Keyframe result;
-            result.translation = lerp(k0.translation, k1.translation, t);
-            result.scaling = lerp(k0.scaling, k1.scaling, t);
-            result.rotation = slerp(k0.rotation, k1.rotation, t);
+            KeyframeInterpolation::fromPose(pose, result);
             result.time = glm::lerp(k0.time, k1.time, (double)t);
             return result;
         }
@@ -97,10 +73,10 @@ namespace Falcor
         Animation::Keyframe interpolateHermite(const Animation::Keyframe& k0, const Animation::Keyframe& k1, const Animation::Keyframe& k2, const Animation::Keyframe& k3, float t)
         {
             FALCOR_ASSERT(t >= 0.f && t <= 1.f);
+            auto pose = KeyframeInterpolation::interpolateHermite(
+                KeyframeInterpolation::toPose(k0), KeyframeInterpolation::toPose(k1), KeyframeInterpolation::toPose(k2), KeyframeInterpolation::toPose(k3), t);
             Animation::Keyframe result;
-            result.translation = interpolateHermite(k0.translation, k1.translation, k2.translation, k3.translation, t);
-            result.scaling = lerp(k1.scaling, k2.scaling, t);
-            result.rotation = interpolateHermite(k0.rotation, k1.rotation, k2.rotation, k3.rotation, t);
+            KeyframeInterpolation::fromPose(pose, result);
             result.time = glm::lerp(k1.time, k2.time, (double)t);
             return result;
         }
@@ -153,32 +129,37 @@ namespace Falcor
             interpolated = interpolate(mInterpolationMode, time);
         }
 
-        rmcv::mat4 T = rmcv::translate(interpolated.translation);
-        rmcv::mat4 R = rmcv::mat4_cast(interpolated.rotation);
-        rmcv::mat4 S = rmcv::scale(interpolated.scaling);
-        rmcv::mat4 transform = T * R * S;
-
-        return transform;
+        return calcTransform(interpolated);
     }
 
     Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
     {
         FALCOR_ASSERT(!mKeyframes.empty());
+        FALCOR_ASSERT(mKeyframeTimes.size() == mKeyframes.size());
 
-        // Validate cached frame index.
-        size_t frameIndex = clamp(mCachedFrameIndex, (size_t)0, mKeyframes.size() - 1);
-        if (time < mKeyframes[frameIndex].time) frameIndex = 0;
+        // Find and cache frame index.
+        size_t frameIndex = findFrameIndex(mKeyframeTimes.data(), mKeyframeTimes.size(), time, mCachedFrameIndex);
+        mCachedFrameIndex = frameIndex;
 
-        // Find frame index.
-        while (frameIndex < mKeyframes.size() - 1)
+        if (mode == InterpolationMode::Linear || mKeyframes.size() < 4)
         {
-            if (mKeyframes[frameIndex + 1].time > time) break;
-            frameIndex++;
+            Segment segment = calcSegment(false, time, frameIndex);
+            return interpolateLinear(mKeyframes[segment.indices[0]], mKeyframes[segment.indices[1]], segment.t);
         }
+        else if (mode == InterpolationMode::Hermite)
+        {
+            Segment segment = calcSegment(true, time, frameIndex);
+            const auto& i = segment.indices;
+            return interpolateHermite(mKeyframes[i[0]], mKeyframes[i[1]], mKeyframes[i[2]], mKeyframes[i[3]], segment.t);
+        }
+        else
+        {
+            throw ArgumentError("'mode' is unknown interpolation mode");
+        }
+    }
 
-        // Cache frame index;
-        mCachedFrameIndex = frameIndex;
-
+    Animation::Segment Animation::calcSegment(bool hermite, double time, size_t frameIndex) const
+    {
         // Compute index of adjacent frame including optional warping.
         auto adjacentFrame = [this] (size_t frame, int32_t offset = 1)
         {
@@ -186,42 +167,80 @@ namespace Falcor
             return mEnableWarping ? (frame + count + offset) % count : clamp(frame + offset, (size_t)0, count - 1);
         };
 
-        if (mode == InterpolationMode::Linear || mKeyframes.size() < 4)
+        Segment segment;
+        if (hermite)
+        {
+            size_t i1 = frameIndex;
+            segment.indices = { adjacentFrame(i1, -1), i1, adjacentFrame(i1, 1), adjacentFrame(i1, 2) };
+        }
+        else
         {
             size_t i0 = frameIndex;
-            size_t i1 = adjacentFrame(i0);
+            segment.indices = { i0, adjacentFrame(i0), 0, 0 };
+        }
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
+        // Interpolate between the first two keyframes for linear and the middle two for hermite interpolation.
+        const Keyframe& k0 = mKeyframes[segment.indices[hermite ? 1 : 0]];
+        const Keyframe& k1 = mKeyframes[segment.indices[hermite ? 2 : 1]];
 
-            double segmentDuration = k1.time - k0.time;
-            if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
-            float t = (float)clamp((segmentDuration > 0.0 ? (time - k0.time) / segmentDuration : 1.0), 0.0, 1.0);
+        double segmentDuration = k1.time - k0.time;
+        if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
+        segment.t = (float)clamp((segmentDuration > 0.0 ? (time - k0.time) / segmentDuration : 1.0), 0.0, 1.0);
 
-            return interpolateLinear(k0, k1, t);
-        }
-        else if (mode == InterpolationMode::Hermite)
-        {
-            size_t i1 = frameIndex;
-            size_t i0 = adjacentFrame(i1, -1);
-            size_t i2 = adjacentFrame(i1, 1);
-            size_t i3 = adjacentFrame(i1, 2);
+        return segment;
+    }
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
-            const Keyframe& k2 = mKeyframes[i2];
-            const Keyframe& k3 = mKeyframes[i3];
+    // Returns the index of the last keyframe at or before the given time, or 0 if the time is before the first keyframe.
+    size_t Animation::findFrameIndex(const double* times, size_t count, double time, size_t cachedFrameIndex)
+    {
+        FALCOR_ASSERT(count > 0);
 
-            double segmentDuration = k2.time - k1.time;
-            if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
-            float t = (float)clamp(segmentDuration > 0.0 ? (time - k1.time) / segmentDuration : 1.0, 0.0, 1.0);
+        // Check the cached frame and the one following it first, as animations typically advance by less than a frame.
+        size_t frameIndex = std::min(cachedFrameIndex, count - 1);
+        for (size_t i = frameIndex; i < std::min(frameIndex + 2, count); i++)
+        {
+            bool afterStart = i == 0 || times[i] <= time;
+            bool beforeEnd = i + 1 == count || times[i + 1] > time;
+            if (afterStart && beforeEnd) return i;
+        }
 
-            return interpolateHermite(k0, k1, k2, k3, t);
+        // Count the keyframes at or before the given time.
+        size_t n = 0;
+        if (count <= kMaxLinearSearchKeyframes)
+        {
+            size_t i = 0;
+#if FALCOR_ANIMATION_SSE2
+            // Compare two keyframe times per instruction.
+            __m128d t = _mm_set1_pd(time);
+            for (; i + 2 <= count; i += 2)
+            {
+                int mask = _mm_movemask_pd(_mm_cmple_pd(_mm_loadu_pd(times + i), t));
+                n += (mask & 1) + (mask >> 1);
+            }
+#endif
+            for (; i < count; i++) n += times[i] <= time ? 1 : 0;
         }
         else
         {
-            throw ArgumentError("'mode' is unknown interpolation mode");
+            n = std::upper_bound(times, times + count, time) - times;
         }
+
+        return n > 0 ? n - 1 : 0;
+    }
+
+    rmcv::mat4 Animation::calcTransform(const Keyframe& keyframe)
+    {
+        rmcv::mat4 T = rmcv::translate(keyframe.translation);
+        rmcv::mat4 R = rmcv::mat4_cast(keyframe.rotation);
+        rmcv::mat4 S = rmcv::scale(keyframe.scaling);
+        return T * R * S;
+    }
+
+    void Animation::updateKeyframeTimes()
+    {
+        mKeyframeTimes.resize(mKeyframes.size());
+        for (size_t i = 0; i < mKeyframes.size(); i++) mKeyframeTimes[i] = mKeyframes[i].time;
+        mRevision++;
     }
 
     // Calculates the sample time within the keyframe range if the current time lies outside and
@@ -262,14 +281,22 @@ namespace Falcor
     void Animation::addKeyframe(const Keyframe& keyframe)
     {
         FALCOR_ASSERT(keyframe.time <= mDuration);
+        FALCOR_ASSERT(mKeyframeTimes.size() == mKeyframes.size());
+        mRevision++;
+
+        auto insertKeyframe = [&](size_t index)
+        {
+            mKeyframes.insert(mKeyframes.begin() + index, keyframe);
+            mKeyframeTimes.insert(mKeyframeTimes.begin() + index, keyframe.time);
+        };
 
         if (mKeyframes.size() == 0 || mKeyframes[0].time > keyframe.time)
         {
-            mKeyframes.insert(mKeyframes.begin(), keyframe);
+            insertKeyframe(0);
         }
         else if (mKeyframes.back().time < keyframe.time)
         {
-            mKeyframes.push_back(keyframe);
+            insertKeyframe(mKeyframes.size());
         }
         else
         {
@@ -289,14 +316,14 @@ namespace Falcor
                     auto& Next = mKeyframes[i + 1];
                     if (current.time < keyframe.time && Next.time > keyframe.time)
                     {
-                        mKeyframes.insert(mKeyframes.begin() + i + 1, keyframe);
+                        insertKeyframe(i + 1);
                         return;
                     }
                 }
             }
 
             // If we got here, need to push it to the end of the list
-            mKeyframes.push_back(keyframe);
+            insertKeyframe(mKeyframes.size());
         }
     }
 
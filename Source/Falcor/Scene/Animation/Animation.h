@@ -31,6 +31,7 @@
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/UI/Gui.h"
+#include <array>
 #include <memory>
 #include <string>
 #include <vector>
@@ -112,7 +113,7 @@ namespace Falcor
 
         /** Set the interpolation mode.
         */
-        void setInterpolationMode(InterpolationMode interpolationMode) { mInterpolationMode = interpolationMode; }
+        void setInterpolationMode(InterpolationMode interpolationMode) { mInterpolationMode = interpolationMode; mRevision++; }
 
         /** Return true if warping is enabled.
         */
@@ -152,11 +153,26 @@ namespace Falcor
         void renderUI(Gui::Widgets& widget);
 
     private:
+        /** Keyframes and interpolation weight for a time.
+            Linear interpolation uses the first two keyframes, hermite interpolation uses all four.
+        */
+        struct Segment
+        {
+            std::array<size_t, 4> indices;
+            float t;
+        };
+
         Animation(const std::string& name, NodeID nodeID, double duration);
 
         Keyframe interpolate(InterpolationMode mode, double time) const;
+        bool isHermite() const { return mInterpolationMode == InterpolationMode::Hermite && mKeyframes.size() >= 4; }
+        Segment calcSegment(bool hermite, double time, size_t frameIndex) const;
+        void updateKeyframeTimes();
         double calcSampleTime(double currentTime);
 
+        static size_t findFrameIndex(const double* times, size_t count, double time, size_t cachedFrameIndex);
+        static rmcv::mat4 calcTransform(const Keyframe& keyframe);
+
         std::string mName;
         NodeID mNodeID;
         double mDuration; // Includes any time before the first keyframe. May be Assimp or FBX specific.
@@ -168,8 +184,11 @@ namespace Falcor
         bool mEnableWarping = false;
 
         std::vector<Keyframe> mKeyframes;
+        std::vector<double> mKeyframeTimes; ///< Keyframe times stored contiguously for fast searching. Kept in sync with mKeyframes.
         mutable size_t mCachedFrameIndex = 0;
+        uint32_t mRevision = 0; ///< Incremented when the keyframes or the interpolation mode change.
 
+        friend class AnimationBatch;
         friend class SceneCache;
     };
 }
@@ -0,0 +1,274 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AnimationBatch.h"
+#include "KeyframeInterpolation.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FALCOR_ANIMATION_BATCH_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_ANIMATION_BATCH_SSE2 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        // Groups of animations are evaluated in parallel if there are at least this many.
+        const size_t kParallelGroupThreshold = 64;
+
+        // Number of groups per work item when evaluating in parallel.
+        const size_t kGroupChunkSize = 16;
+
+        enum Channel
+        {
+            kTranslationX, kTranslationY, kTranslationZ,
+            kScalingX, kScalingY, kScalingZ,
+            kRotationX, kRotationY, kRotationZ, kRotationW,
+        };
+
+#if FALCOR_ANIMATION_BATCH_SSE2
+        /** Four float lanes in an SSE register. Implements the lane type of KeyframeInterpolation.
+        */
+        struct Float4
+        {
+            __m128 v;
+            Float4() = default;
+            Float4(__m128 v) : v(v) {}
+            explicit Float4(float x) : v(_mm_set1_ps(x)) {}
+        };
+
+        struct Mask4
+        {
+            __m128 v;
+        };
+
+        inline Float4 operator+(const Float4& a, const Float4& b) { return _mm_add_ps(a.v, b.v); }
+        inline Float4 operator-(const Float4& a, const Float4& b) { return _mm_sub_ps(a.v, b.v); }
+        inline Float4 operator*(const Float4& a, const Float4& b) { return _mm_mul_ps(a.v, b.v); }
+        inline Float4 operator/(const Float4& a, const Float4& b) { return _mm_div_ps(a.v, b.v); }
+        inline Float4 operator-(const Float4& a) { return _mm_xor_ps(a.v, _mm_set1_ps(-0.f)); }
+        inline Mask4 operator<(const Float4& a, const Float4& b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+        inline Mask4 operator>(const Float4& a, const Float4& b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+
+        inline Float4 select(const Mask4& mask, const Float4& a, const Float4& b) { return _mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v)); }
+        inline bool all(const Mask4& mask) { return _mm_movemask_ps(mask.v) == 0xf; }
+
+        template<typename F>
+        Float4 mapLanes(const Float4& x, F func)
+        {
+            alignas(16) float lanes[4];
+            _mm_store_ps(lanes, x.v);
+            for (float& lane : lanes) lane = func(lane);
+            return _mm_load_ps(lanes);
+        }
+
+        using Lanes = Float4;
+        constexpr size_t kLaneCount = 4;
+        inline Float4 loadLanes(const float* values) { return _mm_loadu_ps(values); }
+        inline void storeLanes(const Float4& x, float* values) { _mm_storeu_ps(values, x.v); }
+#else
+        using Lanes = float;
+        constexpr size_t kLaneCount = 1;
+        inline float loadLanes(const float* values) { return values[0]; }
+        inline void storeLanes(float x, float* values) { values[0] = x; }
+#endif
+    }
+
+    void AnimationBatch::animate(const std::vector<Animation::SharedPtr>& animations, double time)
+    {
+        if (!isValid(animations)) build(animations);
+
+        const size_t groupCount = mLanes.size() / kLaneCount;
+        if (groupCount >= kParallelGroupThreshold)
+        {
+            // Each animation belongs to a single group, so groups can be evaluated concurrently.
+            Threading::parallelFor<size_t>(0, div_round_up(groupCount, kGroupChunkSize), [&](size_t chunk)
+            {
+                const size_t end = std::min(groupCount, (chunk + 1) * kGroupChunkSize);
+                for (size_t group = chunk * kGroupChunkSize; group < end; group++) animateGroup(group, time);
+            });
+        }
+        else
+        {
+            for (size_t group = 0; group < groupCount; group++) animateGroup(group, time);
+        }
+    }
+
+    bool AnimationBatch::isValid(const std::vector<Animation::SharedPtr>& animations) const
+    {
+        if (animations.size() != mEntries.size()) return false;
+        for (size_t i = 0; i < animations.size(); i++)
+        {
+            const Animation* pAnimation = animations[i].get();
+            if (pAnimation != mEntries[i].pAnimation || pAnimation->mRevision != mEntries[i].revision) return false;
+        }
+        return true;
+    }
+
+    void AnimationBatch::build(const std::vector<Animation::SharedPtr>& animations)
+    {
+        mEntries.clear();
+        mTimes.clear();
+        for (auto& channel : mChannels) channel.clear();
+
+        // Copy the keyframes into the channel arrays.
+        for (const auto& pAnimation : animations)
+        {
+            FALCOR_ASSERT(!pAnimation->mKeyframes.empty());
+
+            Entry entry;
+            entry.pAnimation = pAnimation.get();
+            entry.offset = (uint32_t)mTimes.size();
+            entry.count = (uint32_t)pAnimation->mKeyframes.size();
+            entry.revision = pAnimation->mRevision;
+            entry.hermite = pAnimation->isHermite();
+            mEntries.push_back(entry);
+
+            for (const auto& keyframe : pAnimation->mKeyframes)
+            {
+                mTimes.push_back(keyframe.time);
+                for (int i = 0; i < 3; i++) mChannels[kTranslationX + i].push_back(keyframe.translation[i]);
+                for (int i = 0; i < 3; i++) mChannels[kScalingX + i].push_back(keyframe.scaling[i]);
+                mChannels[kRotationX].push_back(keyframe.rotation.x);
+                mChannels[kRotationY].push_back(keyframe.rotation.y);
+                mChannels[kRotationZ].push_back(keyframe.rotation.z);
+                mChannels[kRotationW].push_back(keyframe.rotation.w);
+            }
+        }
+
+        // Group the animations by interpolation mode.
+        // The last group of each mode is padded by repeating its first animation, which is evaluated redundantly.
+        mLanes.clear();
+        auto addLanes = [&](bool hermite)
+        {
+            for (uint32_t i = 0; i < (uint32_t)mEntries.size(); i++)
+            {
+                if (mEntries[i].hermite == hermite) mLanes.push_back(i);
+            }
+            const size_t groupStart = mLanes.size() / kLaneCount * kLaneCount;
+            while (mLanes.size() % kLaneCount != 0) mLanes.push_back(mLanes[groupStart]);
+        };
+
+        addLanes(false);
+        mHermiteGroupStart = mLanes.size() / kLaneCount;
+        addLanes(true);
+
+        mTransforms.resize(animations.size());
+    }
+
+    void AnimationBatch::animateGroup(size_t group, double time)
+    {
+        const bool hermite = group >= mHermiteGroupStart;
+        const uint32_t* lanes = &mLanes[group * kLaneCount];
+
+        // Find the keyframes and the interpolation weight of each lane, the same way as Animation::animate().
+        // Lanes that extrapolate linearly beyond the keyframes are evaluated by the animation itself.
+        bool active[kLaneCount];
+        uint32_t keyframes[4][kLaneCount];
+        float weights[kLaneCount];
+
+        for (size_t lane = 0; lane < kLaneCount; lane++)
+        {
+            Entry& entry = mEntries[lanes[lane]];
+            Animation& animation = *entry.pAnimation;
+            const double* times = &mTimes[entry.offset];
+            const double firstTime = times[0];
+            const double lastTime = times[entry.count - 1];
+
+            double sampleTime = time;
+            if (sampleTime < firstTime || sampleTime > lastTime) sampleTime = animation.calcSampleTime(time);
+
+            bool isLinearPostInfinity = sampleTime > lastTime && animation.getPostInfinityBehavior() == Animation::Behavior::Linear;
+            bool isLinearPreInfinity = sampleTime < firstTime && animation.getPreInfinityBehavior() == Animation::Behavior::Linear;
+
+            active[lane] = !((isLinearPreInfinity || isLinearPostInfinity) && entry.count > 1);
+            if (!active[lane])
+            {
+                mTransforms[lanes[lane]] = animation.animate(time);
+                for (auto& indices : keyframes) indices[lane] = entry.offset;
+                weights[lane] = 0.f;
+                continue;
+            }
+
+            entry.cachedFrameIndex = Animation::findFrameIndex(times, entry.count, sampleTime, entry.cachedFrameIndex);
+            Animation::Segment segment = animation.calcSegment(hermite, sampleTime, entry.cachedFrameIndex);
+            for (size_t k = 0; k < 4; k++) keyframes[k][lane] = entry.offset + (uint32_t)segment.indices[k];
+            weights[lane] = segment.t;
+        }
+
+        // Interpolate all lanes at once.
+        auto loadPose = [&](const uint32_t* indices)
+        {
+            auto gather = [&](Channel channel)
+            {
+                float values[kLaneCount];
+                for (size_t lane = 0; lane < kLaneCount; lane++) values[lane] = mChannels[channel][indices[lane]];
+                return loadLanes(values);
+            };
+            return KeyframeInterpolation::Pose<Lanes>
+            {
+                { gather(kTranslationX), gather(kTranslationY), gather(kTranslationZ) },
+                { gather(kScalingX), gather(kScalingY), gather(kScalingZ) },
+                { gather(kRotationX), gather(kRotationY), gather(kRotationZ), gather(kRotationW) },
+            };
+        };
+
+        const Lanes t = loadLanes(weights);
+        KeyframeInterpolation::Pose<Lanes> pose = hermite
+            ? KeyframeInterpolation::interpolateHermite(loadPose(keyframes[0]), loadPose(keyframes[1]), loadPose(keyframes[2]), loadPose(keyframes[3]), t)
+            : KeyframeInterpolation::interpolateLinear(loadPose(keyframes[0]), loadPose(keyframes[1]), t);
+
+        float values[kChannelCount][kLaneCount];
+        storeLanes(pose.translation.x, values[kTranslationX]);
+        storeLanes(pose.translation.y, values[kTranslationY]);
+        storeLanes(pose.translation.z, values[kTranslationZ]);
+        storeLanes(pose.scaling.x, values[kScalingX]);
+        storeLanes(pose.scaling.y, values[kScalingY]);
+        storeLanes(pose.scaling.z, values[kScalingZ]);
+        storeLanes(pose.rotation.x, values[kRotationX]);
+        storeLanes(pose.rotation.y, values[kRotationY]);
+        storeLanes(pose.rotation.z, values[kRotationZ]);
+        storeLanes(pose.rotation.w, values[kRotationW]);
+
+        // Compose the transforms of the active lanes.
+        for (size_t lane = 0; lane < kLaneCount; lane++)
+        {
+            if (!active[lane]) continue;
+
+            Animation::Keyframe keyframe;
+            keyframe.translation = float3(values[kTranslationX][lane], values[kTranslationY][lane], values[kTranslationZ][lane]);
+            keyframe.scaling = float3(values[kScalingX][lane], values[kScalingY][lane], values[kScalingZ][lane]);
+            keyframe.rotation = glm::quat(values[kRotationW][lane], values[kRotationX][lane], values[kRotationY][lane], values[kRotationZ][lane]);
+            mTransforms[lanes[lane]] = Animation::calcTransform(keyframe);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Animation.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include <array>
+#include <vector>
+
+namespace Falcor
+{
+    /** Batched evaluation of animations.
+
+        The keyframes of all animations are stored in structure-of-arrays form, with one array per keyframe channel.
+        Animations are grouped by interpolation mode and interpolated several at a time using SIMD instructions
+        (four animations per SSE register). The keyframe search, the trigonometric functions of the quaternion
+        slerp and the composition of the final transform are done per animation.
+        The results are identical to evaluating each animation with Animation::animate().
+
+        The batch is rebuilt automatically when the list of animations, their keyframes or their interpolation mode change.
+    */
+    class FALCOR_API AnimationBatch
+    {
+    public:
+        /** Evaluate animations.
+            \param[in] animations List of animations.
+            \param[in] time The current time in seconds.
+        */
+        void animate(const std::vector<Animation::SharedPtr>& animations, double time);
+
+        /** Get the transforms computed by the last call to animate(), one per animation in the order they were passed in.
+        */
+        const std::vector<rmcv::mat4>& getTransforms() const { return mTransforms; }
+
+    private:
+        static constexpr size_t kChannelCount = 10;
+
+        struct Entry
+        {
+            Animation* pAnimation = nullptr;
+            uint32_t offset = 0;            ///< Index of the first keyframe in the keyframe arrays.
+            uint32_t count = 0;             ///< Number of keyframes.
+            uint32_t revision = 0;          ///< Revision of the animation when the keyframes were copied.
+            bool hermite = false;           ///< True if the animation uses hermite interpolation.
+            size_t cachedFrameIndex = 0;
+        };
+
+        bool isValid(const std::vector<Animation::SharedPtr>& animations) const;
+        void build(const std::vector<Animation::SharedPtr>& animations);
+        void animateGroup(size_t group, double time);
+
+        std::vector<Entry> mEntries;
+        std::vector<uint32_t> mLanes;       ///< Animation index per SIMD lane. Linear animations come first, followed by hermite animations.
+        size_t mHermiteGroupStart = 0;      ///< Index of the first group of hermite animations.
+
+        // Keyframes in structure-of-arrays form.
+        std::vector<double> mTimes;
+        std::array<std::vector<float>, kChannelCount> mChannels;    ///< Translation xyz, scaling xyz and rotation xyzw.
+
+        std::vector<rmcv::mat4> mTransforms;
+    };
+}
@@ -28,7 +28,10 @@
 #include "AnimationController.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/Common.h"
 #include "Scene/Scene.h"
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -39,6 +42,41 @@ namespace Falcor
         const std::string kInverseTransposeWorldMatrices = "inverseTransposeWorldMatrices";
         const std::string kPrevWorldMatrices = "prevWorldMatrices";
         const std::string kPrevInverseTransposeWorldMatrices = "prevInverseTransposeWorldMatrices";
+
+        // Number of nodes per work item when updating a level of the scene graph in parallel.
+        const size_t kNodeChunkSize = 1024;
+
+        // Dirty ranges separated by fewer unchanged matrices than this are merged into one upload.
+        const size_t kMaxDirtyRangeGap = 16;
+
+        /** Compute the inverse transpose of an affine transform.
+            The inverse transpose of the upper 3x3 part is computed from the cofactors (cross products of the rows),
+            which is considerably cheaper than a general 4x4 inverse. Falls back to the general inverse for
+            projective or degenerate matrices.
+        */
+        float4x4 inverseTransposeAffine(const float4x4& m)
+        {
+            if (m[3] != float4(0.f, 0.f, 0.f, 1.f)) return transpose(inverse(m));
+
+            const float3 r0 = float3(m[0]), r1 = float3(m[1]), r2 = float3(m[2]);
+            const float3 c0 = glm::cross(r1, r2);
+            const float3 c1 = glm::cross(r2, r0);
+            const float3 c2 = glm::cross(r0, r1);
+            const float det = glm::dot(r0, c0);
+            if (det == 0.f) return transpose(inverse(m));
+
+            // Rows of the inverse transpose of the 3x3 part are the columns of its inverse.
+            const float invDet = 1.f / det;
+            const float3 t = float3(m[0].w, m[1].w, m[2].w);
+            const float3 invT = (c0 * t.x + c1 * t.y + c2 * t.z) * invDet;
+
+            float4x4 result;
+            result[0] = float4(c0 * invDet, 0.f);
+            result[1] = float4(c1 * invDet, 0.f);
+            result[2] = float4(c2 * invDet, 0.f);
+            result[3] = float4(-invT, 1.f);
+            return result;
+        }
     }
 
     AnimationController::AnimationController(Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<Animation::SharedPtr>& animations)
@@ -53,6 +91,8 @@ namespace Falcor
         // Create GPU resources.
         FALCOR_ASSERT(mLocalMatrices.size() <= std::numeric_limits<uint32_t>::max());
 
+        initNodeLevels();
+
         if (!mLocalMatrices.empty())
         {
             mpWorldMatricesBuffer = Buffer::createStructured(sizeof(float4x4), (uint32_t)mLocalMatrices.size(), Resource::BindFlags::ShaderResource, Buffer::CpuAccess::None, nullptr, false);
@@ -121,7 +161,7 @@ namespace Falcor
             for (auto& cache : cachedMeshes)
             {
                 uint32_t offset = mpScene->getMesh(cache.meshID).vbOffset;
-                for (size_t i = 0; i < cache.vertexData.front().size(); i++)
+                for (size_t i = 0; i < cache.getVertexCount(); i++)
                 {
                     prevVertexData.push_back({ staticVertexData[offset + i].position });
                 }
@@ -186,6 +226,47 @@ namespace Falcor
         }
     }
 
+    void AnimationController::initNodeLevels()
+    {
+        // Compute the depth of each node in the scene graph.
+        const auto& sceneGraph = mpScene->mSceneGraph;
+        const uint32_t kUnknownDepth = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> depths(sceneGraph.size(), kUnknownDepth);
+        std::vector<size_t> path;
+        uint32_t levelCount = 0;
+
+        for (size_t i = 0; i < sceneGraph.size(); i++)
+        {
+            // Walk up the hierarchy until a node of known depth or a root is found.
+            size_t nodeID = i;
+            while (depths[nodeID] == kUnknownDepth)
+            {
+                path.push_back(nodeID);
+                NodeID parent = sceneGraph[nodeID].parent;
+                if (parent == NodeID::Invalid()) break;
+                FALCOR_ASSERT(parent.get() < sceneGraph.size());
+                nodeID = parent.get();
+            }
+
+            uint32_t depth = depths[nodeID] == kUnknownDepth ? 0 : depths[nodeID] + 1;
+            while (!path.empty())
+            {
+                if (depths[path.back()] == kUnknownDepth) depths[path.back()] = depth++;
+                path.pop_back();
+            }
+            levelCount = std::max(levelCount, depths[i] + 1);
+        }
+
+        // Sort nodes by depth (counting sort, nodes within a level are kept in node order).
+        mNodeLevelOffsets.assign(levelCount + 1, 0);
+        for (uint32_t depth : depths) mNodeLevelOffsets[depth + 1]++;
+        for (uint32_t level = 0; level < levelCount; level++) mNodeLevelOffsets[level + 1] += mNodeLevelOffsets[level];
+
+        mNodeLevelOrder.resize(sceneGraph.size());
+        std::vector<size_t> writeOffsets(mNodeLevelOffsets.begin(), mNodeLevelOffsets.end() - 1);
+        for (size_t i = 0; i < sceneGraph.size(); i++) mNodeLevelOrder[writeOffsets[depths[i]]++] = (uint32_t)i;
+    }
+
     void AnimationController::initLocalMatrices()
     {
         for (size_t i = 0; i < mLocalMatrices.size(); i++)
@@ -198,7 +279,7 @@ namespace Falcor
     {
         FALCOR_PROFILE("animate");
 
-        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), false);
+        std::fill(mMatricesChanged.begin(), mMatricesChanged.end(), 0);
 
         // Check for edited scene nodes and update local matrices.
         const auto& sceneGraph = mpScene->mSceneGraph;
@@ -292,12 +373,16 @@ namespace Falcor
 
     void AnimationController::updateLocalMatrices(double time)
     {
-        for (auto& pAnimation : mAnimations)
+        mAnimationBatch.animate(mAnimations, time);
+
+        // Write the transforms in animation order, so the last animation of a node wins.
+        const auto& transforms = mAnimationBatch.getTransforms();
+        for (size_t i = 0; i < mAnimations.size(); i++)
         {
-            NodeID nodeID = pAnimation->getNodeID();
+            NodeID nodeID = mAnimations[i]->getNodeID();
             FALCOR_ASSERT(nodeID.get() < mLocalMatrices.size());
-            mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
-            mMatricesChanged[nodeID.get()] = true;
+            mLocalMatrices[nodeID.get()] = transforms[i];
+            mMatricesChanged[nodeID.get()] = 1;
         }
     }
 
@@ -305,29 +390,91 @@ namespace Falcor
     {
         const auto& sceneGraph = mpScene->mSceneGraph;
 
-        for (size_t i = 0; i < mGlobalMatrices.size(); i++)
+        // Process the scene graph level by level. All parents are updated before their children,
+        // so nodes within a level are independent and can be updated in parallel.
+        // Change flags are propagated to children as we go, so only dirty subtrees are recomputed.
+        for (size_t level = 0; level + 1 < mNodeLevelOffsets.size(); level++)
         {
-            // Propagate matrix change flag to children.
-            if (sceneGraph[i].parent != NodeID::Invalid())
+            const size_t levelOffset = mNodeLevelOffsets[level];
+            const size_t levelSize = mNodeLevelOffsets[level + 1] - levelOffset;
+
+            auto updateChunk = [&](size_t chunk)
             {
-                mMatricesChanged[i] = mMatricesChanged[i] || mMatricesChanged[sceneGraph[i].parent.get()];
-            }
+                const size_t end = std::min(levelSize, (chunk + 1) * kNodeChunkSize);
+                for (size_t i = chunk * kNodeChunkSize; i < end; i++)
+                {
+                    const uint32_t nodeID = mNodeLevelOrder[levelOffset + i];
+                    const NodeID parent = sceneGraph[nodeID].parent;
 
-            if (!mMatricesChanged[i] && !updateAll) continue;
+                    // Propagate matrix change flag to children.
+                    if (parent != NodeID::Invalid() && mMatricesChanged[parent.get()]) mMatricesChanged[nodeID] = 1;
 
-            mGlobalMatrices[i] = mLocalMatrices[i];
+                    if (mMatricesChanged[nodeID] || updateAll) updateWorldMatrix(nodeID);
+                }
+            };
 
-            if (mpScene->mSceneGraph[i].parent != NodeID::Invalid())
+            const size_t chunkCount = div_round_up(levelSize, kNodeChunkSize);
+            if (chunkCount == 1)
+            {
+                updateChunk(0);
+            }
+            else
             {
-                mGlobalMatrices[i] = mGlobalMatrices[sceneGraph[i].parent.get()] * mGlobalMatrices[i];
+                Threading::parallelFor<size_t>(0, chunkCount, updateChunk);
             }
+        }
+
+        if (updateAll)
+        {
+            mDirtyRanges.clear();
+            if (!mGlobalMatrices.empty()) mDirtyRanges.push_back({ 0, mGlobalMatrices.size() });
+        }
+        else
+        {
+            updateDirtyRanges();
+        }
+    }
+
+    void AnimationController::updateWorldMatrix(size_t nodeID)
+    {
+        const auto& node = mpScene->mSceneGraph[nodeID];
+
+        mGlobalMatrices[nodeID] = mLocalMatrices[nodeID];
+
+        if (node.parent != NodeID::Invalid())
+        {
+            mGlobalMatrices[nodeID] = mGlobalMatrices[node.parent.get()] * mGlobalMatrices[nodeID];
+        }
+
+        mInvTransposeGlobalMatrices[nodeID] = inverseTransposeAffine(mGlobalMatrices[nodeID]);
 
-            mInvTransposeGlobalMatrices[i] = transpose(inverse(mGlobalMatrices[i]));
+        if (mpSkinningPass)
+        {
+            mSkinningMatrices[nodeID] = mGlobalMatrices[nodeID] * node.localToBindSpace;
+            mInvTransposeSkinningMatrices[nodeID] = inverseTransposeAffine(mSkinningMatrices[nodeID]);
+        }
+    }
+
+    void AnimationController::updateDirtyRanges()
+    {
+        mDirtyRanges.clear();
 
-            if (mpSkinningPass)
+        for (size_t i = 0; i < mMatricesChanged.size();)
+        {
+            // Find the next range of consecutive changed matrices.
+            while (i < mMatricesChanged.size() && !mMatricesChanged[i]) ++i;
+            if (i == mMatricesChanged.size()) break;
+            size_t offset = i;
+            while (i < mMatricesChanged.size() && mMatricesChanged[i]) ++i;
+
+            // Merge with the previous range if the gap is small, as uploading a few unchanged matrices is cheaper than an extra copy.
+            if (!mDirtyRanges.empty() && offset - (mDirtyRanges.back().first + mDirtyRanges.back().second) < kMaxDirtyRangeGap)
+            {
+                mDirtyRanges.back().second = i - mDirtyRanges.back().first;
+            }
+            else
             {
-                mSkinningMatrices[i] = mGlobalMatrices[i] * sceneGraph[i].localToBindSpace;
-                mInvTransposeSkinningMatrices[i] = transpose(inverse(mSkinningMatrices[i]));
+                mDirtyRanges.push_back({ offset, i - offset });
             }
         }
     }
@@ -347,21 +494,12 @@ namespace Falcor
         }
         else
         {
-            // Upload changed matrices only.
-            for (size_t i = 0; i < mGlobalMatrices.size();)
+            // Upload ranges of changed matrices only. The ranges are computed in updateWorldMatrices().
+            for (const auto& [offset, count] : mDirtyRanges)
             {
-                // Detect ranges of consecutive matrices that have all changed or not.
-                size_t offset = i;
-                bool changed = mMatricesChanged[i];
-                while (i < mGlobalMatrices.size() && mMatricesChanged[i] == changed) ++i;
-
-                // Upload range of changed matrices.
-                if (changed)
-                {
-                    size_t count = i - offset;
-                    mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                    mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
-                }
+                FALCOR_ASSERT(offset + count <= mGlobalMatrices.size());
+                mpWorldMatricesBuffer->setBlob(&mGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
+                mpInvTransposeWorldMatricesBuffer->setBlob(&mInvTransposeGlobalMatrices[offset], offset * sizeof(float4x4), count * sizeof(float4x4));
             }
         }
     }
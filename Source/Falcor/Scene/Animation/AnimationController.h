@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Animation.h"
+#include "AnimationBatch.h"
 #include "AnimatedVertexCache.h"
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
@@ -150,9 +151,12 @@ namespace Falcor
         friend class SceneBuilder;
         AnimationController(Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<Animation::SharedPtr>& animations);
 
+        void initNodeLevels();
         void initLocalMatrices();
         void updateLocalMatrices(double time);
         void updateWorldMatrices(bool updateAll = false);
+        void updateWorldMatrix(size_t nodeID);
+        void updateDirtyRanges();
         void uploadWorldMatrices(bool uploadAll = false);
 
         void bindBuffers();
@@ -162,11 +166,15 @@ namespace Falcor
 
         // Animation
         std::vector<Animation::SharedPtr> mAnimations;
+        AnimationBatch mAnimationBatch;
         std::vector<bool> mNodesEdited;
         std::vector<float4x4> mLocalMatrices;
         std::vector<float4x4> mGlobalMatrices;
         std::vector<float4x4> mInvTransposeGlobalMatrices;
-        std::vector<bool> mMatricesChanged;         ///< Flag per matrix, true if matrix changed since last frame.
+        std::vector<uint8_t> mMatricesChanged;      ///< Flag per matrix, true if matrix changed since last frame. Stored as bytes to allow concurrent updates.
+        std::vector<uint32_t> mNodeLevelOrder;      ///< Node IDs sorted by their depth in the scene graph (breadth-first order).
+        std::vector<size_t> mNodeLevelOffsets;      ///< Offsets into mNodeLevelOrder for each level. The last entry is the total node count.
+        std::vector<std::pair<size_t, size_t>> mDirtyRanges; ///< Ranges (offset, count) of matrices that changed in the last update.
 
         bool mFirstUpdate = true;       ///< True if this is the first update.
         bool mEnabled = true;           ///< True if animations are enabled.
@@ -0,0 +1,211 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Animation.h"
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    /** Keyframe interpolation shared by Animation and AnimationBatch.
+
+        The functions are templated on the lane type V, which is either float or a SIMD vector of floats.
+        Each lane goes through the same sequence of floating-point operations, so evaluating a batch of
+        animations gives bit-identical results to evaluating them one at a time. This assumes the compiler
+        does not contract multiplies and adds into FMA instructions, which holds for the default build flags.
+
+        A lane type must support +, -, * and / with itself, unary minus, construction from a float,
+        and comparisons returning a mask. The following functions must be defined for it:
+        - select(mask, a, b) returns a where the mask is set and b elsewhere.
+        - all(mask) returns true if the mask is set in all lanes.
+        - mapLanes(v, func) applies a scalar function to each lane.
+    */
+    namespace KeyframeInterpolation
+    {
+        template<typename V>
+        struct Vec3
+        {
+            V x, y, z;
+        };
+
+        template<typename V>
+        struct Quat
+        {
+            V x, y, z, w;
+        };
+
+        /** Keyframe transform of one or more animations.
+        */
+        template<typename V>
+        struct Pose
+        {
+            Vec3<V> translation;
+            Vec3<V> scaling;
+            Quat<V> rotation;
+        };
+
+        inline float select(bool mask, float a, float b) { return mask ? a : b; }
+        inline bool all(bool mask) { return mask; }
+        template<typename F> float mapLanes(float x, F func) { return func(x); }
+
+        inline Pose<float> toPose(const Animation::Keyframe& keyframe)
+        {
+            const auto& t = keyframe.translation;
+            const auto& s = keyframe.scaling;
+            const auto& r = keyframe.rotation;
+            return { { t.x, t.y, t.z }, { s.x, s.y, s.z }, { r.x, r.y, r.z, r.w } };
+        }
+
+        inline void fromPose(const Pose<float>& pose, Animation::Keyframe& keyframe)
+        {
+            keyframe.translation = float3(pose.translation.x, pose.translation.y, pose.translation.z);
+            keyframe.scaling = float3(pose.scaling.x, pose.scaling.y, pose.scaling.z);
+            keyframe.rotation = glm::quat(pose.rotation.w, pose.rotation.x, pose.rotation.y, pose.rotation.z);
+        }
+
+        template<typename V>
+        V lerp(const V& a, const V& b, const V& t)
+        {
+            return (V(1.f) - t) * a + t * b;
+        }
+
+        template<typename V>
+        Vec3<V> lerp(const Vec3<V>& a, const Vec3<V>& b, const V& t)
+        {
+            return { lerp(a.x, b.x, t), lerp(a.y, b.y, t), lerp(a.z, b.z, t) };
+        }
+
+        /** Spherical linear interpolation along the shortest path.
+            Falls back to linear interpolation if the quaternions are nearly identical.
+        */
+        template<typename V>
+        Quat<V> slerp(const Quat<V>& x, const Quat<V>& y, const V& a)
+        {
+            V cosTheta = (x.w * y.w + x.x * y.x) + (x.y * y.y + x.z * y.z);
+
+            // Negate one quaternion if needed to take the shortest path.
+            auto flip = cosTheta < V(0.f);
+            Quat<V> z = { select(flip, -y.x, y.x), select(flip, -y.y, y.y), select(flip, -y.z, y.z), select(flip, -y.w, y.w) };
+            cosTheta = select(flip, -cosTheta, cosTheta);
+
+            auto isLinear = cosTheta > V(1.f - std::numeric_limits<float>::epsilon());
+            Quat<V> result =
+            {
+                x.x * (V(1.f) - a) + z.x * a,
+                x.y * (V(1.f) - a) + z.y * a,
+                x.z * (V(1.f) - a) + z.z * a,
+                x.w * (V(1.f) - a) + z.w * a,
+            };
+
+            if (!all(isLinear))
+            {
+                auto sin = [](float v) { return std::sin(v); };
+                V angle = mapLanes(cosTheta, [](float v) { return std::acos(v); });
+                V s0 = mapLanes((V(1.f) - a) * angle, sin);
+                V s1 = mapLanes(a * angle, sin);
+                V s = mapLanes(angle, sin);
+
+                result.x = select(isLinear, result.x, (s0 * x.x + s1 * z.x) / s);
+                result.y = select(isLinear, result.y, (s0 * x.y + s1 * z.y) / s);
+                result.z = select(isLinear, result.z, (s0 * x.z + s1 * z.z) / s);
+                result.w = select(isLinear, result.w, (s0 * x.w + s1 * z.w) / s);
+            }
+
+            return result;
+        }
+
+        /** Bezier form hermite spline.
+        */
+        template<typename V>
+        V hermite(const V& p0, const V& p1, const V& p2, const V& p3, const V& t)
+        {
+            V b0 = p1;
+            V b1 = p1 + (p2 - p0) * V(0.5f) / V(3.f);
+            V b2 = p2 - (p3 - p1) * V(0.5f) / V(3.f);
+            V b3 = p2;
+
+            V q0 = lerp(b0, b1, t);
+            V q1 = lerp(b1, b2, t);
+            V q2 = lerp(b2, b3, t);
+
+            V qq0 = lerp(q0, q1, t);
+            V qq1 = lerp(q1, q2, t);
+
+            return lerp(qq0, qq1, t);
+        }
+
+        template<typename V>
+        Vec3<V> hermite(const Vec3<V>& p0, const Vec3<V>& p1, const Vec3<V>& p2, const Vec3<V>& p3, const V& t)
+        {
+            return { hermite(p0.x, p1.x, p2.x, p3.x, t), hermite(p0.y, p1.y, p2.y, p3.y, t), hermite(p0.z, p1.z, p2.z, p3.z, t) };
+        }
+
+        /** Bezier form hermite slerp.
+        */
+        template<typename V>
+        Quat<V> hermite(const Quat<V>& r0, const Quat<V>& r1, const Quat<V>& r2, const Quat<V>& r3, const V& t)
+        {
+            auto tangent = [](const V& p0, const V& p2) { return (p2 - p0) * V(0.5f) / V(3.f); };
+
+            Quat<V> b0 = r1;
+            Quat<V> b1 = { r1.x + tangent(r0.x, r2.x), r1.y + tangent(r0.y, r2.y), r1.z + tangent(r0.z, r2.z), r1.w + tangent(r0.w, r2.w) };
+            Quat<V> b2 = { r2.x - tangent(r1.x, r3.x), r2.y - tangent(r1.y, r3.y), r2.z - tangent(r1.z, r3.z), r2.w - tangent(r1.w, r3.w) };
+            Quat<V> b3 = r2;
+
+            Quat<V> q0 = slerp(b0, b1, t);
+            Quat<V> q1 = slerp(b1, b2, t);
+            Quat<V> q2 = slerp(b2, b3, t);
+
+            Quat<V> qq0 = slerp(q0, q1, t);
+            Quat<V> qq1 = slerp(q1, q2, t);
+
+            return slerp(qq0, qq1, t);
+        }
+
+        /** Linear interpolation between two keyframes. Extrapolates linearly if t is outside [0, 1].
+        */
+        template<typename V>
+        Pose<V> interpolateLinear(const Pose<V>& k0, const Pose<V>& k1, const V& t)
+        {
+            return { lerp(k0.translation, k1.translation, t), lerp(k0.scaling, k1.scaling, t), slerp(k0.rotation, k1.rotation, t) };
+        }
+
+        /** Hermite interpolation between the keyframes k1 and k2.
+        */
+        template<typename V>
+        Pose<V> interpolateHermite(const Pose<V>& k0, const Pose<V>& k1, const Pose<V>& k2, const Pose<V>& k3, const V& t)
+        {
+            return
+            {
+                hermite(k0.translation, k1.translation, k2.translation, k3.translation, t),
+                lerp(k1.scaling, k2.scaling, t),
+                hermite(k0.rotation, k1.rotation, k2.rotation, k3.rotation, t),
+            };
+        }
+    }
+}
@@ -0,0 +1,151 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "KeyframeStreamer.h"
+#include "Core/Assert.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    KeyframeStreamer::KeyframeStreamer(uint32_t keyframeCount, uint32_t capacity, LoadFunc loadFunc)
+        : mKeyframeCount(keyframeCount)
+        , mCapacity(std::min(std::max(capacity, 2u), keyframeCount))
+        , mLoadFunc(std::move(loadFunc))
+        , mInWindow(keyframeCount, false)
+    {
+        FALCOR_ASSERT(keyframeCount > 0);
+    }
+
+    KeyframeStreamer::~KeyframeStreamer()
+    {
+        for (auto& [keyframe, entry] : mEntries)
+        {
+            try
+            {
+                entry.task.finish();
+            }
+            catch (...)
+            {
+                // Ignore errors from keyframes that were never requested.
+            }
+        }
+    }
+
+    void KeyframeStreamer::update(uint32_t keyframeA, uint32_t keyframeB, bool forward, bool looped)
+    {
+        FALCOR_ASSERT(keyframeA < mKeyframeCount && keyframeB < mKeyframeCount);
+
+        // Build the window in order of priority.
+        for (uint32_t keyframe : mWindow) mInWindow[keyframe] = false;
+        mWindow.clear();
+
+        auto addToWindow = [&](uint32_t keyframe)
+        {
+            if (mInWindow[keyframe]) return;
+            mInWindow[keyframe] = true;
+            mWindow.push_back(keyframe);
+        };
+
+        addToWindow(keyframeA);
+        addToWindow(keyframeB);
+
+        uint32_t keyframe = keyframeB;
+        while (mWindow.size() < mCapacity)
+        {
+            if (forward)
+            {
+                if (keyframe + 1 < mKeyframeCount) keyframe++;
+                else if (looped) keyframe = 0;
+                else break;
+            }
+            else
+            {
+                if (keyframe > 0) keyframe--;
+                else if (looped) keyframe = mKeyframeCount - 1;
+                else break;
+            }
+            if (mInWindow[keyframe]) break;
+            addToWindow(keyframe);
+        }
+
+        // Evict keyframes that left the window. Keyframes that are still loading are kept until they finish,
+        // they count towards the capacity in the meantime.
+        for (auto it = mEntries.begin(); it != mEntries.end();)
+        {
+            if (!mInWindow[it->first] && !it->second.task.isRunning()) it = mEntries.erase(it);
+            else ++it;
+        }
+
+        // Start loading missing keyframes in order of priority.
+        for (uint32_t k : mWindow)
+        {
+            if (mEntries.size() >= mCapacity) break;
+            if (mEntries.count(k) == 0) load(k);
+        }
+    }
+
+    const std::vector<uint8_t>& KeyframeStreamer::getKeyframe(uint32_t keyframe)
+    {
+        FALCOR_ASSERT(keyframe < mKeyframeCount);
+
+        auto it = mEntries.find(keyframe);
+        if (it == mEntries.end())
+        {
+            load(keyframe);
+            it = mEntries.find(keyframe);
+        }
+
+        try
+        {
+            it->second.task.finish();
+        }
+        catch (...)
+        {
+            // Remove the entry so that loading is retried on the next request.
+            mEntries.erase(it);
+            throw;
+        }
+        return *it->second.pData;
+    }
+
+    bool KeyframeStreamer::isResident(uint32_t keyframe) const
+    {
+        auto it = mEntries.find(keyframe);
+        return it != mEntries.end() && !it->second.task.isRunning();
+    }
+
+    void KeyframeStreamer::load(uint32_t keyframe)
+    {
+        Entry entry;
+        entry.pData = std::make_shared<std::vector<uint8_t>>();
+        entry.task = Threading::dispatchTask([loadFunc = mLoadFunc, pData = entry.pData, keyframe]()
+        {
+            loadFunc(keyframe, *pData);
+        });
+        mEntries.emplace(keyframe, std::move(entry));
+    }
+}
@@ -0,0 +1,106 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Threading.h"
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Keeps a window of keyframes resident in host memory while an animation plays.
+
+        Keyframes are loaded on background threads. The window consists of the keyframes needed
+        for interpolation at the current time followed by keyframes prefetched in the playback
+        direction. At most 'capacity' keyframes are resident or loading at any time, keyframes
+        leaving the window are evicted.
+    */
+    class FALCOR_API KeyframeStreamer
+    {
+    public:
+        /** Function loading a keyframe, called as loadFunc(keyframe, data) from a worker thread.
+        */
+        using LoadFunc = std::function<void(uint32_t, std::vector<uint8_t>&)>;
+
+        /** Constructor.
+            \param[in] keyframeCount Number of keyframes.
+            \param[in] capacity Max number of resident keyframes (at least 2).
+            \param[in] loadFunc Function loading a keyframe.
+        */
+        KeyframeStreamer(uint32_t keyframeCount, uint32_t capacity, LoadFunc loadFunc);
+
+        /** Waits for pending loads to finish.
+        */
+        ~KeyframeStreamer();
+
+        /** Update the residency window and start loading missing keyframes.
+            \param[in] keyframeA First keyframe needed at the current time.
+            \param[in] keyframeB Second keyframe needed at the current time. Prefetching continues from here.
+            \param[in] forward True if the animation plays forward.
+            \param[in] looped True if the animation wraps around at the end.
+        */
+        void update(uint32_t keyframeA, uint32_t keyframeB, bool forward, bool looped);
+
+        /** Get the data of a keyframe, waiting for it to load if necessary.
+            The returned data stays valid until the next call to update().
+            \param[in] keyframe Keyframe index.
+            \return Keyframe data.
+        */
+        const std::vector<uint8_t>& getKeyframe(uint32_t keyframe);
+
+        uint32_t getKeyframeCount() const { return mKeyframeCount; }
+        uint32_t getCapacity() const { return mCapacity; }
+
+        /** Get the number of keyframes that are resident or loading.
+        */
+        uint32_t getResidentCount() const { return (uint32_t)mEntries.size(); }
+
+        /** Check if a keyframe is loaded.
+        */
+        bool isResident(uint32_t keyframe) const;
+
+    private:
+        struct Entry
+        {
+            std::shared_ptr<std::vector<uint8_t>> pData;
+            Threading::Task task;
+        };
+
+        void load(uint32_t keyframe);
+
+        uint32_t mKeyframeCount = 0;
+        uint32_t mCapacity = 0;
+        LoadFunc mLoadFunc;
+        std::unordered_map<uint32_t, Entry> mEntries;
+        std::vector<uint32_t> mWindow;
+        std::vector<bool> mInWindow;
+    };
+}
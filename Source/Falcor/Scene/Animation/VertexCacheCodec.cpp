@@ -0,0 +1,306 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheCodec.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Utils/Math/PackedFormats.h"
+#include <lz4.h>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FALCOR_VERTEX_CACHE_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_VERTEX_CACHE_SSE2 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        // Components stored per vertex, each as a 16-bit stream.
+        // Mesh: position (3), octahedral normal (2), tangent sign and curve radius (1), octahedral tangent (2), texture coordinates (4).
+        // Curve: position (3).
+        const uint32_t kMeshStreamCount = 12;
+        const uint32_t kCurveStreamCount = 3;
+
+        uint32_t getStreamCount(VertexCacheCodec::Type type)
+        {
+            return type == VertexCacheCodec::Type::Mesh ? kMeshStreamCount : kCurveStreamCount;
+        }
+
+        template<typename VertexT>
+        void computeBounds(const std::vector<std::vector<VertexT>>& keyframes, VertexCacheCodec::Params& params)
+        {
+            float3 minPos(std::numeric_limits<float>::max());
+            float3 maxPos(-std::numeric_limits<float>::max());
+            for (const auto& keyframe : keyframes)
+            {
+                for (const auto& v : keyframe)
+                {
+                    minPos = min(minPos, v.position);
+                    maxPos = max(maxPos, v.position);
+                }
+            }
+            params.vertexCount = keyframes.empty() ? 0 : (uint32_t)keyframes.front().size();
+            params.origin = params.vertexCount > 0 ? minPos : float3(0.f);
+            params.extent = params.vertexCount > 0 ? maxPos - minPos : float3(0.f);
+        }
+
+        uint16_t quantize(float value, float origin, float extent)
+        {
+            if (extent <= 0.f) return 0;
+            return (uint16_t)std::clamp(std::lround((value - origin) / extent * 65535.f), 0l, 65535l);
+        }
+
+        void quantizePositions(const VertexCacheCodec::Params& params, const float3& position, size_t i, uint16_t* pStreams)
+        {
+            size_t n = params.vertexCount;
+            pStreams[0 * n + i] = quantize(position.x, params.origin.x, params.extent.x);
+            pStreams[1 * n + i] = quantize(position.y, params.origin.y, params.extent.y);
+            pStreams[2 * n + i] = quantize(position.z, params.origin.z, params.extent.z);
+        }
+
+        void quantizeKeyframe(const VertexCacheCodec::Params& params, const std::vector<PackedStaticVertexData>& vertices, uint16_t* pStreams)
+        {
+            size_t n = params.vertexCount;
+            for (size_t i = 0; i < n; i++)
+            {
+                const auto& v = vertices[i];
+                quantizePositions(params, v.position, i, pStreams);
+
+                uint32_t packedX = asuint(v.packedNormalTangentCurveRadius.x);
+                uint32_t packedY = asuint(v.packedNormalTangentCurveRadius.y);
+                uint32_t packedZ = asuint(v.packedNormalTangentCurveRadius.z);
+
+                float2 normalXY = glm::unpackHalf2x16(packedX);
+                float normalZ = glm::unpackHalf2x16(packedY & 0xffff).x;
+                float3 normal(normalXY.x, normalXY.y, normalZ);
+                uint32_t octNormal = encodeNormal2x16(dot(normal, normal) > 0.f ? normalize(normal) : float3(0.f, 0.f, 1.f));
+
+                pStreams[3 * n + i] = (uint16_t)(octNormal & 0xffff);
+                pStreams[4 * n + i] = (uint16_t)(octNormal >> 16);
+                pStreams[5 * n + i] = (uint16_t)(packedY >> 16);
+                pStreams[6 * n + i] = (uint16_t)(packedZ & 0xffff);
+                pStreams[7 * n + i] = (uint16_t)(packedZ >> 16);
+                pStreams[8 * n + i] = (uint16_t)(asuint(v.texCrd.x) & 0xffff);
+                pStreams[9 * n + i] = (uint16_t)(asuint(v.texCrd.x) >> 16);
+                pStreams[10 * n + i] = (uint16_t)(asuint(v.texCrd.y) & 0xffff);
+                pStreams[11 * n + i] = (uint16_t)(asuint(v.texCrd.y) >> 16);
+            }
+        }
+
+        void quantizeKeyframe(const VertexCacheCodec::Params& params, const std::vector<DynamicCurveVertexData>& vertices, uint16_t* pStreams)
+        {
+            for (size_t i = 0; i < params.vertexCount; i++) quantizePositions(params, vertices[i].position, i, pStreams);
+        }
+
+        /** Dequantize a position stream to a strided float array.
+        */
+        void dequantizePositions(const uint16_t* pStream, float origin, float extent, size_t count, float* pDst, size_t stride)
+        {
+            const float scale = extent / 65535.f;
+            size_t i = 0;
+#if FALCOR_VERTEX_CACHE_SSE2
+            float values[8];
+            const __m128 originV = _mm_set1_ps(origin);
+            const __m128 scaleV = _mm_set1_ps(scale);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128i q = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pStream + i));
+                __m128 lo = _mm_cvtepi32_ps(_mm_unpacklo_epi16(q, zero));
+                __m128 hi = _mm_cvtepi32_ps(_mm_unpackhi_epi16(q, zero));
+                _mm_storeu_ps(values, _mm_add_ps(originV, _mm_mul_ps(lo, scaleV)));
+                _mm_storeu_ps(values + 4, _mm_add_ps(originV, _mm_mul_ps(hi, scaleV)));
+                for (size_t j = 0; j < 8; j++) pDst[(i + j) * stride] = values[j];
+            }
+#endif
+            for (; i < count; i++) pDst[i * stride] = origin + (float)pStream[i] * scale;
+        }
+
+        /** Undo the byte plane split and zigzag encoding of a stream, and add the values to the previous keyframe.
+        */
+        void decodeStream(const uint8_t* pLow, const uint8_t* pHigh, uint16_t* pValues, size_t count, bool delta)
+        {
+            size_t i = 0;
+#if FALCOR_VERTEX_CACHE_SSE2
+            const __m128i one = _mm_set1_epi16(1);
+            const __m128i zero = _mm_setzero_si128();
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128i lo = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pLow + i));
+                __m128i hi = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(pHigh + i));
+                __m128i v = _mm_unpacklo_epi8(lo, hi);
+                __m128i d = _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_sub_epi16(zero, _mm_and_si128(v, one)));
+                if (delta) d = _mm_add_epi16(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(pValues + i)));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(pValues + i), d);
+            }
+#endif
+            for (; i < count; i++)
+            {
+                uint16_t v = (uint16_t)(pLow[i] | (pHigh[i] << 8));
+                uint16_t d = (uint16_t)((v >> 1) ^ (0u - (v & 1u)));
+                pValues[i] = delta ? (uint16_t)(pValues[i] + d) : d;
+            }
+        }
+
+        template<typename VertexT>
+        std::vector<std::vector<uint8_t>> compressKeyframes(const std::vector<std::vector<VertexT>>& keyframes, VertexCacheCodec::Params& params)
+        {
+            computeBounds(keyframes, params);
+
+            const size_t valueCount = getStreamCount(params.type) * (size_t)params.vertexCount;
+            std::vector<uint16_t> streams(valueCount);
+            std::vector<uint16_t> prevStreams(valueCount);
+            std::vector<uint8_t> planes(2 * valueCount);
+
+            std::vector<std::vector<uint8_t>> compressed(keyframes.size());
+            for (size_t k = 0; k < keyframes.size(); k++)
+            {
+                if (keyframes[k].size() != params.vertexCount) throw RuntimeError("Vertex cache keyframes must have the same number of vertices.");
+
+                quantizeKeyframe(params, keyframes[k], streams.data());
+
+                // Store the zigzag encoded difference to the previous keyframe split into low and high byte planes.
+                bool delta = k % VertexCacheCodec::kKeyframeInterval != 0;
+                const size_t n = params.vertexCount;
+                for (size_t i = 0; i < valueCount; i++)
+                {
+                    int16_t d = (int16_t)(uint16_t)(streams[i] - (delta ? prevStreams[i] : 0));
+                    uint16_t z = (uint16_t)(((uint16_t)d << 1) ^ (uint16_t)(d >> 15));
+                    size_t stream = i / n;
+                    planes[2 * stream * n + i % n] = (uint8_t)(z & 0xff);
+                    planes[(2 * stream + 1) * n + i % n] = (uint8_t)(z >> 8);
+                }
+                std::swap(streams, prevStreams);
+
+                auto& data = compressed[k];
+                data.resize(LZ4_compressBound((int)planes.size()));
+                int size = LZ4_compress_default((const char*)planes.data(), (char*)data.data(), (int)planes.size(), (int)data.size());
+                if (size <= 0) throw RuntimeError("Failed to compress vertex cache keyframe.");
+                data.resize(size);
+                data.shrink_to_fit();
+            }
+            return compressed;
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> VertexCacheCodec::compress(const std::vector<std::vector<PackedStaticVertexData>>& keyframes, Params& params)
+    {
+        params.type = Type::Mesh;
+        return compressKeyframes(keyframes, params);
+    }
+
+    std::vector<std::vector<uint8_t>> VertexCacheCodec::compress(const std::vector<std::vector<DynamicCurveVertexData>>& keyframes, Params& params)
+    {
+        params.type = Type::Curve;
+        return compressKeyframes(keyframes, params);
+    }
+
+    VertexCacheCodec::Decoder::Decoder(const Params& params, ReadFunc readFunc)
+        : mParams(params)
+        , mReadFunc(std::move(readFunc))
+        , mStreams(getStreamCount(params.type) * (size_t)params.vertexCount)
+    {}
+
+    void VertexCacheCodec::Decoder::decodeStreams(uint32_t keyframe)
+    {
+        if (keyframe == mKeyframe) return;
+
+        // Continue from the current keyframe if possible, otherwise start at the preceding reference keyframe.
+        uint32_t reference = keyframe - keyframe % kKeyframeInterval;
+        uint32_t first = (mKeyframe != kInvalidKeyframe && mKeyframe >= reference && mKeyframe < keyframe) ? mKeyframe + 1 : reference;
+
+        const size_t n = mParams.vertexCount;
+        const size_t planeSize = 2 * mStreams.size();
+        mPlanes.resize(planeSize);
+
+        for (uint32_t k = first; k <= keyframe; k++)
+        {
+            // Invalidate the state in case decoding fails.
+            mKeyframe = kInvalidKeyframe;
+
+            mReadFunc(k, mCompressed);
+            int size = LZ4_decompress_safe((const char*)mCompressed.data(), (char*)mPlanes.data(), (int)mCompressed.size(), (int)planeSize);
+            if (size != (int)planeSize) throw RuntimeError("Failed to decompress vertex cache keyframe {}.", k);
+
+            bool delta = k != reference;
+            for (size_t stream = 0; stream < mStreams.size() / std::max<size_t>(n, 1); stream++)
+            {
+                decodeStream(mPlanes.data() + 2 * stream * n, mPlanes.data() + (2 * stream + 1) * n, mStreams.data() + stream * n, n, delta);
+            }
+            mKeyframe = k;
+        }
+    }
+
+    void VertexCacheCodec::Decoder::decode(uint32_t keyframe, std::vector<PackedStaticVertexData>& vertices)
+    {
+        FALCOR_ASSERT(mParams.type == Type::Mesh);
+        decodeStreams(keyframe);
+
+        const size_t n = mParams.vertexCount;
+        vertices.resize(n);
+
+        const size_t stride = sizeof(PackedStaticVertexData) / sizeof(float);
+        float* pPositions = reinterpret_cast<float*>(vertices.data());
+        dequantizePositions(mStreams.data() + 0 * n, mParams.origin.x, mParams.extent.x, n, pPositions + 0, stride);
+        dequantizePositions(mStreams.data() + 1 * n, mParams.origin.y, mParams.extent.y, n, pPositions + 1, stride);
+        dequantizePositions(mStreams.data() + 2 * n, mParams.origin.z, mParams.extent.z, n, pPositions + 2, stride);
+
+        const uint16_t* pStreams = mStreams.data();
+        for (size_t i = 0; i < n; i++)
+        {
+            auto& v = vertices[i];
+
+            float3 normal = decodeNormal2x16(pStreams[3 * n + i] | ((uint32_t)pStreams[4 * n + i] << 16));
+            uint32_t normalZ = glm::packHalf2x16({ normal.z, 0.f });
+            v.packedNormalTangentCurveRadius.x = asfloat(glm::packHalf2x16({ normal.x, normal.y }));
+            v.packedNormalTangentCurveRadius.y = asfloat((normalZ & 0xffff) | ((uint32_t)pStreams[5 * n + i] << 16));
+            v.packedNormalTangentCurveRadius.z = asfloat(pStreams[6 * n + i] | ((uint32_t)pStreams[7 * n + i] << 16));
+            v.texCrd.x = asfloat(pStreams[8 * n + i] | ((uint32_t)pStreams[9 * n + i] << 16));
+            v.texCrd.y = asfloat(pStreams[10 * n + i] | ((uint32_t)pStreams[11 * n + i] << 16));
+        }
+    }
+
+    void VertexCacheCodec::Decoder::decode(uint32_t keyframe, std::vector<DynamicCurveVertexData>& vertices)
+    {
+        FALCOR_ASSERT(mParams.type == Type::Curve);
+        decodeStreams(keyframe);
+
+        const size_t n = mParams.vertexCount;
+        vertices.resize(n);
+
+        const size_t stride = sizeof(DynamicCurveVertexData) / sizeof(float);
+        float* pPositions = reinterpret_cast<float*>(vertices.data());
+        dequantizePositions(mStreams.data() + 0 * n, mParams.origin.x, mParams.extent.x, n, pPositions + 0, stride);
+        dequantizePositions(mStreams.data() + 1 * n, mParams.origin.y, mParams.extent.y, n, pPositions + 1, stride);
+        dequantizePositions(mStreams.data() + 2 * n, mParams.origin.z, mParams.extent.z, n, pPositions + 2, stride);
+    }
+}
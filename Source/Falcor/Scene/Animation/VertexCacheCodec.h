@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Scene/SceneTypes.slang"
+#include "Utils/Math/Vector.h"
+#include <functional>
+#include <limits>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Compression of vertex cache keyframes.
+
+        Positions are quantized to 16 bits per component relative to the bounds of all keyframes of a cache.
+        Normals are octahedral encoded with 16 bits per component. Tangents, texture coordinates and curve
+        radii are kept bit exact. Each keyframe is stored as the difference to the previous keyframe, except
+        for every kKeyframeInterval-th keyframe which is stored as is to allow random access. The differences
+        are split into byte planes and compressed with LZ4.
+
+        Decoded positions are within getMaxPositionError() of the input, normals are within 1e-3 per component.
+    */
+    class FALCOR_API VertexCacheCodec
+    {
+    public:
+        static const uint32_t kKeyframeInterval = 16;   ///< Distance between keyframes that are stored without reference to the previous keyframe.
+
+        enum class Type
+        {
+            Mesh,   ///< Keyframes of PackedStaticVertexData.
+            Curve,  ///< Keyframes of DynamicCurveVertexData.
+        };
+
+        /** Parameters shared by all keyframes of a cache.
+        */
+        struct Params
+        {
+            Type type = Type::Mesh;
+            uint32_t vertexCount = 0;       ///< Number of vertices per keyframe.
+            float3 origin = float3(0.f);    ///< Minimum of the position bounds over all keyframes.
+            float3 extent = float3(0.f);    ///< Extent of the position bounds over all keyframes.
+
+            /** Get the max error of decoded positions per component.
+            */
+            float3 getMaxPositionError() const { return extent * (0.5f / 65535.f); }
+        };
+
+        /** Function returning the compressed data of a keyframe, called as readFunc(keyframe, data).
+        */
+        using ReadFunc = std::function<void(uint32_t, std::vector<uint8_t>&)>;
+
+        /** Compress keyframes.
+            \param[in] keyframes Keyframes, all with the same number of vertices.
+            \param[out] params Parameters needed for decoding.
+            \return Compressed data per keyframe.
+        */
+        static std::vector<std::vector<uint8_t>> compress(const std::vector<std::vector<PackedStaticVertexData>>& keyframes, Params& params);
+        static std::vector<std::vector<uint8_t>> compress(const std::vector<std::vector<DynamicCurveVertexData>>& keyframes, Params& params);
+
+        /** Decoder for the keyframes of a single cache.
+            Decoding keyframes in increasing order is cheapest. Other keyframes are decoded starting
+            from the closest preceding keyframe that was stored without reference to the previous one.
+        */
+        class FALCOR_API Decoder
+        {
+        public:
+            Decoder(const Params& params, ReadFunc readFunc);
+
+            /** Decode a keyframe. Throws if the data is corrupt.
+            */
+            void decode(uint32_t keyframe, std::vector<PackedStaticVertexData>& vertices);
+            void decode(uint32_t keyframe, std::vector<DynamicCurveVertexData>& vertices);
+
+        private:
+            void decodeStreams(uint32_t keyframe);
+
+            static const uint32_t kInvalidKeyframe = std::numeric_limits<uint32_t>::max();
+
+            Params mParams;
+            ReadFunc mReadFunc;
+            uint32_t mKeyframe = kInvalidKeyframe;  ///< Keyframe currently held in mStreams.
+            std::vector<uint16_t> mStreams;         ///< Quantized values of the current keyframe, one stream per component.
+            std::vector<uint8_t> mCompressed;
+            std::vector<uint8_t> mPlanes;
+        };
+    };
+}
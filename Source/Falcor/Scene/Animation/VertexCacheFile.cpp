@@ -0,0 +1,161 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheFile.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/Platform/OS.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMagic = 0x46435646; // "FVCF"
+        const uint32_t kVersion = 1;
+
+        struct Header
+        {
+            uint32_t magic = kMagic;
+            uint32_t version = kVersion;
+            uint64_t tableOffset = 0;   ///< Offset of the chunk table, zero until the file is finalized.
+        };
+    }
+
+    VertexCacheFile::SharedPtr VertexCacheFile::create(const std::filesystem::path& path)
+    {
+        bool temporary = path.empty();
+        SharedPtr pFile(new VertexCacheFile(temporary ? getTempFilePath() : path, temporary));
+
+        pFile->mWriteStream.open(pFile->mPath, std::ios::binary | std::ios::trunc);
+        if (!pFile->mWriteStream) throw RuntimeError("Failed to create vertex cache file '{}'.", pFile->mPath.string());
+
+        Header header;
+        pFile->mWriteStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        return pFile;
+    }
+
+    VertexCacheFile::SharedPtr VertexCacheFile::open(const std::filesystem::path& path)
+    {
+        SharedPtr pFile(new VertexCacheFile(path, false));
+
+        std::ifstream stream(path, std::ios::binary);
+        Header header;
+        if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header))) throw RuntimeError("Failed to read vertex cache file '{}'.", path.string());
+        if (header.magic != kMagic || header.version != kVersion) throw RuntimeError("'{}' is not a valid vertex cache file.", path.string());
+        if (header.tableOffset == 0) throw RuntimeError("Vertex cache file '{}' was not finalized.", path.string());
+
+        uint32_t chunkCount = 0;
+        stream.seekg((std::streamoff)header.tableOffset);
+        stream.read(reinterpret_cast<char*>(&chunkCount), sizeof(chunkCount));
+        pFile->mChunks.resize(chunkCount);
+        stream.read(reinterpret_cast<char*>(pFile->mChunks.data()), chunkCount * sizeof(Chunk));
+        if (!stream) throw RuntimeError("Failed to read chunk table of vertex cache file '{}'.", path.string());
+
+        pFile->mFinalized = true;
+        return pFile;
+    }
+
+    VertexCacheFile::SharedPtr VertexCacheFile::openChunks(const std::filesystem::path& path, std::vector<Chunk> chunks)
+    {
+        SharedPtr pFile(new VertexCacheFile(path, false));
+
+        // Open the stream right away so reads refer to this version of the file, even if it is replaced later on.
+        pFile->mReadStream.open(path, std::ios::binary | std::ios::ate);
+        if (!pFile->mReadStream) throw RuntimeError("Failed to open '{}' for reading vertex cache keyframes.", path.string());
+        uint64_t fileSize = (uint64_t)pFile->mReadStream.tellg();
+        for (const auto& chunk : chunks)
+        {
+            if (chunk.offset + chunk.size > fileSize) throw RuntimeError("Invalid vertex cache chunk in '{}'.", path.string());
+        }
+
+        pFile->mChunks = std::move(chunks);
+        pFile->mFinalized = true;
+        return pFile;
+    }
+
+    VertexCacheFile::VertexCacheFile(const std::filesystem::path& path, bool temporary)
+        : mPath(path)
+        , mTemporary(temporary)
+    {}
+
+    VertexCacheFile::~VertexCacheFile()
+    {
+        if (mWriteStream.is_open()) mWriteStream.close();
+        if (mReadStream.is_open()) mReadStream.close();
+        if (mTemporary)
+        {
+            std::error_code ec;
+            std::filesystem::remove(mPath, ec);
+        }
+    }
+
+    uint32_t VertexCacheFile::writeChunk(const void* pData, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        if (mFinalized) throw RuntimeError("Can't write to finalized vertex cache file '{}'.", mPath.string());
+
+        Chunk chunk;
+        chunk.offset = (uint64_t)mWriteStream.tellp();
+        chunk.size = size;
+        mWriteStream.write(reinterpret_cast<const char*>(pData), size);
+        if (!mWriteStream) throw RuntimeError("Failed to write to vertex cache file '{}'.", mPath.string());
+
+        mChunks.push_back(chunk);
+        return (uint32_t)mChunks.size() - 1;
+    }
+
+    void VertexCacheFile::finalize()
+    {
+        std::lock_guard<std::mutex> lock(mWriteMutex);
+        if (mFinalized) return;
+
+        Header header;
+        header.tableOffset = (uint64_t)mWriteStream.tellp();
+        uint32_t chunkCount = (uint32_t)mChunks.size();
+        mWriteStream.write(reinterpret_cast<const char*>(&chunkCount), sizeof(chunkCount));
+        mWriteStream.write(reinterpret_cast<const char*>(mChunks.data()), mChunks.size() * sizeof(Chunk));
+        mWriteStream.seekp(0);
+        mWriteStream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        mWriteStream.close();
+        if (mWriteStream.fail()) throw RuntimeError("Failed to finalize vertex cache file '{}'.", mPath.string());
+
+        mFinalized = true;
+    }
+
+    void VertexCacheFile::readChunk(uint32_t chunk, void* pData) const
+    {
+        FALCOR_ASSERT(mFinalized && chunk < mChunks.size());
+
+        // Reads from multiple threads share one stream. Chunks are large, so the lock is held for few, long reads.
+        std::lock_guard<std::mutex> lock(mReadMutex);
+        if (!mReadStream.is_open()) mReadStream.open(mPath, std::ios::binary);
+        mReadStream.clear();
+        mReadStream.seekg((std::streamoff)mChunks[chunk].offset);
+        mReadStream.read(reinterpret_cast<char*>(pData), (std::streamsize)mChunks[chunk].size);
+        if (!mReadStream) throw RuntimeError("Failed to read chunk {} of vertex cache file '{}'.", chunk, mPath.string());
+    }
+}
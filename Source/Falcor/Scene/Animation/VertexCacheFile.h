@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Seekable on-disk storage for vertex cache keyframes.
+
+        The file consists of a header, followed by a sequence of chunks that each hold the vertex data
+        of one keyframe, followed by a chunk table. Chunks can be written concurrently and in any order.
+        After the file is finalized, individual chunks can be read concurrently.
+
+        Chunks can also be read from a range of another file with a known layout (see openChunks()),
+        which is used to stream keyframes directly from the scene cache.
+    */
+    class FALCOR_API VertexCacheFile
+    {
+    public:
+        using SharedPtr = std::shared_ptr<VertexCacheFile>;
+
+        /** Location of a chunk in the file.
+        */
+        struct Chunk
+        {
+            uint64_t offset = 0;    ///< Offset from the start of the file in bytes.
+            uint64_t size = 0;      ///< Size in bytes.
+        };
+
+        /** Create a new file for writing.
+            \param[in] path File path. If empty, a temporary file is created and deleted when the object is destroyed.
+            \return A new object, throws on error.
+        */
+        static SharedPtr create(const std::filesystem::path& path = {});
+
+        /** Open a finalized file for reading.
+            \param[in] path File path.
+            \return A new object, throws on error.
+        */
+        static SharedPtr open(const std::filesystem::path& path);
+
+        /** Open chunks stored at known locations in an existing file for reading.
+            The file is not required to be a vertex cache file.
+            \param[in] path File path.
+            \param[in] chunks Chunk locations.
+            \return A new object, throws on error.
+        */
+        static SharedPtr openChunks(const std::filesystem::path& path, std::vector<Chunk> chunks);
+
+        ~VertexCacheFile();
+
+        /** Append a chunk. Thread-safe.
+            \param[in] pData Chunk data.
+            \param[in] size Chunk size in bytes.
+            \return Chunk index.
+        */
+        uint32_t writeChunk(const void* pData, size_t size);
+
+        template<typename T>
+        uint32_t writeChunk(const std::vector<T>& data) { return writeChunk(data.data(), data.size() * sizeof(T)); }
+
+        /** Write the chunk table and close the file for writing. No more chunks can be written afterwards.
+        */
+        void finalize();
+
+        /** Read a chunk. Thread-safe once the file is finalized.
+            \param[in] chunk Chunk index.
+            \param[out] pData Destination, must hold at least getChunkSize(chunk) bytes.
+        */
+        void readChunk(uint32_t chunk, void* pData) const;
+
+        template<typename T>
+        void readChunk(uint32_t chunk, std::vector<T>& data) const
+        {
+            data.resize(getChunkSize(chunk) / sizeof(T));
+            readChunk(chunk, data.data());
+        }
+
+        uint32_t getChunkCount() const { return (uint32_t)mChunks.size(); }
+        size_t getChunkSize(uint32_t chunk) const { return (size_t)mChunks[chunk].size; }
+        const std::filesystem::path& getPath() const { return mPath; }
+
+    private:
+        VertexCacheFile(const std::filesystem::path& path, bool temporary);
+
+        std::filesystem::path mPath;
+        bool mTemporary = false;
+        bool mFinalized = false;
+        std::vector<Chunk> mChunks;
+
+        std::mutex mWriteMutex;
+        std::ofstream mWriteStream;
+
+        mutable std::mutex mReadMutex;
+        mutable std::ifstream mReadStream;  ///< Stream used for all reads. Opened on first read.
+    };
+}
@@ -43,6 +43,8 @@ namespace Falcor
         const std::string kPosition = "position";
         const std::string kTarget = "target";
         const std::string kUp = "up";
+
+        constexpr ShaderVarName kData("data");
     }
 
     static_assert(sizeof(CameraData) % (sizeof(float4)) == 0, "CameraData size should be a multiple of 16");
@@ -272,7 +274,7 @@ namespace Falcor
     void Camera::setShaderData(const ShaderVar& var) const
     {
         calculateCameraParameters();
-        var["data"].setBlob(mData);
+        var[kData].setBlob(mData);
     }
 
     void Camera::setPatternGenerator(const CPUSampleGenerator::SharedPtr& pGenerator, const float2& scale)
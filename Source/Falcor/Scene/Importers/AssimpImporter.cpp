@@ -30,7 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
@@ -44,7 +44,6 @@
 #include <assimp/scene.h>
 #include <assimp/pbrmaterial.h>
 
-#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -541,8 +540,7 @@ namespace Falcor
 
             // Pre-process meshes.
             std::vector<SceneBuilder::ProcessedMesh> processedMeshes(meshes.size());
-            auto range = NumericRange<size_t>(0, meshes.size());
-            std::for_each(std::execution::par, range.begin(), range.end(), [&] (size_t i) {
+            Threading::parallelFor<size_t>(0, meshes.size(), [&] (size_t i) {
                 const aiMesh* pAiMesh = meshes[i];
                 const uint32_t perFaceIndexCount = pAiMesh->mFaces[0].mNumIndices;
 
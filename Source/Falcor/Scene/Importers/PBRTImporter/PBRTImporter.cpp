@@ -63,6 +63,7 @@
 #include "Builder.h"
 #include "Helpers.h"
 #include "LoopSubdivide.h"
+#include "PLYReader.h"
 #include "EnvMapConverter.h"
 #include "Core/Assert.h"
 #include "Core/Errors.h"
@@ -73,6 +74,7 @@
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
+#include "Utils/Threading.h"
 #include "Scene/Importer.h"
 #include "Scene/Material/Material.h"
 #include "Scene/Material/StandardMaterial.h"
@@ -86,6 +88,7 @@
 #include "Scene/Material/PBRT/PBRTDiffuseTransmissionMaterial.h"
 #include "Scene/Curves/CurveTessellation.h"
 
+#include <set>
 #include <unordered_map>
 
 namespace Falcor
@@ -212,6 +215,8 @@ namespace Falcor
 
             std::map<std::string, InstanceDefinition> instanceDefinitions;
 
+            std::unordered_map<const ShapeSceneEntity*, Falcor::TriangleMesh::SharedPtr> plyMeshes; ///< Triangle meshes of 'plymesh' shapes loaded in advance.
+
             size_t curveCount = 0;
 
             bool usePBRTMaterials = false;
@@ -248,7 +253,9 @@ namespace Falcor
 
             Resolver resolver = [this](const std::filesystem::path& path)
             {
-                return scene.resolvePath(path);
+                auto resolvedPath = scene.resolvePath(path);
+                builder.addDependency(resolvedPath);
+                return resolvedPath;
             };
         };
 
@@ -1358,6 +1365,14 @@ namespace Falcor
             }
         }
 
+        /** Load a PLY mesh through the per-asset mesh cache, keyed by the content of the file.
+            Throws if the mesh fails to load.
+        */
+        Falcor::TriangleMesh::SharedPtr loadCachedPLYMesh(BuilderContext& ctx, const std::filesystem::path& path)
+        {
+            return ctx.builder.getOrLoadCachedMesh(path, "PBRTImporter:plymesh:1", [&]() { return loadPLYMesh(path); });
+        }
+
         Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         {
             auto warnUnsupported = [&]() { warnUnsupportedType(entity.loc, "Shape", entity.name); };
@@ -1538,7 +1553,22 @@ namespace Falcor
                 auto filename = params.getString("filename", "");
                 auto path = ctx.resolver(filename);
 
-                shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path.string());
+                if (auto it = ctx.plyMeshes.find(&entity); it != ctx.plyMeshes.end())
+                {
+                    shape.pTriangleMesh = std::move(it->second);
+                    ctx.plyMeshes.erase(it);
+                }
+                else
+                {
+                    try
+                    {
+                        shape.pTriangleMesh = loadCachedPLYMesh(ctx, path);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        logWarning(entity.loc, "Failed to load triangle mesh: {}", e.what());
+                    }
+                }
                 if (shape.pTriangleMesh) shape.pTriangleMesh->setName(filename);
                 shape.transform = entity.transform;
             }
@@ -1556,17 +1586,29 @@ namespace Falcor
                 if (indices.empty()) throwError(entity.loc, "Missing vertex indices in 'indices'.");
                 if (P.empty()) throwError(entity.loc, "Missing vertex positions in 'P'.");
 
-                auto result = loopSubdivide(levels, P, fstd::span<const uint32_t>(reinterpret_cast<const uint32_t*>(indices.data()), indices.size()));
-                Falcor::TriangleMesh::VertexList vertexList(result.positions.size());
-                for (size_t i = 0; i < result.positions.size(); ++i)
+                auto createMesh = [&]()
                 {
-                    auto& vertex = vertexList[i];
-                    vertex.position = result.positions[i];
-                    vertex.normal = result.normals[i];
-                    vertex.texCoord = float3(0.f);
-                }
-
-                shape.pTriangleMesh = Falcor::TriangleMesh::create(vertexList, result.indices);
+                    auto result = loopSubdivide(levels, P, fstd::span<const uint32_t>(reinterpret_cast<const uint32_t*>(indices.data()), indices.size()));
+                    Falcor::TriangleMesh::VertexList vertexList(result.positions.size());
+                    for (size_t i = 0; i < result.positions.size(); ++i)
+                    {
+                        auto& vertex = vertexList[i];
+                        vertex.position = result.positions[i];
+                        vertex.normal = result.normals[i];
+                        vertex.texCoord = float3(0.f);
+                    }
+                    return Falcor::TriangleMesh::create(vertexList, result.indices);
+                };
+
+                // Subdivision is expensive, so the result is kept in the per-asset cache keyed by the input data.
+                SHA1 sha1;
+                const std::string kind = "PBRTImporter:loopsubdiv:1";
+                sha1.update(kind.data(), kind.size());
+                sha1.update(&levels, sizeof(levels));
+                sha1.update(indices.data(), indices.size() * sizeof(indices[0]));
+                sha1.update(P.data(), P.size() * sizeof(P[0]));
+
+                shape.pTriangleMesh = ctx.builder.getOrCreateCachedMesh(sha1.finalize(), createMesh);
                 shape.pTriangleMesh->setName("loopsubdiv");
                 shape.transform = entity.transform;
             }
@@ -1714,6 +1756,57 @@ namespace Falcor
             return instanceDefinition;
         }
 
+        /** Load the triangle meshes of all 'plymesh' shapes in parallel.
+            The meshes are stored in the context and picked up by createShape().
+        */
+        void loadPLYMeshes(BuilderContext& ctx)
+        {
+            std::vector<const ShapeSceneEntity*> entities;
+            auto addShapes = [&entities](const std::vector<ShapeSceneEntity>& shapes)
+            {
+                for (const auto& entity : shapes)
+                {
+                    if (entity.name == "plymesh") entities.push_back(&entity);
+                }
+            };
+
+            addShapes(ctx.scene.getShapes());
+
+            // Only consider instance definitions that are actually instantiated.
+            std::set<std::string> instancedNames;
+            for (const auto& entity : ctx.scene.getInstances()) instancedNames.insert(entity.name);
+            for (const auto& name : instancedNames)
+            {
+                auto it = ctx.scene.getInstanceDefinitions().find(name);
+                if (it != ctx.scene.getInstanceDefinitions().end()) addShapes(it->second.shapes);
+            }
+
+            if (entities.empty()) return;
+
+            std::vector<std::filesystem::path> paths(entities.size());
+            for (size_t i = 0; i < entities.size(); ++i) paths[i] = ctx.resolver(entities[i]->params.getString("filename", ""));
+
+            std::vector<Falcor::TriangleMesh::SharedPtr> meshes(entities.size());
+            std::vector<std::string> errors(entities.size());
+            Threading::parallelFor<size_t>(0, entities.size(), [&](size_t i)
+            {
+                try
+                {
+                    meshes[i] = loadCachedPLYMesh(ctx, paths[i]);
+                }
+                catch (const std::exception& e)
+                {
+                    errors[i] = e.what();
+                }
+            });
+
+            for (size_t i = 0; i < entities.size(); ++i)
+            {
+                if (!errors[i].empty()) logWarning(entities[i]->loc, "Failed to load triangle mesh: {}", errors[i]);
+                ctx.plyMeshes[entities[i]] = std::move(meshes[i]);
+            }
+        }
+
         void buildScene(BuilderContext& ctx)
         {
             // Load float textures.
@@ -1775,6 +1868,9 @@ namespace Falcor
                 }
             }
 
+            // Load PLY meshes in parallel.
+            loadPLYMeshes(ctx);
+
             // Process shapes and create meshes.
             for (const auto& entity : ctx.scene.getShapes())
             {
@@ -1856,7 +1952,7 @@ namespace Falcor
             TimeReport timeReport;
             pbrt::BasicScene pbrtScene(fullPath.parent_path());
             pbrt::BasicSceneBuilder pbrtBuilder(pbrtScene);
-            pbrt::parseFile(pbrtBuilder, fullPath);
+            pbrt::parseFile(pbrtBuilder, fullPath, [&builder](const std::filesystem::path& path) { builder.addDependency(path); });
             timeReport.measure("Parsing pbrt scene");
 
             pbrt::BuilderContext ctx { pbrtScene, builder };
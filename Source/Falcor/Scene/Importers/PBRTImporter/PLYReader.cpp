@@ -0,0 +1,634 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PLYReader.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/StringUtils.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+    namespace pbrt
+    {
+        namespace
+        {
+            const size_t kStreamChunkSize = 1 << 20;    ///< Size of the buffer compressed files are decompressed into.
+            const size_t kMaxInflateInputSize = 1 << 30; ///< Max number of compressed bytes passed to zlib at a time.
+
+            enum class PLYFormat
+            {
+                Ascii,
+                BinaryLittleEndian,
+                BinaryBigEndian,
+            };
+
+            enum class PLYType
+            {
+                Int8,
+                UInt8,
+                Int16,
+                UInt16,
+                Int32,
+                UInt32,
+                Float32,
+                Float64,
+            };
+
+            struct PLYProperty
+            {
+                std::string name;
+                PLYType type = PLYType::Float32;    ///< Value type (item type for list properties).
+                bool isList = false;                ///< True if this is a list property.
+                PLYType countType = PLYType::UInt8; ///< Type of the item count (list properties only).
+            };
+
+            struct PLYElement
+            {
+                std::string name;
+                size_t count = 0;
+                std::vector<PLYProperty> properties;
+            };
+
+            struct PLYHeader
+            {
+                PLYFormat format = PLYFormat::Ascii;
+                std::vector<PLYElement> elements;
+            };
+
+            size_t getTypeSize(PLYType type)
+            {
+                switch (type)
+                {
+                case PLYType::Int8:
+                case PLYType::UInt8:
+                    return 1;
+                case PLYType::Int16:
+                case PLYType::UInt16:
+                    return 2;
+                case PLYType::Int32:
+                case PLYType::UInt32:
+                case PLYType::Float32:
+                    return 4;
+                case PLYType::Float64:
+                    return 8;
+                default:
+                    FALCOR_UNREACHABLE();
+                    return 0;
+                }
+            }
+
+            std::optional<PLYType> parseType(std::string_view str)
+            {
+                if (str == "char" || str == "int8") return PLYType::Int8;
+                if (str == "uchar" || str == "uint8") return PLYType::UInt8;
+                if (str == "short" || str == "int16") return PLYType::Int16;
+                if (str == "ushort" || str == "uint16") return PLYType::UInt16;
+                if (str == "int" || str == "int32") return PLYType::Int32;
+                if (str == "uint" || str == "uint32") return PLYType::UInt32;
+                if (str == "float" || str == "float32") return PLYType::Float32;
+                if (str == "double" || str == "float64") return PLYType::Float64;
+                return {};
+            }
+
+            /** Load a value from unaligned memory, optionally swapping the byte order.
+            */
+            template<typename T>
+            T loadValue(const uint8_t* p, bool swapBytes)
+            {
+                uint8_t bytes[sizeof(T)];
+                std::memcpy(bytes, p, sizeof(T));
+                if (swapBytes) std::reverse(bytes, bytes + sizeof(T));
+                T value;
+                std::memcpy(&value, bytes, sizeof(T));
+                return value;
+            }
+
+            /** Load a value stored with the given PLY type and convert it to T.
+            */
+            template<typename T>
+            T loadValue(const uint8_t* p, PLYType type, bool swapBytes)
+            {
+                switch (type)
+                {
+                case PLYType::Int8:
+                    return (T)loadValue<int8_t>(p, swapBytes);
+                case PLYType::UInt8:
+                    return (T)loadValue<uint8_t>(p, swapBytes);
+                case PLYType::Int16:
+                    return (T)loadValue<int16_t>(p, swapBytes);
+                case PLYType::UInt16:
+                    return (T)loadValue<uint16_t>(p, swapBytes);
+                case PLYType::Int32:
+                    return (T)loadValue<int32_t>(p, swapBytes);
+                case PLYType::UInt32:
+                    return (T)loadValue<uint32_t>(p, swapBytes);
+                case PLYType::Float32:
+                    return (T)loadValue<float>(p, swapBytes);
+                case PLYType::Float64:
+                    return (T)loadValue<double>(p, swapBytes);
+                default:
+                    FALCOR_UNREACHABLE();
+                    return T(0);
+                }
+            }
+
+            /** Byte stream over a PLY file.
+                Uncompressed files are read directly from a memory mapping.
+                Compressed files are memory mapped and decompressed into a fixed size buffer in chunks.
+            */
+            class PLYStream
+            {
+            public:
+                PLYStream(const std::filesystem::path& path)
+                    : mPath(path)
+                {
+                    if (!mFile.open(path, MemoryMappedFile::AccessHint::SequentialScan))
+                    {
+                        throw RuntimeError("Failed to open PLY file '{}'.", path);
+                    }
+
+                    const uint8_t* pData = static_cast<const uint8_t*>(mFile.getData());
+                    if (hasExtension(path, "gz"))
+                    {
+                        // MAX_WBITS | 32 to support both zlib or gzip files.
+                        if (inflateInit2(&mZStream, MAX_WBITS | 32) != Z_OK) throw RuntimeError("inflateInit2 failed while decompressing.");
+                        mCompressed = true;
+                        mBuffer.resize(kStreamChunkSize);
+                        mPos = mEnd = mBuffer.data();
+                    }
+                    else
+                    {
+                        mPos = pData;
+                        mEnd = pData + mFile.getSize();
+                    }
+                }
+
+                ~PLYStream()
+                {
+                    if (mCompressed) inflateEnd(&mZStream);
+                }
+
+                PLYStream(const PLYStream&) = delete;
+                PLYStream& operator=(const PLYStream&) = delete;
+
+                const std::filesystem::path& getPath() const { return mPath; }
+
+                /** Get a pointer to at least 'size' contiguous bytes at the current position.
+                    The pointer is valid until the next call to request() or readLine().
+                    \return Returns a pointer to the data or nullptr if the stream ends before 'size' bytes are available.
+                */
+                const uint8_t* request(size_t size)
+                {
+                    if ((size_t)(mEnd - mPos) >= size) return mPos;
+                    return refill(size) ? mPos : nullptr;
+                }
+
+                /** Advance the current position. The bytes must have been requested before.
+                */
+                void consume(size_t size)
+                {
+                    FALCOR_ASSERT(size <= (size_t)(mEnd - mPos));
+                    mPos += size;
+                }
+
+                /** Read a line of text, excluding the line break.
+                    \return Returns false if the stream ended before a line break was found.
+                */
+                bool readLine(std::string& line)
+                {
+                    size_t offset = 0;
+                    while (true)
+                    {
+                        size_t available = mEnd - mPos;
+                        const void* pNewline = offset < available ? std::memchr(mPos + offset, '\n', available - offset) : nullptr;
+                        if (pNewline)
+                        {
+                            const uint8_t* pLineEnd = static_cast<const uint8_t*>(pNewline);
+                            line.assign(reinterpret_cast<const char*>(mPos), pLineEnd - mPos);
+                            if (!line.empty() && line.back() == '\r') line.pop_back();
+                            mPos = pLineEnd + 1;
+                            return true;
+                        }
+                        offset = available;
+                        if (!refill(available + 1)) return false;
+                    }
+                }
+
+            private:
+                /** Decompress more data such that at least 'size' bytes are available.
+                    Unconsumed data is moved to the start of the buffer.
+                */
+                bool refill(size_t size)
+                {
+                    if (!mCompressed) return false;
+
+                    size_t remaining = mEnd - mPos;
+                    std::memmove(mBuffer.data(), mPos, remaining);
+                    if (size > mBuffer.size()) mBuffer.resize(size);
+
+                    while (remaining < size && !mStreamEnd)
+                    {
+                        if (mZStream.avail_in == 0)
+                        {
+                            size_t inputSize = std::min(mFile.getSize() - mInputOffset, kMaxInflateInputSize);
+                            if (inputSize == 0) break;
+                            mZStream.next_in = const_cast<Bytef*>(static_cast<const Bytef*>(mFile.getData()) + mInputOffset);
+                            mZStream.avail_in = (uInt)inputSize;
+                            mInputOffset += inputSize;
+                        }
+
+                        mZStream.next_out = reinterpret_cast<Bytef*>(mBuffer.data() + remaining);
+                        mZStream.avail_out = (uInt)(mBuffer.size() - remaining);
+
+                        int ret = inflate(&mZStream, Z_NO_FLUSH);
+                        remaining = mBuffer.size() - mZStream.avail_out;
+
+                        if (ret == Z_STREAM_END) mStreamEnd = true;
+                        else if (ret != Z_OK) throw RuntimeError("Failure to decompress file '{}' (error: {}).", mPath, ret);
+                    }
+
+                    mPos = mBuffer.data();
+                    mEnd = mPos + remaining;
+                    return remaining >= size;
+                }
+
+                std::filesystem::path mPath;
+                MemoryMappedFile mFile;
+
+                const uint8_t* mPos = nullptr;  ///< Current position.
+                const uint8_t* mEnd = nullptr;  ///< End of the currently available data (one past).
+
+                bool mCompressed = false;
+                bool mStreamEnd = false;
+                z_stream mZStream = {};
+                size_t mInputOffset = 0;        ///< Offset of the next compressed bytes to pass to zlib.
+                std::vector<uint8_t> mBuffer;   ///< Buffer holding decompressed data.
+            };
+
+            PLYHeader readHeader(PLYStream& stream)
+            {
+                const auto& path = stream.getPath();
+
+                std::string line;
+                if (!stream.readLine(line) || line != "ply") throw RuntimeError("'{}' is not a PLY file.", path);
+
+                PLYHeader header;
+                bool hasFormat = false;
+
+                while (true)
+                {
+                    if (!stream.readLine(line)) throw RuntimeError("Unexpected end of PLY header in '{}'.", path);
+
+                    auto tokens = splitString(line, " \t");
+                    if (tokens.empty()) continue;
+
+                    auto invalidLine = [&]() { throw RuntimeError("Invalid line '{}' in PLY header of '{}'.", line, path); };
+
+                    if (tokens[0] == "end_header")
+                    {
+                        break;
+                    }
+                    else if (tokens[0] == "comment" || tokens[0] == "obj_info")
+                    {
+                        continue;
+                    }
+                    else if (tokens[0] == "format")
+                    {
+                        if (tokens.size() != 3) invalidLine();
+                        if (tokens[1] == "ascii") header.format = PLYFormat::Ascii;
+                        else if (tokens[1] == "binary_little_endian") header.format = PLYFormat::BinaryLittleEndian;
+                        else if (tokens[1] == "binary_big_endian") header.format = PLYFormat::BinaryBigEndian;
+                        else invalidLine();
+                        hasFormat = true;
+                    }
+                    else if (tokens[0] == "element")
+                    {
+                        if (tokens.size() != 3) invalidLine();
+                        PLYElement element;
+                        element.name = tokens[1];
+                        try
+                        {
+                            element.count = std::stoull(tokens[2]);
+                        }
+                        catch (const std::exception&)
+                        {
+                            invalidLine();
+                        }
+                        header.elements.push_back(std::move(element));
+                    }
+                    else if (tokens[0] == "property")
+                    {
+                        if (header.elements.empty()) invalidLine();
+                        PLYProperty property;
+                        if (tokens.size() == 5 && tokens[1] == "list")
+                        {
+                            auto countType = parseType(tokens[2]);
+                            auto type = parseType(tokens[3]);
+                            if (!countType || !type) invalidLine();
+                            property.isList = true;
+                            property.countType = *countType;
+                            property.type = *type;
+                            property.name = tokens[4];
+                        }
+                        else if (tokens.size() == 3)
+                        {
+                            auto type = parseType(tokens[1]);
+                            if (!type) invalidLine();
+                            property.type = *type;
+                            property.name = tokens[2];
+                        }
+                        else
+                        {
+                            invalidLine();
+                        }
+                        header.elements.back().properties.push_back(std::move(property));
+                    }
+                    else
+                    {
+                        invalidLine();
+                    }
+                }
+
+                if (!hasFormat) throw RuntimeError("Missing format in PLY header of '{}'.", path);
+
+                return header;
+            }
+
+            class PLYMeshReader
+            {
+            public:
+                PLYMeshReader(PLYStream& stream, PLYFormat format)
+                    : mStream(stream)
+                    // Note: Falcor only supports little-endian platforms.
+                    , mSwapBytes(format == PLYFormat::BinaryBigEndian)
+                {}
+
+                void readElement(const PLYElement& element)
+                {
+                    if (element.name == "vertex") readVertices(element);
+                    else if (element.name == "face") readFaces(element);
+                    else skipElement(element);
+                }
+
+                Falcor::TriangleMesh::SharedPtr createMesh()
+                {
+                    for (uint32_t index : mIndices)
+                    {
+                        if (index >= mVertices.size()) throw RuntimeError("Vertex index {} is out of bounds in PLY file '{}'.", index, mStream.getPath());
+                    }
+
+                    if (!mHasNormals) createFlatShadedVertices();
+
+                    return Falcor::TriangleMesh::create(std::move(mVertices), std::move(mIndices));
+                }
+
+            private:
+                template<typename T>
+                T readScalar(PLYType type)
+                {
+                    size_t size = getTypeSize(type);
+                    const uint8_t* p = mStream.request(size);
+                    if (!p) throwUnexpectedEnd();
+                    T value = loadValue<T>(p, type, mSwapBytes);
+                    mStream.consume(size);
+                    return value;
+                }
+
+                const uint8_t* requestBytes(size_t size)
+                {
+                    const uint8_t* p = mStream.request(size);
+                    if (!p) throwUnexpectedEnd();
+                    return p;
+                }
+
+                void skipProperty(const PLYProperty& property)
+                {
+                    size_t size = getTypeSize(property.type);
+                    if (property.isList) size *= readScalar<uint32_t>(property.countType);
+                    requestBytes(size);
+                    mStream.consume(size);
+                }
+
+                void skipElement(const PLYElement& element)
+                {
+                    for (size_t i = 0; i < element.count; ++i)
+                    {
+                        for (const auto& property : element.properties) skipProperty(property);
+                    }
+                }
+
+                void readVertices(const PLYElement& element)
+                {
+                    // Map properties to components of the vertex attributes (position, normal, texCoord).
+                    const int kSkip = -1;
+                    std::vector<int> slots(element.properties.size(), kSkip);
+                    uint32_t foundMask = 0;
+                    bool hasList = false;
+                    for (size_t i = 0; i < element.properties.size(); ++i)
+                    {
+                        const auto& property = element.properties[i];
+                        const auto& name = property.name;
+                        hasList |= property.isList;
+                        if (property.isList) continue;
+                        int slot = kSkip;
+                        if (name == "x") slot = 0;
+                        else if (name == "y") slot = 1;
+                        else if (name == "z") slot = 2;
+                        else if (name == "nx") slot = 3;
+                        else if (name == "ny") slot = 4;
+                        else if (name == "nz") slot = 5;
+                        else if (name == "u" || name == "s" || name == "texture_u" || name == "texture_s") slot = 6;
+                        else if (name == "v" || name == "t" || name == "texture_v" || name == "texture_t") slot = 7;
+                        if (slot != kSkip && (foundMask & (1u << slot)) == 0)
+                        {
+                            slots[i] = slot;
+                            foundMask |= 1u << slot;
+                        }
+                    }
+
+                    if ((foundMask & 0x07) != 0x07) throw RuntimeError("PLY file '{}' is missing vertex positions.", mStream.getPath());
+                    mHasNormals = (foundMask & 0x38) == 0x38;
+                    bool hasTexCoords = (foundMask & 0xc0) == 0xc0;
+
+                    mVertices.resize(element.count);
+
+                    auto storeVertex = [&](size_t index, const float values[8])
+                    {
+                        auto& vertex = mVertices[index];
+                        vertex.position = float3(values[0], values[1], values[2]);
+                        vertex.normal = mHasNormals ? float3(values[3], values[4], values[5]) : float3(0.f);
+                        // Flip texture coordinates to match the convention used by TriangleMesh::createFromFile().
+                        vertex.texCoord = hasTexCoords ? float2(values[6], 1.f - values[7]) : float2(0.f);
+                    };
+
+                    float values[8] = {};
+
+                    if (!hasList)
+                    {
+                        // Fast path: All vertices have the same size, decode directly from the stream.
+                        std::vector<size_t> offsets(element.properties.size());
+                        size_t stride = 0;
+                        for (size_t i = 0; i < element.properties.size(); ++i)
+                        {
+                            offsets[i] = stride;
+                            stride += getTypeSize(element.properties[i].type);
+                        }
+
+                        for (size_t v = 0; v < element.count; ++v)
+                        {
+                            const uint8_t* p = requestBytes(stride);
+                            for (size_t i = 0; i < element.properties.size(); ++i)
+                            {
+                                if (slots[i] != kSkip) values[slots[i]] = loadValue<float>(p + offsets[i], element.properties[i].type, mSwapBytes);
+                            }
+                            mStream.consume(stride);
+                            storeVertex(v, values);
+                        }
+                    }
+                    else
+                    {
+                        for (size_t v = 0; v < element.count; ++v)
+                        {
+                            for (size_t i = 0; i < element.properties.size(); ++i)
+                            {
+                                if (slots[i] != kSkip) values[slots[i]] = readScalar<float>(element.properties[i].type);
+                                else skipProperty(element.properties[i]);
+                            }
+                            storeVertex(v, values);
+                        }
+                    }
+                }
+
+                void readFaces(const PLYElement& element)
+                {
+                    auto it = std::find_if(element.properties.begin(), element.properties.end(), [](const PLYProperty& property)
+                    {
+                        return property.isList && (property.name == "vertex_indices" || property.name == "vertex_index");
+                    });
+                    if (it == element.properties.end()) throw RuntimeError("PLY file '{}' is missing face vertex indices.", mStream.getPath());
+                    const PLYProperty& indexProperty = *it;
+                    const size_t indexSize = getTypeSize(indexProperty.type);
+
+                    mIndices.reserve(mIndices.size() + element.count * 3);
+
+                    for (size_t f = 0; f < element.count; ++f)
+                    {
+                        for (const auto& property : element.properties)
+                        {
+                            if (&property != &indexProperty)
+                            {
+                                skipProperty(property);
+                                continue;
+                            }
+
+                            // Triangulate polygons as triangle fans (quads are split into triangles (0,1,2) and (0,2,3)).
+                            uint32_t count = readScalar<uint32_t>(property.countType);
+                            const uint8_t* p = requestBytes(count * indexSize);
+                            if (count >= 3)
+                            {
+                                uint32_t i0 = loadValue<uint32_t>(p, property.type, mSwapBytes);
+                                uint32_t i1 = loadValue<uint32_t>(p + indexSize, property.type, mSwapBytes);
+                                for (uint32_t k = 2; k < count; ++k)
+                                {
+                                    uint32_t i2 = loadValue<uint32_t>(p + k * indexSize, property.type, mSwapBytes);
+                                    mIndices.push_back(i0);
+                                    mIndices.push_back(i1);
+                                    mIndices.push_back(i2);
+                                    i1 = i2;
+                                }
+                            }
+                            mStream.consume(count * indexSize);
+                        }
+                    }
+                }
+
+                /** Create unindexed vertices with face normals, similar to aiProcess_GenNormals.
+                */
+                void createFlatShadedVertices()
+                {
+                    Falcor::TriangleMesh::VertexList vertices(mIndices.size());
+                    for (size_t i = 0; i < mIndices.size(); i += 3)
+                    {
+                        const auto& v0 = mVertices[mIndices[i]];
+                        const auto& v1 = mVertices[mIndices[i + 1]];
+                        const auto& v2 = mVertices[mIndices[i + 2]];
+                        float3 normal = glm::cross(v1.position - v0.position, v2.position - v0.position);
+                        float len = glm::length(normal);
+                        normal = len > 0.f ? normal / len : float3(0.f);
+                        for (size_t j = 0; j < 3; ++j)
+                        {
+                            vertices[i + j] = mVertices[mIndices[i + j]];
+                            vertices[i + j].normal = normal;
+                            mIndices[i + j] = (uint32_t)(i + j);
+                        }
+                    }
+                    mVertices = std::move(vertices);
+                }
+
+                [[noreturn]] void throwUnexpectedEnd() const
+                {
+                    throw RuntimeError("Unexpected end of PLY file '{}'.", mStream.getPath());
+                }
+
+                PLYStream& mStream;
+                bool mSwapBytes;
+                bool mHasNormals = false;
+                Falcor::TriangleMesh::VertexList mVertices;
+                Falcor::TriangleMesh::IndexList mIndices;
+            };
+        }
+
+        Falcor::TriangleMesh::SharedPtr loadPLYMesh(const std::filesystem::path& path)
+        {
+            PLYStream stream(path);
+            PLYHeader header = readHeader(stream);
+
+            if (header.format == PLYFormat::Ascii)
+            {
+                auto pTriangleMesh = Falcor::TriangleMesh::createFromFile(path);
+                if (!pTriangleMesh) throw RuntimeError("Failed to load PLY file '{}'.", path);
+                return pTriangleMesh;
+            }
+
+            PLYMeshReader reader(stream, header.format);
+            for (const auto& element : header.elements) reader.readElement(element);
+            return reader.createMesh();
+        }
+    }
+}
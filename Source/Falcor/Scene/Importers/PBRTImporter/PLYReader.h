@@ -0,0 +1,48 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Scene/TriangleMesh.h"
+#include <filesystem>
+
+namespace Falcor
+{
+    namespace pbrt
+    {
+        /** Load a triangle mesh from a PLY file.
+            Binary (little or big-endian) files are memory mapped and compressed files (.ply.gz) are decompressed
+            in a streaming fashion. Vertex positions, normals and texture coordinates are decoded directly into the
+            vertex list of the triangle mesh. Quads and polygons are triangulated as triangle fans.
+            If the file does not contain vertex normals, the mesh is flat shaded.
+            ASCII files are loaded using TriangleMesh::createFromFile().
+            This function is thread-safe and can be used to load multiple files in parallel.
+            \param[in] path File path.
+            \return Returns the triangle mesh. Throws a RuntimeError if the file could not be loaded.
+        */
+        FALCOR_API Falcor::TriangleMesh::SharedPtr loadPLYMesh(const std::filesystem::path& path);
+    }
+}
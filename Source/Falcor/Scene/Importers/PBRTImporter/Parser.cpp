@@ -36,9 +36,12 @@
 #include "Core/Assert.h"
 #include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 
 #include <fast_float/fast_float.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <charconv>
 
@@ -95,8 +98,12 @@ namespace Falcor
             }
             else
             {
-                std::string str = readFile(path);
-                return std::make_unique<Tokenizer>(std::move(str), path);
+                auto pMappedFile = std::make_unique<MemoryMappedFile>();
+                if (!pMappedFile->open(path, MemoryMappedFile::AccessHint::SequentialScan))
+                {
+                    throwError("Failed to read from file '{}'.", path);
+                }
+                return std::make_unique<Tokenizer>(std::move(pMappedFile), path);
             }
         }
 
@@ -109,13 +116,29 @@ namespace Falcor
             : mPath(path)
             , mContents(std::move(str))
         {
-            auto pFilename = std::make_unique<std::string>(path.string());
+            init(mContents.data(), mContents.size());
+        }
+
+        Tokenizer::Tokenizer(std::unique_ptr<MemoryMappedFile> pMappedFile, const std::filesystem::path& path)
+            : mPath(path)
+            , mpMappedFile(std::move(pMappedFile))
+        {
+            FALCOR_ASSERT(mpMappedFile && mpMappedFile->isOpen());
+            init(static_cast<const char*>(mpMappedFile->getData()), mpMappedFile->getSize());
+        }
+
+        void Tokenizer::init(const char* pData, size_t size)
+        {
+            auto pFilename = std::make_unique<std::string>(mPath.string());
             mLoc = FileLoc(*pFilename);
-            getFilenames().push_back(std::move(pFilename));
+            {
+                std::lock_guard<std::mutex> lock(getFilenamesMutex());
+                getFilenames().push_back(std::move(pFilename));
+            }
 
-            mPos = mContents.data();
-            mEnd = mPos + mContents.size();
-            if (isUTF16(mContents.data(), mContents.size())) throwError("File is encoded with UTF-16, which is not currently supported.");
+            mPos = pData;
+            mEnd = mPos + size;
+            if (isUTF16(pData, size)) throwError("File is encoded with UTF-16, which is not currently supported.");
         }
 
         bool Tokenizer::isUTF16(const void* ptr, size_t len) const
@@ -434,17 +457,123 @@ namespace Falcor
             return parameterVector;
         }
 
-        void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
+        /** Parser target that records all callbacks so that they can be replayed into another target later.
+            This is used to parse files referenced by 'Import' directives concurrently with other files.
+        */
+        class RecordingTarget : public ParserTarget
+        {
+        public:
+            void replay(ParserTarget& target)
+            {
+                for (auto& command : mCommands) command(target);
+                mCommands.clear();
+            }
+
+            void onScale(Float sx, Float sy, Float sz, FileLoc loc) override { record([=](ParserTarget& t) { t.onScale(sx, sy, sz, loc); }); }
+            void onShape(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onShape, name, std::move(params), loc); }
+
+            void onOption(const std::string& name, const std::string& value, FileLoc loc) override { record([=](ParserTarget& t) { t.onOption(name, value, loc); }); }
+
+            void onIdentity(FileLoc loc) override { record([=](ParserTarget& t) { t.onIdentity(loc); }); }
+            void onTranslate(Float dx, Float dy, Float dz, FileLoc loc) override { record([=](ParserTarget& t) { t.onTranslate(dx, dy, dz, loc); }); }
+            void onRotate(Float angle, Float ax, Float ay, Float az, FileLoc loc) override { record([=](ParserTarget& t) { t.onRotate(angle, ax, ay, az, loc); }); }
+            void onLookAt(Float ex, Float ey, Float ez, Float lx, Float ly, Float lz, Float ux, Float uy, Float uz, FileLoc loc) override
+            {
+                record([=](ParserTarget& t) { t.onLookAt(ex, ey, ez, lx, ly, lz, ux, uy, uz, loc); });
+            }
+            void onConcatTransform(Float transform[16], FileLoc loc) override
+            {
+                record([m = toArray(transform), loc](ParserTarget& t) mutable { t.onConcatTransform(m.data(), loc); });
+            }
+            void onTransform(Float transform[16], FileLoc loc) override
+            {
+                record([m = toArray(transform), loc](ParserTarget& t) mutable { t.onTransform(m.data(), loc); });
+            }
+            void onCoordinateSystem(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onCoordinateSystem(name, loc); }); }
+            void onCoordSysTransform(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onCoordSysTransform(name, loc); }); }
+            void onActiveTransformAll(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformAll(loc); }); }
+            void onActiveTransformEndTime(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformEndTime(loc); }); }
+            void onActiveTransformStartTime(FileLoc loc) override { record([=](ParserTarget& t) { t.onActiveTransformStartTime(loc); }); }
+            void onTransformTimes(Float start, Float end, FileLoc loc) override { record([=](ParserTarget& t) { t.onTransformTimes(start, end, loc); }); }
+
+            void onColorSpace(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onColorSpace(name, loc); }); }
+            void onPixelFilter(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onPixelFilter, name, std::move(params), loc); }
+            void onFilm(const std::string& type, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onFilm, type, std::move(params), loc); }
+            void onAccelerator(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onAccelerator, name, std::move(params), loc); }
+            void onIntegrator(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onIntegrator, name, std::move(params), loc); }
+            void onCamera(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onCamera, name, std::move(params), loc); }
+            void onMakeNamedMedium(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onMakeNamedMedium, name, std::move(params), loc); }
+            void onMediumInterface(const std::string& insideName, const std::string& outsideName, FileLoc loc) override
+            {
+                record([=](ParserTarget& t) { t.onMediumInterface(insideName, outsideName, loc); });
+            }
+            void onSampler(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onSampler, name, std::move(params), loc); }
+
+            void onWorldBegin(FileLoc loc) override { record([=](ParserTarget& t) { t.onWorldBegin(loc); }); }
+            void onAttributeBegin(FileLoc loc) override { record([=](ParserTarget& t) { t.onAttributeBegin(loc); }); }
+            void onAttributeEnd(FileLoc loc) override { record([=](ParserTarget& t) { t.onAttributeEnd(loc); }); }
+            void onAttribute(const std::string& target, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onAttribute, target, std::move(params), loc); }
+            void onTexture(const std::string& name, const std::string& type, const std::string& texname, ParsedParameterVector params, FileLoc loc) override
+            {
+                record([=, params = std::move(params)](ParserTarget& t) mutable { t.onTexture(name, type, texname, std::move(params), loc); });
+            }
+            void onMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onMaterial, name, std::move(params), loc); }
+            void onMakeNamedMaterial(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onMakeNamedMaterial, name, std::move(params), loc); }
+            void onNamedMaterial(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onNamedMaterial(name, loc); }); }
+            void onLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onLightSource, name, std::move(params), loc); }
+            void onAreaLightSource(const std::string& name, ParsedParameterVector params, FileLoc loc) override { recordParamList(&ParserTarget::onAreaLightSource, name, std::move(params), loc); }
+            void onReverseOrientation(FileLoc loc) override { record([=](ParserTarget& t) { t.onReverseOrientation(loc); }); }
+            void onObjectBegin(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onObjectBegin(name, loc); }); }
+            void onObjectEnd(FileLoc loc) override { record([=](ParserTarget& t) { t.onObjectEnd(loc); }); }
+            void onObjectInstance(const std::string& name, FileLoc loc) override { record([=](ParserTarget& t) { t.onObjectInstance(name, loc); }); }
+
+            void onEndOfFiles() override { FALCOR_UNREACHABLE(); }
+
+        private:
+            using ParamListFunc = void (ParserTarget::*)(const std::string&, ParsedParameterVector, FileLoc);
+
+            template<typename Func>
+            void record(Func&& func) { mCommands.emplace_back(std::forward<Func>(func)); }
+
+            void recordParamList(ParamListFunc apiFunc, const std::string& name, ParsedParameterVector params, FileLoc loc)
+            {
+                record([=, params = std::move(params)](ParserTarget& t) mutable { (t.*apiFunc)(name, std::move(params), loc); });
+            }
+
+            static std::array<Float, 16> toArray(const Float m[16])
+            {
+                std::array<Float, 16> a;
+                std::copy(m, m + 16, a.begin());
+                return a;
+            }
+
+            std::vector<std::function<void(ParserTarget&)>> mCommands;
+        };
+
+        static void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer, const std::filesystem::path& searchPath, const FileCallback& onFile)
         {
             static std::atomic<bool> warnedTransformBeginEndDeprecated{false};
 
             logInfo("PBRTImporter: Started parsing '{}'.", tokenizer->getPath().string());
 
-            auto searchPath = tokenizer->getPath().parent_path();
-
             std::vector<std::unique_ptr<Tokenizer>> fileStack;
             fileStack.push_back(std::move(tokenizer));
 
+            /** Files referenced by 'Import' directives are parsed concurrently once the current file stack is exhausted.
+                Everything following an 'Import' directive is recorded into a separate buffer, so that all callbacks
+                can be replayed into the target in the order of the directives, independent of thread scheduling.
+            */
+            struct ImportedFile
+            {
+                std::filesystem::path path;
+                FileLoc loc;
+                RecordingTarget importTarget;       ///< Callbacks from parsing the imported file.
+                RecordingTarget continuationTarget; ///< Callbacks following the 'Import' directive.
+            };
+            std::vector<std::unique_ptr<ImportedFile>> importedFiles;
+
+            ParserTarget* pTarget = &target;
+
             std::optional<Token> ungetToken;
 
             /** Helper function that handles the file stack, returning the next token from
@@ -500,7 +629,7 @@ namespace Falcor
                 std::string_view dequoted = dequoteString(t);
                 std::string n = toString(dequoted);
                 ParsedParameterVector parameterVector = parseParameters(nextToken, unget);
-                (target.*apiFunc)(n, std::move(parameterVector), loc);
+                (pTarget->*apiFunc)(n, std::move(parameterVector), loc);
             };
 
             auto syntaxError = [&](const Token& t)
@@ -527,11 +656,11 @@ namespace Falcor
                 case 'A':
                     if (tok->token == "AttributeBegin")
                     {
-                        target.onAttributeBegin(tok->loc);
+                        pTarget->onAttributeBegin(tok->loc);
                     }
                     else if (tok->token == "AttributeEnd")
                     {
-                        target.onAttributeEnd(tok->loc);
+                        pTarget->onAttributeEnd(tok->loc);
                     }
                     else if (tok->token == "Attribute")
                     {
@@ -540,9 +669,9 @@ namespace Falcor
                     else if (tok->token == "ActiveTransform")
                     {
                         Token a = *nextToken(TokenRequired);
-                        if (a.token == "All") target.onActiveTransformAll(tok->loc);
-                        else if (a.token == "EndTime") target.onActiveTransformEndTime(tok->loc);
-                        else if (a.token == "StartTime") target.onActiveTransformStartTime(tok->loc);
+                        if (a.token == "All") pTarget->onActiveTransformAll(tok->loc);
+                        else if (a.token == "EndTime") pTarget->onActiveTransformEndTime(tok->loc);
+                        else if (a.token == "StartTime") pTarget->onActiveTransformStartTime(tok->loc);
                         else syntaxError(*tok);
                     }
                     else if (tok->token == "AreaLightSource")
@@ -566,22 +695,22 @@ namespace Falcor
                         Float m[16];
                         for (int i = 0; i < 16; ++i) m[i] = parseFloat(*nextToken(TokenRequired));
                         if (nextToken(TokenRequired)->token != "]") syntaxError(*tok);
-                        target.onConcatTransform(m, tok->loc);
+                        pTarget->onConcatTransform(m, tok->loc);
                     }
                     else if (tok->token == "CoordinateSystem")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onCoordinateSystem(toString(n), tok->loc);
+                        pTarget->onCoordinateSystem(toString(n), tok->loc);
                     }
                     else if (tok->token == "CoordSysTransform")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onCoordSysTransform(toString(n), tok->loc);
+                        pTarget->onCoordSysTransform(toString(n), tok->loc);
                     }
                     else if (tok->token == "ColorSpace")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onColorSpace(toString(n), tok->loc);
+                        pTarget->onColorSpace(toString(n), tok->loc);
                     }
                     else if (tok->token == "Camera")
                     {
@@ -614,17 +743,24 @@ namespace Falcor
                         Token filenameToken = *nextToken(TokenRequired);
                         std::string filename = toString(dequoteString(filenameToken));
                         auto path = searchPath / filename;
+                        if (onFile) onFile(path);
                         std::unique_ptr<Tokenizer> includeTokenizer = Tokenizer::createFromFile(path);
                         logInfo("PBRTImporter: Started parsing '{}'.", includeTokenizer->getPath().string());
                         fileStack.push_back(std::move(includeTokenizer));
                     }
                     else if (tok->token == "Import")
                     {
-                        throwError(tok->loc, "'Import' directive not supported yet.");
+                        Token filenameToken = *nextToken(TokenRequired);
+                        std::string filename = toString(dequoteString(filenameToken));
+                        auto pImportedFile = std::make_unique<ImportedFile>();
+                        pImportedFile->path = searchPath / filename;
+                        pImportedFile->loc = tok->loc;
+                        pTarget = &pImportedFile->continuationTarget;
+                        importedFiles.push_back(std::move(pImportedFile));
                     }
                     else if (tok->token == "Identity")
                     {
-                        target.onIdentity(tok->loc);
+                        pTarget->onIdentity(tok->loc);
                     }
                     else
                     {
@@ -642,7 +778,7 @@ namespace Falcor
                         Float v[9];
                         for (int i = 0; i < 9; ++i)
                             v[i] = parseFloat(*nextToken(TokenRequired));
-                        target.onLookAt(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
+                        pTarget->onLookAt(v[0], v[1], v[2], v[3], v[4], v[5], v[6], v[7], v[8],
                                     tok->loc);
                     }
                     else
@@ -682,7 +818,7 @@ namespace Falcor
                         } else
                             names[1] = names[0];
 
-                        target.onMediumInterface(names[0], names[1], tok->loc);
+                        pTarget->onMediumInterface(names[0], names[1], tok->loc);
                     }
                     else
                     {
@@ -694,7 +830,7 @@ namespace Falcor
                     if (tok->token == "NamedMaterial")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onNamedMaterial(toString(n), tok->loc);
+                        pTarget->onNamedMaterial(toString(n), tok->loc);
                     }
                     else
                     {
@@ -706,22 +842,22 @@ namespace Falcor
                     if (tok->token == "ObjectBegin")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onObjectBegin(toString(n), tok->loc);
+                        pTarget->onObjectBegin(toString(n), tok->loc);
                     }
                     else if (tok->token == "ObjectEnd")
                     {
-                        target.onObjectEnd(tok->loc);
+                        pTarget->onObjectEnd(tok->loc);
                     }
                     else if (tok->token == "ObjectInstance")
                     {
                         std::string_view n = dequoteString(*nextToken(TokenRequired));
-                        target.onObjectInstance(toString(n), tok->loc);
+                        pTarget->onObjectInstance(toString(n), tok->loc);
                     }
                     else if (tok->token == "Option")
                     {
                         std::string name = toString(dequoteString(*nextToken(TokenRequired)));
                         std::string value = toString(nextToken(TokenRequired)->token);
-                        target.onOption(name, value, tok->loc);
+                        pTarget->onOption(name, value, tok->loc);
                     }
                     else
                     {
@@ -743,13 +879,13 @@ namespace Falcor
                 case 'R':
                     if (tok->token == "ReverseOrientation")
                     {
-                        target.onReverseOrientation(tok->loc);
+                        pTarget->onReverseOrientation(tok->loc);
                     }
                     else if (tok->token == "Rotate")
                     {
                         Float v[4];
                         for (int i = 0; i < 4; ++i) v[i] = parseFloat(*nextToken(TokenRequired));
-                        target.onRotate(v[0], v[1], v[2], v[3], tok->loc);
+                        pTarget->onRotate(v[0], v[1], v[2], v[3], tok->loc);
                     }
                     else
                     {
@@ -770,7 +906,7 @@ namespace Falcor
                     {
                         Float v[3];
                         for (int i = 0; i < 3; ++i) v[i] = parseFloat(*nextToken(TokenRequired));
-                        target.onScale(v[0], v[1], v[2], tok->loc);
+                        pTarget->onScale(v[0], v[1], v[2], tok->loc);
                     }
                     else
                     {
@@ -786,11 +922,11 @@ namespace Falcor
                             logWarning(tok->loc, "TransformBegin/End are deprecated and should be replaced with AttributeBegin/End.");
                             warnedTransformBeginEndDeprecated = true;
                         }
-                        target.onAttributeBegin(tok->loc);
+                        pTarget->onAttributeBegin(tok->loc);
                     }
                     else if (tok->token == "TransformEnd")
                     {
-                        target.onAttributeEnd(tok->loc);
+                        pTarget->onAttributeEnd(tok->loc);
                     }
                     else if (tok->token == "Transform")
                     {
@@ -801,21 +937,21 @@ namespace Falcor
                             m[i] = parseFloat(*nextToken(TokenRequired));
                         if (nextToken(TokenRequired)->token != "]")
                             syntaxError(*tok);
-                        target.onTransform(m, tok->loc);
+                        pTarget->onTransform(m, tok->loc);
                     }
                     else if (tok->token == "Translate")
                     {
                         Float v[3];
                         for (int i = 0; i < 3; ++i)
                             v[i] = parseFloat(*nextToken(TokenRequired));
-                        target.onTranslate(v[0], v[1], v[2], tok->loc);
+                        pTarget->onTranslate(v[0], v[1], v[2], tok->loc);
                     }
                     else if (tok->token == "TransformTimes")
                     {
                         Float v[2];
                         for (int i = 0; i < 2; ++i)
                             v[i] = parseFloat(*nextToken(TokenRequired));
-                        target.onTransformTimes(v[0], v[1], tok->loc);
+                        pTarget->onTransformTimes(v[0], v[1], tok->loc);
                     }
                     else if (tok->token == "Texture")
                     {
@@ -828,7 +964,7 @@ namespace Falcor
                         std::string_view dequoted = dequoteString(t);
                         std::string texName = toString(dequoted);
                         ParsedParameterVector params = parseParameters(nextToken, unget);
-                        target.onTexture(name, type, texName, std::move(params), tok->loc);
+                        pTarget->onTexture(name, type, texName, std::move(params), tok->loc);
                     }
                     else
                     {
@@ -839,7 +975,7 @@ namespace Falcor
                 case 'W':
                     if (tok->token == "WorldBegin")
                     {
-                        target.onWorldBegin(tok->loc);
+                        pTarget->onWorldBegin(tok->loc);
                     }
                     else
                     {
@@ -851,19 +987,40 @@ namespace Falcor
                     syntaxError(*tok);
                 }
             }
+
+            if (importedFiles.empty()) return;
+
+            // Parse imported files in parallel. Imported files may contain further 'Import' directives, which are handled recursively.
+            Threading::parallelFor<size_t>(0, importedFiles.size(), [&](size_t i)
+            {
+                auto& importedFile = *importedFiles[i];
+                if (onFile) onFile(importedFile.path);
+                parse(importedFile.importTarget, Tokenizer::createFromFile(importedFile.path), searchPath, onFile);
+            });
+
+            // Replay in directive order. As in pbrt-v4, changes to the graphics state made by an imported file are scoped to that file.
+            for (auto& pImportedFile : importedFiles)
+            {
+                target.onAttributeBegin(pImportedFile->loc);
+                pImportedFile->importTarget.replay(target);
+                target.onAttributeEnd(pImportedFile->loc);
+                pImportedFile->continuationTarget.replay(target);
+            }
         }
 
-        void parseFile(ParserTarget& target, const std::filesystem::path& path)
+        void parseFile(ParserTarget& target, const std::filesystem::path& path, const FileCallback& onFile)
         {
+            if (onFile) onFile(path);
             auto tokenizer = Tokenizer::createFromFile(path);
-            parse(target, std::move(tokenizer));
+            parse(target, std::move(tokenizer), path.parent_path(), onFile);
             target.onEndOfFiles();
         }
 
         void parseString(ParserTarget& target, std::string str)
         {
             auto tokenizer = Tokenizer::createFromString(std::move(str));
-            parse(target, std::move(tokenizer));
+            auto searchPath = tokenizer->getPath().parent_path();
+            parse(target, std::move(tokenizer), searchPath, {});
             target.onEndOfFiles();
         }
     }
@@ -35,9 +35,11 @@
 
 #include "Types.h"
 #include "Parameters.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include <functional>
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
 
@@ -96,7 +98,12 @@ namespace Falcor
             virtual void onEndOfFiles() = 0;
         };
 
-        void parseFile(ParserTarget& target, const std::filesystem::path& path);
+        /** Callback invoked for every file that is read by the parser, including files referenced by 'Include' and 'Import' directives.
+            Note: The callback may be invoked concurrently from multiple threads.
+        */
+        using FileCallback = std::function<void(const std::filesystem::path& path)>;
+
+        void parseFile(ParserTarget& target, const std::filesystem::path& path, const FileCallback& onFile = {});
         void parseString(ParserTarget& target, std::string str);
 
         struct Token
@@ -113,6 +120,11 @@ namespace Falcor
         public:
             Tokenizer(std::string str, const std::filesystem::path& path);
 
+            /** Create a tokenizer operating directly on a memory mapped file.
+                The tokenizer takes ownership of the mapping and keeps it alive while tokens are in use.
+            */
+            Tokenizer(std::unique_ptr<MemoryMappedFile> pMappedFile, const std::filesystem::path& path);
+
             static std::unique_ptr<Tokenizer> createFromFile(const std::filesystem::path& path);
             static std::unique_ptr<Tokenizer> createFromString(std::string str);
 
@@ -133,6 +145,16 @@ namespace Falcor
                 return filenames;
             }
 
+            /** Mutex protecting the filename list, as files may be tokenized on multiple threads.
+            */
+            static std::mutex& getFilenamesMutex()
+            {
+                static std::mutex mutex;
+                return mutex;
+            }
+
+            void init(const char* pData, size_t size);
+
             bool isUTF16(const void* ptr, size_t len) const;
 
             int getChar()
@@ -164,7 +186,8 @@ namespace Falcor
 
             std::filesystem::path mPath;    ///< File path we're reading from.
             FileLoc mLoc;                   ///< File location.
-            std::string mContents;          ///< File contents we're parsing.
+            std::string mContents;          ///< File contents we're parsing (if not memory mapped).
+            std::unique_ptr<MemoryMappedFile> mpMappedFile; ///< Memory mapped file we're parsing (if memory mapped).
 
             const char* mPos;               ///< Current position in the file.
             const char* mEnd;               ///< End of the file (one past).
@@ -28,7 +28,7 @@
 #include "ImporterContext.h"
 #include "USDHelpers.h"
 #include "Core/API/Device.h"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Scene/Importer.h"
 #include "Scene/Curves/CurveConfig.h"
 #include "Scene/Material/HairMaterial.h"
@@ -77,6 +77,8 @@ namespace Falcor
     namespace
     {
         const bool kLoadMeshVertexAnimations = true;
+        const bool kStreamVertexAnimations = false; // Keep vertex animation keyframes on disk and stream them during playback.
+        const bool kCompressVertexAnimations = false; // Store vertex animation keyframes quantized and delta compressed.
 
         // Subdivide each bspline curve segment into a single linear swept sphere segments (could be more if memory/perf allows).
         uint32_t kCurveSubdivPerSegment = 1;
@@ -956,7 +958,7 @@ namespace Falcor
                 mesh.cachedMeshes[i].meshID = mesh.meshIDs[i];
                 for (auto& t : mesh.cachedMeshes[i].timeSamples) t /= ctx.timeCodesPerSecond; // Convert to seconds
 
-                std::vector<PackedStaticVertexData>& keyframeData = mesh.cachedMeshes[i].vertexData[sampleIdx];
+                std::vector<PackedStaticVertexData> keyframeData;
                 keyframeData.reserve(indices.size());
                 for (size_t j = 0; j < indices.size(); j++)
                 {
@@ -969,6 +971,15 @@ namespace Falcor
                     data.texCrd = v.texCrd;
                     keyframeData.emplace_back(data);
                 }
+
+                if (mesh.cachedMeshes[i].isStreamed())
+                {
+                    mesh.cachedMeshes[i].keyframeChunks[sampleIdx] = mesh.cachedMeshes[i].pKeyframeFile->writeChunk(keyframeData);
+                }
+                else
+                {
+                    mesh.cachedMeshes[i].vertexData[sampleIdx] = std::move(keyframeData);
+                }
             }
 
             return true;
@@ -1096,14 +1107,11 @@ namespace Falcor
         void addMeshesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected mesh tasks.
-            NumericRange<size_t> meshRange(0, ctx.meshTasks.size());
-            std::for_each(std::execution::par, meshRange.begin(), meshRange.end(),
-                [&](size_t i)
-                {
-                    FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
-                    processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
-                }
-            );
+            Threading::parallelFor<size_t>(0, ctx.meshTasks.size(), [&](size_t i)
+            {
+                FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
+                processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
+            });
 
             // Add processed meshes to scene builder.
             // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
@@ -1118,6 +1126,15 @@ namespace Falcor
 
             if (gpFramework->getSettings().getOption("usdImporter:loadMeshVertexAnimations", kLoadMeshVertexAnimations))
             {
+                // Keyframes are either kept in memory or written to a file to be streamed during playback.
+                // Uncompressed keyframes are written to the file as they are processed, compressed ones once all keyframes of a mesh are known.
+                VertexCacheFile::SharedPtr pKeyframeFile;
+                if (gpFramework->getSettings().getOption("usdImporter:streamVertexAnimations", kStreamVertexAnimations))
+                {
+                    pKeyframeFile = VertexCacheFile::create();
+                }
+                bool compress = gpFramework->getSettings().getOption("usdImporter:compressVertexAnimations", kCompressVertexAnimations);
+
                 // Allocate storage for mesh keyframe output
                 for (auto& m : ctx.meshes)
                 {
@@ -1126,20 +1143,41 @@ namespace Falcor
                         m.cachedMeshes.resize(m.processedMeshes.size());
                         for (auto& c : m.cachedMeshes)
                         {
-                            c.vertexData.resize(m.timeSamples.size());
+                            if (pKeyframeFile && !compress)
+                            {
+                                c.pKeyframeFile = pKeyframeFile;
+                                c.keyframeChunks.resize(m.timeSamples.size());
+                            }
+                            else
+                            {
+                                c.vertexData.resize(m.timeSamples.size());
+                            }
                         }
                     }
                 }
 
                 // Process time-sampled mesh keyframes
-                NumericRange<size_t> keyframeRange(0, ctx.meshKeyframeTasks.size());
-                std::for_each(std::execution::par, keyframeRange.begin(), keyframeRange.end(),
-                    [&](size_t i)
+                Threading::parallelFor<size_t>(0, ctx.meshKeyframeTasks.size(), [&](size_t i)
+                {
+                    auto& task = ctx.meshKeyframeTasks[i];
+                    processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
+                });
+
+                if (compress)
+                {
+                    std::vector<CachedMesh*> caches;
+                    for (auto& m : ctx.meshes)
                     {
-                        auto& task = ctx.meshKeyframeTasks[i];
-                        processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
+                        for (auto& c : m.cachedMeshes) caches.push_back(&c);
                     }
-                );
+                    Threading::parallelFor<size_t>(0, caches.size(), [&](size_t i)
+                    {
+                        caches[i]->compress();
+                        if (pKeyframeFile) caches[i]->moveToFile(pKeyframeFile);
+                    });
+                }
+
+                if (pKeyframeFile) pKeyframeFile->finalize();
 
                 // Gather keyframe data from all meshes
                 size_t totalMeshes = 0;
@@ -1262,10 +1300,7 @@ namespace Falcor
         void addCurvesToSceneBuilder(ImporterContext& ctx, TimeReport& timeReport)
         {
             // Process collected curves.
-            NumericRange<size_t> range(0, ctx.curves.size());
-            std::for_each(std::execution::par, range.begin(), range.end(),
-                [&](size_t i) { processCurve(ctx.curves[i], ctx); }
-            );
+            Threading::parallelFor<size_t>(0, ctx.curves.size(), [&](size_t i) { processCurve(ctx.curves[i], ctx); });
 
             // Add processed curves or meshes (of the first keyframe) to scene builder.
             // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
@@ -1283,7 +1318,13 @@ namespace Falcor
             }
 
             // Add curve vertex cache (only has positions) to scene builder.
+            if (gpFramework->getSettings().getOption("usdImporter:streamVertexAnimations", kStreamVertexAnimations))
+            {
+                ctx.pCurveKeyframeFile = VertexCacheFile::create();
+            }
+            ctx.compressCurveKeyframes = gpFramework->getSettings().getOption("usdImporter:compressVertexAnimations", kCompressVertexAnimations);
             for (auto& curve : ctx.curves) ctx.addCachedCurve(curve);
+            if (ctx.pCurveKeyframeFile) ctx.pCurveKeyframeFile->finalize();
             ctx.builder.setCachedCurves(std::move(ctx.cachedCurves));
 
             timeReport.measure("Process curves");
@@ -1771,13 +1812,10 @@ namespace Falcor
                 break;
             }
 
-            NumericRange<size_t> range(0, indexData.size());
-            std::for_each(std::execution::par, range.begin(), range.end(),
-                [&](size_t j)
-                {
-                    isSameTopology |= (indexData[j] == refIndexData[j]);
-                }
-            );
+            Threading::parallelFor<size_t>(0, indexData.size(), [&](size_t j)
+            {
+                isSameTopology |= (indexData[j] == refIndexData[j]);
+            });
             if (!isSameTopology) break;
         }
         if (!isSameTopology)
@@ -1788,15 +1826,30 @@ namespace Falcor
         cachedCurve.indexData.resize(refIndexData.size());
         std::memcpy(cachedCurve.indexData.data(), refIndexData.data(), cachedCurve.indexData.size() * sizeof(uint32_t));
 
-        cachedCurve.vertexData.resize(curve.processedCurves.size());
-        for (size_t i = 0; i < cachedCurve.vertexData.size(); i++)
+        // Compressed keyframes are written to the file once all keyframes are known.
+        bool streamKeyframes = pCurveKeyframeFile && !compressCurveKeyframes;
+        if (streamKeyframes)
+        {
+            cachedCurve.pKeyframeFile = pCurveKeyframeFile;
+            cachedCurve.keyframeChunks.resize(curve.processedCurves.size());
+        }
+        else
+        {
+            cachedCurve.vertexData.resize(curve.processedCurves.size());
+        }
+
+        std::vector<DynamicCurveVertexData> keyframeData;
+        for (size_t i = 0; i < curve.processedCurves.size(); i++)
         {
-            cachedCurve.vertexData[i].resize(curve.processedCurves[i].staticData.size());
-            for (size_t j = 0; j < cachedCurve.vertexData[i].size(); j++)
+            keyframeData.resize(curve.processedCurves[i].staticData.size());
+            for (size_t j = 0; j < keyframeData.size(); j++)
             {
-                cachedCurve.vertexData[i][j].position = curve.processedCurves[i].staticData[j].position;
+                keyframeData[j].position = curve.processedCurves[i].staticData[j].position;
             }
 
+            if (streamKeyframes) cachedCurve.keyframeChunks[i] = pCurveKeyframeFile->writeChunk(keyframeData);
+            else cachedCurve.vertexData[i] = keyframeData;
+
             // Deallocate memory.
             if (i > 0)
             {
@@ -1804,6 +1857,12 @@ namespace Falcor
             }
         }
 
+        if (compressCurveKeyframes)
+        {
+            cachedCurve.compress();
+            if (pCurveKeyframeFile) cachedCurve.moveToFile(pCurveKeyframeFile);
+        }
+
         cachedCurves.push_back(cachedCurve);
     }
 
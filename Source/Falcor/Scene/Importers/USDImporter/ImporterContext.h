@@ -33,6 +33,7 @@
 #include "Scene/SceneIDs.h"
 #include "Scene/SceneBuilder.h"
 #include "Scene/Animation/Animation.h"
+#include "Scene/Animation/VertexCacheFile.h"
 #include "Scene/Curves/CurveTessellation.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
@@ -364,6 +365,8 @@ namespace Falcor
         std::vector<GeomInstance> curveInstances;                                                    ///< List of curve instances.
         std::unordered_map<UsdObject, size_t, UsdObjHash> curveMap;                                  ///< Map from prim to curve.
         std::vector<CachedCurve> cachedCurves;                                                       ///< List of animated curve vertex caches.
+        VertexCacheFile::SharedPtr pCurveKeyframeFile;                                               ///< File holding streamed curve keyframes, or nullptr if keyframes are kept in memory.
+        bool compressCurveKeyframes = false;                                                         ///< Compress curve keyframes.
 
         UsdShadeMaterialBindingAPI::CollectionQueryCache collQueryCache;                             ///< Material collection binding cache
         UsdShadeMaterialBindingAPI::BindingsCache bindingsCache;                                     ///< Material binding cache
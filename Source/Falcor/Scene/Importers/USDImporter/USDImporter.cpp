@@ -327,6 +327,13 @@ namespace Falcor
 
         timeReport.measure("Open stage");
 
+        // Add all layers composed into the stage (sublayers, references, payloads) as scene dependencies.
+        for (const auto& pLayer : pStage->GetUsedLayers())
+        {
+            const std::string& layerPath = pLayer->GetRealPath();
+            if (!layerPath.empty()) builder.addDependency(layerPath);
+        }
+
         ImporterContext ctx(path, pStage, builder, dict, timeReport);
 
         // Falcor uses meter scene unit; scale if necessary. Note that Omniverse uses cm by default.
@@ -85,11 +85,8 @@ namespace Falcor
         auto pScene = mpScene.lock();
         if (!pScene) return false;
 
-        if (pUpdateStatus)
-        {
-            pUpdateStatus->lightsUpdateInfo.clear();
-            pUpdateStatus->lightsUpdateInfo.reserve(mMeshLights.size());
-        }
+        mUpdateStatus.lightsUpdateInfo.clear();
+        mUpdateStatus.lightsUpdateInfo.reserve(mMeshLights.size());
 
         // Update transform matrices and check for updates.
         // TODO: Move per-mesh instance update flags into Scene. Return just a list of mesh lights that have changed.
@@ -106,13 +103,16 @@ namespace Falcor
 
             // Store update status.
             if (updateFlags != UpdateFlags::None) updatedLights.push_back(lightIdx);
-            if (pUpdateStatus) pUpdateStatus->lightsUpdateInfo.push_back(updateFlags);
+            mUpdateStatus.lightsUpdateInfo.push_back(updateFlags);
         }
 
+        if (pUpdateStatus) *pUpdateStatus = mUpdateStatus;
+
         // Update light data if needed.
         if (!updatedLights.empty())
         {
             updateTrianglePositions(pRenderContext, *pScene, updatedLights);
+            mUpdateCount++;
             return true;
         }
 
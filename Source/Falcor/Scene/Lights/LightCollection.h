@@ -161,6 +161,15 @@ namespace Falcor
         */
         const std::vector<MeshLightData>& getMeshLights() const { return mMeshLights; }
 
+        /** Returns the update status of the last call to update().
+        */
+        const UpdateStatus& getUpdateStatus() const { return mUpdateStatus; }
+
+        /** Returns the number of calls to update() that detected changes to the lights.
+            This can be used to detect whether the update status of an intermediate update was missed.
+        */
+        uint64_t getUpdateCount() const { return mUpdateCount; }
+
         /** Prepare for syncing the CPU data.
             If the mesh light triangles will be accessed with getMeshLightTriangles()
             performance can be improved by calling this function ahead of time.
@@ -209,6 +218,9 @@ namespace Falcor
         mutable std::vector<uint32_t>           mActiveTriangleList;    ///< List of active (non-culled) emissive triangles.
         mutable std::vector<uint32_t>           mTriToActiveList;       ///< Mapping of all light triangles to index in mActiveTriangleList.
 
+        UpdateStatus                            mUpdateStatus;          ///< Update status of the last call to update().
+        uint64_t                                mUpdateCount = 0;       ///< Number of calls to update() that detected changes.
+
         mutable MeshLightStats                  mMeshLightStats;        ///< Stats before/after pre-processing of mesh lights. Do not access this directly, use getStats() which ensures the stats are up-to-date.
         mutable bool                            mStatsValid = false;    ///< True when stats are valid.
 
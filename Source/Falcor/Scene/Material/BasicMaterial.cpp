@@ -588,6 +588,33 @@ namespace Falcor
         return (*this) == (*other);
     }
 
+    size_t BasicMaterial::getHash() const
+    {
+        // Hash the same fields that are compared in operator==.
+        // The sampler descs are not included, which is consistent but may cause some collisions.
+        FNVHash64 hash;
+        hashBase(hash);
+
+#define hash_field(_a) hashValue(hash, mData._a)
+        hash_field(flags);
+        hash_field(displacementScale);
+        hash_field(displacementOffset);
+        hash_field(baseColor);
+        hash_field(specular);
+        hash_field(emissive);
+        hash_field(emissiveFactor);
+        hash_field(IoR);
+        hash_field(diffuseTransmission);
+        hash_field(specularTransmission);
+        hash_field(transmission);
+        hash_field(volumeAbsorption);
+        hash_field(volumeAnisotropy);
+        hash_field(volumeScattering);
+#undef hash_field
+
+        return (size_t)hash.get();
+    }
+
     bool BasicMaterial::operator==(const BasicMaterial& other) const
     {
         if (!isBaseEqual(other)) return false;
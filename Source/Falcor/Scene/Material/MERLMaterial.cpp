@@ -123,6 +123,14 @@ namespace Falcor
         return true;
     }
 
+    size_t MERLMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+        hashValue(hash, std::filesystem::hash_value(mPath));
+        return (size_t)hash.get();
+    }
+
     Program::ShaderModuleList MERLMaterial::getShaderModules() const
     {
         return { Program::ShaderModule(kShaderFile) };
@@ -301,6 +301,31 @@ namespace Falcor
         return true;
     }
 
+    void Material::hashBase(FNVHash64& hash) const
+    {
+        // This function hashes all data in the base class that is compared in isBaseEqual() *except* the name.
+
+        hashValue(hash, mHeader.packedData);
+        hashValue(hash, mTextureTransform.getTranslation());
+        hashValue(hash, mTextureTransform.getScaling());
+        hashValue(hash, mTextureTransform.getRotation());
+
+        for (size_t i = 0; i < mTextureSlotInfo.size(); i++)
+        {
+            auto slot = (TextureSlot)i;
+            bool hasSlot = hasTextureSlot(slot);
+            hashValue(hash, hasSlot);
+            if (hasSlot)
+            {
+                const auto& info = mTextureSlotInfo[i];
+                hash.insert(info.name.data(), info.name.size());
+                hashValue(hash, info.mask);
+                hashValue(hash, info.srgb);
+                hashValue(hash, mTextureSlotData[i].pTexture.get());
+            }
+        }
+    }
+
     FALCOR_SCRIPT_BINDING(Material)
     {
         using namespace pybind11::literals;
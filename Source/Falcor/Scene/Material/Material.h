@@ -34,6 +34,8 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Math/FNVHash.h"
+#include "Utils/Math/Float16.h"
 #include "Utils/UI/Gui.h"
 #include "Scene/Transform.h"
 #include <array>
@@ -41,6 +43,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <type_traits>
 
 namespace Falcor
 {
@@ -154,6 +157,13 @@ namespace Falcor
         */
         virtual bool isEqual(const Material::SharedPtr& pOther) const = 0;
 
+        /** Compute a hash of the material properties.
+            The hash is consistent with isEqual(), i.e. materials that compare equal have identical hashes.
+            This is used to efficiently find duplicate materials.
+            \return Hash of all material properties *except* the name.
+        */
+        virtual size_t getHash() const = 0;
+
         /** Set the double-sided flag. This flag doesn't affect the cull state, just the shading.
         */
         virtual void setDoubleSided(bool doubleSided);
@@ -306,6 +316,29 @@ namespace Falcor
         void updateTextureHandle(MaterialSystem* pOwner, const TextureSlot slot, TextureHandle& handle);
         void updateDefaultTextureSamplerID(MaterialSystem* pOwner, const Sampler::SharedPtr& pSampler);
         bool isBaseEqual(const Material& other) const;
+        void hashBase(FNVHash64& hash) const;
+
+        /** Add a value to a material hash.
+            Floating-point values are hashed by value so that +0 and -0 hash identically,
+            other types are hashed by their binary representation. Vector types are hashed per component.
+        */
+        template<typename T>
+        static void hashValue(FNVHash64& hash, const T& value)
+        {
+            if constexpr (std::is_floating_point<T>::value)
+            {
+                T v = value == T(0) ? T(0) : value;
+                hash.insert(&v, sizeof(v));
+            }
+            else if constexpr (std::is_integral<T>::value || std::is_enum<T>::value || std::is_same<T, float16_t>::value || std::is_pointer<T>::value)
+            {
+                hash.insert(&value, sizeof(value));
+            }
+            else
+            {
+                for (int i = 0; i < (int)T::length(); ++i) hashValue(hash, value[i]);
+            }
+        }
 
         template<typename T>
         MaterialDataBlob prepareDataBlob(const T& data) const
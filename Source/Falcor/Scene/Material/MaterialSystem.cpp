@@ -30,6 +30,7 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Algorithm/UniqueElements.h"
 #include <numeric>
 
 namespace Falcor
@@ -37,10 +38,10 @@ namespace Falcor
     namespace
     {
         const std::string kShaderFilename = "Scene/Material/MaterialSystem.slang";
-        const std::string kMaterialDataName = "materialData";
-        const std::string kMaterialSamplersName = "materialSamplers";
-        const std::string kMaterialTexturesName = "materialTextures";
-        const std::string kMaterialBuffersName = "materialBuffers";
+        constexpr ShaderVarName kMaterialDataName("materialData");
+        constexpr ShaderVarName kMaterialSamplersName("materialSamplers");
+        constexpr ShaderVarName kMaterialTexturesName("materialTextures");
+        constexpr ShaderVarName kMaterialBuffersName("materialBuffers");
 
         const size_t kMaxSamplerCount = 1ull << MaterialHeader::kSamplerIDBits;
         const size_t kMaxTextureCount = 1ull << TextureHandle::kTextureIDBits;
@@ -265,23 +266,28 @@ namespace Falcor
 
     size_t MaterialSystem::removeDuplicateMaterials(std::vector<MaterialID>& idMap)
     {
+        // Find unique set of materials.
+        // Materials are bucketed by hash and only compared using isEqual() within a bucket.
+        std::vector<size_t> uniqueMap;
+        auto uniqueIDs = findUniqueElements(mMaterials.size(),
+            [&](size_t i) { return mMaterials[i]->getHash(); },
+            [&](size_t i, size_t j) { return mMaterials[i]->isEqual(mMaterials[j]); },
+            uniqueMap);
+
         std::vector<Material::SharedPtr> uniqueMaterials;
-        idMap.resize(mMaterials.size());
+        uniqueMaterials.reserve(uniqueIDs.size());
+        for (size_t i : uniqueIDs) uniqueMaterials.push_back(mMaterials[i]);
 
-        // Find unique set of materials.
+        idMap.resize(mMaterials.size());
         for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id)
         {
-            const auto& pMaterial = mMaterials[id.get()];
-            auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&pMaterial](const auto& m) { return m->isEqual(pMaterial); });
-            if (it == uniqueMaterials.end())
-            {
-                idMap[id.get()] = MaterialID{ uniqueMaterials.size() };
-                uniqueMaterials.push_back(pMaterial);
-            }
-            else
+            idMap[id.get()] = MaterialID{ uniqueMap[id.get()] };
+
+            if (uniqueIDs[uniqueMap[id.get()]] != id.get())
             {
-                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), (*it)->getName());
-                idMap[id.get()] = MaterialID{ (size_t)std::distance(uniqueMaterials.begin(), it) };
+                const auto& pMaterial = mMaterials[id.get()];
+                const auto& pUniqueMaterial = uniqueMaterials[uniqueMap[id.get()]];
+                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), pUniqueMaterial->getName());
 
                 // Update metadata.
                 if (isSpecGloss(pMaterial)) mSpecGlossMaterialCount--;
@@ -492,6 +498,10 @@ namespace Falcor
             if (isCompressedFormat(t->getFormat())) s.textureCompressedCount++;
         }
 
+        auto textureStats = mpTextureManager->getStats();
+        s.textureDeduplicatedCount = textureStats.deduplicatedTextureCount;
+        s.textureDeduplicatedMemoryInBytes = textureStats.deduplicatedMemoryInBytes;
+
         return s;
     }
 
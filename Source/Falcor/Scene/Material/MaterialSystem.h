@@ -68,6 +68,8 @@ namespace Falcor
             uint64_t textureCompressedCount = 0;        ///< Number of unique compressed textures.
             uint64_t textureTexelCount = 0;             ///< Total number of texels in all textures.
             uint64_t textureMemoryInBytes = 0;          ///< Total memory in bytes used by the textures.
+            uint64_t textureDeduplicatedCount = 0;      ///< Number of texture loads aliased to an identical texture by content-based deduplication.
+            uint64_t textureDeduplicatedMemoryInBytes = 0; ///< Total memory in bytes saved by content-based texture deduplication.
         };
 
         /** Create a material system.
@@ -137,6 +137,14 @@ namespace Falcor
         return true;
     }
 
+    size_t RGLMaterial::getHash() const
+    {
+        FNVHash64 hash;
+        hashBase(hash);
+        hashValue(hash, std::filesystem::hash_value(mFilePath));
+        return (size_t)hash.get();
+    }
+
     Program::ShaderModuleList RGLMaterial::getShaderModules() const
     {
         return { Program::ShaderModule(kShaderFile) };
@@ -0,0 +1,218 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFBrickData.h"
+#include "Core/Errors.h"
+#include "Utils/Threading.h"
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    SDFBrickData SDFBrickData::createFromValues(const std::vector<float>& cornerValues, uint32_t gridWidth, uint32_t brickWidth)
+    {
+        checkArgument(gridWidth > 0 && brickWidth > 0, "'gridWidth' ({}) and 'brickWidth' ({}) must be larger than zero", gridWidth, brickWidth);
+        const size_t gridWidthInValues = gridWidth + 1;
+        checkArgument(cornerValues.size() == gridWidthInValues * gridWidthInValues * gridWidthInValues, "Corner value count ({}) does not match grid width ({})", cornerValues.size(), gridWidth);
+
+        SDFBrickData bricks;
+        bricks.gridWidth = gridWidth;
+        bricks.brickWidth = brickWidth;
+
+        const uint32_t bricksPerAxis = bricks.getVirtualBricksPerAxis();
+        const uint32_t w = bricks.getBrickWidthInValues();
+        const size_t valueCountPerBrick = bricks.getValueCountPerBrick();
+        const float normalizationMultiplier = 2.0f * gridWidth / std::sqrt(3.0f);
+
+        // Process one layer of bricks per task, so that only the bricks containing the surface are stored.
+        std::vector<SDFBrickData> layers(bricksPerAxis);
+        Threading::parallelFor<uint32_t>(0, bricksPerAxis, [&](uint32_t brickZ)
+        {
+            SDFBrickData& layer = layers[brickZ];
+            std::vector<int8_t> values(valueCountPerBrick);
+            for (uint32_t brickY = 0; brickY < bricksPerAxis; brickY++)
+            {
+                for (uint32_t brickX = 0; brickX < bricksPerAxis; brickX++)
+                {
+                    uint3 brickOrigin = uint3(brickX, brickY, brickZ) * brickWidth;
+                    for (uint32_t z = 0; z < w; z++)
+                    {
+                        for (uint32_t y = 0; y < w; y++)
+                        {
+                            for (uint32_t x = 0; x < w; x++)
+                            {
+                                uint3 corner = brickOrigin + uint3(x, y, z);
+                                int8_t& value = values[x + w * (y + w * z)];
+                                if (glm::any(glm::greaterThan(corner, uint3(gridWidth)))) value = INT8_MAX;
+                                else value = quantize(cornerValues[corner.x + gridWidthInValues * (corner.y + gridWidthInValues * corner.z)] * normalizationMultiplier);
+                            }
+                        }
+                    }
+
+                    if (containsSurface(values.data(), brickWidth))
+                    {
+                        layer.brickCoords.emplace_back(brickX, brickY, brickZ);
+                        layer.values.insert(layer.values.end(), values.begin(), values.end());
+                    }
+                }
+            }
+        });
+
+        for (auto& layer : layers)
+        {
+            bricks.brickCoords.insert(bricks.brickCoords.end(), layer.brickCoords.begin(), layer.brickCoords.end());
+            bricks.values.insert(bricks.values.end(), layer.values.begin(), layer.values.end());
+            layer = {};
+        }
+
+        return bricks;
+    }
+
+    bool SDFBrickData::containsSurface(const int8_t* pValues, uint32_t brickWidth)
+    {
+        const uint32_t w = brickWidth + 1;
+        for (uint32_t z = 0; z < brickWidth; z++)
+        {
+            for (uint32_t y = 0; y < brickWidth; y++)
+            {
+                for (uint32_t x = 0; x < brickWidth; x++)
+                {
+                    bool hasNegative = false;
+                    bool hasPositive = false;
+                    for (uint32_t c = 0; c < 8; c++)
+                    {
+                        int8_t value = pValues[(x + (c & 1)) + w * ((y + ((c >> 1) & 1)) + w * (z + (c >> 2)))];
+                        hasNegative |= value <= 0;
+                        hasPositive |= value >= 0;
+                    }
+                    if (hasNegative && hasPositive) return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    uint64_t SDFBrickData::compressBC4Block(const int8_t values[16])
+    {
+        auto fixRange = [](int& minValue, int& maxValue, int steps)
+        {
+            if (maxValue - minValue < steps)
+            {
+                maxValue = std::min(minValue + steps, 127);
+                minValue = maxValue - minValue < steps ? std::max(-128, maxValue - steps) : minValue;
+            }
+        };
+
+        auto fitCodes = [&](const int codes[8], uint32_t indices[16])
+        {
+            int err = 0;
+            for (int i = 0; i < 16; ++i)
+            {
+                int value = values[i];
+                int least = std::numeric_limits<int>::max();
+                for (uint32_t j = 0; j < 8; ++j)
+                {
+                    int dist = (value - codes[j]) * (value - codes[j]);
+                    if (dist < least)
+                    {
+                        least = dist;
+                        indices[i] = j;
+                    }
+                }
+                err += least;
+            }
+            return err;
+        };
+
+        auto writeBlock = [](int alpha0, int alpha1, const uint32_t indices[16])
+        {
+            uint64_t compressedBlock = uint64_t(alpha0 & 0xff) | uint64_t(alpha1 & 0xff) << 8;
+            for (int i = 0; i < 16; ++i) compressedBlock |= uint64_t(indices[i] & 0x7) << (3 * i + 16);
+            return compressedBlock;
+        };
+
+        // Get the range for 5-alpha and 7-alpha interpolation.
+        int min5 = 127, max5 = -128, min7 = 127, max7 = -128;
+        for (int i = 0; i < 16; ++i)
+        {
+            int value = values[i];
+            min7 = std::min(min7, value);
+            max7 = std::max(max7, value);
+            if (value != -128 && value < min5) min5 = value;
+            if (value != 127 && value > max5) max5 = value;
+        }
+        min5 = std::min(min5, max5);
+        min7 = std::min(min7, max7);
+        fixRange(min5, max5, 5);
+        fixRange(min7, max7, 7);
+
+        int codes5[8] = { min5, max5, 0, 0, 0, 0, -128, 127 };
+        for (int i = 1; i < 5; ++i) codes5[1 + i] = ((5 - i) * min5 + i * max5) / 5;
+        int codes7[8] = { min7, max7 };
+        for (int i = 1; i < 7; ++i) codes7[1 + i] = ((7 - i) * min7 + i * max7) / 7;
+
+        uint32_t indices5[16];
+        uint32_t indices7[16];
+        int err5 = fitCodes(codes5, indices5);
+        int err7 = fitCodes(codes7, indices7);
+
+        // The endpoint order selects the interpolation mode, swap the endpoints and remap the indices if needed.
+        if (err5 <= err7)
+        {
+            if (min5 <= max5) return writeBlock(min5, max5, indices5);
+            for (auto& index : indices5) index = index == 0 ? 1 : index == 1 ? 0 : index <= 5 ? 7 - index : index;
+            return writeBlock(max5, min5, indices5);
+        }
+        else
+        {
+            if (min7 >= max7) return writeBlock(min7, max7, indices7);
+            for (auto& index : indices7) index = index == 0 ? 1 : index == 1 ? 0 : 9 - index;
+            return writeBlock(max7, min7, indices7);
+        }
+    }
+
+    void SDFBrickData::decompressBC4Block(uint64_t block, int8_t values[16])
+    {
+        // Use the same integer interpolation as compressBC4Block() so that the encoded codes are reproduced exactly.
+        int alpha0 = int8_t(block & 0xff);
+        int alpha1 = int8_t((block >> 8) & 0xff);
+
+        int codes[8] = { alpha0, alpha1 };
+        if (alpha0 > alpha1)
+        {
+            for (int i = 1; i < 7; ++i) codes[1 + i] = ((7 - i) * alpha0 + i * alpha1) / 7;
+        }
+        else
+        {
+            for (int i = 1; i < 5; ++i) codes[1 + i] = ((5 - i) * alpha0 + i * alpha1) / 5;
+            codes[6] = -INT8_MAX;
+            codes[7] = INT8_MAX;
+        }
+
+        for (int i = 0; i < 16; ++i) values[i] = int8_t(std::max(codes[(block >> (3 * i + 16)) & 0x7], -INT8_MAX));
+    }
+}
@@ -0,0 +1,98 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace Falcor
+{
+    /** Sparse set of SDF bricks, used to create sparse SDF grids without a dense value grid.
+
+        The virtual grid of gridWidth^3 voxels is divided into bricks of brickWidth^3 voxels. Only bricks that contain
+        the surface are stored. Each brick stores the (brickWidth + 1)^3 distance values at the corners of its voxels
+        (x fastest, then y, then z) as 8-bit snorms, where 1 represents half a voxel diagonal, i.e., the same
+        normalization that the sparse SDF grids use on the GPU.
+    */
+    struct FALCOR_API SDFBrickData
+    {
+        uint32_t gridWidth = 0;             ///< Width of the virtual grid in voxels.
+        uint32_t brickWidth = 0;            ///< Width of a brick in voxels.
+        std::vector<uint3> brickCoords;     ///< Virtual brick coordinates of each brick.
+        std::vector<int8_t> values;         ///< Corner values of all bricks, getValueCountPerBrick() values per brick.
+
+        bool empty() const { return brickCoords.empty(); }
+        uint32_t getBrickCount() const { return (uint32_t)brickCoords.size(); }
+        uint32_t getBrickWidthInValues() const { return brickWidth + 1; }
+        size_t getValueCountPerBrick() const { return (size_t)getBrickWidthInValues() * getBrickWidthInValues() * getBrickWidthInValues(); }
+
+        /** Returns the number of bricks along each axis of the virtual grid.
+        */
+        uint32_t getVirtualBricksPerAxis() const { return (gridWidth + brickWidth - 1) / brickWidth; }
+
+        const int8_t* getBrickValues(uint32_t brickID) const { return values.data() + brickID * getValueCountPerBrick(); }
+        int8_t* getBrickValues(uint32_t brickID) { return values.data() + brickID * getValueCountPerBrick(); }
+
+        /** Create bricks from a dense grid of corner values. Only bricks with voxels containing the surface are kept.
+            \param[in] cornerValues The (gridWidth + 1)^3 corner values of the grid, in the local space of the grid.
+            \param[in] gridWidth The width of the grid in voxels.
+            \param[in] brickWidth The width of a brick in voxels.
+            \return The bricks containing the surface.
+        */
+        static SDFBrickData createFromValues(const std::vector<float>& cornerValues, uint32_t gridWidth, uint32_t brickWidth);
+
+        /** Check if any voxel of a brick contains the surface, using the same test as the GPU.
+            \param[in] pValues The (brickWidth + 1)^3 corner values of the brick.
+            \param[in] brickWidth The width of the brick in voxels.
+        */
+        static bool containsSurface(const int8_t* pValues, uint32_t brickWidth);
+
+        /** Compress a 4x4 block of 8-bit snorms to BC4, matching compressBlock() in BC4Encode.slang.
+            \param[in] values The values of the block in row-major order.
+            \return The compressed block.
+        */
+        static uint64_t compressBC4Block(const int8_t values[16]);
+
+        /** Decompress a BC4 block.
+            \param[in] block The compressed block.
+            \param[out] values The values of the block in row-major order.
+        */
+        static void decompressBC4Block(uint64_t block, int8_t values[16]);
+
+        /** Quantize a normalized distance to an 8-bit snorm.
+        */
+        static int8_t quantize(float normalizedDistance)
+        {
+            float integerScale = std::clamp(normalizedDistance, -1.0f, 1.0f) * float(INT8_MAX);
+            return integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
+        }
+    };
+}
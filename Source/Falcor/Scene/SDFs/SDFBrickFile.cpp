@@ -0,0 +1,272 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFBrickFile.h"
+#include "Core/Errors.h"
+#include "Core/Platform/OS.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/Threading.h"
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const char* kMagic = "FalcorB$";
+        const uint32_t kVersion = 1;
+
+        // Width of a BC4 block.
+        const uint32_t kCompressionWidth = 4;
+
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t gridWidth{};
+            uint32_t brickWidth{};
+            uint32_t brickCount{};
+
+            bool isValid() const
+            {
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
+            }
+        };
+
+        /** Entry in the brick index following the header.
+        */
+        struct BrickDesc
+        {
+            uint64_t offset{};                  ///< Offset of the brick data from the start of the file.
+            uint16_t coords[3]{};               ///< Virtual brick coordinates.
+            SDFBrickFile::Encoding encoding{};  ///< Encoding of the brick data.
+        };
+
+        static_assert(sizeof(Header) == 24);
+        static_assert(sizeof(BrickDesc) == 16);
+
+        uint32_t getBlocksPerAxis(uint32_t brickWidth)
+        {
+            return (brickWidth + kCompressionWidth) / kCompressionWidth;
+        }
+
+        /** Compress a brick to BC4 blocks. Blocks on the brick boundary are padded by clamping.
+        */
+        void compressBrick(const int8_t* pValues, uint32_t brickWidth, uint64_t* pBlocks)
+        {
+            const uint32_t w = brickWidth + 1;
+            const uint32_t blocksPerAxis = getBlocksPerAxis(brickWidth);
+            for (uint32_t z = 0; z < w; z++)
+            {
+                for (uint32_t blockY = 0; blockY < blocksPerAxis; blockY++)
+                {
+                    for (uint32_t blockX = 0; blockX < blocksPerAxis; blockX++)
+                    {
+                        int8_t block[16];
+                        for (uint32_t y = 0; y < kCompressionWidth; y++)
+                        {
+                            for (uint32_t x = 0; x < kCompressionWidth; x++)
+                            {
+                                uint32_t vx = std::min(blockX * kCompressionWidth + x, w - 1);
+                                uint32_t vy = std::min(blockY * kCompressionWidth + y, w - 1);
+                                block[x + kCompressionWidth * y] = pValues[vx + w * (vy + w * z)];
+                            }
+                        }
+                        *pBlocks++ = SDFBrickData::compressBC4Block(block);
+                    }
+                }
+            }
+        }
+
+        void decompressBrick(const uint8_t* pData, uint32_t brickWidth, int8_t* pValues)
+        {
+            const uint32_t w = brickWidth + 1;
+            const uint32_t blocksPerAxis = getBlocksPerAxis(brickWidth);
+            for (uint32_t z = 0; z < w; z++)
+            {
+                for (uint32_t blockY = 0; blockY < blocksPerAxis; blockY++)
+                {
+                    for (uint32_t blockX = 0; blockX < blocksPerAxis; blockX++)
+                    {
+                        uint64_t compressedBlock;
+                        std::memcpy(&compressedBlock, pData, sizeof(uint64_t));
+                        pData += sizeof(uint64_t);
+
+                        int8_t block[16];
+                        SDFBrickData::decompressBC4Block(compressedBlock, block);
+                        for (uint32_t y = 0; y < kCompressionWidth && blockY * kCompressionWidth + y < w; y++)
+                        {
+                            for (uint32_t x = 0; x < kCompressionWidth && blockX * kCompressionWidth + x < w; x++)
+                            {
+                                pValues[(blockX * kCompressionWidth + x) + w * ((blockY * kCompressionWidth + y) + w * z)] = block[x + kCompressionWidth * y];
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        int sign(int8_t value)
+        {
+            return (value > 0) - (value < 0);
+        }
+    }
+
+    bool SDFBrickFile::isBrickFile(const std::filesystem::path& path)
+    {
+        return hasExtension(path, kExtension);
+    }
+
+    size_t SDFBrickFile::getEncodedBrickSize(uint32_t brickWidth, Encoding encoding)
+    {
+        const size_t w = brickWidth + 1;
+        switch (encoding)
+        {
+        case Encoding::Int8:
+            return w * w * w;
+        case Encoding::BC4:
+            return (size_t)getBlocksPerAxis(brickWidth) * getBlocksPerAxis(brickWidth) * w * sizeof(uint64_t);
+        default:
+            throw ArgumentError("Invalid SDF brick encoding {}", (uint32_t)encoding);
+        }
+    }
+
+    void SDFBrickFile::write(const std::filesystem::path& path, const SDFBrickData& bricks, bool compressed)
+    {
+        checkArgument(bricks.values.size() == bricks.getBrickCount() * bricks.getValueCountPerBrick(), "Brick value count ({}) does not match brick count ({})", bricks.values.size(), bricks.getBrickCount());
+        checkArgument(bricks.getVirtualBricksPerAxis() <= std::numeric_limits<uint16_t>::max(), "Grid width {} is too large for a brick width of {}", bricks.gridWidth, bricks.brickWidth);
+
+        const uint32_t brickCount = bricks.getBrickCount();
+        const size_t valueCountPerBrick = bricks.getValueCountPerBrick();
+        const size_t compressedBrickSize = getEncodedBrickSize(bricks.brickWidth, Encoding::BC4);
+
+        // Encode the bricks in parallel. Bricks are kept uncompressed if compression changes the sign of any value, as that changes the surface.
+        std::vector<BrickDesc> brickDescs(brickCount);
+        std::vector<uint64_t> compressedBricks;
+        if (compressed) compressedBricks.resize(brickCount * compressedBrickSize / sizeof(uint64_t));
+
+        Threading::parallelFor<uint32_t>(0, brickCount, [&](uint32_t brickID)
+        {
+            BrickDesc& desc = brickDescs[brickID];
+            for (uint32_t i = 0; i < 3; i++) desc.coords[i] = (uint16_t)bricks.brickCoords[brickID][i];
+            desc.encoding = Encoding::Int8;
+            if (!compressed) return;
+
+            const int8_t* pValues = bricks.getBrickValues(brickID);
+            uint64_t* pBlocks = compressedBricks.data() + brickID * compressedBrickSize / sizeof(uint64_t);
+            compressBrick(pValues, bricks.brickWidth, pBlocks);
+
+            std::vector<int8_t> decompressed(valueCountPerBrick);
+            decompressBrick(reinterpret_cast<const uint8_t*>(pBlocks), bricks.brickWidth, decompressed.data());
+            for (size_t i = 0; i < valueCountPerBrick; i++)
+            {
+                if (sign(decompressed[i]) != sign(pValues[i])) return;
+            }
+            desc.encoding = Encoding::BC4;
+        });
+
+        uint64_t offset = sizeof(Header) + brickCount * sizeof(BrickDesc);
+        for (auto& desc : brickDescs)
+        {
+            desc.offset = offset;
+            offset += getEncodedBrickSize(bricks.brickWidth, desc.encoding);
+        }
+
+        std::ofstream file(path, std::ios::out | std::ios::binary);
+        if (!file.is_open()) throw RuntimeError("Failed to create SDF brick file '{}'.", path);
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+        header.version = kVersion;
+        header.gridWidth = bricks.gridWidth;
+        header.brickWidth = bricks.brickWidth;
+        header.brickCount = brickCount;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+        file.write(reinterpret_cast<const char*>(brickDescs.data()), brickCount * sizeof(BrickDesc));
+
+        for (uint32_t brickID = 0; brickID < brickCount; brickID++)
+        {
+            if (brickDescs[brickID].encoding == Encoding::BC4) file.write(reinterpret_cast<const char*>(compressedBricks.data() + brickID * compressedBrickSize / sizeof(uint64_t)), compressedBrickSize);
+            else file.write(reinterpret_cast<const char*>(bricks.getBrickValues(brickID)), valueCountPerBrick);
+        }
+
+        if (!file.good()) throw RuntimeError("Failed to write SDF brick file '{}'.", path);
+    }
+
+    SDFBrickData SDFBrickFile::read(const std::filesystem::path& path)
+    {
+        MemoryMappedFile mappedFile;
+        if (!mappedFile.open(path, MemoryMappedFile::AccessHint::SequentialScan)) throw RuntimeError("Failed to open SDF brick file '{}'.", path);
+        const uint8_t* pData = static_cast<const uint8_t*>(mappedFile.getData());
+        const size_t fileSize = mappedFile.getSize();
+
+        // Validate header and brick index.
+        Header header;
+        if (fileSize < sizeof(Header)) throw RuntimeError("Invalid header in SDF brick file '{}'.", path);
+        std::memcpy(&header, pData, sizeof(Header));
+        if (!header.isValid() || header.gridWidth == 0 || header.brickWidth == 0) throw RuntimeError("Invalid header in SDF brick file '{}'.", path);
+
+        SDFBrickData bricks;
+        bricks.gridWidth = header.gridWidth;
+        bricks.brickWidth = header.brickWidth;
+
+        if (fileSize < sizeof(Header) + (uint64_t)header.brickCount * sizeof(BrickDesc)) throw RuntimeError("Invalid brick index in SDF brick file '{}'.", path);
+        std::vector<BrickDesc> brickDescs(header.brickCount);
+        std::memcpy(brickDescs.data(), pData + sizeof(Header), header.brickCount * sizeof(BrickDesc));
+
+        const uint32_t bricksPerAxis = bricks.getVirtualBricksPerAxis();
+        for (const auto& desc : brickDescs)
+        {
+            if (desc.encoding != Encoding::Int8 && desc.encoding != Encoding::BC4) throw RuntimeError("Invalid brick encoding in SDF brick file '{}'.", path);
+            size_t size = getEncodedBrickSize(header.brickWidth, desc.encoding);
+            if (desc.offset > fileSize || size > fileSize - desc.offset) throw RuntimeError("Invalid brick offset in SDF brick file '{}'.", path);
+            if (desc.coords[0] >= bricksPerAxis || desc.coords[1] >= bricksPerAxis || desc.coords[2] >= bricksPerAxis) throw RuntimeError("Invalid brick coordinates in SDF brick file '{}'.", path);
+        }
+
+        if (header.brickCount > 0)
+        {
+            // Start paging in the brick data, it is stored contiguously after the index.
+            size_t dataOffset = sizeof(Header) + header.brickCount * sizeof(BrickDesc);
+            mappedFile.prefetch(dataOffset, fileSize - dataOffset);
+        }
+
+        // Decode the bricks in parallel directly from the mapping.
+        bricks.brickCoords.resize(header.brickCount);
+        bricks.values.resize(header.brickCount * bricks.getValueCountPerBrick());
+        Threading::parallelFor<uint32_t>(0, header.brickCount, [&](uint32_t brickID)
+        {
+            const BrickDesc& desc = brickDescs[brickID];
+            bricks.brickCoords[brickID] = uint3(desc.coords[0], desc.coords[1], desc.coords[2]);
+            if (desc.encoding == Encoding::BC4) decompressBrick(pData + desc.offset, bricks.brickWidth, bricks.getBrickValues(brickID));
+            else std::memcpy(bricks.getBrickValues(brickID), pData + desc.offset, bricks.getValueCountPerBrick());
+        });
+
+        return bricks;
+    }
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SDFBrickData.h"
+#include "Core/Macros.h"
+#include <filesystem>
+
+namespace Falcor
+{
+    /** Reads and writes sparse SDF brick files (.sdfb).
+
+        Unlike .sdfg files, which store the dense grid of corner values, brick files only store the bricks
+        containing the surface. The file starts with a header, followed by a brick index with the virtual
+        coordinates, encoding and offset of each brick, followed by the brick data. Each brick is stored either
+        as 8-bit snorms or as BC4 blocks, where each z-slice of the brick is split into 4x4 blocks.
+        Files are memory mapped when read and the bricks are decoded in parallel.
+    */
+    class FALCOR_API SDFBrickFile
+    {
+    public:
+        static constexpr const char* kExtension = ".sdfb";
+
+        /** Encoding of a single brick.
+        */
+        enum class Encoding : uint16_t
+        {
+            Int8 = 0,   ///< Uncompressed 8-bit snorms.
+            BC4 = 1,    ///< BC4 compressed 8-bit snorms.
+        };
+
+        /** Check if a path has the brick file extension.
+        */
+        static bool isBrickFile(const std::filesystem::path& path);
+
+        /** Write bricks to a file.
+            When compression is enabled, bricks are BC4 compressed unless compression changes the sign of any of their values.
+            Throws an exception if the file can't be written.
+            \param[in] path The path of the file.
+            \param[in] bricks The bricks to write.
+            \param[in] compressed Enables BC4 compression.
+        */
+        static void write(const std::filesystem::path& path, const SDFBrickData& bricks, bool compressed = true);
+
+        /** Read bricks from a file.
+            Throws an exception if the file can't be opened or is invalid.
+            \param[in] path The path of the file.
+            \return The bricks stored in the file.
+        */
+        static SDFBrickData read(const std::filesystem::path& path);
+
+        /** Get the size of the data of an encoded brick in bytes.
+            \param[in] brickWidth The width of the brick in voxels.
+            \param[in] encoding The encoding of the brick.
+        */
+        static size_t getEncodedBrickSize(uint32_t brickWidth, Encoding encoding);
+    };
+}
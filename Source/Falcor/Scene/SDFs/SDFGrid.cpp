@@ -30,6 +30,8 @@
 #include "SparseVoxelSet/SDFSVS.h"
 #include "SparseBrickSet/SDFSBS.h"
 #include "SparseVoxelOctree/SDFSVO.h"
+#include "SDFBrickFile.h"
+#include "SDFMeshBuilder.h"
 #include "Core/Assert.h"
 #include "Core/Errors.h"
 #include "Core/API/Device.h"
@@ -37,6 +39,7 @@
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Scene/TriangleMesh.h"
 #include <rapidjson/rapidjson.h>
 #include <rapidjson/document.h>
 #include <rapidjson/prettywriter.h>
@@ -330,23 +333,66 @@ namespace Falcor
 
     void SDFGrid::setValues(const std::vector<float>& cornerValues, uint32_t gridWidth)
     {
-        // All types except SBS need to have a gridWidth that is a power of 2.
-        Type type = getType();
-        if (type != Type::SparseBrickSet)
-        {
-            checkArgument(isPowerOf2(gridWidth), "'gridWidth' ({}) must be a power of 2 for SDFGrid type of {}", gridWidth, getTypeName(type));
-        }
+        checkGridWidth(gridWidth);
 
         mGridWidth = gridWidth;
+        mMeshCenter = float3(0.f);
+        mMeshScale = 1.f;
 
         setValuesInternal(cornerValues);
     }
 
+    void SDFGrid::setBricks(const SDFBrickData& bricks)
+    {
+        checkGridWidth(bricks.gridWidth);
+        checkArgument(bricks.values.size() == bricks.getBrickCount() * bricks.getValueCountPerBrick(), "Brick value count ({}) does not match brick count ({})", bricks.values.size(), bricks.getBrickCount());
+
+        mGridWidth = bricks.gridWidth;
+        mMeshCenter = float3(0.f);
+        mMeshScale = 1.f;
+
+        setBricksInternal(bricks);
+    }
+
+    void SDFGrid::setValuesFromMesh(const TriangleMesh& mesh, uint32_t gridWidth)
+    {
+        checkGridWidth(gridWidth);
+
+        SDFMeshBuilder::Options options;
+        options.gridWidth = gridWidth;
+        options.brickWidth = getPreferredBrickWidth();
+        SDFMeshBuilder::Result result = SDFMeshBuilder::build(mesh, options);
+
+        logInfo("SDFGrid::setValuesFromMesh() created {} bricks, mesh center is {} and scale is {}.", result.bricks.getBrickCount(), to_string(result.meshCenter), result.meshScale);
+        setBricks(result.bricks);
+        mMeshCenter = result.meshCenter;
+        mMeshScale = result.meshScale;
+        mInitializedWithPrimitives = false;
+    }
+
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
         std::filesystem::path fullPath;
         if (findFileInDataDirectories(path, fullPath))
         {
+            if (SDFBrickFile::isBrickFile(fullPath))
+            {
+                // Reading fails on invalid files, and setting the bricks fails for grid types that can't be created
+                // from bricks or have a different brick width.
+                try
+                {
+                    setBricks(SDFBrickFile::read(fullPath));
+                }
+                catch (const Exception& e)
+                {
+                    logWarning("SDFGrid::loadValuesFromFile() file '{}' could not be loaded: {}", path, e.what());
+                    return false;
+                }
+
+                mInitializedWithPrimitives = false;
+                return true;
+            }
+
             std::ifstream file(fullPath, std::ios::in | std::ios::binary);
 
             if (file.is_open())
@@ -448,6 +494,14 @@ namespace Falcor
         pFence->syncCpu();
         const float* pValues = reinterpret_cast<const float*>(pValuesStagingBuffer->map(Buffer::MapType::Read));
 
+        if (SDFBrickFile::isBrickFile(path))
+        {
+            SDFBrickData bricks = SDFBrickData::createFromValues(std::vector<float>(pValues, pValues + valueCount), mGridWidth, getPreferredBrickWidth());
+            pValuesStagingBuffer->unmap();
+            SDFBrickFile::write(path, bricks);
+            return true;
+        }
+
         std::ofstream file(path, std::ios::out | std::ios::binary);
 
         if (file.is_open())
@@ -590,6 +644,21 @@ namespace Falcor
         mBakePrimitives = true;
     }
 
+    void SDFGrid::checkGridWidth(uint32_t gridWidth) const
+    {
+        // All types except SBS need to have a gridWidth that is a power of 2.
+        Type type = getType();
+        if (type != Type::SparseBrickSet)
+        {
+            checkArgument(isPowerOf2(gridWidth), "'gridWidth' ({}) must be a power of 2 for SDFGrid type of {}", gridWidth, getTypeName(type));
+        }
+    }
+
+    void SDFGrid::setBricksInternal(const SDFBrickData& bricks)
+    {
+        throw RuntimeError("SDFGrid type {} can't be created from sparse bricks.", getTypeName(getType()));
+    }
+
     std::string SDFGrid::getTypeName(Type type)
     {
         switch (type)
@@ -642,6 +711,9 @@ namespace Falcor
         sdfGrid.def_static("createSBS", createSBS);
         sdfGrid.def_static("createSVO", [](){ return SDFGrid::SharedPtr(SDFSVO::create()); });
         sdfGrid.def("loadValuesFromFile", &SDFGrid::loadValuesFromFile, "path"_a);
+        sdfGrid.def("setValuesFromMesh", &SDFGrid::setValuesFromMesh, "mesh"_a, "gridWidth"_a);
+        sdfGrid.def_property_readonly("meshCenter", &SDFGrid::getMeshCenter);
+        sdfGrid.def_property_readonly("meshScale", &SDFGrid::getMeshScale);
         sdfGrid.def("loadPrimitivesFromFile", &SDFGrid::loadPrimitivesFromFile, "path"_a, "gridWidth"_a, "dir"_a = "");
         sdfGrid.def("generateCheeseValues", &SDFGrid::generateCheeseValues, "gridWidth"_a, "seed"_a);
         sdfGrid.def_property("name", &SDFGrid::getName, &SDFGrid::setName);
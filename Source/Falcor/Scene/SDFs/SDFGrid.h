@@ -30,6 +30,7 @@
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
 #include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Scene/SDFs/SDFBrickData.h"
 #include "RenderGraph/BasePasses/ComputePass.h"
 #include <memory>
 #include <vector>
@@ -40,6 +41,7 @@
 namespace Falcor
 {
     class RenderContext;
+    class TriangleMesh;
     struct ShaderVar;
 
     /** SDF grid base class, stored by distance values at grid cell/voxel corners.
@@ -122,8 +124,24 @@ namespace Falcor
         */
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
+        /** Set the signed distance values of the SDF grid from sparse bricks, without creating the dense value grid.
+            Only supported by the sparse voxel set and the sparse brick set. The brick width of an SDFSBS must match the brick width of the bricks.
+            \param[in] bricks The bricks containing the surface.
+        */
+        void setBricks(const SDFBrickData& bricks);
+
+        /** Set the signed distance values of the SDF grid from a triangle mesh, see SDFMeshBuilder.
+            The mesh is uniformly scaled and centered to fit the grid. Only supported by the sparse voxel set and the sparse brick set.
+            The mapping from mesh space to the local space of the grid is available from getMeshCenter() and getMeshScale().
+            \param[in] mesh A closed triangle mesh.
+            \param[in] gridWidth The grid width in voxels.
+        */
+        void setValuesFromMesh(const TriangleMesh& mesh, uint32_t gridWidth);
+
         /** Set the signed distance values of the SDF grid from a file.
-            \param[in] path The path of a .sdfg file.
+            Sparse brick files (.sdfb, see SDFBrickFile) are passed to setBricks() without creating the dense grid.
+            Loading a .sdfb file fails if the grid type can't be created from bricks or the brick width doesn't match.
+            \param[in] path The path of a .sdfg or .sdfb file.
             \return true if the values could be set, otherwise false.
         */
         bool loadValuesFromFile(const std::filesystem::path& path);
@@ -135,6 +153,7 @@ namespace Falcor
         void generateCheeseValues(uint32_t gridWidth, uint32_t seed);
 
         /** Evaluates the SDF grid primitives on to a grid and writes the grid to a file.
+            If the path has the .sdfb extension, only the bricks containing the surface are written, see SDFBrickFile.
             \param[in] path A path to the file that should store the values.
             \return true if the values could be written, otherwise false.
         */
@@ -173,6 +192,17 @@ namespace Falcor
         */
         uint32_t getGridWidth() const { return mGridWidth; }
 
+        /** Returns the center of the mesh bounds the grid was created from by setValuesFromMesh().
+            The center is mapped to the origin of the grid, i.e., a grid point p corresponds to the mesh point p / getMeshScale() + getMeshCenter().
+            Returns zero if the grid was not created from a mesh.
+        */
+        const float3& getMeshCenter() const { return mMeshCenter; }
+
+        /** Returns the scale from mesh space to the local space of the grid used by setValuesFromMesh().
+            Returns one if the grid was not created from a mesh.
+        */
+        float getMeshScale() const { return mMeshScale; }
+
         /** Returns the number of primitives in the SDF grid.
         */
         uint32_t getPrimitiveCount() const { return (uint32_t)mPrimitives.size(); }
@@ -236,12 +266,24 @@ namespace Falcor
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) = 0;
 
+        /** Set the values from sparse bricks. Throws by default, implemented by grids that can be created without the dense value grid.
+        */
+        virtual void setBricksInternal(const SDFBrickData& bricks);
+
+        /** Returns the brick width used when building bricks for this grid.
+        */
+        virtual uint32_t getPreferredBrickWidth() const { return 8; }
+
         void createEvaluatePrimitivesPass(bool writeToTexture3D, bool mergeWithSDField);
 
+        void checkGridWidth(uint32_t gridWidth) const;
+
         void updatePrimitivesBuffer();
 
         std::string             mName;
         uint32_t                mGridWidth = 0;
+        float3                  mMeshCenter = float3(0.f);          ///< Center of the mesh bounds if created from a mesh.
+        float                   mMeshScale = 1.f;                   ///< Scale from mesh space to grid local space if created from a mesh.
 
         // Primitive data.
         std::vector<SDF3DPrimitive> mPrimitives;
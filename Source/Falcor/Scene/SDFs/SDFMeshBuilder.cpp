@@ -0,0 +1,542 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFMeshBuilder.h"
+#include "Core/Errors.h"
+#include "Scene/TriangleMesh.h"
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kLeafSize = 4;               ///< Max number of triangles in a BVH leaf.
+        const uint32_t kMaxStackSize = 64;          ///< Traversal stack size, the median split BVH is at most log2(triangleCount) deep.
+        const uint32_t kTriangleBlockSize = 4096;   ///< Number of triangles processed per task when finding the bricks overlapping the mesh.
+        const float kNormalization = 2.f / std::sqrt(3.f); ///< Converts distances in voxels to distances normalized to half a voxel diagonal.
+
+        /** Triangle with pseudo normals for signing distances.
+            The pseudo normals are ordered by the features reported by closestPointOnTriangle().
+        */
+        struct Triangle
+        {
+            float3 v[3];
+            float3 normals[7]; ///< Pseudo normals of the vertices, the edges (v0v1, v1v2, v2v0) and the face.
+        };
+
+        struct PositionHash
+        {
+            size_t operator()(const float3& p) const
+            {
+                size_t hash = 0;
+                for (int i = 0; i < 3; i++) hash = hash * 0x9e3779b97f4a7c15ull + std::hash<float>()(p[i]);
+                return hash;
+            }
+        };
+
+        /** Find the point on a triangle closest to p (see Ericson, Real-Time Collision Detection, 5.1.5).
+            \param[out] feature The closest feature: 0-2 for vertices, 3-5 for edges and 6 for the face.
+        */
+        float3 closestPointOnTriangle(const float3& p, const float3& a, const float3& b, const float3& c, uint32_t& feature)
+        {
+            float3 ab = b - a;
+            float3 ac = c - a;
+            float3 ap = p - a;
+            float d1 = glm::dot(ab, ap);
+            float d2 = glm::dot(ac, ap);
+            if (d1 <= 0.f && d2 <= 0.f) { feature = 0; return a; }
+
+            float3 bp = p - b;
+            float d3 = glm::dot(ab, bp);
+            float d4 = glm::dot(ac, bp);
+            if (d3 >= 0.f && d4 <= d3) { feature = 1; return b; }
+
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) { feature = 3; return a + ab * (d1 / (d1 - d3)); }
+
+            float3 cp = p - c;
+            float d5 = glm::dot(ab, cp);
+            float d6 = glm::dot(ac, cp);
+            if (d6 >= 0.f && d5 <= d6) { feature = 2; return c; }
+
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) { feature = 5; return a + ac * (d2 / (d2 - d6)); }
+
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.f && d4 - d3 >= 0.f && d5 - d6 >= 0.f) { feature = 4; return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))); }
+
+            float denom = 1.f / (va + vb + vc);
+            feature = 6;
+            return a + ab * (vb * denom) + ac * (vc * denom);
+        }
+
+        /** Separating axis test between a triangle and an axis aligned box (see Akenine-Moeller, Fast 3D Triangle-Box Overlap Testing).
+        */
+        bool triangleOverlapsBox(const float3 tri[3], const float3& boxCenter, const float3& boxHalfSize)
+        {
+            const float3 v[3] = { tri[0] - boxCenter, tri[1] - boxCenter, tri[2] - boxCenter };
+            const float3 e[3] = { v[1] - v[0], v[2] - v[1], v[0] - v[2] };
+
+            // Box face normals.
+            for (int i = 0; i < 3; i++)
+            {
+                if (std::min({ v[0][i], v[1][i], v[2][i] }) > boxHalfSize[i] || std::max({ v[0][i], v[1][i], v[2][i] }) < -boxHalfSize[i]) return false;
+            }
+
+            // Triangle plane.
+            float3 n = glm::cross(e[0], e[1]);
+            if (std::abs(glm::dot(n, v[0])) > glm::dot(boxHalfSize, glm::abs(n))) return false;
+
+            // Cross products of the edges with the box axes.
+            for (int i = 0; i < 3; i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    float3 axis(0.f);
+                    axis[j] = 1.f;
+                    axis = glm::cross(axis, e[i]);
+                    float p0 = glm::dot(v[0], axis);
+                    float p1 = glm::dot(v[1], axis);
+                    float p2 = glm::dot(v[2], axis);
+                    float r = glm::dot(boxHalfSize, glm::abs(axis));
+                    if (std::min({ p0, p1, p2 }) > r || std::max({ p0, p1, p2 }) < -r) return false;
+                }
+            }
+
+            return true;
+        }
+
+        float boxDistanceSquared(const float3& p, const float3& boxMin, const float3& boxMax)
+        {
+            float3 d = glm::max(glm::max(boxMin - p, p - boxMax), float3(0.f));
+            return glm::dot(d, d);
+        }
+
+        /** Median split BVH over triangles for closest point queries.
+        */
+        class TriangleBVH
+        {
+        public:
+            /** Build the BVH. The triangles are reordered.
+            */
+            TriangleBVH(std::vector<Triangle>& triangles)
+                : mTriangles(triangles)
+            {
+                if (mTriangles.empty()) return;
+
+                std::vector<uint32_t> order(mTriangles.size());
+                std::iota(order.begin(), order.end(), 0);
+                mNodes.reserve(2 * mTriangles.size() / kLeafSize + 1);
+                mNodes.emplace_back();
+                buildNode(0, order, 0, (uint32_t)order.size());
+
+                std::vector<Triangle> sorted(mTriangles.size());
+                for (size_t i = 0; i < order.size(); i++) sorted[i] = mTriangles[order[i]];
+                mTriangles = std::move(sorted);
+            }
+
+            /** Find the triangle closest to p.
+                \param[in] p Query point.
+                \param[in] maxDistance Upper bound of the distance to the closest triangle.
+                \param[out] distance Distance to the closest triangle.
+                \param[out] normal Pseudo normal of the closest feature.
+                \param[out] closest Closest point.
+                \return True if a triangle closer than maxDistance was found.
+            */
+            bool findClosest(const float3& p, float maxDistance, float& distance, float3& normal, float3& closest) const
+            {
+                if (mNodes.empty()) return false;
+
+                float bestDistSq = maxDistance * maxDistance;
+                const Triangle* pBest = nullptr;
+                uint32_t bestFeature = 0;
+
+                // Stack of nodes along with the squared distance to their bounds.
+                std::pair<uint32_t, float> stack[kMaxStackSize];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = { 0, boxDistanceSquared(p, mNodes[0].boundsMin, mNodes[0].boundsMax) };
+
+                while (stackSize > 0)
+                {
+                    auto [nodeIndex, nodeDistSq] = stack[--stackSize];
+                    if (nodeDistSq >= bestDistSq) continue;
+                    const Node& node = mNodes[nodeIndex];
+
+                    if (node.count > 0)
+                    {
+                        for (uint32_t i = node.offset; i < node.offset + node.count; i++)
+                        {
+                            const Triangle& tri = mTriangles[i];
+                            uint32_t feature;
+                            float3 q = closestPointOnTriangle(p, tri.v[0], tri.v[1], tri.v[2], feature);
+                            float distSq = glm::dot(p - q, p - q);
+                            if (distSq < bestDistSq)
+                            {
+                                bestDistSq = distSq;
+                                pBest = &tri;
+                                bestFeature = feature;
+                                closest = q;
+                            }
+                        }
+                    }
+                    else
+                    {
+                        // Visit the closer child first.
+                        uint32_t left = node.offset;
+                        uint32_t right = node.offset + 1;
+                        float leftDistSq = boxDistanceSquared(p, mNodes[left].boundsMin, mNodes[left].boundsMax);
+                        float rightDistSq = boxDistanceSquared(p, mNodes[right].boundsMin, mNodes[right].boundsMax);
+                        if (leftDistSq > rightDistSq)
+                        {
+                            std::swap(left, right);
+                            std::swap(leftDistSq, rightDistSq);
+                        }
+                        if (rightDistSq < bestDistSq) stack[stackSize++] = { right, rightDistSq };
+                        if (leftDistSq < bestDistSq) stack[stackSize++] = { left, leftDistSq };
+                    }
+                }
+
+                if (!pBest) return false;
+                distance = std::sqrt(bestDistSq);
+                normal = pBest->normals[bestFeature];
+                return true;
+            }
+
+        private:
+            struct Node
+            {
+                float3 boundsMin;
+                uint32_t offset = 0;    ///< First triangle for leaves, first of the two children otherwise.
+                float3 boundsMax;
+                uint32_t count = 0;     ///< Number of triangles for leaves, zero otherwise.
+            };
+
+            void buildNode(uint32_t nodeIndex, std::vector<uint32_t>& order, uint32_t begin, uint32_t end)
+            {
+                float3 boundsMin(std::numeric_limits<float>::max());
+                float3 boundsMax(-std::numeric_limits<float>::max());
+                float3 centroidMin = boundsMin;
+                float3 centroidMax = boundsMax;
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    const Triangle& tri = mTriangles[order[i]];
+                    for (const auto& v : tri.v)
+                    {
+                        boundsMin = glm::min(boundsMin, v);
+                        boundsMax = glm::max(boundsMax, v);
+                    }
+                    float3 centroid = (tri.v[0] + tri.v[1] + tri.v[2]) / 3.f;
+                    centroidMin = glm::min(centroidMin, centroid);
+                    centroidMax = glm::max(centroidMax, centroid);
+                }
+
+                mNodes[nodeIndex].boundsMin = boundsMin;
+                mNodes[nodeIndex].boundsMax = boundsMax;
+
+                float3 extent = centroidMax - centroidMin;
+                int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+                if (end - begin <= kLeafSize || extent[axis] <= 0.f)
+                {
+                    mNodes[nodeIndex].offset = begin;
+                    mNodes[nodeIndex].count = end - begin;
+                    return;
+                }
+
+                uint32_t mid = (begin + end) / 2;
+                std::nth_element(order.begin() + begin, order.begin() + mid, order.begin() + end, [&](uint32_t a, uint32_t b)
+                {
+                    const Triangle& ta = mTriangles[a];
+                    const Triangle& tb = mTriangles[b];
+                    return ta.v[0][axis] + ta.v[1][axis] + ta.v[2][axis] < tb.v[0][axis] + tb.v[1][axis] + tb.v[2][axis];
+                });
+
+                uint32_t left = (uint32_t)mNodes.size();
+                mNodes.emplace_back();
+                mNodes.emplace_back();
+                mNodes[nodeIndex].offset = left;
+                buildNode(left, order, begin, mid);
+                buildNode(left + 1, order, mid, end);
+            }
+
+            std::vector<Triangle>& mTriangles;
+            std::vector<Node> mNodes;
+        };
+
+        /** Create triangles with angle weighted pseudo normals (see Baerentzen and Aanaes, Signed Distance Computation Using the Angle Weighted Pseudonormal).
+            Vertices with equal positions are welded so that the pseudo normals are shared across seams. Degenerate triangles are skipped.
+        */
+        std::vector<Triangle> createTriangles(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW)
+        {
+            // Weld vertices.
+            std::unordered_map<float3, uint32_t, PositionHash> positionToVertex;
+            std::vector<uint32_t> vertexRemap(positions.size());
+            std::vector<float3> vertices;
+            for (size_t i = 0; i < positions.size(); i++)
+            {
+                auto it = positionToVertex.try_emplace(positions[i], (uint32_t)vertices.size()).first;
+                if (it->second == vertices.size()) vertices.push_back(positions[i]);
+                vertexRemap[i] = it->second;
+            }
+
+            // Collect non-degenerate triangles with counter clockwise winding.
+            std::vector<uint3> faces;
+            std::vector<float3> faceNormals;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                uint3 f(vertexRemap[indices[i]], vertexRemap[indices[i + 1]], vertexRemap[indices[i + 2]]);
+                if (frontFaceCW) std::swap(f.y, f.z);
+                float3 n = glm::cross(vertices[f.y] - vertices[f.x], vertices[f.z] - vertices[f.x]);
+                float length = glm::length(n);
+                if (!(length > 0.f)) continue;
+                faces.push_back(f);
+                faceNormals.push_back(n / length);
+            }
+
+            // Accumulate angle weighted vertex normals.
+            std::vector<float3> vertexNormals(vertices.size(), float3(0.f));
+            for (size_t i = 0; i < faces.size(); i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    float3 p = vertices[faces[i][j]];
+                    float3 e0 = vertices[faces[i][(j + 1) % 3]] - p;
+                    float3 e1 = vertices[faces[i][(j + 2) % 3]] - p;
+                    float cosAngle = glm::dot(e0, e1) / (glm::length(e0) * glm::length(e1));
+                    float angle = std::acos(std::clamp(cosAngle, -1.f, 1.f));
+                    vertexNormals[faces[i][j]] += angle * faceNormals[i];
+                }
+            }
+
+            // Accumulate edge normals by sorting the edges of all faces.
+            std::vector<std::pair<uint64_t, uint32_t>> edges(3 * faces.size());
+            for (size_t i = 0; i < faces.size(); i++)
+            {
+                for (int j = 0; j < 3; j++)
+                {
+                    uint64_t a = faces[i][j];
+                    uint64_t b = faces[i][(j + 1) % 3];
+                    edges[3 * i + j] = { std::min(a, b) << 32 | std::max(a, b), uint32_t(3 * i + j) };
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            std::vector<float3> edgeNormals(edges.size());
+            for (size_t begin = 0, end = 0; begin < edges.size(); begin = end)
+            {
+                float3 n(0.f);
+                for (end = begin; end < edges.size() && edges[end].first == edges[begin].first; end++) n += faceNormals[edges[end].second / 3];
+                for (size_t i = begin; i < end; i++) edgeNormals[edges[i].second] = n;
+            }
+
+            std::vector<Triangle> triangles(faces.size());
+            for (size_t i = 0; i < faces.size(); i++)
+            {
+                auto& tri = triangles[i];
+                for (int j = 0; j < 3; j++)
+                {
+                    tri.v[j] = vertices[faces[i][j]];
+                    tri.normals[j] = vertexNormals[faces[i][j]];
+                    tri.normals[3 + j] = edgeNormals[3 * i + j];
+                }
+                tri.normals[6] = faceNormals[i];
+            }
+            return triangles;
+        }
+    }
+
+    SDFMeshBuilder::Result SDFMeshBuilder::build(const TriangleMesh& mesh, const Options& options)
+    {
+        std::vector<float3> positions(mesh.getVertices().size());
+        for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.getVertices()[i].position;
+        return build(positions, mesh.getIndices(), mesh.getFrontFaceCW(), options);
+    }
+
+    SDFMeshBuilder::Result SDFMeshBuilder::build(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW, const Options& options)
+    {
+        checkArgument(options.gridWidth > 0 && options.brickWidth > 0, "'gridWidth' ({}) and 'brickWidth' ({}) must be larger than zero", options.gridWidth, options.brickWidth);
+        checkArgument(options.gridWidth > 2 * options.margin, "'margin' ({}) is too large for a grid width of {}", options.margin, options.gridWidth);
+        checkArgument(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3", indices.size());
+        for (uint32_t index : indices) checkArgument(index < positions.size(), "Vertex index {} is out of range", index);
+
+        Result result;
+        SDFBrickData& bricks = result.bricks;
+        bricks.gridWidth = options.gridWidth;
+        bricks.brickWidth = options.brickWidth;
+
+        const uint32_t bricksPerAxis = bricks.getVirtualBricksPerAxis();
+        if ((uint64_t)bricksPerAxis * bricksPerAxis * bricksPerAxis > std::numeric_limits<uint32_t>::max())
+        {
+            throw RuntimeError("SDF grid width {} is too large for a brick width of {}.", options.gridWidth, options.brickWidth);
+        }
+
+        // Fit the mesh into the grid, leaving a margin for the narrow band around it.
+        float3 boundsMin(std::numeric_limits<float>::max());
+        float3 boundsMax(-std::numeric_limits<float>::max());
+        for (uint32_t index : indices)
+        {
+            boundsMin = glm::min(boundsMin, positions[index]);
+            boundsMax = glm::max(boundsMax, positions[index]);
+        }
+        float3 boundsExtent = boundsMax - boundsMin;
+        float extent = std::max({ boundsExtent.x, boundsExtent.y, boundsExtent.z });
+        if (indices.empty() || !(extent > 0.f)) throw RuntimeError("Cannot create an SDF from an empty mesh.");
+
+        result.meshCenter = 0.5f * (boundsMin + boundsMax);
+        result.meshScale = float(options.gridWidth - 2 * options.margin) / (options.gridWidth * extent);
+
+        // Transform positions to voxel space where the grid covers [0, gridWidth]^3.
+        std::vector<float3> voxelPositions(positions.size());
+        for (size_t i = 0; i < positions.size(); i++) voxelPositions[i] = ((positions[i] - result.meshCenter) * result.meshScale + 0.5f) * float(options.gridWidth);
+
+        std::vector<Triangle> triangles = createTriangles(voxelPositions, indices, frontFaceCW);
+        if (triangles.empty()) throw RuntimeError("Cannot create an SDF from a mesh without non-degenerate triangles.");
+
+        // Find the bricks overlapping the triangles. Bricks are expanded by a voxel so that all bricks with voxels containing the surface are found.
+        const uint32_t blockCount = ((uint32_t)triangles.size() + kTriangleBlockSize - 1) / kTriangleBlockSize;
+        std::vector<std::vector<uint32_t>> blockBricks(blockCount);
+        Threading::parallelFor<uint32_t>(0, blockCount, [&](uint32_t block)
+        {
+            const float brickWidth = float(options.brickWidth);
+            const float3 boxHalfSize(0.5f * brickWidth + 1.f);
+            auto& ids = blockBricks[block];
+
+            uint32_t end = std::min((block + 1) * kTriangleBlockSize, (uint32_t)triangles.size());
+            for (uint32_t t = block * kTriangleBlockSize; t < end; t++)
+            {
+                const float3* v = triangles[t].v;
+                int3 lo = glm::clamp(int3(glm::floor((glm::min(glm::min(v[0], v[1]), v[2]) - 1.f) / brickWidth)), int3(0), int3(bricksPerAxis - 1));
+                int3 hi = glm::clamp(int3(glm::floor((glm::max(glm::max(v[0], v[1]), v[2]) + 1.f) / brickWidth)), int3(0), int3(bricksPerAxis - 1));
+                for (int z = lo.z; z <= hi.z; z++)
+                {
+                    for (int y = lo.y; y <= hi.y; y++)
+                    {
+                        for (int x = lo.x; x <= hi.x; x++)
+                        {
+                            float3 boxCenter = (float3(x, y, z) + 0.5f) * brickWidth;
+                            if (triangleOverlapsBox(v, boxCenter, boxHalfSize)) ids.push_back(x + bricksPerAxis * (y + bricksPerAxis * z));
+                        }
+                    }
+                }
+            }
+
+            std::sort(ids.begin(), ids.end());
+            ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+        });
+
+        std::vector<uint32_t> candidates;
+        for (auto& ids : blockBricks)
+        {
+            candidates.insert(candidates.end(), ids.begin(), ids.end());
+            ids = {};
+        }
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+        TriangleBVH bvh(triangles);
+
+        // Evaluate the corner values of the candidate bricks and keep the bricks with voxels containing the surface.
+        const uint32_t w = bricks.getBrickWidthInValues();
+        const size_t valueCountPerBrick = bricks.getValueCountPerBrick();
+        std::vector<int8_t> values(candidates.size() * valueCountPerBrick);
+        std::vector<uint8_t> containsSurface(candidates.size(), 0);
+
+        Threading::parallelFor<size_t>(0, candidates.size(), [&](size_t i)
+        {
+            uint32_t id = candidates[i];
+            uint3 brickCoords(id % bricksPerAxis, (id / bricksPerAxis) % bricksPerAxis, id / (bricksPerAxis * bricksPerAxis));
+            uint3 brickOrigin = brickCoords * options.brickWidth;
+            int8_t* pValues = values.data() + i * valueCountPerBrick;
+
+            // Distances change by at most one voxel between neighboring corners. This bounds the search for the next corner,
+            // and the sign can't change while the distance stays above zero, so far away corners are saturated without a search.
+            // The distance at the first corner of the previous row (or slice) bounds the search for the first corner of the next one.
+            float sliceStartDistance = std::numeric_limits<float>::infinity();
+            for (uint32_t z = 0; z < w; z++)
+            {
+                float rowStartDistance = sliceStartDistance;
+                for (uint32_t y = 0; y < w; y++)
+                {
+                    float lowerBound = 0.f;
+                    float upperBound = rowStartDistance + 1.f;
+                    float sign = 1.f;
+                    for (uint32_t x = 0; x < w; x++, lowerBound -= 1.f, upperBound += 1.f)
+                    {
+                        uint3 corner = brickOrigin + uint3(x, y, z);
+                        int8_t& value = pValues[x + w * (y + w * z)];
+                        if (glm::any(glm::greaterThan(corner, uint3(options.gridWidth))))
+                        {
+                            value = INT8_MAX;
+                            lowerBound = 0.f;
+                            upperBound = std::numeric_limits<float>::infinity();
+                            if (x == 0) rowStartDistance = upperBound;
+                            if (x == 0 && y == 0) sliceStartDistance = upperBound;
+                            continue;
+                        }
+
+                        if (lowerBound * kNormalization >= 1.f)
+                        {
+                            value = SDFBrickData::quantize(sign);
+                            continue;
+                        }
+
+                        float3 p = float3(corner);
+                        float distance;
+                        float3 normal, closest;
+                        if (!bvh.findClosest(p, upperBound + 1e-3f, distance, normal, closest))
+                        {
+                            bvh.findClosest(p, std::numeric_limits<float>::infinity(), distance, normal, closest);
+                        }
+                        lowerBound = upperBound = distance;
+                        if (x == 0) rowStartDistance = distance;
+                        if (x == 0 && y == 0) sliceStartDistance = distance;
+
+                        sign = glm::dot(p - closest, normal) < 0.f ? -1.f : 1.f;
+                        value = SDFBrickData::quantize(sign * distance * kNormalization);
+                    }
+                }
+            }
+
+            containsSurface[i] = SDFBrickData::containsSurface(pValues, options.brickWidth) ? 1 : 0;
+        });
+
+        // Compact the bricks containing the surface.
+        for (size_t i = 0; i < candidates.size(); i++)
+        {
+            if (!containsSurface[i]) continue;
+            uint32_t id = candidates[i];
+            bricks.brickCoords.emplace_back(id % bricksPerAxis, (id / bricksPerAxis) % bricksPerAxis, id / (bricksPerAxis * bricksPerAxis));
+            bricks.values.insert(bricks.values.end(), values.begin() + i * valueCountPerBrick, values.begin() + (i + 1) * valueCountPerBrick);
+        }
+
+        return result;
+    }
+}
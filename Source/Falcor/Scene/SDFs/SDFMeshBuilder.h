@@ -0,0 +1,79 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SDFBrickData.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <vector>
+#include <cstdint>
+
+namespace Falcor
+{
+    class TriangleMesh;
+
+    /** Builds sparse SDF bricks from a triangle mesh on the CPU.
+
+        The mesh is uniformly scaled and centered to fit the local space [-0.5, 0.5]^3 of the SDF grid.
+        Only bricks overlapping the triangles are evaluated, the dense value grid is never allocated.
+        Distances are found using a BVH over the triangles and signed using angle weighted pseudo normals,
+        which requires the mesh to be closed and consistently oriented. Bricks are evaluated in parallel.
+    */
+    class FALCOR_API SDFMeshBuilder
+    {
+    public:
+        struct Options
+        {
+            uint32_t gridWidth = 256;   ///< Width of the SDF grid in voxels.
+            uint32_t brickWidth = 7;    ///< Width of a brick in voxels.
+            uint32_t margin = 2;        ///< Number of voxels between the mesh bounds and the grid boundary.
+        };
+
+        struct Result
+        {
+            SDFBrickData bricks;                ///< Bricks containing the surface of the mesh.
+            float3 meshCenter = float3(0.f);    ///< Center of the mesh bounds, which is mapped to the origin of the grid.
+            float meshScale = 1.f;              ///< Scale from mesh space to the local space of the grid.
+        };
+
+        /** Build SDF bricks from a triangle mesh.
+            \param[in] mesh The triangle mesh.
+            \param[in] options Build options.
+            \return The bricks and the transform from mesh space to grid local space.
+        */
+        static Result build(const TriangleMesh& mesh, const Options& options);
+
+        /** Build SDF bricks from a triangle list.
+            \param[in] positions Vertex positions.
+            \param[in] indices Vertex indices, three per triangle.
+            \param[in] frontFaceCW True if front facing triangles are wound clockwise, i.e., their normals point inwards.
+            \param[in] options Build options.
+            \return The bricks and the transform from mesh space to grid local space.
+        */
+        static Result build(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, bool frontFaceCW, const Options& options);
+    };
+}
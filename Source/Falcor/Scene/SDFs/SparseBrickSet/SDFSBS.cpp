@@ -31,6 +31,9 @@
 #include "Core/API/IndirectCommands.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Scene/SDFs/SDFVoxelTypes.slang"
+#include "Utils/Threading.h"
+#include <cstring>
+#include <limits>
 
 namespace Falcor
 {
@@ -56,6 +59,9 @@ namespace Falcor
 
         // Chunk width must be equal to 4 for now.
         const uint32_t kChunkWidth = 4;
+
+        // Width of a BC4 block.
+        const uint32_t kCompressionWidth = 4;
     }
 
     SDFSBS::SharedPtr SDFSBS::create(uint32_t brickWidth, bool compressed, uint32_t defaultGridWidth)
@@ -88,6 +94,13 @@ namespace Falcor
 
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
+        // Grids created from sparse bricks are static. Their resources are created from the bricks in createResources().
+        if (mCreatedFromBricks)
+        {
+            if (!mPrimitives.empty()) throw RuntimeError("An SDFSBS created from sparse bricks can't be combined with primitives!");
+            return UpdateFlags::None;
+        }
+
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
         bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
         if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
@@ -112,7 +125,13 @@ namespace Falcor
             mSDField.clear();
         }
 
-        if (!mPrimitives.empty())
+        if (mCreatedFromBricks)
+        {
+            if (!mPrimitives.empty()) throw RuntimeError("An SDFSBS created from sparse bricks can't be combined with primitives!");
+            if (mBricks.gridWidth > 0) createResourcesFromBricks();
+            mBricks = {};
+        }
+        else if (!mPrimitives.empty())
         {
             createResourcesFromPrimitivesAndSDField(pRenderContext, deleteScratchData);
         }
@@ -969,6 +988,8 @@ namespace Falcor
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mSDField.resize(valueCount);
+        mCreatedFromBricks = false;
+        mBricks = {};
 
         // The grid is in the size [-1, 1] thus the longest distance that can be stored is sqrt(3) (the length from corner to corner)
         constexpr float normalizationFactor = 1.f;// 1.f / glm::root_three<float>();
@@ -980,6 +1001,109 @@ namespace Falcor
         }
     }
 
+    void SDFSBS::setBricksInternal(const SDFBrickData& bricks)
+    {
+        checkArgument(bricks.brickWidth == mBrickWidth, "Brick width ({}) does not match the brick width of the SDFSBS ({})", bricks.brickWidth, mBrickWidth);
+
+        mBricks = bricks;
+        mCreatedFromBricks = true;
+        mSDField.clear();
+        mpSDFGridTexture.reset();
+    }
+
+    void SDFSBS::createResourcesFromBricks()
+    {
+        mBrickCount = mBricks.getBrickCount();
+        mVirtualBricksPerAxis = std::max(mVirtualBricksPerAxis, mBricks.getVirtualBricksPerAxis());
+
+        // Create the indirection texture and brick AABBs.
+        {
+            std::vector<uint32_t> indirection((size_t)mVirtualBricksPerAxis * mVirtualBricksPerAxis * mVirtualBricksPerAxis, std::numeric_limits<uint32_t>::max());
+            std::vector<AABB> brickAABBs(mBrickCount);
+            for (uint32_t brickID = 0; brickID < mBrickCount; brickID++)
+            {
+                const uint3& virtualBrickCoords = mBricks.brickCoords[brickID];
+                indirection[virtualBrickCoords.x + mVirtualBricksPerAxis * (virtualBrickCoords.y + mVirtualBricksPerAxis * virtualBrickCoords.z)] = brickID;
+
+                float3 brickAABBMin = -0.5f + float3(virtualBrickCoords * mBrickWidth) / float(mGridWidth);
+                float3 brickAABBMax = glm::min(brickAABBMin + float(mBrickWidth) / float(mGridWidth), float3(0.5f));
+                brickAABBs[brickID] = AABB(brickAABBMin, brickAABBMax);
+            }
+
+            mpIndirectionTexture = Texture::create3D(mVirtualBricksPerAxis, mVirtualBricksPerAxis, mVirtualBricksPerAxis, ResourceFormat::R32Uint, 1, indirection.data(), ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess);
+            mpIndirectionTexture->setName("SDFSBS::IndirectionTextureBricks");
+
+            mpBrickAABBsBuffer = Buffer::createStructured(sizeof(AABB), std::max(mBrickCount, 1u), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource, Buffer::CpuAccess::None, brickAABBs.data(), false);
+            mpBrickAABBsBuffer->setName("SDFSBS::BrickAABBsBuffer");
+        }
+
+        // Create the brick texture, using the same layout as createResourcesFromSDField().
+        {
+            uint32_t brickWidthInValues = mBrickWidth + 1;
+            uint32_t bricksAlongX = std::max(1u, (uint32_t)std::ceil(std::sqrt((float)mBrickCount / brickWidthInValues)));
+            uint32_t bricksAlongY = std::max(1u, (uint32_t)std::ceil((float)mBrickCount / bricksAlongX));
+            mBricksPerAxis = uint2(bricksAlongX, bricksAlongY);
+
+            uint32_t textureWidth = brickWidthInValues * brickWidthInValues * bricksAlongX;
+            uint32_t textureHeight = brickWidthInValues * bricksAlongY;
+
+            if (mCompressed)
+            {
+                uint32_t blocksPerRow = textureWidth / kCompressionWidth;
+                std::vector<uint64_t> blocks((size_t)blocksPerRow * (textureHeight / kCompressionWidth), 0);
+                Threading::parallelFor<uint32_t>(0, mBrickCount, [&](uint32_t brickID)
+                {
+                    const int8_t* pValues = mBricks.getBrickValues(brickID);
+                    uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+                    for (uint32_t z = 0; z < brickWidthInValues; ++z)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; y += kCompressionWidth)
+                        {
+                            for (uint32_t x = 0; x < brickWidthInValues; x += kCompressionWidth)
+                            {
+                                int8_t block[16];
+                                for (uint32_t bY = 0; bY < kCompressionWidth; ++bY)
+                                {
+                                    for (uint32_t bX = 0; bX < kCompressionWidth; ++bX) block[bX + kCompressionWidth * bY] = pValues[(x + bX) + brickWidthInValues * ((y + bY) + brickWidthInValues * z)];
+                                }
+
+                                uint2 blockTextureCoords = (brickTextureCoords + uint2(x + z * brickWidthInValues, y)) / kCompressionWidth;
+                                blocks[blockTextureCoords.x + blocksPerRow * blockTextureCoords.y] = SDFBrickData::compressBC4Block(block);
+                            }
+                        }
+                    }
+                });
+
+                mpBrickTexture = Texture::create2D(textureWidth, textureHeight, ResourceFormat::BC4Snorm, 1, 1, blocks.data());
+            }
+            else
+            {
+                std::vector<int8_t> texels((size_t)textureWidth * textureHeight, 0);
+                Threading::parallelFor<uint32_t>(0, mBrickCount, [&](uint32_t brickID)
+                {
+                    const int8_t* pValues = mBricks.getBrickValues(brickID);
+                    uint2 brickTextureCoords = uint2(brickID % bricksAlongX, brickID / bricksAlongX) * uint2(brickWidthInValues * brickWidthInValues, brickWidthInValues);
+                    for (uint32_t z = 0; z < brickWidthInValues; ++z)
+                    {
+                        for (uint32_t y = 0; y < brickWidthInValues; ++y)
+                        {
+                            size_t offset = (size_t)(brickTextureCoords.y + y) * textureWidth + brickTextureCoords.x + z * brickWidthInValues;
+                            std::memcpy(texels.data() + offset, pValues + brickWidthInValues * (y + brickWidthInValues * z), brickWidthInValues);
+                        }
+                    }
+                });
+
+                mpBrickTexture = Texture::create2D(textureWidth, textureHeight, ResourceFormat::R8Snorm, 1, 1, texels.data(), ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource);
+            }
+
+            mpBrickTexture->setName("SDFSBS::BrickTexture");
+            mBrickTextureDimensions = uint2(mpBrickTexture->getWidth(), mpBrickTexture->getHeight());
+        }
+
+        mHasGridRepresentation = true;
+        mWasEmpty = false;
+    }
+
     void SDFSBS::createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int16_t>& sdField)
     {
         checkArgument(!sdField.empty(), "Cannot create SDF grid texture from empty values vector");
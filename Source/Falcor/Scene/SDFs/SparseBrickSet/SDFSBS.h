@@ -70,6 +70,7 @@ namespace Falcor
 
     protected:
         void createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData);
+        void createResourcesFromBricks();
         SDFGrid::UpdateFlags createResourcesFromPrimitivesAndSDField(RenderContext* pRenderContext, bool deleteScratchData);
 
         void expandSDFGridTexture(RenderContext* pRenderContext, bool deleteScratchData, uint32_t oldGridWidthInSDField, uint32_t gridWidthInSDField);
@@ -78,6 +79,8 @@ namespace Falcor
         void allocatePrimitiveBits();
 
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setBricksInternal(const SDFBrickData& bricks) override;
+        virtual uint32_t getPreferredBrickWidth() const override { return mBrickWidth; }
 
         void createSDFGridTexture(RenderContext* pRenderContext, const std::vector<int16_t>& sdField);
 
@@ -91,6 +94,7 @@ namespace Falcor
 
         // CPU data.
         std::vector<int16_t> mSDField;
+        SDFBrickData mBricks;                           ///< Bricks to create the grid from, cleared once the GPU data is created.
 
         // Specs.
         uint32_t mDefaultGridWidth = 0;                 ///< The grid width used if the grid was not loaded from a file (it is empty).
@@ -108,6 +112,7 @@ namespace Falcor
         uint32_t mCurrentBakedPrimitiveCount = 0;
         bool mWasEmpty = false;
         bool mBuildEmptyGrid = false;
+        bool mCreatedFromBricks = false;                ///< True if the grid was created from sparse bricks, which can't be combined with primitives.
 
         // GPU data.
         Buffer::SharedPtr mpBrickAABBsBuffer;           ///< A compact buffer containing AABBs for each brick.
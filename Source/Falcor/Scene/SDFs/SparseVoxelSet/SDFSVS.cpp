@@ -29,7 +29,8 @@
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Math/MathHelpers.h"
-#include "Scene/SDFs/SDFVoxelTypes.slang"
+#include "Utils/Threading.h"
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -61,6 +62,15 @@ namespace Falcor
             throw RuntimeError("An SDFSVS instance cannot be created from primitives!");
         }
 
+        // Voxels created from sparse bricks are uploaded directly.
+        if (!mVoxels.empty())
+        {
+            mVoxelCount = (uint32_t)mVoxels.size();
+            mpVoxelAABBBuffer = Buffer::createStructured(sizeof(AABB), mVoxelCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, mVoxelAABBs.data(), false);
+            mpVoxelBuffer = Buffer::createStructured(sizeof(SDFSVSVoxel), mVoxelCount, ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess, Buffer::CpuAccess::None, mVoxels.data(), false);
+            return;
+        }
+
         if (mpSDFGridTexture && mpSDFGridTexture->getWidth() == mGridWidth + 1)
         {
             pRenderContext->updateTextureData(mpSDFGridTexture.get(), mValues.data());
@@ -177,6 +187,8 @@ namespace Falcor
         uint32_t gridWidthInValues = mGridWidth + 1;
         uint32_t valueCount = gridWidthInValues * gridWidthInValues * gridWidthInValues;
         mValues.resize(valueCount);
+        mVoxels.clear();
+        mVoxelAABBs.clear();
 
         float normalizationMultipler = 2.0f * mGridWidth / glm::root_three<float>();
         for (uint32_t v = 0; v < valueCount; v++)
@@ -187,4 +199,113 @@ namespace Falcor
             mValues[v] = integerScale >= 0.0f ? int8_t(integerScale + 0.5f) : int8_t(integerScale - 0.5f);
         }
     }
+
+    void SDFSVS::setBricksInternal(const SDFBrickData& bricks)
+    {
+        // Create the voxels on the CPU the same way SDFSVSVoxelizer.cs.slang does from the dense grid.
+        const uint32_t bricksPerAxis = bricks.getVirtualBricksPerAxis();
+        const uint32_t w = bricks.getBrickWidthInValues();
+
+        std::unordered_map<uint64_t, uint32_t> brickMap;
+        auto getBrickKey = [&](const uint3& brickCoords) { return brickCoords.x + bricksPerAxis * (brickCoords.y + (uint64_t)bricksPerAxis * brickCoords.z); };
+        for (uint32_t brickID = 0; brickID < bricks.getBrickCount(); brickID++) brickMap[getBrickKey(bricks.brickCoords[brickID])] = brickID;
+
+        // Returns the value at a grid corner, or nullptr if it is outside the bricks. The corner is looked up in the brick of the voxel with the same coords,
+        // or in the brick of the neighboring voxel for corners on the upper brick boundaries.
+        auto findValue = [&](const int3& corner) -> const int8_t*
+        {
+            if (glm::any(glm::lessThan(corner, int3(0))) || glm::any(glm::greaterThan(corner, int3(mGridWidth)))) return nullptr;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                int3 voxel = corner - int3(i & 1, (i >> 1) & 1, i >> 2);
+                if (glm::any(glm::lessThan(voxel, int3(0)))) continue;
+                uint3 brickCoords = uint3(voxel) / bricks.brickWidth;
+                if (glm::any(glm::greaterThanEqual(brickCoords, uint3(bricksPerAxis)))) continue;
+                auto it = brickMap.find(getBrickKey(brickCoords));
+                if (it == brickMap.end()) continue;
+                uint3 local = uint3(corner) - brickCoords * bricks.brickWidth;
+                return bricks.getBrickValues(it->second) + local.x + w * (local.y + w * local.z);
+            }
+            return nullptr;
+        };
+
+        auto voxelContainsSurface = [&](const int3& voxel)
+        {
+            if (glm::any(glm::lessThan(voxel, int3(0))) || glm::any(glm::greaterThanEqual(voxel, int3(mGridWidth)))) return false;
+            bool hasNegative = false;
+            bool hasPositive = false;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                const int8_t* pValue = findValue(voxel + int3(i & 1, (i >> 1) & 1, i >> 2));
+                if (!pValue) return false;
+                hasNegative |= *pValue <= 0;
+                hasPositive |= *pValue >= 0;
+            }
+            return hasNegative && hasPositive;
+        };
+
+        std::vector<std::vector<SDFSVSVoxel>> brickVoxels(bricks.getBrickCount());
+        std::vector<std::vector<AABB>> brickVoxelAABBs(bricks.getBrickCount());
+        Threading::parallelFor<uint32_t>(0, bricks.getBrickCount(), [&](uint32_t brickID)
+        {
+            int3 brickOrigin = int3(bricks.brickCoords[brickID] * bricks.brickWidth);
+            for (uint32_t z = 0; z < bricks.brickWidth; z++)
+            {
+                for (uint32_t y = 0; y < bricks.brickWidth; y++)
+                {
+                    for (uint32_t x = 0; x < bricks.brickWidth; x++)
+                    {
+                        int3 voxelCoords = brickOrigin + int3(x, y, z);
+                        if (!voxelContainsSurface(voxelCoords)) continue;
+
+                        // Corners outside the bricks contain no surface, they are approximated by the saturated value of the closest corner of the voxel.
+                        auto loadValue = [&](const int3& corner)
+                        {
+                            if (glm::any(glm::lessThan(corner, int3(0))) || glm::any(glm::greaterThanEqual(corner, int3(mGridWidth)))) return INT8_MAX;
+                            if (const int8_t* pValue = findValue(corner)) return (int)*pValue;
+                            int value = *findValue(glm::clamp(corner, voxelCoords, voxelCoords + 1));
+                            return value < 0 ? -INT8_MAX : INT8_MAX;
+                        };
+
+                        SDFSVSVoxel voxel;
+                        for (int sx = 0; sx < 4; sx++)
+                        {
+                            uint32_t packedValues[4];
+                            for (int sy = 0; sy < 4; sy++)
+                            {
+                                packedValues[sy] = 0;
+                                for (int sz = 0; sz < 4; sz++) packedValues[sy] |= uint32_t(uint8_t(loadValue(voxelCoords + int3(sx - 1, sy - 1, sz - 1)))) << (8 * sz);
+                            }
+                            voxel.packedValuesSlices[sx] = uint4(packedValues[0], packedValues[1], packedValues[2], packedValues[3]);
+                        }
+
+                        voxel.validNeighborsMask = 0;
+                        for (int nz = 0; nz <= 2; nz++)
+                        {
+                            for (int ny = 0; ny <= 2; ny++)
+                            {
+                                for (int nx = 0; nx <= 2; nx++)
+                                {
+                                    if (voxelContainsSurface(voxelCoords + int3(nx - 1, ny - 1, nz - 1))) voxel.validNeighborsMask |= 1u << (nz + 3 * (ny + 3 * nx));
+                                }
+                            }
+                        }
+
+                        float3 p = float3(voxelCoords) - float(mGridWidth) * 0.5f;
+                        brickVoxels[brickID].push_back(voxel);
+                        brickVoxelAABBs[brickID].push_back(AABB(p / float(mGridWidth), (p + 1.0f) / float(mGridWidth)));
+                    }
+                }
+            }
+        });
+
+        mValues.clear();
+        mVoxels.clear();
+        mVoxelAABBs.clear();
+        for (uint32_t brickID = 0; brickID < bricks.getBrickCount(); brickID++)
+        {
+            mVoxels.insert(mVoxels.end(), brickVoxels[brickID].begin(), brickVoxels[brickID].end());
+            mVoxelAABBs.insert(mVoxelAABBs.end(), brickVoxelAABBs[brickID].begin(), brickVoxelAABBs[brickID].end());
+        }
+    }
 }
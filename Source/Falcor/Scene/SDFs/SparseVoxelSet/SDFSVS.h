@@ -28,6 +28,7 @@
 #pragma once
 
 #include "Scene/SDFs/SDFGrid.h"
+#include "Scene/SDFs/SDFVoxelTypes.slang"
 #include "Core/API/Buffer.h"
 #include "Core/API/Texture.h"
 #include "RenderGraph/BasePasses/ComputePass.h"
@@ -59,12 +60,15 @@ namespace Falcor
 
     protected:
         virtual void setValuesInternal(const std::vector<float>& cornerValues) override;
+        virtual void setBricksInternal(const SDFBrickData& bricks) override;
 
     private:
         SDFSVS() = default;
 
         // CPU data.
         std::vector<int8_t> mValues;
+        std::vector<SDFSVSVoxel> mVoxels;               ///< Voxels created on the CPU from sparse bricks, used instead of mValues if not empty.
+        std::vector<AABB> mVoxelAABBs;
 
         // Specs.
         Buffer::SharedPtr mpVoxelAABBBuffer;
@@ -74,7 +74,7 @@ namespace Falcor
         const std::string kPrevCurveVertexBufferName = "prevCurveVertices";
         const std::string kSDFGridsArrayName = "sdfGrids";
         const std::string kCustomPrimitiveBufferName = "customPrimitives";
-        const std::string kMaterialsBlockName = "materials";
+        constexpr ShaderVarName kMaterialsBlockName("materials");
         const std::string kLightsBufferName = "lights";
         const std::string kGridVolumesBufferName = "gridVolumes";
 
@@ -209,11 +209,12 @@ namespace Falcor
         for (const auto &mesh : sceneData.cachedMeshes)
         {
             if (!mMeshDesc[mesh.meshID.get()].isAnimated()) throw RuntimeError("Cached Mesh Animation: Referenced mesh ID is not dynamic");
-            if (mesh.timeSamples.size() != mesh.vertexData.size()) throw RuntimeError("Cached Mesh Animation: Time sample count mismatch.");
+            if (mesh.timeSamples.size() != mesh.getKeyframeCount()) throw RuntimeError("Cached Mesh Animation: Time sample count mismatch.");
             for (const auto &vertices : mesh.vertexData)
             {
                 if (vertices.size() != mMeshDesc[mesh.meshID.get()].vertexCount) throw RuntimeError("Cached Mesh Animation: Vertex count mismatch.");
             }
+            if (mesh.getKeyframeCount() > 0 && mesh.getVertexCount() != mMeshDesc[mesh.meshID.get()].vertexCount) throw RuntimeError("Cached Mesh Animation: Vertex count mismatch.");
         }
         for (const auto& cache : sceneData.cachedCurves)
         {
@@ -332,7 +333,7 @@ namespace Falcor
     {
         FALCOR_PROFILE("rasterizeScene");
 
-        pVars->setParameterBlock(kParameterBlockName, mpSceneBlock);
+        pVars->getRootVar()[mSceneBlockHandle] = mpSceneBlock;
 
         auto pCurrentRS = pState->getRasterizerState();
         bool isIndexed = hasIndexBuffer();
@@ -386,7 +387,7 @@ namespace Falcor
         setRaytracingShaderData(pContext, pVars->getRootVar(), rayTypeCount);
 
         // Set ray type constant.
-        pVars->getRootVar()["DxrPerFrame"]["rayTypeCount"] = rayTypeCount;
+        pVars->getRootVar()[mRayTypeCountHandle] = rayTypeCount;
 
         pContext->raytrace(pProgram, pVars.get(), dispatchDims.x, dispatchDims.y, dispatchDims.z);
     }
@@ -713,7 +714,7 @@ namespace Falcor
 
     void Scene::uploadSelectedCamera()
     {
-        getCamera()->setShaderData(mpSceneBlock[kCamera]);
+        getCamera()->setShaderData(mpSceneBlock[mCameraHandle]);
     }
 
     void Scene::updateBounds()
@@ -1572,7 +1573,7 @@ namespace Falcor
             flags |= UpdateFlags::MaterialsChanged;
 
             // Bind materials parameter block to scene.
-            mpSceneBlock->setParameterBlock(kMaterialsBlockName, mpMaterials->getParameterBlock());
+            mpSceneBlock[kMaterialsBlockName] = mpMaterials->getParameterBlock();
 
             // If displacement parameters have changed, we need to trigger displacement update.
             if (is_set(materialUpdates, Material::UpdateFlags::DisplacementChanged))
@@ -1939,6 +1940,8 @@ namespace Falcor
                 << "  Texture count (compressed): " << s.materials.textureCompressedCount << std::endl
                 << "  Texture texel count: " << s.materials.textureTexelCount << std::endl
                 << "  Texture memory: " << formatByteSize(s.materials.textureMemoryInBytes) << std::endl
+                << "  Texture count (deduplicated): " << s.materials.textureDeduplicatedCount << std::endl
+                << "  Texture memory saved by deduplication: " << formatByteSize(s.materials.textureDeduplicatedMemoryInBytes) << std::endl
                 << "  Bytes/texel (average): " << std::fixed << std::setprecision(2) << bytesPerTexel << std::endl
                 << std::endl;
 
@@ -3549,11 +3552,11 @@ namespace Falcor
 
         // Bind TLAS.
         FALCOR_ASSERT(tlasIt != mTlasCache.end() && tlasIt->second.pTlasObject)
-        mpSceneBlock["rtAccel"].setAccelerationStructure(tlasIt->second.pTlasObject);
+        mpSceneBlock[mRtAccelHandle].setAccelerationStructure(tlasIt->second.pTlasObject);
 
         // Bind Scene parameter block.
-        getCamera()->setShaderData(mpSceneBlock[kCamera]); // TODO REMOVE: Shouldn't be needed anymore?
-        var[kParameterBlockName] = mpSceneBlock;
+        getCamera()->setShaderData(mpSceneBlock[mCameraHandle]); // TODO REMOVE: Shouldn't be needed anymore?
+        var[mSceneBlockHandle] = mpSceneBlock;
     }
 
     std::vector<uint32_t> Scene::getMeshBlasIDs() const
@@ -3847,6 +3850,8 @@ namespace Falcor
         d["textureCompressedCount"] = materials.textureCompressedCount;
         d["textureTexelCount"] = materials.textureTexelCount;
         d["textureMemoryInBytes"] = materials.textureMemoryInBytes;
+        d["textureDeduplicatedCount"] = materials.textureDeduplicatedCount;
+        d["textureDeduplicatedMemoryInBytes"] = materials.textureDeduplicatedMemoryInBytes;
 
         // Raytracing stats
         d["blasGroupCount"] = blasGroupCount;
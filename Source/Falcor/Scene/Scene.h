@@ -1285,6 +1285,12 @@ namespace Falcor
         Buffer::SharedPtr mpGridVolumesBuffer;
         ParameterBlock::SharedPtr mpSceneBlock;
 
+        // Cached lookups of the shader variables bound every frame
+        ShaderVarHandle mSceneBlockHandle{ ShaderVarName("gScene") };
+        ShaderVarHandle mRtAccelHandle{ ShaderVarName("rtAccel") };
+        ShaderVarHandle mCameraHandle{ ShaderVarName("camera") };
+        ShaderVarHandle mRayTypeCountHandle{ ShaderVarName("DxrPerFrame"), ShaderVarName("rayTypeCount") };
+
         // Camera
         UpDirection mUpDirection = UpDirection::YPos;
         CameraControllerType mCamCtrlType = CameraControllerType::FirstPerson;
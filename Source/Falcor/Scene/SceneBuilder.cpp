@@ -31,14 +31,19 @@
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/Algorithm/UniqueElements.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
+#include "Utils/Threading.h"
 #include <mikktspace.h>
+#include <fstd/bit.h> // TODO C++20: Replace with <bit>
 #include <filesystem>
 #include <cmath>
+#include <algorithm>
+#include <unordered_map>
 
 namespace Falcor
 {
@@ -52,6 +57,12 @@ namespace Falcor
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
 
+        // Threshold for comparing vertex attributes when merging duplicate vertices.
+        const float kVertexMergeThreshold = 1e-6f;
+
+        // Meshes with at least this many indices have their duplicate vertices merged in parallel.
+        const size_t kParallelVertexMergeThreshold = 1 << 16;
+
         int largestAxis(const float3& v)
         {
             if (v.x >= v.y && v.x >= v.z) return 0;
@@ -161,7 +172,7 @@ namespace Falcor
             if (isZero(v.normal) || isZero(v.tangent.xyz())) zeroCount++;
         }
 
-        bool compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, float threshold = 1e-6f)
+        bool compareVertices(const SceneBuilder::Mesh::Vertex& lhs, const SceneBuilder::Mesh::Vertex& rhs, float threshold = kVertexMergeThreshold)
         {
             using namespace glm;
             if (lhs.position != rhs.position) return false; // Position need to be exact to avoid cracks
@@ -175,6 +186,102 @@ namespace Falcor
             return true;
         }
 
+        uint64_t hashCombine(uint64_t hash, uint64_t value)
+        {
+            // Mixing function from splitmix64.
+            hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+            hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9ull;
+            hash = (hash ^ (hash >> 27)) * 0x94d049bb133111ebull;
+            return hash ^ (hash >> 31);
+        }
+
+        /** Compute a hash of a vertex for merging duplicate vertices.
+            The hash covers the original vertex index and the attributes that compareVertices() compares exactly.
+            Attributes that are compared with a tolerance are not hashed, so vertices that compare equal always hash identically.
+        */
+        uint64_t computeVertexHash(const SceneBuilder::Mesh::Vertex& v, uint32_t origIndex)
+        {
+            uint64_t hash = origIndex;
+            auto hashExact = [&hash](float x)
+            {
+                // Hash by value so that +0 and -0 hash identically.
+                hash = hashCombine(hash, x == 0.f ? 0u : fstd::bit_cast<uint32_t>(x));
+            };
+
+            for (int i = 0; i < 3; ++i) hashExact(v.position[i]);
+            hashExact(v.tangent.w);
+            hashExact(v.curveRadius);
+            for (int i = 0; i < 4; ++i) hash = hashCombine(hash, v.boneIDs[i]);
+            return hash;
+        }
+
+        /** Find duplicate vertices in a mesh.
+            Each index buffer entry (corner) is mapped to the first corner with an identical vertex.
+            Corners are bucketed by computeVertexHash() and only compared against earlier unique corners in the same bucket.
+            For large meshes the corners are partitioned by hash and the partitions are processed in parallel.
+            The result is deterministic as each partition is processed in index buffer order.
+            \param[in] mesh The mesh.
+            \return For each corner, the index of the first corner that has an identical vertex (possibly itself).
+        */
+        std::vector<uint32_t> findDuplicateVertices(const SceneBuilder::Mesh& mesh)
+        {
+            const uint32_t invalidIndex = 0xffffffff;
+            const size_t cornerCount = mesh.indexCount;
+
+            // Hash all corners.
+            std::vector<uint64_t> hashes(cornerCount);
+            Threading::parallelFor<size_t>(0, cornerCount, [&](size_t i)
+            {
+                hashes[i] = computeVertexHash(mesh.getVertex((uint32_t)i / 3, (uint32_t)i % 3), mesh.pIndices[i]);
+            });
+
+            // Partition corners by hash (counting sort, preserving the index buffer order within each partition).
+            const size_t partitionCount = cornerCount < kParallelVertexMergeThreshold ? 1 : (size_t)Threading::getThreadCount() * 4;
+            auto getPartition = [&](size_t i) { return (size_t)(hashes[i] >> 32) % partitionCount; };
+
+            std::vector<size_t> partitionOffsets(partitionCount + 1, 0);
+            for (size_t i = 0; i < cornerCount; ++i) partitionOffsets[getPartition(i) + 1]++;
+            for (size_t p = 0; p < partitionCount; ++p) partitionOffsets[p + 1] += partitionOffsets[p];
+
+            std::vector<uint32_t> partitionCorners(cornerCount);
+            {
+                std::vector<size_t> writeOffsets(partitionOffsets.begin(), partitionOffsets.end() - 1);
+                for (size_t i = 0; i < cornerCount; ++i) partitionCorners[writeOffsets[getPartition(i)]++] = (uint32_t)i;
+            }
+
+            // Find the first identical corner for each corner.
+            // Each bucket holds a linked list of unique corners with the same hash, which avoids allocations per bucket.
+            std::vector<uint32_t> firstCorner(cornerCount);
+            std::vector<uint32_t> next(cornerCount, invalidIndex);
+
+            Threading::parallelFor<size_t>(0, partitionCount, [&](size_t p)
+            {
+                std::unordered_map<uint64_t, uint32_t> heads;
+                heads.reserve(partitionOffsets[p + 1] - partitionOffsets[p]);
+
+                for (size_t k = partitionOffsets[p]; k < partitionOffsets[p + 1]; ++k)
+                {
+                    const uint32_t corner = partitionCorners[k];
+                    const auto v = mesh.getVertex(corner / 3, corner % 3);
+
+                    auto it = heads.try_emplace(hashes[corner], invalidIndex).first;
+                    uint32_t index = it->second;
+                    while (index != invalidIndex && !compareVertices(v, mesh.getVertex(index / 3, index % 3))) index = next[index];
+
+                    if (index == invalidIndex)
+                    {
+                        // Insert new unique corner.
+                        next[corner] = it->second;
+                        it->second = corner;
+                        index = corner;
+                    }
+                    firstCorner[corner] = index;
+                }
+            });
+
+            return firstCorner;
+        }
+
         std::vector<uint32_t> compact16BitIndices(const std::vector<uint32_t>& indices)
         {
             if (indices.empty()) return {};
@@ -189,15 +296,15 @@ namespace Falcor
             return indexData;
         }
 
-        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags)
+        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags, const SceneBuilder::InstanceMatrices& instances)
         {
-            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache));
+            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache | SceneBuilder::Flags::HashCacheDependencies));
             SHA1 sha1;
             auto pathStr = path.string();
             sha1.update(pathStr.data(), pathStr.size());
             sha1.update(&cacheFlags, sizeof(cacheFlags));
+            if (!instances.empty()) sha1.update(instances.data(), instances.size() * sizeof(SceneBuilder::InstanceMatrices::value_type));
             return sha1.finalize();
-
         }
     }
 
@@ -206,6 +313,8 @@ namespace Falcor
     {
         mpFence = GpuFence::create();
         mSceneData.pMaterials = MaterialSystem::create();
+        if (is_set(flags, Flags::CookTextures)) mSceneData.pMaterials->getTextureManager()->setTextureCooker(TextureCooker::create());
+        if (is_set(flags, Flags::DeduplicateTextures)) mSceneData.pMaterials->getTextureManager()->setDeduplicationEnabled(true);
     }
 
     SceneBuilder::SharedPtr SceneBuilder::create(Flags flags)
@@ -223,19 +332,17 @@ namespace Falcor
 
         auto pBuilder = create(buildFlags);
 
-        // We can only use scene cache if not using instances.
-        bool sceneCacheSupported = instances.empty();
-
-        // Compute scene cache key based on absolute scene path and build flags.
-        pBuilder->mSceneCacheKey = computeSceneCacheKey(fullPath, buildFlags);
+        // Compute scene cache key based on absolute scene path, build flags and instances.
+        // The cache is validated against the files the scene was built from when it is loaded.
+        pBuilder->mSceneCacheKey = computeSceneCacheKey(fullPath, buildFlags, instances);
 
         // Determine if scene cache should be written after import.
         bool useCache = is_set(buildFlags, Flags::UseCache);
         bool rebuildCache = is_set(buildFlags, Flags::RebuildCache);
-        pBuilder->mWriteSceneCache = sceneCacheSupported && (useCache || rebuildCache);
+        pBuilder->mWriteSceneCache = useCache || rebuildCache;
 
-        // Try to load scene cache if supported, available and requested.
-        if (sceneCacheSupported && useCache && !rebuildCache && SceneCache::hasValidCache(pBuilder->mSceneCacheKey))
+        // Try to load scene cache if available and requested.
+        if (useCache && !rebuildCache && SceneCache::hasValidCache(pBuilder->mSceneCacheKey))
         {
             try
             {
@@ -255,9 +362,61 @@ namespace Falcor
     void SceneBuilder::import(const std::filesystem::path& path, const InstanceMatrices& instances, const Dictionary& dict)
     {
         mSceneData.path = path;
+        addDependency(path);
         Importer::import(path, *this, instances, dict);
     }
 
+    void SceneBuilder::addDependency(const std::filesystem::path& path)
+    {
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath)) return;
+
+        std::lock_guard<std::mutex> lock(mDependencyMutex);
+        mDependencies.insert(fullPath);
+    }
+
+    TriangleMesh::SharedPtr SceneBuilder::getOrCreateCachedMesh(const SceneCache::Key& key, const std::function<TriangleMesh::SharedPtr()>& create)
+    {
+        if (!is_set(mFlags, Flags::UseCache) && !is_set(mFlags, Flags::RebuildCache)) return create();
+
+        if (!is_set(mFlags, Flags::RebuildCache))
+        {
+            if (auto pMesh = SceneCache::readMeshCache(key)) return pMesh;
+        }
+
+        auto pMesh = create();
+        if (pMesh) SceneCache::writeMeshCache(key, pMesh);
+        return pMesh;
+    }
+
+    TriangleMesh::SharedPtr SceneBuilder::loadTriangleMesh(const std::filesystem::path& path, bool smoothNormals)
+    {
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath))
+        {
+            logWarning("Error when loading triangle mesh. Can't find mesh file '{}'.", path);
+            return nullptr;
+        }
+
+        addDependency(fullPath);
+
+        auto load = [&]() { return TriangleMesh::createFromFile(fullPath, smoothNormals); };
+        return getOrLoadCachedMesh(fullPath, fmt::format("TriangleMesh::createFromFile:1:{}", smoothNormals), load);
+    }
+
+    TriangleMesh::SharedPtr SceneBuilder::getOrLoadCachedMesh(const std::filesystem::path& path, const std::string& loader, const std::function<TriangleMesh::SharedPtr()>& load)
+    {
+        if (!is_set(mFlags, Flags::UseCache) && !is_set(mFlags, Flags::RebuildCache)) return load();
+
+        auto fileHash = SceneCache::computeFileHash(path);
+        if (!fileHash) return load();
+
+        SHA1 sha1;
+        sha1.update(loader.data(), loader.size());
+        sha1.update(fileHash->data(), fileHash->size());
+        return getOrCreateCachedMesh(sha1.finalize(), load);
+    }
+
     Scene::SharedPtr SceneBuilder::getScene()
     {
         if (mpScene) return mpScene;
@@ -329,7 +488,8 @@ namespace Falcor
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
+            SceneCache::writeCache(mSceneData, mSceneCacheKey, collectDependencies());
+            SceneCache::trimMeshCache(SceneCache::kMeshCacheSizeLimit);
             timeReport.measure("Writing cache");
         }
 
@@ -355,6 +515,8 @@ namespace Falcor
         checkArgument(pTriangleMesh != nullptr, "'pTriangleMesh' is missing");
         checkArgument(pMaterial != nullptr, "'pMaterial' is missing");
 
+        if (!pTriangleMesh->getSourcePath().empty()) addDependency(pTriangleMesh->getSourcePath());
+
         Mesh mesh;
 
         const auto& indices = pTriangleMesh->getIndices();
@@ -466,16 +628,11 @@ namespace Falcor
         }
 
         // Build new vertex/index buffers by merging identical vertices.
-        // The search is based on the topology defined by the original index buffer.
+        // The search is based on the topology defined by the original index buffer,
+        // i.e. only vertices using the same original vertex index are merged.
+        // See findDuplicateVertices() for details.
         //
-        // A linked-list of vertices is built for each original vertex index.
-        // We iterate over all vertices and first check if a vertex is identical to any of the other vertices
-        // using the same original vertex index. If not, a new vertex is inserted and added to the list.
-        // The 'heads' array point to the first vertex in each list, and each vertex has an associated next-pointer.
-        // This ensures that adding to the linked lists do not require any dynamic memory allocation.
-        //
-        const uint32_t invalidIndex = 0xffffffff;
-        std::vector<std::pair<Mesh::Vertex, uint32_t>> vertices;
+        std::vector<Mesh::Vertex> vertices;
         std::vector<uint32_t> indices(mesh.indexCount);
 
         if (pAttributeIndices)
@@ -487,54 +644,38 @@ namespace Falcor
         {
             vertices.reserve(mesh.vertexCount);
 
-            std::vector<uint32_t> heads(mesh.vertexCount, invalidIndex);
+            std::vector<uint32_t> firstCorner = findDuplicateVertices(mesh);
 
+            // Assign new vertex indices in order of first occurrence.
             for (uint32_t face = 0; face < mesh.faceCount; face++)
             {
                 for (uint32_t vert = 0; vert < 3; vert++)
                 {
-                    const Mesh::Vertex v = mesh.getVertex(face, vert);
-                    const uint32_t origIndex = mesh.pIndices[face * 3 + vert];
-
-                    // Iterate over vertex list to check if it already exists.
-                    FALCOR_ASSERT(origIndex < heads.size());
-                    uint32_t index = heads[origIndex];
-                    bool found = false;
-
-                    while (index != invalidIndex)
-                    {
-                        if (compareVertices(v, vertices[index].first))
-                        {
-                            found = true;
-                            break;
-                        }
-                        index = vertices[index].second;
-                    }
+                    const uint32_t corner = face * 3 + vert;
+                    FALCOR_ASSERT(firstCorner[corner] <= corner);
 
-                    // Insert new vertex if we couldn't find it.
-                    if (!found)
+                    if (firstCorner[corner] == corner)
                     {
                         FALCOR_ASSERT(vertices.size() < std::numeric_limits<uint32_t>::max());
-                        index = (uint32_t)vertices.size();
-                        vertices.push_back({ v, heads[origIndex] });
+                        indices[corner] = (uint32_t)vertices.size();
+                        vertices.push_back(mesh.getVertex(face, vert));
 
                         if (pAttributeIndices)
                         {
                             pAttributeIndices->push_back(mesh.getAttributeIndices(face, vert));
                             FALCOR_ASSERT(vertices.size() == pAttributeIndices->size());
                         }
-
-                        heads[origIndex] = index;
                     }
-
-                    // Store new vertex index.
-                    indices[face * 3 + vert] = index;
+                    else
+                    {
+                        indices[corner] = indices[firstCorner[corner]];
+                    }
                 }
             }
         }
         else
         {
-            vertices = { mesh.vertexCount, std::make_pair(Mesh::Vertex{}, invalidIndex) };
+            vertices.resize(mesh.vertexCount);
 
             for (uint32_t face = 0; face < mesh.faceCount; face++)
             {
@@ -544,7 +685,7 @@ namespace Falcor
                     const uint32_t index = mesh.getAttributeIndex(mesh.positions, face, vert);
 
                     FALCOR_ASSERT(index < vertices.size());
-                    vertices[index].first = v;
+                    vertices[index] = v;
 
                     if (pAttributeIndices)
                     {
@@ -573,7 +714,7 @@ namespace Falcor
         size_t zeroCount = 0;
         for (const auto& v : vertices)
         {
-            validateVertex(v.first, invalidCount, zeroCount);
+            validateVertex(v, invalidCount, zeroCount);
         }
         if (invalidCount > 0) logWarning("The mesh '{}' has inf/nan vertex attributes at {} vertices. Please fix the asset.", mesh.name, invalidCount);
         if (zeroCount > 0) logWarning("The mesh '{}' has zero-length normals/tangents at {} vertices. Please fix the asset.", mesh.name, zeroCount);
@@ -600,7 +741,7 @@ namespace Falcor
         {
             uint32_t index = isIndexed ? i : indices[i];
             FALCOR_ASSERT(index < vertices.size());
-            const Mesh::Vertex& v = vertices[index].first;
+            const Mesh::Vertex& v = vertices[index];
 
             StaticVertexData s;
             s.position = v.position;
@@ -822,6 +963,7 @@ namespace Falcor
     void SceneBuilder::loadMaterialTexture(const Material::SharedPtr& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path)
     {
         checkArgument(pMaterial != nullptr, "'pMaterial' is missing");
+        addDependency(path);
         if (!mpMaterialTextureLoader)
         {
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
@@ -882,6 +1024,7 @@ namespace Falcor
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
+        addDependency(filename);
         mSceneData.pLightProfile = LightProfile::createFromIesProfile(std::filesystem::path(filename), normalize);
     }
 
@@ -1632,27 +1775,6 @@ namespace Falcor
         mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
     }
 
-    void SceneBuilder::updateSDFGridID(SdfGridID oldID, SdfGridID newID)
-    {
-        // This is a helper function to update all the references to a specific SDF grid ID
-        // to a new SDF grid ID.
-
-        for (Scene::SDFGridDesc& sdfGridDesc : mSceneData.sdfGridDesc)
-        {
-            if (sdfGridDesc.sdfGridID == oldID) sdfGridDesc.sdfGridID = newID;
-        }
-
-        for (GeometryInstanceData& sdfGridInstance : mSceneData.sdfGridInstances)
-        {
-            if (SdfGridID::fromSlang(sdfGridInstance.geometryID) == oldID)
-            {
-                sdfGridInstance.geometryID = newID.getSlang();
-                InternalNode& node = mSceneGraph[sdfGridInstance.globalMatrixID];
-                std::replace(node.sdfGrids.begin(), node.sdfGrids.end(), oldID, newID);
-            }
-        }
-    }
-
     void SceneBuilder::unifyTriangleWinding()
     {
         // This function makes the triangle winding for all meshes consistent in object space,
@@ -2505,34 +2627,86 @@ namespace Falcor
     void SceneBuilder::removeDuplicateSDFGrids()
     {
         // Removes duplicate SDF grids.
+        // Grids are bucketed by hash so that the cost is linear in the number of grids.
 
-        std::vector<SDFGrid::SharedPtr> uniqueSDFGrids;
-        std::unordered_set<SdfGridID> removedIDs;
+        const auto& sdfGrids = mSceneData.sdfGrids;
+        std::vector<size_t> idMap;
+        auto uniqueIDs = findUniqueElements(sdfGrids.size(),
+            [&](size_t i) { return std::hash<SDFGrid*>()(sdfGrids[i].get()); },
+            [&](size_t i, size_t j) { return sdfGrids[i] == sdfGrids[j]; },
+            idMap);
+
+        if (uniqueIDs.size() == sdfGrids.size()) return;
+
+        // Update all references to SDF grid IDs.
+        auto remapID = [&idMap](SdfGridID id) { return SdfGridID{ idMap[id.get()] }; };
+
+        for (Scene::SDFGridDesc& sdfGridDesc : mSceneData.sdfGridDesc)
+        {
+            sdfGridDesc.sdfGridID = remapID(sdfGridDesc.sdfGridID);
+        }
 
-        for (SdfGridID i{ 0 }; i.get() < mSceneData.sdfGrids.size(); ++i)
+        for (GeometryInstanceData& sdfGridInstance : mSceneData.sdfGridInstances)
         {
-            if (removedIDs.count(i) > 0)
-                continue;
+            sdfGridInstance.geometryID = remapID(SdfGridID::fromSlang(sdfGridInstance.geometryID)).getSlang();
+        }
 
-            const SDFGrid::SharedPtr& pSDFGridA = mSceneData.sdfGrids[i.get()];
-            uniqueSDFGrids.push_back(pSDFGridA);
+        for (InternalNode& node : mSceneGraph)
+        {
+            for (SdfGridID& id : node.sdfGrids) id = remapID(id);
+        }
 
-            if (removedIDs.size() > 0)
-                updateSDFGridID(i, SdfGridID{ i.get() - (uint32_t)removedIDs.size() });
+        std::vector<SDFGrid::SharedPtr> uniqueSDFGrids;
+        uniqueSDFGrids.reserve(uniqueIDs.size());
+        for (size_t i : uniqueIDs) uniqueSDFGrids.push_back(sdfGrids[i]);
+        mSceneData.sdfGrids = std::move(uniqueSDFGrids);
+    }
 
-            for (SdfGridID j{ i.get() + 1 }; j.get() < mSceneData.sdfGrids.size(); ++j)
-            {
-                const SDFGrid::SharedPtr& pSDFGridB = mSceneData.sdfGrids[j.get()];
+    SceneCache::DependencyList SceneBuilder::collectDependencies()
+    {
+        // Add files referenced by the scene data. This covers files loaded directly by importers or scripts.
+        auto addTexture = [this](const Texture::SharedPtr& pTexture)
+        {
+            if (pTexture && !pTexture->getSourcePath().empty()) addDependency(pTexture->getSourcePath());
+        };
 
-                if (pSDFGridA == pSDFGridB)
-                {
-                    removedIDs.insert(j);
-                    updateSDFGridID(j, i);
-                }
+        const auto& pMaterials = mSceneData.pMaterials;
+        for (uint32_t i = 0; i < pMaterials->getMaterialCount(); i++)
+        {
+            const auto& pMaterial = pMaterials->getMaterial(MaterialID(i));
+            for (uint32_t slot = 0; slot < (uint32_t)Material::TextureSlot::Count; ++slot)
+            {
+                addTexture(pMaterial->getTexture(Material::TextureSlot(slot)));
             }
         }
+        if (mSceneData.pEnvMap) addTexture(mSceneData.pEnvMap->getEnvMap());
+        for (const auto& pGrid : mSceneData.grids)
+        {
+            if (!pGrid->getSourcePath().empty()) addDependency(pGrid->getSourcePath());
+        }
 
-        mSceneData.sdfGrids = std::move(uniqueSDFGrids);
+        std::set<std::filesystem::path> paths;
+        {
+            std::lock_guard<std::mutex> lock(mDependencyMutex);
+            paths = mDependencies;
+        }
+
+        // Stat (and optionally hash) all files in parallel, as scenes can depend on many thousands of files.
+        std::vector<std::filesystem::path> pathList(paths.begin(), paths.end());
+        std::vector<std::optional<SceneCache::Dependency>> dependencies(pathList.size());
+        bool computeHash = is_set(mFlags, Flags::HashCacheDependencies);
+        Threading::parallelFor<size_t>(0, pathList.size(), [&](size_t i)
+        {
+            dependencies[i] = SceneCache::createDependency(pathList[i], computeHash);
+        });
+
+        SceneCache::DependencyList result;
+        result.reserve(dependencies.size());
+        for (auto& dependency : dependencies)
+        {
+            if (dependency) result.push_back(std::move(*dependency));
+        }
+        return result;
     }
 
     void SceneBuilder::createMeshData()
@@ -2819,8 +2993,11 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("CookTextures", SceneBuilder::Flags::CookTextures);
+        flags.value("DeduplicateTextures", SceneBuilder::Flags::DeduplicateTextures);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
+        flags.value("HashCacheDependencies", SceneBuilder::Flags::HashCacheDependencies);
         ScriptBindings::addEnumBinaryOperators(flags);
 
         pybind11::class_<SceneBuilder, SceneBuilder::SharedPtr> sceneBuilder(m, "SceneBuilder");
@@ -2844,6 +3021,8 @@ namespace Falcor
             pSceneBuilder->import(path, instanceMatrices, Dictionary(dict));
         }, "path"_a, "dict"_a = pybind11::dict(), "instances"_a = std::vector<Transform>());
         sceneBuilder.def("addTriangleMesh", &SceneBuilder::addTriangleMesh, "triangleMesh"_a, "material"_a);
+        sceneBuilder.def("loadTriangleMesh", &SceneBuilder::loadTriangleMesh, "path"_a, "smoothNormals"_a = false);
+        sceneBuilder.def("addDependency", &SceneBuilder::addDependency, "path"_a);
         sceneBuilder.def("addSDFGrid", &SceneBuilder::addSDFGrid, "sdfGrid"_a, "material"_a);
         sceneBuilder.def("addMaterial", &SceneBuilder::addMaterial, "material"_a);
         sceneBuilder.def("getMaterial", &SceneBuilder::getMaterial, "name"_a);
@@ -43,7 +43,10 @@
 #include "Utils/Scripting/Dictionary.h"
 
 #include <filesystem>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -76,9 +79,12 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            CookTextures                    = 0x20000,  ///< Cook material textures into block-compressed DDS files with precomputed mips, stored in a content-addressed cache. Reduces load time and texture memory at the cost of lossy compression.
+            DeduplicateTextures             = 0x40000,  ///< Alias material textures with identical content loaded from different paths to a single texture. Statistics are reported in the scene stats.
 
-            UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
+            UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time. Meshes loaded by the PBRT importer are additionally cached per file (size limited, least recently used entries are removed), Assimp and USD meshes are not.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
+            HashCacheDependencies           = 0x40000000, ///< Store content hashes of the files the scene cache depends on. Files that are written to without changing their content then don't invalidate the cache.
 
             Default = None
         };
@@ -354,6 +360,48 @@ namespace Falcor
         */
         Flags getFlags() const { return mFlags; }
 
+        /** Add a file the scene depends on.
+            The scene cache is invalidated if any of the dependencies change. Scene files, textures, grids and triangle meshes
+            loaded from files are added automatically, importers need to add any other files they read.
+            This function is thread-safe.
+            \param path File path. Relative paths are resolved using the data directories.
+        */
+        void addDependency(const std::filesystem::path& path);
+
+        /** Get a triangle mesh from the per-asset cache, or create it on a cache miss.
+            The per-asset cache is only used if scene caching is enabled. It allows assets to skip expensive processing
+            when the scene cache is rebuilt because of a change to another file. It is currently used by the PBRT importer
+            (plymesh and loopsubdiv shapes) and loadTriangleMesh(). The Assimp and USD importers convert whole scene files
+            in memory and don't use it.
+            The cache is trimmed to SceneCache::kMeshCacheSizeLimit bytes by removing the least recently used entries
+            whenever a scene cache is written.
+            This function is thread-safe.
+            \param key Key identifying the asset. This needs to be computed from all data and settings affecting the result.
+            \param create Function creating the mesh on a cache miss.
+            \return Returns the triangle mesh, or nullptr if it failed to be created.
+        */
+        TriangleMesh::SharedPtr getOrCreateCachedMesh(const SceneCache::Key& key, const std::function<TriangleMesh::SharedPtr()>& create);
+
+        /** Get a triangle mesh loaded from a file from the per-asset cache, or load it on a cache miss.
+            The cache entry is keyed by the content hash of the file and the loader, so the mesh is only loaded again
+            if the file changes. Importers that load meshes from individual files should use this.
+            This function is thread-safe.
+            \param path Full path of the mesh file.
+            \param loader Name of the loader including any settings affecting the result. Include a version number and bump it whenever the loader output changes.
+            \param load Function loading the mesh on a cache miss.
+            \return Returns the triangle mesh, or nullptr if it failed to be loaded.
+        */
+        TriangleMesh::SharedPtr getOrLoadCachedMesh(const std::filesystem::path& path, const std::string& loader, const std::function<TriangleMesh::SharedPtr()>& load);
+
+        /** Load a triangle mesh from a file.
+            This is equivalent to TriangleMesh::createFromFile(), but if scene caching is enabled the result is stored
+            in the per-asset cache keyed by the hash of the file, so it is only imported again if the file changes.
+            \param path File path to load mesh from.
+            \param smoothNormals If no normals are defined in the model, generate smooth instead of facet normals.
+            \return Returns the triangle mesh or nullptr if the mesh failed to load.
+        */
+        TriangleMesh::SharedPtr loadTriangleMesh(const std::filesystem::path& path, bool smoothNormals = false);
+
         /** Set the render settings.
         */
         void setRenderSettings(const Scene::RenderSettings& renderSettings) { mSceneData.renderSettings = renderSettings; }
@@ -728,6 +776,8 @@ namespace Falcor
         Scene::SharedPtr mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        std::set<std::filesystem::path> mDependencies; ///< Files the scene depends on.
+        std::mutex mDependencyMutex;
 
         SceneGraph mSceneGraph;
         const Flags mFlags;
@@ -746,7 +796,6 @@ namespace Falcor
         bool collapseNodes(NodeID parentNodeID, NodeID childNodeID);
         bool mergeNodes(NodeID dstNodeID, NodeID srcNodeID);
         void flipTriangleWinding(MeshSpec& mesh);
-        void updateSDFGridID(SdfGridID oldID, SdfGridID newID);
 
         /** Split a mesh by the given axis-aligned splitting plane.
             \return Pair of optional mesh IDs for the meshes on the left and right side, respectively.
@@ -784,6 +833,7 @@ namespace Falcor
         void collectVolumeGrids();
         void quantizeTexCoords();
         void removeDuplicateSDFGrids();
+        SceneCache::DependencyList collectDependencies();
 
         // Scene setup
         void createMeshData();
@@ -26,15 +26,22 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SceneCache.h"
+#include "Animation/VertexCacheFile.h"
 #include "Material/StandardMaterial.h"
 #include "Material/HairMaterial.h"
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Threading.h"
 
-#include <lz4_stream/lz4_stream.h>
+#include <lz4.h>
 
-#include <sstream>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
 #include <fstream>
 
 namespace Falcor
@@ -44,37 +51,154 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 32;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
         const std::string kDirectory = "NVIDIA/Falcor/SceneCache";
 
-        const size_t kBlockSize = 1 * 1024 * 1024;
+        /** Alignment of sections in the cache file.
+            Sections are aligned to the allocation granularity (64KB on Windows) to allow accessing them directly from a memory mapping.
+        */
+        const size_t kSectionAlignment = 64 * 1024;
+
+        /** Size of the independently compressed chunks a section is split into.
+            Chunks are compressed and decompressed in parallel.
+        */
+        const size_t kChunkSize = 1 * 1024 * 1024;
+
+        /** Sections and chunks are only stored compressed if compression reduces the size to at most this fraction.
+        */
+        const double kMaxCompressionRatio = 0.9;
+
+        // Section names.
+        const char* kMainSection = "Main";
+        const char* kGridsSection = "Grids";
+        const char* kAnimationsSection = "Animations";
+        const char* kMeshIndexSection = "MeshIndex";
+        const char* kMeshStaticSection = "MeshStatic";
+        const char* kMeshSkinningSection = "MeshSkinning";
+        const char* kCachedMeshesSection = "CachedMeshes";
+        const char* kCurveIndexSection = "CurveIndex";
+        const char* kCurveStaticSection = "CurveStatic";
+        const char* kCachedCurvesSection = "CachedCurves";
+        const char* kDependenciesSection = "Dependencies";
+        const char* kKeyframesSection = "Keyframes";
 
         const char* kMagic = "FalcorS$";
         struct Header
         {
             uint8_t magic[8]{};
             uint32_t version{};
+            uint32_t sectionCount{};
 
             bool isValid() const
             {
                 return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
             }
         };
+
+        enum class SectionCompression : uint32_t
+        {
+            None,           ///< Section is stored uncompressed.
+            ChunkedLZ4,     ///< Section is stored as a chunk table followed by individually LZ4 compressed chunks.
+        };
+
+        /** Entry in the section table following the header.
+        */
+        struct SectionDesc
+        {
+            char name[16]{};                                        ///< Section name (zero terminated).
+            uint64_t offset = 0;                                    ///< Offset of the section data from the start of the file.
+            uint64_t size = 0;                                      ///< Size of the uncompressed section data in bytes.
+            uint64_t storedSize = 0;                                ///< Size of the section data in the file in bytes.
+            SectionCompression compression = SectionCompression::None; ///< Compression used for the stored data.
+            uint32_t chunkSize = 0;                                 ///< Uncompressed size of each chunk (except the last) if chunked.
+        };
+
+        static_assert(sizeof(SectionDesc) == 48);
+
+        /** Entry in the chunk table at the start of a chunked section.
+        */
+        struct ChunkDesc
+        {
+            uint64_t offset = 0;                                    ///< Offset of the chunk data from the start of the section.
+            uint32_t storedSize = 0;                                ///< Size of the chunk data in the file in bytes.
+            uint32_t isCompressed = 0;                              ///< True if chunk is LZ4 compressed, otherwise stored uncompressed.
+        };
+
+        static_assert(sizeof(ChunkDesc) == 16);
+
+        /** Chunked section data in a memory mapped cache file.
+        */
+        struct ChunkedData
+        {
+            const uint8_t* pStored = nullptr;                       ///< Stored section data (chunk table followed by chunk data).
+            size_t size = 0;                                        ///< Size of the uncompressed data in bytes.
+            size_t chunkSize = 0;                                   ///< Uncompressed size of each chunk (except the last).
+
+            size_t getChunkCount() const { return (size + chunkSize - 1) / chunkSize; }
+            size_t getChunkDataSize(size_t index) const { return std::min(chunkSize, size - index * chunkSize); }
+            const ChunkDesc& getChunk(size_t index) const { return reinterpret_cast<const ChunkDesc*>(pStored)[index]; }
+
+            /** Decode a chunk.
+                \param[in] index Chunk index.
+                \param[out] pDst Destination, must hold at least getChunkDataSize(index) bytes.
+                \return Returns false if the chunk data is corrupt.
+            */
+            bool decodeChunk(size_t index, uint8_t* pDst) const
+            {
+                const ChunkDesc& chunk = getChunk(index);
+                const size_t dataSize = getChunkDataSize(index);
+                const uint8_t* pSrc = pStored + chunk.offset;
+                if (chunk.isCompressed)
+                {
+                    return LZ4_decompress_safe((const char*)pSrc, (char*)pDst, (int)chunk.storedSize, (int)dataSize) == (int)dataSize;
+                }
+                if (chunk.storedSize != dataSize) return false;
+                std::memcpy(pDst, pSrc, dataSize);
+                return true;
+            }
+        };
+
+        /** Per-asset mesh cache directory (subdirectory of the scene cache directory).
+        */
+        const std::string kMeshDirectory = "Meshes";
+
+        /** Specifies the current mesh cache file version.
+            This needs to be incremented every time the mesh cache file format or the TriangleMesh layout changes!
+        */
+        const uint32_t kMeshVersion = 1;
+
+        const char* kMeshMagic = "FalcorM$";
+        struct MeshHeader
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t reserved{};
+            SceneCache::Key key{};
+
+            bool isValid(const SceneCache::Key& expectedKey) const
+            {
+                return std::memcmp(magic, kMeshMagic, sizeof(MeshHeader::magic)) == 0 && version == kMeshVersion && key == expectedKey;
+            }
+        };
+
+        uint64_t alignSectionOffset(uint64_t offset)
+        {
+            return (offset + kSectionAlignment - 1) / kSectionAlignment * kSectionAlignment;
+        }
     }
 
-    /** Wrapper around std::ostream to ease serialization of basic types.
+    /** Helper to serialize basic types into a memory buffer.
     */
     class SceneCache::OutputStream
     {
     public:
-        OutputStream(std::ostream& stream) : mStream(stream) {}
-
         void write(const void* data, size_t len)
         {
-            mStream.write(reinterpret_cast<const char*>(data), len);
+            const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(data);
+            mData.insert(mData.end(), pBytes, pBytes + len);
         }
 
         template<typename T>
@@ -120,20 +244,31 @@ namespace Falcor
             if (hasValue) write(opt.value());
         }
 
+        std::vector<uint8_t>& getData() { return mData; }
+        const std::vector<uint8_t>& getData() const { return mData; }
+
     private:
-        std::ostream& mStream;
+        std::vector<uint8_t> mData;
     };
 
-    /** Wrapper around std::istream to ease serialization of basic types.
+    /** Helper to deserialize basic types from a memory buffer or chunked section.
+        The buffer is typically a section of a memory mapped cache file, so reading
+        trivial arrays copies the data straight from the mapping into the destination.
+        Chunked sections are decoded while they are read. Whole chunks covered by a read are decoded in parallel
+        straight into the destination, smaller reads are served from the last decoded chunk.
     */
     class SceneCache::InputStream
     {
     public:
-        InputStream(std::istream& stream) : mStream(stream) {}
+        InputStream(const uint8_t* pData, size_t size) : mpData(pData), mSize(size) {}
+        InputStream(const ChunkedData& chunked) : mSize(chunked.size), mChunked(chunked) {}
 
         void read(void* data, size_t len)
         {
-            mStream.read(reinterpret_cast<char*>(data), len);
+            if (len > mSize - mOffset) throw RuntimeError("Unexpected end of scene cache data.");
+            if (mChunked) readChunked(static_cast<uint8_t*>(data), len);
+            else std::memcpy(data, mpData + mOffset, len);
+            mOffset += len;
         }
 
         template<typename T>
@@ -189,25 +324,419 @@ namespace Falcor
         }
 
     private:
-        std::istream& mStream;
+        void readChunked(uint8_t* pDst, size_t len)
+        {
+            const ChunkedData& chunked = *mChunked;
+            const size_t end = mOffset + len;
+            size_t offset = mOffset;
+
+            while (offset < end)
+            {
+                const size_t chunk = offset / chunked.chunkSize;
+                const size_t chunkOffset = offset - chunk * chunked.chunkSize;
+                const size_t endChunk = end == chunked.size ? chunked.getChunkCount() : end / chunked.chunkSize;
+
+                if (chunkOffset == 0 && endChunk > chunk)
+                {
+                    // Decode whole chunks straight into the destination.
+                    std::atomic<bool> failed = false;
+                    Threading::parallelFor<size_t>(chunk, endChunk, [&](size_t i)
+                    {
+                        if (!chunked.decodeChunk(i, pDst + (i - chunk) * chunked.chunkSize)) failed = true;
+                    });
+                    if (failed) throw RuntimeError("Failed to decompress scene cache data.");
+
+                    const size_t decodedEnd = std::min(endChunk * chunked.chunkSize, chunked.size);
+                    pDst += decodedEnd - offset;
+                    offset = decodedEnd;
+                }
+                else
+                {
+                    // Copy part of a chunk, decoding it if it isn't the last decoded one.
+                    if (mDecodedChunk != chunk)
+                    {
+                        mDecoded.resize(chunked.getChunkDataSize(chunk));
+                        if (!chunked.decodeChunk(chunk, mDecoded.data())) throw RuntimeError("Failed to decompress scene cache data.");
+                        mDecodedChunk = chunk;
+                    }
+
+                    const size_t copySize = std::min(end - offset, mDecoded.size() - chunkOffset);
+                    std::memcpy(pDst, mDecoded.data() + chunkOffset, copySize);
+                    pDst += copySize;
+                    offset += copySize;
+                }
+            }
+        }
+
+        const uint8_t* mpData = nullptr;
+        size_t mSize;
+        size_t mOffset = 0;
+        std::optional<ChunkedData> mChunked;
+        std::vector<uint8_t> mDecoded;                      ///< Data of the last decoded chunk when reading a chunked section.
+        size_t mDecodedChunk = std::numeric_limits<size_t>::max();
+    };
+
+    /** Helper for writing a sectioned cache file.
+        Sections are serialized into memory and written in one go by write().
+        Each section is stored aligned to kSectionAlignment. Sections are split into chunks of kChunkSize
+        which are LZ4 compressed independently and in parallel.
+    */
+    class SceneCache::SectionWriter
+    {
+    public:
+        /** Add a section.
+            \param[in] name Section name.
+            \param[in] allowCompression If false, the section is always stored uncompressed so its data can be read directly from the file.
+            \return Stream for writing the section data. The stream is valid for the lifetime of the writer.
+        */
+        OutputStream& addSection(const std::string& name, bool allowCompression = true)
+        {
+            FALCOR_ASSERT(name.size() < sizeof(SectionDesc::name));
+            FALCOR_ASSERT(std::none_of(mSections.begin(), mSections.end(), [&](const auto& s) { return s.name == name; }));
+            mSections.push_back({ name });
+            mSections.back().allowCompression = allowCompression;
+            return mSections.back().stream;
+        }
+
+        /** Append a chunk of a vertex cache file to an uncompressed section, after the data written to its stream.
+            The chunk is copied from the file when the cache is written, so large data never needs to be held in memory.
+            \param[in] name Section name.
+            \param[in] pFile File to copy from. The file must stay valid until the cache is written.
+            \param[in] chunk Chunk index.
+            \return Offset of the chunk data from the start of the section.
+        */
+        uint64_t appendFileChunk(const std::string& name, const VertexCacheFile::SharedPtr& pFile, uint32_t chunk)
+        {
+            auto it = std::find_if(mSections.begin(), mSections.end(), [&](const auto& s) { return s.name == name; });
+            FALCOR_ASSERT(it != mSections.end() && !it->allowCompression);
+            uint64_t offset = it->getSize();
+            it->fileChunks.push_back({ pFile, chunk });
+            it->fileChunkSize += pFile->getChunkSize(chunk);
+            return offset;
+        }
+
+        void write(const std::filesystem::path& path)
+        {
+            std::ofstream fs(path.c_str(), std::ios_base::binary);
+            if (fs.bad()) throw RuntimeError("Failed to create scene cache file '{}'.", path);
+
+            compressSections();
+
+            // Layout sections.
+            std::vector<SectionDesc> descs(mSections.size());
+            uint64_t offset = alignSectionOffset(sizeof(Header) + descs.size() * sizeof(SectionDesc));
+            for (size_t i = 0; i < mSections.size(); ++i)
+            {
+                const auto& section = mSections[i];
+                auto& desc = descs[i];
+                std::memcpy(desc.name, section.name.data(), section.name.size());
+                desc.offset = offset;
+                desc.size = section.getSize();
+                desc.compression = section.isChunked ? SectionCompression::ChunkedLZ4 : SectionCompression::None;
+                desc.chunkSize = section.isChunked ? (uint32_t)kChunkSize : 0;
+                desc.storedSize = section.isChunked ? section.chunkTable.size() * sizeof(ChunkDesc) : desc.size;
+                for (const auto& chunk : section.chunkTable) desc.storedSize += chunk.storedSize;
+                offset = alignSectionOffset(offset + desc.storedSize);
+            }
+
+            // Write header and section table.
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+            header.version = kVersion;
+            header.sectionCount = (uint32_t)descs.size();
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(descs.data()), descs.size() * sizeof(SectionDesc));
+
+            // Write section data.
+            for (size_t i = 0; i < mSections.size(); ++i)
+            {
+                const auto& section = mSections[i];
+                const auto& data = section.stream.getData();
+                fs.seekp(descs[i].offset);
+                if (section.isChunked)
+                {
+                    fs.write(reinterpret_cast<const char*>(section.chunkTable.data()), section.chunkTable.size() * sizeof(ChunkDesc));
+                    for (size_t j = 0; j < section.chunkTable.size(); ++j)
+                    {
+                        if (section.chunkTable[j].isCompressed) fs.write(reinterpret_cast<const char*>(section.chunks[j].data()), section.chunks[j].size());
+                        else fs.write(reinterpret_cast<const char*>(data.data() + j * kChunkSize), section.chunkTable[j].storedSize);
+                    }
+                }
+                else
+                {
+                    fs.write(reinterpret_cast<const char*>(data.data()), data.size());
+
+                    // Copy file chunks one at a time.
+                    std::vector<uint8_t> chunkData;
+                    for (const auto& fileChunk : section.fileChunks)
+                    {
+                        fileChunk.pFile->readChunk(fileChunk.chunk, chunkData);
+                        fs.write(reinterpret_cast<const char*>(chunkData.data()), chunkData.size());
+                    }
+                }
+            }
+
+            // Pad the file to the end of the last section.
+            fs.seekp(offset - 1);
+            fs.put(0);
+
+            if (fs.bad()) throw RuntimeError("Failed to write scene cache file to '{}'.", path);
+        }
+
+    private:
+        struct Section
+        {
+            std::string name;
+            OutputStream stream;
+            bool allowCompression = true;
+            bool isChunked = false;
+            std::vector<ChunkDesc> chunkTable;
+            std::vector<std::vector<uint8_t>> chunks;   ///< Compressed chunk data (empty for chunks stored uncompressed).
+
+            struct FileChunk
+            {
+                VertexCacheFile::SharedPtr pFile;
+                uint32_t chunk;
+            };
+            std::vector<FileChunk> fileChunks;          ///< File chunks appended to the stream data (uncompressed sections only).
+            uint64_t fileChunkSize = 0;                 ///< Total size of the file chunks in bytes.
+
+            uint64_t getSize() const { return stream.getData().size() + fileChunkSize; }
+        };
+
+        void compressSections()
+        {
+            // Gather chunks of all sections.
+            struct ChunkRef
+            {
+                Section* pSection;
+                size_t index;
+            };
+            std::vector<ChunkRef> chunkRefs;
+
+            for (auto& section : mSections)
+            {
+                if (!section.allowCompression) continue;
+                size_t chunkCount = (section.stream.getData().size() + kChunkSize - 1) / kChunkSize;
+                section.chunkTable.resize(chunkCount);
+                section.chunks.resize(chunkCount);
+                for (size_t i = 0; i < chunkCount; ++i) chunkRefs.push_back({ &section, i });
+            }
+
+            // Compress all chunks in parallel.
+            Threading::parallelFor<size_t>(0, chunkRefs.size(), [&](size_t i)
+            {
+                Section& section = *chunkRefs[i].pSection;
+                size_t index = chunkRefs[i].index;
+                const auto& data = section.stream.getData();
+                const size_t offset = index * kChunkSize;
+                const int size = (int)std::min(kChunkSize, data.size() - offset);
+
+                std::vector<uint8_t> compressed(LZ4_compressBound(size));
+                int compressedSize = LZ4_compress_default((const char*)data.data() + offset, (char*)compressed.data(), size, (int)compressed.size());
+                if (compressedSize > 0 && compressedSize <= kMaxCompressionRatio * size)
+                {
+                    compressed.resize(compressedSize);
+                    section.chunks[index] = std::move(compressed);
+                    section.chunkTable[index].storedSize = (uint32_t)compressedSize;
+                    section.chunkTable[index].isCompressed = 1;
+                }
+                else
+                {
+                    section.chunkTable[index].storedSize = (uint32_t)size;
+                    section.chunkTable[index].isCompressed = 0;
+                }
+            });
+
+            // Store sections chunked only if compression pays off overall.
+            for (auto& section : mSections)
+            {
+                uint64_t size = section.stream.getData().size();
+                uint64_t storedSize = section.chunkTable.size() * sizeof(ChunkDesc);
+                for (const auto& chunk : section.chunkTable) storedSize += chunk.storedSize;
+
+                section.isChunked = section.allowCompression && size > 0 && storedSize <= kMaxCompressionRatio * size;
+                if (section.isChunked)
+                {
+                    uint64_t chunkOffset = section.chunkTable.size() * sizeof(ChunkDesc);
+                    for (auto& chunk : section.chunkTable)
+                    {
+                        chunk.offset = chunkOffset;
+                        chunkOffset += chunk.storedSize;
+                    }
+                }
+                else
+                {
+                    section.chunkTable.clear();
+                    section.chunks.clear();
+                }
+            }
+        }
+
+        // Use a deque so that references to section streams stay valid when adding sections.
+        std::deque<Section> mSections;
     };
 
+    /** Helper for reading a sectioned cache file.
+        The file is memory mapped and getSection() returns streams reading from the mapping.
+        Uncompressed sections are read directly from the mapping without intermediate copies.
+        Chunked sections are decompressed only as the stream is read, so large arrays are decoded straight
+        into their destination. Whole chunks are decompressed in parallel and each worker faults in the pages
+        of its own chunk, so reading from disk overlaps with decompression of other chunks.
+    */
+    class SceneCache::SectionReader
+    {
+    public:
+        SectionReader(const std::filesystem::path& path)
+            : mPath(path)
+        {
+            if (!mFile.open(path, MemoryMappedFile::AccessHint::SequentialScan)) throw RuntimeError("Failed to open scene cache file '{}'.", path);
+
+            // Validate header and section table.
+            const uint8_t* pData = static_cast<const uint8_t*>(mFile.getData());
+            Header header;
+            if (mFile.getSize() < sizeof(Header)) throw RuntimeError("Invalid header in scene cache file '{}'.", path);
+            std::memcpy(&header, pData, sizeof(Header));
+            if (!header.isValid()) throw RuntimeError("Invalid header in scene cache file '{}'.", path);
+
+            if (mFile.getSize() < sizeof(Header) + header.sectionCount * sizeof(SectionDesc)) throw RuntimeError("Invalid section table in scene cache file '{}'.", path);
+            mSections.resize(header.sectionCount);
+            std::memcpy(mSections.data(), pData + sizeof(Header), header.sectionCount * sizeof(SectionDesc));
+
+            for (const auto& desc : mSections)
+            {
+                if (desc.offset + desc.storedSize > mFile.getSize()) throw RuntimeError("Invalid section '{}' in scene cache file '{}'.", desc.name, path);
+                // Start paging in the section data while earlier sections are decoded.
+                mFile.prefetch(desc.offset, desc.storedSize);
+            }
+        }
+
+        /** Get a stream for reading a section.
+            The stream is valid until the reader is destroyed.
+        */
+        InputStream getSection(const std::string& name)
+        {
+            auto it = std::find_if(mSections.begin(), mSections.end(), [&](const SectionDesc& desc) { return name == desc.name; });
+            if (it == mSections.end()) throw RuntimeError("Missing section '{}' in scene cache file '{}'.", name, mPath);
+            const SectionDesc& desc = *it;
+            const uint8_t* pStored = static_cast<const uint8_t*>(mFile.getData()) + desc.offset;
+
+            switch (desc.compression)
+            {
+            case SectionCompression::None:
+                return InputStream(pStored, desc.size);
+            case SectionCompression::ChunkedLZ4:
+                return InputStream(getChunkedData(desc, pStored));
+            default:
+                throw RuntimeError("Unsupported compression in section '{}' in scene cache file '{}'.", name, mPath);
+            }
+        }
+
+        /** Get the offset of an uncompressed section from the start of the file.
+            This allows reading the section data directly from the file later on.
+        */
+        uint64_t getSectionFileOffset(const std::string& name) const
+        {
+            auto it = std::find_if(mSections.begin(), mSections.end(), [&](const SectionDesc& desc) { return name == desc.name; });
+            if (it == mSections.end()) throw RuntimeError("Missing section '{}' in scene cache file '{}'.", name, mPath);
+            if (it->compression != SectionCompression::None) throw RuntimeError("Section '{}' in scene cache file '{}' is compressed.", name, mPath);
+            return it->offset;
+        }
+
+        const std::filesystem::path& getPath() const { return mPath; }
+
+    private:
+        ChunkedData getChunkedData(const SectionDesc& desc, const uint8_t* pStored) const
+        {
+            ChunkedData chunked{ pStored, desc.size, desc.chunkSize };
+            if (chunked.chunkSize == 0) throw RuntimeError("Invalid chunk size in section '{}' in scene cache file '{}'.", desc.name, mPath);
+
+            // Validate the chunk table so that chunks can be decoded without further checks.
+            const size_t chunkCount = chunked.getChunkCount();
+            if (chunkCount * sizeof(ChunkDesc) > desc.storedSize) throw RuntimeError("Invalid chunk table in section '{}' in scene cache file '{}'.", desc.name, mPath);
+            for (size_t i = 0; i < chunkCount; i++)
+            {
+                const ChunkDesc& chunk = chunked.getChunk(i);
+                if (chunk.offset + chunk.storedSize > desc.storedSize) throw RuntimeError("Invalid chunk table in section '{}' in scene cache file '{}'.", desc.name, mPath);
+            }
+            return chunked;
+        }
+
+        std::filesystem::path mPath;
+        MemoryMappedFile mFile;
+        std::vector<SectionDesc> mSections;
+    };
+
+    std::optional<SceneCache::Dependency> SceneCache::createDependency(const std::filesystem::path& path, bool computeHash)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) return {};
+
+        Dependency dependency;
+        dependency.path = path;
+        dependency.size = std::filesystem::file_size(path, ec);
+        if (ec) return {};
+        dependency.lastWriteTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec) return {};
+        if (computeHash) dependency.hash = computeFileHash(path);
+        return dependency;
+    }
+
+    bool SceneCache::isDependencyUpToDate(const Dependency& dependency)
+    {
+        auto current = createDependency(dependency.path, false);
+        if (!current || current->size != dependency.size) return false;
+        if (current->lastWriteTime == dependency.lastWriteTime) return true;
+
+        // The file has been written to, but it is unchanged if the content is the same.
+        return dependency.hash && computeFileHash(dependency.path) == dependency.hash;
+    }
+
+    std::optional<SceneCache::Key> SceneCache::computeFileHash(const std::filesystem::path& path)
+    {
+        MemoryMappedFile file;
+        if (!file.open(path, MemoryMappedFile::AccessHint::SequentialScan)) return {};
+        return SHA1::compute(file.getData(), file.getSize());
+    }
+
     bool SceneCache::hasValidCache(const Key& key)
     {
         auto cachePath = getCachePath(key);
         if (!std::filesystem::exists(cachePath)) return false;
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) return false;
-
         // Verify header.
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        {
+            std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
+            if (fs.bad()) return false;
+
+            Header header;
+            fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (fs.eof() || !header.isValid()) return false;
+        }
+
+        // Verify that none of the files the scene was built from have changed.
+        try
+        {
+            SectionReader reader(cachePath);
+            for (const auto& dependency : readDependencies(reader))
+            {
+                if (!isDependencyUpToDate(dependency))
+                {
+                    logInfo("Scene cache '{}' is out of date, '{}' has changed.", cachePath, dependency.path);
+                    return false;
+                }
+            }
+        }
+        catch (const RuntimeError& e)
+        {
+            logWarning("Failed to validate scene cache '{}': {}", cachePath, e.what());
+            return false;
+        }
+
+        return true;
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, const DependencyList& dependencies)
     {
         auto cachePath = getCachePath(key);
 
@@ -216,21 +745,30 @@ namespace Falcor
         // Create directories if not existing.
         std::filesystem::create_directories(cachePath.parent_path());
 
-        // Open file.
-        std::ofstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) throw RuntimeError("Failed to create scene cache file '{}'.", cachePath);
+        SectionWriter writer;
+        writeSceneData(writer, sceneData);
+        writeDependencies(writer, dependencies);
 
-        // Write header (uncompressed).
-        Header header;
-        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
-        header.version = kVersion;
-        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        // Write to a temporary file first. Scenes loaded from a previous cache file may still stream keyframes from it,
+        // so the file must not be modified in place.
+        auto tempPath = getTempFilePathFor(cachePath);
+        try
+        {
+            writer.write(tempPath);
+        }
+        catch (const std::exception& e)
+        {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            throw RuntimeError("Failed to write scene cache file '{}': {}", cachePath, e.what());
+        }
 
-        // Write cache (compressed).
-        lz4_stream::basic_ostream<kBlockSize> zs(fs);
-        OutputStream stream(zs);
-        writeSceneData(stream, sceneData);
-        if (fs.bad()) throw RuntimeError("Failed to write scene cache file to '{}'.", cachePath);
+        // Replacing the file fails on Windows while a scene streams keyframes from it. The previous cache file is kept then.
+        // It is rejected on the next load if any of its dependencies have changed.
+        if (!moveFileIntoPlace(tempPath, cachePath))
+        {
+            logWarning("Failed to replace scene cache file '{}', it is still in use. The previous cache file is kept.", cachePath);
+        }
     }
 
     Scene::SceneData SceneCache::readCache(const Key& key)
@@ -239,35 +777,170 @@ namespace Falcor
 
         logInfo("Loading scene cache from '{}'.", cachePath);
 
-        // Open file.
-        std::ifstream fs(cachePath.c_str(), std::ios_base::binary);
-        if (fs.bad()) throw RuntimeError("Failed to open scene cache file '{}'.", cachePath);
+        SectionReader reader(cachePath);
+        return readSceneData(reader);
+    }
+
+    TriangleMesh::SharedPtr SceneCache::readMeshCache(const Key& key)
+    {
+        auto path = getMeshCachePath(key);
+        if (!std::filesystem::exists(path)) return nullptr;
 
-        // Read header (uncompressed).
-        Header header;
-        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        if (!header.isValid()) throw RuntimeError("Invalid header in scene cache file '{}'.", cachePath);
+        MemoryMappedFile file;
+        if (!file.open(path, MemoryMappedFile::AccessHint::SequentialScan)) return nullptr;
 
-        // Read cache (compressed).
-        lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
-        InputStream stream(zs);
-        auto sceneData = readSceneData(stream);
-        if (fs.bad()) throw RuntimeError("Failed to read scene cache file from '{}'.", cachePath);
-        return sceneData;
+        try
+        {
+            InputStream stream(static_cast<const uint8_t*>(file.getData()), file.getSize());
+            auto header = stream.read<MeshHeader>();
+            if (!header.isValid(key)) return nullptr;
+
+            auto name = stream.read<std::string>();
+            auto vertices = stream.read<TriangleMesh::VertexList>();
+            auto indices = stream.read<TriangleMesh::IndexList>();
+            auto frontFaceCW = stream.read<bool>();
+
+            auto pMesh = TriangleMesh::create(std::move(vertices), std::move(indices), frontFaceCW);
+            pMesh->setName(name);
+
+            // Mark the entry as recently used, so it is the last to be removed when the cache is trimmed.
+            std::error_code ec;
+            std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+            return pMesh;
+        }
+        catch (const RuntimeError& e)
+        {
+            logWarning("Failed to read mesh cache '{}': {}", path, e.what());
+            return nullptr;
+        }
+    }
+
+    void SceneCache::writeMeshCache(const Key& key, const TriangleMesh::SharedPtr& pMesh)
+    {
+        FALCOR_ASSERT(pMesh);
+        auto path = getMeshCachePath(key);
+        auto tempPath = getTempFilePathFor(path);
+
+        std::error_code ec;
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+        MeshHeader header;
+        std::memcpy(header.magic, kMeshMagic, sizeof(MeshHeader::magic));
+        header.version = kMeshVersion;
+        header.key = key;
+
+        OutputStream stream;
+        stream.write(header);
+        stream.write(pMesh->getName());
+        stream.write(pMesh->getVertices());
+        stream.write(pMesh->getIndices());
+        stream.write(pMesh->getFrontFaceCW());
+
+        {
+            std::ofstream fs(tempPath, std::ios_base::binary);
+            fs.write(reinterpret_cast<const char*>(stream.getData().data()), stream.getData().size());
+            if (!fs.good())
+            {
+                fs.close();
+                std::filesystem::remove(tempPath, ec);
+                logWarning("Failed to write mesh cache '{}'.", path);
+                return;
+            }
+        }
+
+        moveFileIntoPlace(tempPath, path);
+    }
+
+    void SceneCache::trimMeshCache(uint64_t sizeLimit)
+    {
+        struct Entry
+        {
+            std::filesystem::path path;
+            uint64_t size = 0;
+            std::filesystem::file_time_type lastWriteTime;
+        };
+
+        std::vector<Entry> entries;
+        uint64_t totalSize = 0;
+
+        std::error_code ec;
+        for (const auto& it : std::filesystem::directory_iterator(getAppDataDirectory() / kDirectory / kMeshDirectory, ec))
+        {
+            // Skip temporary files that are still being written.
+            if (!it.is_regular_file(ec) || it.path().extension() == ".tmp") continue;
+            Entry entry{ it.path() };
+            entry.size = it.file_size(ec);
+            if (ec) continue;
+            entry.lastWriteTime = it.last_write_time(ec);
+            if (ec) continue;
+            totalSize += entry.size;
+            entries.push_back(std::move(entry));
+        }
+
+        if (totalSize <= sizeLimit) return;
+
+        std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastWriteTime < b.lastWriteTime; });
+
+        size_t removedCount = 0;
+        uint64_t removedSize = 0;
+        for (const auto& entry : entries)
+        {
+            if (totalSize <= sizeLimit) break;
+            if (!std::filesystem::remove(entry.path, ec)) continue;
+            totalSize -= entry.size;
+            removedSize += entry.size;
+            removedCount++;
+        }
+
+        logInfo("Trimmed mesh cache, removed {} entries ({:.1f} MB).", removedCount, removedSize / double(1 << 20));
     }
 
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
-        std::stringstream ss;
-        ss << std::hex << std::setfill('0') << std::setw(2);
-        for (auto c : key) ss << (int)c;
-        return getAppDataDirectory() / kDirectory / ss.str();
+        return getAppDataDirectory() / kDirectory / SHA1::toHexString(key);
+    }
+
+    std::filesystem::path SceneCache::getMeshCachePath(const Key& key)
+    {
+        return getAppDataDirectory() / kDirectory / kMeshDirectory / SHA1::toHexString(key);
+    }
+
+    // Dependencies
+
+    void SceneCache::writeDependencies(SectionWriter& writer, const DependencyList& dependencies)
+    {
+        OutputStream& stream = writer.addSection(kDependenciesSection);
+        stream.write((uint64_t)dependencies.size());
+        for (const auto& dependency : dependencies)
+        {
+            stream.write(dependency.path);
+            stream.write(dependency.size);
+            stream.write(dependency.lastWriteTime);
+            stream.write(dependency.hash);
+        }
+    }
+
+    SceneCache::DependencyList SceneCache::readDependencies(SectionReader& reader)
+    {
+        InputStream stream = reader.getSection(kDependenciesSection);
+        DependencyList dependencies(stream.read<uint64_t>());
+        for (auto& dependency : dependencies)
+        {
+            stream.read(dependency.path);
+            stream.read(dependency.size);
+            stream.read(dependency.lastWriteTime);
+            stream.read(dependency.hash);
+        }
+        return dependencies;
     }
 
     // SceneData
 
-    void SceneCache::writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData)
+    void SceneCache::writeSceneData(SectionWriter& writer, const Scene::SceneData& sceneData)
     {
+        OutputStream& stream = writer.addSection(kMainSection);
+
         writeMarker(stream, "Path");
         stream.write(sceneData.path);
 
@@ -284,10 +957,6 @@ namespace Falcor
         stream.write((uint32_t)sceneData.lights.size());
         for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
 
-        writeMarker(stream, "Grids");
-        stream.write((uint32_t)sceneData.grids.size());
-        for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
-
         writeMarker(stream, "GridVolumes");
         stream.write((uint32_t)sceneData.gridVolumes.size());
         for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
@@ -311,13 +980,6 @@ namespace Falcor
             stream.write(node.localToBindSpace);
         }
 
-        writeMarker(stream, "Animations");
-        stream.write((uint32_t)sceneData.animations.size());
-        for (const auto& pAnimation : sceneData.animations)
-        {
-            writeAnimation(stream, pAnimation);
-        }
-
         writeMarker(stream, "Metadata");
         writeMetadata(stream, sceneData.metadata);
 
@@ -338,52 +1000,108 @@ namespace Falcor
             stream.write(group.isStatic);
             stream.write(group.isDisplaced);
         }
-        stream.write((uint32_t)sceneData.cachedMeshes.size());
-        for (const auto& cachedMesh : sceneData.cachedMeshes)
-        {
-            stream.write(cachedMesh.meshID);
-            stream.write(cachedMesh.timeSamples);
-            stream.write((uint32_t)cachedMesh.vertexData.size());
-            for (const auto& data : cachedMesh.vertexData) stream.write(data);
-        }
         stream.write(sceneData.useCompressedHitInfo);
         stream.write(sceneData.has16BitIndices);
         stream.write(sceneData.has32BitIndices);
         stream.write(sceneData.meshDrawCount);
-        stream.write(sceneData.meshIndexData);
-        stream.write(sceneData.meshStaticData);
-        stream.write(sceneData.meshSkinningData);
 
         writeMarker(stream, "Curves");
         stream.write(sceneData.curveDesc);
         stream.write(sceneData.curveBBs);
         stream.write(sceneData.curveInstanceData);
-        stream.write(sceneData.curveIndexData);
-        stream.write(sceneData.curveStaticData);
-
-        stream.write((uint32_t)sceneData.cachedCurves.size());
-        for (const auto& cachedCurve : sceneData.cachedCurves)
-        {
-            stream.write(cachedCurve.tessellationMode);
-            stream.write(cachedCurve.geometryID);
-            stream.write(cachedCurve.timeSamples);
-            stream.write(cachedCurve.indexData);
-            stream.write((uint32_t)cachedCurve.vertexData.size());
-            for (const auto& data : cachedCurve.vertexData) stream.write(data);
-        }
 
         writeMarker(stream, "CustomPrimitives");
         stream.write(sceneData.customPrimitiveDesc);
         stream.write(sceneData.customPrimitiveAABBs);
 
         writeMarker(stream, "End");
+
+        // Bulk data is stored in separate sections so it can be decoded independently.
+        {
+            OutputStream& gridStream = writer.addSection(kGridsSection);
+            gridStream.write((uint32_t)sceneData.grids.size());
+            for (const auto& pGrid : sceneData.grids) writeGrid(gridStream, pGrid);
+        }
+
+        {
+            OutputStream& animationStream = writer.addSection(kAnimationsSection);
+            animationStream.write((uint32_t)sceneData.animations.size());
+            for (const auto& pAnimation : sceneData.animations) writeAnimation(animationStream, pAnimation);
+        }
+
+        writer.addSection(kMeshIndexSection).write(sceneData.meshIndexData);
+        writer.addSection(kMeshStaticSection).write(sceneData.meshStaticData);
+        writer.addSection(kMeshSkinningSection).write(sceneData.meshSkinningData);
+
+        // Streamed keyframes are stored uncompressed in their own section, so that they can be streamed from the cache file later on.
+        writer.addSection(kKeyframesSection, false);
+        auto writeKeyframes = [&](OutputStream& stream, const auto& cache)
+        {
+            using VertexT = typename std::decay_t<decltype(cache.vertexData)>::value_type::value_type;
+            stream.write(cache.compressed);
+            if (cache.compressed) stream.write(cache.compressionParams);
+            stream.write(cache.isStreamed());
+            stream.write((uint32_t)cache.getKeyframeCount());
+
+            std::vector<uint8_t> data;
+            std::vector<VertexT> vertexData;
+            for (size_t i = 0; i < cache.getKeyframeCount(); i++)
+            {
+                if (cache.isStreamed())
+                {
+                    // Compressed or not, the chunk is copied as is when the file is written.
+                    uint32_t chunk = cache.keyframeChunks[i];
+                    stream.write(writer.appendFileChunk(kKeyframesSection, cache.pKeyframeFile, chunk));
+                    stream.write((uint64_t)cache.pKeyframeFile->getChunkSize(chunk));
+                }
+                else if (cache.compressed)
+                {
+                    cache.readCompressedKeyframe(i, data);
+                    stream.write(data);
+                }
+                else
+                {
+                    cache.readKeyframe(i, vertexData);
+                    stream.write(vertexData);
+                }
+            }
+        };
+
+        {
+            OutputStream& cachedMeshStream = writer.addSection(kCachedMeshesSection);
+            cachedMeshStream.write((uint32_t)sceneData.cachedMeshes.size());
+            for (const auto& cachedMesh : sceneData.cachedMeshes)
+            {
+                cachedMeshStream.write(cachedMesh.meshID);
+                cachedMeshStream.write(cachedMesh.timeSamples);
+                writeKeyframes(cachedMeshStream, cachedMesh);
+            }
+        }
+
+        writer.addSection(kCurveIndexSection).write(sceneData.curveIndexData);
+        writer.addSection(kCurveStaticSection).write(sceneData.curveStaticData);
+
+        {
+            OutputStream& cachedCurveStream = writer.addSection(kCachedCurvesSection);
+            cachedCurveStream.write((uint32_t)sceneData.cachedCurves.size());
+            for (const auto& cachedCurve : sceneData.cachedCurves)
+            {
+                cachedCurveStream.write(cachedCurve.tessellationMode);
+                cachedCurveStream.write(cachedCurve.geometryID);
+                cachedCurveStream.write(cachedCurve.timeSamples);
+                cachedCurveStream.write(cachedCurve.indexData);
+                writeKeyframes(cachedCurveStream, cachedCurve);
+            }
+        }
     }
 
-    Scene::SceneData SceneCache::readSceneData(InputStream& stream)
+    Scene::SceneData SceneCache::readSceneData(SectionReader& reader)
     {
         Scene::SceneData sceneData;
         sceneData.pMaterials = MaterialSystem::create();
 
+        InputStream stream = reader.getSection(kMainSection);
+
         readMarker(stream, "Path");
         stream.read(sceneData.path);
 
@@ -400,9 +1118,12 @@ namespace Falcor
         sceneData.lights.resize(stream.read<uint32_t>());
         for (auto& pLight : sceneData.lights) pLight = readLight(stream);
 
-        readMarker(stream, "Grids");
-        sceneData.grids.resize(stream.read<uint32_t>());
-        for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream);
+        // Grids are read from their own section before the grid volumes that reference them.
+        {
+            InputStream gridStream = reader.getSection(kGridsSection);
+            sceneData.grids.resize(gridStream.read<uint32_t>());
+            for (auto& pGrid : sceneData.grids) pGrid = readGrid(gridStream);
+        }
 
         readMarker(stream, "GridVolumes");
         sceneData.gridVolumes.resize(stream.read<uint32_t>());
@@ -435,10 +1156,6 @@ namespace Falcor
             stream.read(node.localToBindSpace);
         }
 
-        readMarker(stream, "Animations");
-        sceneData.animations.resize(stream.read<uint32_t>());
-        for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
-
         readMarker(stream, "Metadata");
         sceneData.metadata = readMetadata(stream);
 
@@ -459,39 +1176,15 @@ namespace Falcor
             stream.read(group.isStatic);
             stream.read(group.isDisplaced);
         }
-        sceneData.cachedMeshes.resize(stream.read<uint32_t>());
-        for (auto& cachedMesh : sceneData.cachedMeshes)
-        {
-            stream.read(cachedMesh.meshID);
-            stream.read(cachedMesh.timeSamples);
-            cachedMesh.vertexData.resize(stream.read<uint32_t>());
-            for (auto& data : cachedMesh.vertexData) stream.read(data);
-        }
         stream.read(sceneData.useCompressedHitInfo);
         stream.read(sceneData.has16BitIndices);
         stream.read(sceneData.has32BitIndices);
         stream.read(sceneData.meshDrawCount);
-        stream.read(sceneData.meshIndexData);
-        stream.read(sceneData.meshStaticData);
-        stream.read(sceneData.meshSkinningData);
 
         readMarker(stream, "Curves");
         stream.read(sceneData.curveDesc);
         stream.read(sceneData.curveBBs);
         stream.read(sceneData.curveInstanceData);
-        stream.read(sceneData.curveIndexData);
-        stream.read(sceneData.curveStaticData);
-
-        sceneData.cachedCurves.resize(stream.read<uint32_t>());
-        for (auto& cachedCurve : sceneData.cachedCurves)
-        {
-            stream.read(cachedCurve.tessellationMode);
-            stream.read(cachedCurve.geometryID);
-            stream.read(cachedCurve.timeSamples);
-            stream.read(cachedCurve.indexData);
-            cachedCurve.vertexData.resize(stream.read<uint32_t>());
-            for (auto& data : cachedCurve.vertexData) stream.read(data);
-        }
 
         readMarker(stream, "CustomPrimitives");
         stream.read(sceneData.customPrimitiveDesc);
@@ -499,6 +1192,77 @@ namespace Falcor
 
         readMarker(stream, "End");
 
+        // Decode bulk data sections. Each section is released right after decoding to limit peak memory.
+        {
+            InputStream animationStream = reader.getSection(kAnimationsSection);
+            sceneData.animations.resize(animationStream.read<uint32_t>());
+            for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(animationStream);
+        }
+
+        reader.getSection(kMeshIndexSection).read(sceneData.meshIndexData);
+        reader.getSection(kMeshStaticSection).read(sceneData.meshStaticData);
+        reader.getSection(kMeshSkinningSection).read(sceneData.meshSkinningData);
+
+        // Streamed keyframes are read on demand from the keyframe section of the cache file.
+        const uint64_t keyframeSectionOffset = reader.getSectionFileOffset(kKeyframesSection);
+        auto readKeyframes = [&](InputStream& stream, auto& cache)
+        {
+            stream.read(cache.compressed);
+            if (cache.compressed) stream.read(cache.compressionParams);
+            bool streamed = stream.read<bool>();
+            uint32_t keyframeCount = stream.read<uint32_t>();
+
+            if (streamed)
+            {
+                std::vector<VertexCacheFile::Chunk> chunks(keyframeCount);
+                for (auto& chunk : chunks)
+                {
+                    chunk.offset = keyframeSectionOffset + stream.read<uint64_t>();
+                    chunk.size = stream.read<uint64_t>();
+                }
+                cache.pKeyframeFile = VertexCacheFile::openChunks(reader.getPath(), std::move(chunks));
+                cache.keyframeChunks.resize(keyframeCount);
+                for (uint32_t i = 0; i < keyframeCount; i++) cache.keyframeChunks[i] = i;
+            }
+            else if (cache.compressed)
+            {
+                cache.compressedData.resize(keyframeCount);
+                for (auto& data : cache.compressedData) stream.read(data);
+            }
+            else
+            {
+                cache.vertexData.resize(keyframeCount);
+                for (auto& data : cache.vertexData) stream.read(data);
+            }
+        };
+
+        {
+            InputStream cachedMeshStream = reader.getSection(kCachedMeshesSection);
+            sceneData.cachedMeshes.resize(cachedMeshStream.read<uint32_t>());
+            for (auto& cachedMesh : sceneData.cachedMeshes)
+            {
+                cachedMeshStream.read(cachedMesh.meshID);
+                cachedMeshStream.read(cachedMesh.timeSamples);
+                readKeyframes(cachedMeshStream, cachedMesh);
+            }
+        }
+
+        reader.getSection(kCurveIndexSection).read(sceneData.curveIndexData);
+        reader.getSection(kCurveStaticSection).read(sceneData.curveStaticData);
+
+        {
+            InputStream cachedCurveStream = reader.getSection(kCachedCurvesSection);
+            sceneData.cachedCurves.resize(cachedCurveStream.read<uint32_t>());
+            for (auto& cachedCurve : sceneData.cachedCurves)
+            {
+                cachedCurveStream.read(cachedCurve.tessellationMode);
+                cachedCurveStream.read(cachedCurve.geometryID);
+                cachedCurveStream.read(cachedCurve.timeSamples);
+                cachedCurveStream.read(cachedCurve.indexData);
+                readKeyframes(cachedCurveStream, cachedCurve);
+            }
+        }
+
         pMaterialTextureLoader.reset();
 
         return sceneData;
@@ -654,6 +1418,10 @@ namespace Falcor
 
     void SceneCache::writeMaterials(OutputStream& stream, const MaterialSystem::SharedPtr& pMaterials)
     {
+        // Textures are stored by their source path. Store whether they need to be loaded through the texture cooker and deduplicated.
+        stream.write(pMaterials->getTextureManager()->getTextureCooker() != nullptr);
+        stream.write(pMaterials->getTextureManager()->isDeduplicationEnabled());
+
         uint32_t materialCount = pMaterials->getMaterialCount();
         stream.write(materialCount);
 
@@ -709,6 +1477,9 @@ namespace Falcor
 
     void SceneCache::readMaterials(InputStream& stream, const MaterialSystem::SharedPtr& pMaterials, MaterialTextureLoader& materialTextureLoader)
     {
+        if (stream.read<bool>()) pMaterials->getTextureManager()->setTextureCooker(TextureCooker::create());
+        if (stream.read<bool>()) pMaterials->getTextureManager()->setDeduplicationEnabled(true);
+
         uint32_t materialCount = 0;
         stream.read(materialCount);
 
@@ -935,6 +1706,7 @@ namespace Falcor
         stream.read(pAnimation->mInterpolationMode);
         stream.read(pAnimation->mEnableWarping);
         stream.read(pAnimation->mKeyframes);
+        pAnimation->updateKeyframeTimes();
         return pAnimation;
     }
 
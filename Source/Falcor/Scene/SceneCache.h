@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Scene.h"
+#include "TriangleMesh.h"
 #include "Animation/Animation.h"
 #include "Camera/Camera.h"
 #include "Lights/EnvMap.h"
@@ -41,6 +42,7 @@
 #include "Utils/CryptoUtils.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -49,13 +51,55 @@ namespace Falcor
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+        The file is split into aligned, optionally compressed sections that are listed in a section table after the header.
+        On write, the whole scene is serialized into memory before the file is written.
+        On load, the file is memory mapped and all sections are decoded up front, one section at a time.
+        The decoded data of a section is released once it has been read into the scene data.
+        Streamed vertex cache keyframes are the exception: they are stored in an uncompressed section and read from the file on demand.
     */
     class FALCOR_API SceneCache
     {
     public:
         using Key = SHA1::MD;
 
+        /** Size limit of the per-asset mesh cache in bytes.
+        */
+        static constexpr uint64_t kMeshCacheSizeLimit = 8ull << 30;
+
+        /** Input file a scene cache was built from.
+            A cache is only valid as long as all of its dependencies are unchanged.
+        */
+        struct Dependency
+        {
+            std::filesystem::path path;     ///< Absolute path of the file.
+            uint64_t size = 0;              ///< Size of the file in bytes.
+            int64_t lastWriteTime = 0;      ///< Last write time of the file (in ticks of the file clock).
+            std::optional<Key> hash;        ///< Optional hash of the file content. If available, a file with a different write time but the same content is considered unchanged.
+        };
+
+        using DependencyList = std::vector<Dependency>;
+
+        /** Create a dependency for a file.
+            \param[in] path Absolute file path.
+            \param[in] computeHash Compute the hash of the file content.
+            \return Returns the dependency, or an empty optional if the file doesn't exist.
+        */
+        static std::optional<Dependency> createDependency(const std::filesystem::path& path, bool computeHash);
+
+        /** Check if a file is unchanged since a dependency was created for it.
+            \param[in] dependency Dependency.
+            \return Returns true if the file still exists and is unchanged.
+        */
+        static bool isDependencyUpToDate(const Dependency& dependency);
+
+        /** Compute the hash of a file's content.
+            \param[in] path File path.
+            \return Returns the hash, or an empty optional if the file couldn't be read.
+        */
+        static std::optional<Key> computeFileHash(const std::filesystem::path& path);
+
         /** Check if there is a valid scene cache for a given cache key.
+            The cache is only valid if all files it depends on are unchanged.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
         */
@@ -64,8 +108,9 @@ namespace Falcor
         /** Write a scene cache.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] dependencies Files the scene was built from.
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, const DependencyList& dependencies);
 
         /** Read a scene cache.
             \param[in] key Cache key.
@@ -73,14 +118,46 @@ namespace Falcor
         */
         static Scene::SceneData readCache(const Key& key);
 
+        /** Read a triangle mesh from the per-asset cache.
+            The per-asset cache stores intermediate import results of individual assets, so that assets which are unchanged
+            don't need to be processed again when the scene cache is rebuilt.
+            \param[in] key Asset key, typically computed from the hash of the source data and the import settings.
+            \return Returns the triangle mesh, or nullptr if the mesh is not cached.
+        */
+        static TriangleMesh::SharedPtr readMeshCache(const Key& key);
+
+        /** Write a triangle mesh to the per-asset cache.
+            \param[in] key Asset key.
+            \param[in] pMesh Triangle mesh.
+        */
+        static void writeMeshCache(const Key& key, const TriangleMesh::SharedPtr& pMesh);
+
+        /** Trim the per-asset mesh cache to a size limit.
+            Entries are removed in least recently used order until the total size is within the limit.
+            Entries that can't be removed (e.g. because they are in use by another process) are skipped.
+            \param[in] sizeLimit Size limit in bytes.
+        */
+        static void trimMeshCache(uint64_t sizeLimit);
+
+        /** Get the path of a per-asset mesh cache entry.
+            \param[in] key Asset key.
+            \return Returns the path of the cache file.
+        */
+        static std::filesystem::path getMeshCachePath(const Key& key);
+
     private:
         class OutputStream;
         class InputStream;
+        class SectionWriter;
+        class SectionReader;
 
         static std::filesystem::path getCachePath(const Key& key);
 
-        static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
-        static Scene::SceneData readSceneData(InputStream& stream);
+        static void writeDependencies(SectionWriter& writer, const DependencyList& dependencies);
+        static DependencyList readDependencies(SectionReader& reader);
+
+        static void writeSceneData(SectionWriter& writer, const Scene::SceneData& sceneData);
+        static Scene::SceneData readSceneData(SectionReader& reader);
 
         static void writeMetadata(OutputStream& stream, const Scene::Metadata& metadata);
         static Scene::Metadata readMetadata(InputStream& stream);
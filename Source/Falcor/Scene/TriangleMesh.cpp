@@ -42,9 +42,9 @@ namespace Falcor
         return SharedPtr(new TriangleMesh());
     }
 
-    TriangleMesh::SharedPtr TriangleMesh::create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
+    TriangleMesh::SharedPtr TriangleMesh::create(VertexList vertices, IndexList indices, bool frontFaceCW)
     {
-        return SharedPtr(new TriangleMesh(vertices, indices, frontFaceCW));
+        return SharedPtr(new TriangleMesh(std::move(vertices), std::move(indices), frontFaceCW));
     }
 
     TriangleMesh::SharedPtr TriangleMesh::createDummy()
@@ -264,7 +264,9 @@ namespace Falcor
             }
         }
 
-        return create(vertices, indices);
+        auto pMesh = create(vertices, indices);
+        pMesh->mSourcePath = fullPath;
+        return pMesh;
     }
 
     uint32_t TriangleMesh::addVertex(float3 position, float3 normal, float2 texCoord)
@@ -304,9 +306,9 @@ namespace Falcor
     TriangleMesh::TriangleMesh()
     {}
 
-    TriangleMesh::TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW)
-        : mVertices(vertices)
-        , mIndices(indices)
+    TriangleMesh::TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW)
+        : mVertices(std::move(vertices))
+        , mIndices(std::move(indices))
         , mFrontFaceCW(frontFaceCW)
     {}
 
@@ -67,7 +67,7 @@ namespace Falcor
             \param[in] frontFaceCW Triangle winding.
             \return Returns the triangle mesh.
         */
-        static SharedPtr create(const VertexList& vertices, const IndexList& indices, bool frontFaceCW = false);
+        static SharedPtr create(VertexList vertices, IndexList indices, bool frontFaceCW = false);
 
         /** Creates a dummy mesh (single degenerate triangle).
             \return Returns the triangle mesh.
@@ -109,6 +109,11 @@ namespace Falcor
         */
         static SharedPtr createFromFile(const std::filesystem::path& path, bool smoothNormals = false);
 
+        /** Get the path of the file the triangle mesh was loaded from.
+            \return Returns the full path, or an empty path if the mesh was not loaded from a file.
+        */
+        const std::filesystem::path& getSourcePath() const { return mSourcePath; }
+
         /** Get the name of the triangle mesh.
             \return Returns the name.
         */
@@ -170,9 +175,10 @@ namespace Falcor
 
     private:
         TriangleMesh();
-        TriangleMesh(const VertexList& vertices, const IndexList& indices, bool frontFaceCW);
+        TriangleMesh(VertexList vertices, IndexList indices, bool frontFaceCW);
 
         std::string mName;
+        std::filesystem::path mSourcePath;
         std::vector<Vertex> mVertices;
         std::vector<uint32_t> mIndices;
         bool mFrontFaceCW = false;
@@ -95,19 +95,23 @@ namespace Falcor
             return nullptr;
         }
 
+        SharedPtr pGrid;
         if (hasExtension(fullPath, "nvdb"))
         {
-            return createFromNanoVDBFile(fullPath, gridname);
+            pGrid = createFromNanoVDBFile(fullPath, gridname);
         }
         else if (hasExtension(fullPath, "vdb"))
         {
-            return createFromOpenVDBFile(fullPath, gridname);
+            pGrid = createFromOpenVDBFile(fullPath, gridname);
         }
         else
         {
             logWarning("Error when loading grid. Unsupported grid file '{}'.", fullPath);
             return nullptr;
         }
+
+        if (pGrid) pGrid->mSourcePath = fullPath;
+        return pGrid;
     }
 
     void Grid::renderUI(Gui::Widgets& widget)
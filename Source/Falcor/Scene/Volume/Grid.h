@@ -86,6 +86,11 @@ namespace Falcor
         */
         static SharedPtr createFromFile(const std::filesystem::path& path, const std::string& gridname);
 
+        /** Get the path of the file the grid was loaded from.
+            \return Returns the full path, or an empty path if the grid was not loaded from a file.
+        */
+        const std::filesystem::path& getSourcePath() const { return mSourcePath; }
+
         /** Render the UI.
         */
         void renderUI(Gui::Widgets& widget);
@@ -147,6 +152,8 @@ namespace Falcor
         static SharedPtr createFromNanoVDBFile(const std::filesystem::path& path, const std::string& gridname);
         static SharedPtr createFromOpenVDBFile(const std::filesystem::path& path, const std::string& gridname);
 
+        std::filesystem::path mSourcePath;
+
         // Host data.
         nanovdb::GridHandle<nanovdb::HostBuffer> mGridHandle;
         nanovdb::FloatGrid* mpFloatGrid;
@@ -31,7 +31,7 @@
 #include "Core/API/Formats.h"
 #include "Utils/Logger.h"
 #include "Utils/HostDeviceShared.slangh"
-#include "Utils/NumericRange.h"
+#include "Utils/Threading.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Timing/CpuTimer.h"
 
@@ -46,7 +46,6 @@
 
 #include <algorithm>
 #include <atomic>
-#include <execution>
 #include <vector>
 
 namespace Falcor
@@ -286,8 +285,7 @@ namespace Falcor
     BrickedGrid NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::convert()
     {
         auto t0 = CpuTimer::getCurrentTimePoint();
-        auto range = NumericRange<int>(0, mLeafDim[0].z);
-        std::for_each(std::execution::par, range.begin(), range.end(), [&](int z) { convertSlice(z); });
+        Threading::parallelFor<int>(0, mLeafDim[0].z, [&](int z) { convertSlice(z); });
         for (int mip = 1; mip < 4; ++mip) computeMip(mip);
         double dt = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
         logInfo("converted in {}ms: mNonEmptyCount {} vs max {}", dt, mNonEmptyCount, getAtlasMaxBrick());
@@ -0,0 +1,78 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Threading.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Find the set of unique elements in a list using hash buckets.
+        Elements are first bucketed by hash and only compared for equality against other
+        unique elements in the same bucket, making the expected cost linear in the number of elements.
+        The hash function must be consistent with the equality function, i.e. equal elements must have identical hashes.
+        Hashes are computed in parallel, so the hash function needs to be thread-safe.
+        \param[in] count Number of elements.
+        \param[in] getHash Function returning the hash (size_t) of element i.
+        \param[in] isEqual Function returning true if elements i and j are equal.
+        \param[out] idMap For each element, the index into the returned list of the unique element it is equal to.
+        \return List of indices of the unique elements. The first occurrence of each element is kept, in the original order.
+    */
+    template<typename HashFunc, typename EqualFunc>
+    std::vector<size_t> findUniqueElements(size_t count, HashFunc getHash, EqualFunc isEqual, std::vector<size_t>& idMap)
+    {
+        std::vector<size_t> hashes(count);
+        Threading::parallelFor<size_t>(0, count, [&](size_t i) { hashes[i] = getHash(i); });
+
+        // Map from hash to the list of unique elements (indices into the returned list) with that hash.
+        std::unordered_map<size_t, std::vector<size_t>> buckets;
+        buckets.reserve(count);
+
+        std::vector<size_t> uniqueElements;
+        idMap.resize(count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto& bucket = buckets[hashes[i]];
+            auto it = std::find_if(bucket.begin(), bucket.end(), [&](size_t uniqueID) { return isEqual(uniqueElements[uniqueID], i); });
+            if (it == bucket.end())
+            {
+                idMap[i] = uniqueElements.size();
+                bucket.push_back(uniqueElements.size());
+                uniqueElements.push_back(i);
+            }
+            else
+            {
+                idMap[i] = *it;
+            }
+        }
+
+        return uniqueElements;
+    }
+}
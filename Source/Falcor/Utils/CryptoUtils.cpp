@@ -108,6 +108,19 @@ namespace Falcor
         return sha1.finalize();
     }
 
+    std::string SHA1::toHexString(const MD& md)
+    {
+        static const char* kHexDigits = "0123456789abcdef";
+        std::string str;
+        str.reserve(md.size() * 2);
+        for (uint8_t b : md)
+        {
+            str.push_back(kHexDigits[b >> 4]);
+            str.push_back(kHexDigits[b & 0xf]);
+        }
+        return str;
+    }
+
     void SHA1::addByte(uint8_t byte)
     {
         mBuf[mIndex++] = byte;
@@ -30,6 +30,7 @@
 #include <array>
 #include <cstdint>
 #include <cstdlib>
+#include <string>
 
 namespace Falcor
 {
@@ -65,6 +66,12 @@ namespace Falcor
         */
         static MD compute(const void* data, size_t len);
 
+        /** Convert a message digest to a string of lower case hex digits.
+            \param[in] md Message digest.
+            \return Returns the hex string (two digits per byte).
+        */
+        static std::string toHexString(const MD& md);
+
     private:
         void addByte(uint8_t x);
         void processBlock(const uint8_t* ptr);
@@ -51,11 +51,17 @@ namespace Falcor
     std::future<Texture::SharedPtr> AsyncTextureLoader::loadFromFile(const std::filesystem::path& path, bool generateMipLevels, bool loadAsSrgb, Resource::BindFlags bindFlags, LoadCallback callback)
     {
         std::lock_guard<std::mutex> lock(mMutex);
-        mLoadRequestQueue.push(LoadRequest{path, generateMipLevels, loadAsSrgb, bindFlags, callback });
+        mLoadRequestQueue.push(LoadRequest{path, generateMipLevels, loadAsSrgb, bindFlags, callback, mpTextureCooker });
         mCondition.notify_one();
         return mLoadRequestQueue.back().promise.get_future();
     }
 
+    void AsyncTextureLoader::setTextureCooker(const TextureCooker::SharedPtr& pTextureCooker)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mpTextureCooker = pTextureCooker;
+    }
+
     void AsyncTextureLoader::runWorkers(size_t threadCount)
     {
         // Create a barrier to synchronize worker threads before issuing a global flush.
@@ -106,7 +112,9 @@ namespace Falcor
             lock.unlock();
 
             // Load the textures (this part is running in parallel).
-            Texture::SharedPtr pTexture = Texture::createFromFile(request.path, request.generateMipLevels, request.loadAsSRGB, request.bindFlags);
+            Texture::SharedPtr pTexture = request.pTextureCooker
+                ? request.pTextureCooker->loadTexture(request.path, request.generateMipLevels, request.loadAsSRGB, request.bindFlags)
+                : Texture::createFromFile(request.path, request.generateMipLevels, request.loadAsSRGB, request.bindFlags);
             request.promise.set_value(pTexture);
 
             if (request.callback)
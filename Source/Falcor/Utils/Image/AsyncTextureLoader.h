@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "TextureCooker.h"
 #include "Core/Macros.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
@@ -75,6 +76,11 @@ namespace Falcor
             LoadCallback callback = {}
         );
 
+        /** Set the texture cooker used for subsequent load requests.
+            \param[in] pTextureCooker Texture cooker, or nullptr to load textures from their source files.
+        */
+        void setTextureCooker(const TextureCooker::SharedPtr& pTextureCooker);
+
     private:
         void runWorkers(size_t threadCount);
         void runWorker();
@@ -87,6 +93,7 @@ namespace Falcor
             bool loadAsSRGB;
             Resource::BindFlags bindFlags;
             LoadCallback callback;
+            TextureCooker::SharedPtr pTextureCooker;
             std::promise<Texture::SharedPtr> promise;
         };
 
@@ -97,6 +104,7 @@ namespace Falcor
 
         // Internal state. Do not access outside of critical section.
         std::queue<LoadRequest> mLoadRequestQueue;  ///< Texture loading request queue.
+        TextureCooker::SharedPtr mpTextureCooker;   ///< Texture cooker used for new requests, or nullptr if disabled.
 
         bool mTerminate = false;                    ///< Flag to terminate worker threads.
         bool mFlushPending = false;                 ///< Flag to indicate a GPU flush is pending.
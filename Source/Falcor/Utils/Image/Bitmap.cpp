@@ -26,16 +26,24 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Bitmap.h"
+#include "PixelConversion.h"
 #include "Core/API/Texture.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Threading.h"
+#include "Utils/Math/Common.h"
 
 #include <FreeImage.h>
+#include <algorithm>
+#include <cstring>
 
 namespace Falcor
 {
     static bool isRGB32fSupported() { return false; } // FIX THIS
 
+    static const size_t kParallelCopyMinSize = 1 << 24;     ///< Images of at least this many bytes are copied on multiple threads.
+    static const uint32_t kRowsPerStrip = 64;               ///< Number of rows per strip when copying on multiple threads.
+
     static void genWarning(const std::string& errMsg, const std::filesystem::path& path)
     {
         logWarning("Error when loading image file from '{}': {}", path, errMsg);
@@ -137,41 +145,54 @@ namespace Falcor
         return floatData;
     }
 
-    /** Converts 96bpp to 128bpp RGBA without clamping.
-        Note that we can't use FreeImage_ConvertToRGBAF() as it clamps to [0,1].
+    /** Copy a FreeImage bitmap into a bitmap buffer.
+        24-bit pixels are expanded to 32 bits and 96-bit RGB float pixels to 128-bit RGBA float if the destination format requires it.
+        This writes directly into the final allocation instead of going through intermediate FreeImage conversions.
+        Note that we can't use FreeImage_ConvertToRGBAF() for RGB float images as it clamps to [0,1].
+        Large images are converted in strips of rows on multiple threads.
     */
-    static FIBITMAP* convertToRGBAF(FIBITMAP* pDib)
+    static void copyFromDib(FIBITMAP* pDib, ResourceFormat format, uint8_t* pDst, uint32_t dstPitch, bool isTopDown)
     {
-        const unsigned width = FreeImage_GetWidth(pDib);
-        const unsigned height = FreeImage_GetHeight(pDib);
-
-        auto pNew = FreeImage_AllocateT(FIT_RGBAF, width, height);
-        FreeImage_CloneMetadata(pNew, pDib);
-
-        const unsigned src_pitch = FreeImage_GetPitch(pDib);
-        const unsigned dst_pitch = FreeImage_GetPitch(pNew);
-
-        const BYTE *src_bits = (BYTE*)FreeImage_GetBits(pDib);
-        BYTE* dst_bits = (BYTE*)FreeImage_GetBits(pNew);
+        const uint32_t width = FreeImage_GetWidth(pDib);
+        const uint32_t height = FreeImage_GetHeight(pDib);
+        const uint32_t bpp = FreeImage_GetBPP(pDib);
+        const size_t lineSize = std::min<size_t>(FreeImage_GetLine(pDib), dstPitch);
 
-        for (unsigned y = 0; y < height; y++)
+        auto convertRows = [&](uint32_t rowBegin, uint32_t rowEnd)
         {
-            const FIRGBF *src_pixel = (FIRGBF*)src_bits;
-            FIRGBAF* dst_pixel = (FIRGBAF*)dst_bits;
-
-            for (unsigned x = 0; x < width; x++)
+            for (uint32_t row = rowBegin; row < rowEnd; row++)
             {
-                // Convert pixels directly, while adding a "dummy" alpha of 1.0
-                dst_pixel[x].red = src_pixel[x].red;
-                dst_pixel[x].green = src_pixel[x].green;
-                dst_pixel[x].blue = src_pixel[x].blue;
-                dst_pixel[x].alpha = 1.0F;
+                // FreeImage stores scanlines bottom-up.
+                const uint8_t* pSrcRow = FreeImage_GetScanLine(pDib, isTopDown ? height - row - 1 : row);
+                uint8_t* pDstRow = pDst + size_t(row) * dstPitch;
 
+                if (bpp == 24)
+                {
+                    expand24To32Bit(pSrcRow, pDstRow, width);
+                }
+                else if (bpp == 96 && format == ResourceFormat::RGBA32Float)
+                {
+                    expandRGB32FloatToRGBA32Float(reinterpret_cast<const float*>(pSrcRow), reinterpret_cast<float*>(pDstRow), width);
+                }
+                else
+                {
+                    std::memcpy(pDstRow, pSrcRow, lineSize);
+                }
             }
-            src_bits += src_pitch;
-            dst_bits += dst_pitch;
+        };
+
+        if (size_t(dstPitch) * height >= kParallelCopyMinSize)
+        {
+            const uint32_t stripCount = div_round_up(height, kRowsPerStrip);
+            Threading::parallelFor<uint32_t>(0, stripCount, [&](uint32_t strip)
+            {
+                convertRows(strip * kRowsPerStrip, std::min(height, (strip + 1) * kRowsPerStrip));
+            });
+        }
+        else
+        {
+            convertRows(0, height);
         }
-        return pNew;
     }
 
     Bitmap::UniqueConstPtr Bitmap::create(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData)
@@ -276,27 +297,12 @@ namespace Falcor
             return nullptr;
         }
 
-        // Convert the image to RGBX image
-        if (bpp == 24)
-        {
-            bpp = 32;
-            auto pNew = FreeImage_ConvertTo32Bits(pDib);
-            FreeImage_Unload(pDib);
-            pDib = pNew;
-        }
-        else if (bpp == 96 && (isRGB32fSupported() == false))
-        {
-            bpp = 128;
-            auto pNew = convertToRGBAF(pDib);
-            FreeImage_Unload(pDib);
-            pDib = pNew;
-        }
-
         // PFM images are loaded y-flipped, fix this by inverting the isTopDown flag.
         if (fifFormat == FIF_PFM) isTopDown = !isTopDown;
 
+        // Copy the image into the bitmap, expanding 24-bit images to RGBX and RGB float images to RGBA float on the way.
         UniqueConstPtr pBmp = UniqueConstPtr(new Bitmap(width, height, format));
-        FreeImage_ConvertToRawBits(pBmp->getData(), pDib, pBmp->getRowPitch(), bpp, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, isTopDown);
+        copyFromDib(pDib, format, pBmp->getData(), pBmp->getRowPitch(), isTopDown);
         FreeImage_Unload(pDib);
         return pBmp;
     }
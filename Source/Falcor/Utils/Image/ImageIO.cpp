@@ -29,6 +29,7 @@
 #include "Core/Errors.h"
 #include "Core/API/CopyContext.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/Common.h"
 
 #include <dds_header/DDSHeader.h>
 #include <nvtt/nvtt.h>
@@ -637,6 +638,55 @@ namespace Falcor
         return pTex;
     }
 
+    ImageIO::MipChain ImageIO::loadMipChainFromDDS(const std::filesystem::path& path)
+    {
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath))
+        {
+            throw RuntimeError("Failed to load DDS image from '{}': Can't find file.", path);
+        }
+
+        ImportData data;
+        try
+        {
+            loadDDS(fullPath, false, data);
+        }
+        catch (const RuntimeError& e)
+        {
+            throw RuntimeError("Failed to load DDS image from '{}': {}", path, e.what());
+        }
+
+        if (data.type != Resource::Type::Texture2D || data.arraySize != 1)
+        {
+            throw RuntimeError("Failed to load DDS image from '{}': Expected a single 2D image.", path);
+        }
+
+        MipChain mipChain;
+        mipChain.format = data.format;
+        mipChain.width = data.width;
+        mipChain.height = data.height;
+
+        const uint32_t blockWidth = getFormatWidthCompressionRatio(data.format);
+        const uint32_t blockHeight = getFormatHeightCompressionRatio(data.format);
+        const size_t bytesPerBlock = getFormatBytesPerBlock(data.format);
+
+        size_t offset = 0;
+        for (uint32_t mip = 0; mip < data.mipLevels; mip++)
+        {
+            uint32_t width = std::max(1u, data.width >> mip);
+            uint32_t height = std::max(1u, data.height >> mip);
+            size_t size = size_t(div_round_up(width, blockWidth)) * div_round_up(height, blockHeight) * bytesPerBlock;
+            if (offset + size > data.imageData.size())
+            {
+                throw RuntimeError("Failed to load DDS image from '{}': Image data is truncated.", path);
+            }
+            mipChain.mips.emplace_back(data.imageData.begin() + offset, data.imageData.begin() + offset + size);
+            offset += size;
+        }
+
+        return mipChain;
+    }
+
     void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap, CompressionMode mode, bool generateMips)
     {
         if (!hasExtension(path, "dds"))
@@ -644,6 +694,27 @@ namespace Falcor
             logWarning("Saving DDS image to '{}' which does not have 'dds' file extension.", path);
         }
 
+        // NVTT only accepts single channel images in 32-bit float. Expand 8-bit single channel images to BGRA
+        // with the value in the red channel, which is the channel encoded by BC4.
+        if (bitmap.getFormat() == ResourceFormat::R8Unorm)
+        {
+            const uint32_t width = bitmap.getWidth();
+            const uint32_t height = bitmap.getHeight();
+            std::vector<uint8_t> data(size_t(width) * height * 4, 0);
+            for (uint32_t y = 0; y < height; y++)
+            {
+                const uint8_t* pSrc = bitmap.getData() + size_t(y) * bitmap.getRowPitch();
+                uint8_t* pDst = data.data() + size_t(y) * width * 4;
+                for (uint32_t x = 0; x < width; x++)
+                {
+                    pDst[4 * x + 2] = pSrc[x];
+                    pDst[4 * x + 3] = 0xff;
+                }
+            }
+            saveToDDS(path, *Bitmap::create(width, height, ResourceFormat::BGRA8Unorm, data.data()), mode, generateMips);
+            return;
+        }
+
         try
         {
             ExportData image;
@@ -30,6 +30,7 @@
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include <filesystem>
+#include <vector>
 
 namespace Falcor
 {
@@ -80,6 +81,16 @@ namespace Falcor
             None
         };
 
+        /** Image data with a full mip chain in CPU memory.
+        */
+        struct MipChain
+        {
+            ResourceFormat format = ResourceFormat::Unknown;
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<std::vector<uint8_t>> mips;     ///< Data for each mip level, stored as tightly packed rows of blocks.
+        };
+
         /** Load a DDS file to a Bitmap. If the file contains an image array and/or mips, only the first image will be loaded.
             Throws an exception if the DDS file is malformed.
             \param[in] path Path of file to load.
@@ -95,6 +106,13 @@ namespace Falcor
         */
         static Texture::SharedPtr loadTextureFromDDS(const std::filesystem::path& path, bool loadAsSrgb);
 
+        /** Load all mip levels of a 2D DDS file to CPU memory.
+            Throws an exception if the DDS file is malformed or does not contain a single 2D image.
+            \param[in] path Path of file to load.
+            \return The mip chain stored in the file.
+        */
+        static MipChain loadMipChainFromDDS(const std::filesystem::path& path);
+
         /** Saves a bitmap to a DDS file.
             Throws an exception if path is invalid or the image cannot be saved.
             \param[in] path Path to save to.
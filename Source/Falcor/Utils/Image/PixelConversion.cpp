@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "PixelConversion.h"
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define FALCOR_PIXEL_CONVERSION_SSE2 1
+#include <emmintrin.h>
+#else
+#define FALCOR_PIXEL_CONVERSION_SSE2 0
+#endif
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#define FALCOR_PIXEL_CONVERSION_SSSE3 1
+#include <tmmintrin.h>
+#else
+#define FALCOR_PIXEL_CONVERSION_SSSE3 0
+#endif
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kOpaqueAlpha = 0xff000000;
+
+        uint32_t load32(const uint8_t* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        void store32(uint8_t* p, uint32_t value)
+        {
+            std::memcpy(p, &value, sizeof(value));
+        }
+    }
+
+    void expand24To32Bit(const uint8_t* pSrc, uint8_t* pDst, size_t pixelCount)
+    {
+        size_t i = 0;
+#if FALCOR_PIXEL_CONVERSION_SSSE3
+        // Shuffle 4 pixels from a 16-byte load. Stop early so the load doesn't read past the end of the source.
+        const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alpha = _mm_set1_epi32((int)kOpaqueAlpha);
+        for (; i + 6 <= pixelCount; i += 4)
+        {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i * 3));
+            v = _mm_or_si128(_mm_shuffle_epi8(v, shuffle), alpha);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i * 4), v);
+        }
+#endif
+        // Expand 4 pixels from three 32-bit words (assumes little-endian byte order).
+        for (; i + 4 <= pixelCount; i += 4)
+        {
+            const uint8_t* s = pSrc + i * 3;
+            uint8_t* d = pDst + i * 4;
+            uint32_t w0 = load32(s), w1 = load32(s + 4), w2 = load32(s + 8);
+            store32(d, w0 | kOpaqueAlpha);
+            store32(d + 4, (w0 >> 24) | (w1 << 8) | kOpaqueAlpha);
+            store32(d + 8, (w1 >> 16) | (w2 << 16) | kOpaqueAlpha);
+            store32(d + 12, (w2 >> 8) | kOpaqueAlpha);
+        }
+        for (; i < pixelCount; i++)
+        {
+            pDst[i * 4 + 0] = pSrc[i * 3 + 0];
+            pDst[i * 4 + 1] = pSrc[i * 3 + 1];
+            pDst[i * 4 + 2] = pSrc[i * 3 + 2];
+            pDst[i * 4 + 3] = 0xff;
+        }
+    }
+
+    void expandRGB32FloatToRGBA32Float(const float* pSrc, float* pDst, size_t pixelCount)
+    {
+        size_t i = 0;
+#if FALCOR_PIXEL_CONVERSION_SSE2
+        // Load 4 floats per pixel and replace the last one with alpha. The last pixel is handled below to avoid reading past the end of the source.
+        const __m128 rgbMask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+        const __m128 alpha = _mm_setr_ps(0.f, 0.f, 0.f, 1.f);
+        for (; i + 1 < pixelCount; i++)
+        {
+            __m128 v = _mm_loadu_ps(pSrc + i * 3);
+            _mm_storeu_ps(pDst + i * 4, _mm_or_ps(_mm_and_ps(v, rgbMask), alpha));
+        }
+#endif
+        for (; i < pixelCount; i++)
+        {
+            pDst[i * 4 + 0] = pSrc[i * 3 + 0];
+            pDst[i * 4 + 1] = pSrc[i * 3 + 1];
+            pDst[i * 4 + 2] = pSrc[i * 3 + 2];
+            pDst[i * 4 + 3] = 1.f;
+        }
+    }
+}
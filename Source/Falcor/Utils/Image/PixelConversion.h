@@ -0,0 +1,54 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Pixel conversion kernels used when loading images.
+        The kernels use SSE/SSSE3 when available and fall back to portable code otherwise.
+        Source and destination must not overlap.
+    */
+
+    /** Expand 24-bit pixels to 32-bit pixels by appending an opaque alpha byte (0xff).
+        The channel order is preserved, e.g. BGR pixels are expanded to BGRA.
+        \param[in] pSrc Source pixels, 3 bytes per pixel.
+        \param[out] pDst Destination pixels, 4 bytes per pixel.
+        \param[in] pixelCount Number of pixels.
+    */
+    FALCOR_API void expand24To32Bit(const uint8_t* pSrc, uint8_t* pDst, size_t pixelCount);
+
+    /** Expand RGB32Float pixels to RGBA32Float pixels with alpha set to 1.0.
+        \param[in] pSrc Source pixels, 3 floats per pixel.
+        \param[out] pDst Destination pixels, 4 floats per pixel.
+        \param[in] pixelCount Number of pixels.
+    */
+    FALCOR_API void expandRGB32FloatToRGBA32Float(const float* pSrc, float* pDst, size_t pixelCount);
+}
@@ -0,0 +1,260 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureCooker.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current cooker version.
+            This needs to be incremented every time the choice of compression mode or the encoder settings change!
+        */
+        const uint32_t kVersion = 1;
+
+        /** Texture cache directory (subdirectory in the application data directory).
+        */
+        const std::string kDirectory = "NVIDIA/Falcor/TextureCache";
+
+        const std::string kEntryExtension = ".dds";
+        const std::string kTempExtension = ".tmp";
+
+        /** Returns true if all texels of a four channel bitmap have the given alpha value.
+        */
+        template<typename T>
+        bool isAlphaConstant(const Bitmap& bitmap, T alpha)
+        {
+            for (uint32_t y = 0; y < bitmap.getHeight(); y++)
+            {
+                const T* pRow = reinterpret_cast<const T*>(bitmap.getData() + size_t(y) * bitmap.getRowPitch());
+                for (uint32_t x = 0; x < bitmap.getWidth(); x++)
+                {
+                    if (pRow[4 * x + 3] != alpha) return false;
+                }
+            }
+            return true;
+        }
+
+        bool isOpaque(const Bitmap& bitmap)
+        {
+            switch (bitmap.getFormat())
+            {
+            case ResourceFormat::BGRX8Unorm:
+            case ResourceFormat::RGB16Float:
+            case ResourceFormat::RGB32Float:
+                return true;
+            case ResourceFormat::BGRA8Unorm:
+                return isAlphaConstant<uint8_t>(bitmap, 0xff);
+            case ResourceFormat::RGBA16Float:
+                return isAlphaConstant<uint16_t>(bitmap, 0x3c00); // 1.0 in half precision
+            case ResourceFormat::RGBA32Float:
+                return isAlphaConstant<float>(bitmap, 1.f);
+            default:
+                FALCOR_UNREACHABLE();
+                return false;
+            }
+        }
+    }
+
+    TextureCooker::SharedPtr TextureCooker::create(const std::filesystem::path& directory)
+    {
+        return SharedPtr(new TextureCooker(directory));
+    }
+
+    TextureCooker::TextureCooker(const std::filesystem::path& directory)
+        : mDirectory(directory)
+    {
+    }
+
+    std::filesystem::path TextureCooker::getDefaultDirectory()
+    {
+        return getAppDataDirectory() / kDirectory;
+    }
+
+    std::optional<ImageIO::CompressionMode> TextureCooker::chooseCompressionMode(const Bitmap& bitmap, bool isSrgb)
+    {
+        // Block compressed textures need dimensions that are a multiple of the block size.
+        // Cropping the image (as ImageIO does when generating mips) would change the texture, so don't cook these.
+        if (bitmap.getWidth() % 4 != 0 || bitmap.getHeight() % 4 != 0) return {};
+
+        switch (bitmap.getFormat())
+        {
+        case ResourceFormat::R8Unorm:
+            return ImageIO::CompressionMode::BC4;
+        case ResourceFormat::RG8Unorm:
+            return ImageIO::CompressionMode::BC5;
+        case ResourceFormat::BGRX8Unorm:
+        case ResourceFormat::BGRA8Unorm:
+            // Use BC1 for opaque color data. Non-color data (normal maps, roughness, ...) is much more
+            // sensitive to the quantization in BC1, so use BC7 for it as well as for images with alpha.
+            return isSrgb && isOpaque(bitmap) ? ImageIO::CompressionMode::BC1 : ImageIO::CompressionMode::BC7;
+        case ResourceFormat::RGB16Float:
+        case ResourceFormat::RGB32Float:
+        case ResourceFormat::RGBA16Float:
+        case ResourceFormat::RGBA32Float:
+            // BC6H doesn't store alpha. HDR images with alpha are stored uncompressed, which still saves decoding them and generating mips.
+            return isOpaque(bitmap) ? ImageIO::CompressionMode::BC6 : ImageIO::CompressionMode::None;
+        default:
+            return {};
+        }
+    }
+
+    std::optional<TextureCooker::Key> TextureCooker::computeKey(const std::filesystem::path& path, bool generateMipLevels, bool isSrgb)
+    {
+        MemoryMappedFile file;
+        if (!file.open(path, MemoryMappedFile::AccessHint::SequentialScan)) return {};
+
+        SHA1 sha1;
+        sha1.update(&kVersion, sizeof(kVersion));
+        sha1.update(uint8_t(generateMipLevels));
+        sha1.update(uint8_t(isSrgb));
+        sha1.update(file.getData(), file.getSize());
+        return sha1.finalize();
+    }
+
+    Texture::SharedPtr TextureCooker::loadTexture(const std::filesystem::path& path, bool generateMipLevels, bool loadAsSrgb, Resource::BindFlags bindFlags)
+    {
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath))
+        {
+            logWarning("Error when loading image file. Can't find image file '{}'.", path);
+            return nullptr;
+        }
+
+        // Block compressed formats can only be bound as shader resources. DDS files are already in their final form.
+        if (bindFlags != Resource::BindFlags::ShaderResource || hasExtension(fullPath, "dds"))
+        {
+            mSkipCount++;
+            return Texture::createFromFile(fullPath, generateMipLevels, loadAsSrgb, bindFlags);
+        }
+
+        auto key = computeKey(fullPath, generateMipLevels, loadAsSrgb);
+        if (!key)
+        {
+            logWarning("Error when loading image file. Can't read image file '{}'.", fullPath);
+            return nullptr;
+        }
+
+        auto entryPath = getEntryPath(*key);
+        auto loadCooked = [&]() -> Texture::SharedPtr
+        {
+            auto pTexture = ImageIO::loadTextureFromDDS(entryPath, loadAsSrgb);
+            if (pTexture) pTexture->setSourcePath(fullPath);
+            return pTexture;
+        };
+
+        std::error_code ec;
+        if (std::filesystem::exists(entryPath, ec))
+        {
+            if (auto pTexture = loadCooked())
+            {
+                mHitCount++;
+                return pTexture;
+            }
+
+            // The cooked file is unreadable. Remove it and cook the texture again.
+            logWarning("Removing invalid cooked texture '{}'.", entryPath);
+            std::filesystem::remove(entryPath, ec);
+        }
+
+        Bitmap::UniqueConstPtr pBitmap = Texture::loadBitmapFromFile(fullPath);
+        if (!pBitmap) return nullptr;
+
+        if (auto mode = chooseCompressionMode(*pBitmap, loadAsSrgb))
+        {
+            try
+            {
+                cook(*pBitmap, *mode, generateMipLevels, entryPath);
+
+                if (auto pTexture = loadCooked())
+                {
+                    mCookCount++;
+                    return pTexture;
+                }
+            }
+            catch (const RuntimeError& e)
+            {
+                logWarning("Failed to cook texture '{}': {}", fullPath, e.what());
+            }
+        }
+
+        // Fall back to creating the texture from the decoded image.
+        mSkipCount++;
+        auto pTexture = Texture::createFromBitmap(*pBitmap, generateMipLevels, loadAsSrgb, bindFlags);
+        if (pTexture) pTexture->setSourcePath(fullPath);
+        return pTexture;
+    }
+
+    std::filesystem::path TextureCooker::getEntryPath(const Key& key) const
+    {
+        return mDirectory / (SHA1::toHexString(key) + kEntryExtension);
+    }
+
+    TextureCooker::Stats TextureCooker::getStats() const
+    {
+        Stats stats;
+        stats.hitCount = mHitCount;
+        stats.cookCount = mCookCount;
+        stats.skipCount = mSkipCount;
+        return stats;
+    }
+
+    void TextureCooker::resetStats()
+    {
+        mHitCount = 0;
+        mCookCount = 0;
+        mSkipCount = 0;
+    }
+
+    void TextureCooker::cook(const Bitmap& bitmap, ImageIO::CompressionMode mode, bool generateMipLevels, const std::filesystem::path& entryPath)
+    {
+        // Keep the DDS extension last, ImageIO warns about files without it.
+        auto tempPath = getTempFilePathFor(entryPath, kTempExtension + kEntryExtension);
+
+        std::error_code ec;
+        std::filesystem::create_directories(mDirectory, ec);
+
+        try
+        {
+            ImageIO::saveToDDS(tempPath, bitmap, mode, generateMipLevels);
+        }
+        catch (const RuntimeError&)
+        {
+            std::filesystem::remove(tempPath, ec);
+            throw;
+        }
+
+        moveFileIntoPlace(tempPath, entryPath);
+    }
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Bitmap.h"
+#include "ImageIO.h"
+#include "Core/Macros.h"
+#include "Core/API/Resource.h"
+#include "Core/API/Texture.h"
+#include "Utils/CryptoUtils.h"
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <optional>
+
+namespace Falcor
+{
+    /** Offline texture cooker.
+
+        Converts source images (PNG, JPG, EXR, ...) into block-compressed DDS files with a
+        precomputed mip chain. Cooked files are stored in a content-addressed cache directory,
+        so later loads read the compressed data directly instead of decoding the source image
+        and generating mips on the GPU.
+
+        The compression mode is chosen from the channels used by the image and whether it
+        holds color (sRGB) data. Images that can't be block compressed (unsupported formats,
+        dimensions that are not a multiple of 4) are loaded the regular way.
+
+        Block compression is lossy, so cooking is opt-in.
+    */
+    class FALCOR_API TextureCooker
+    {
+    public:
+        using SharedPtr = std::shared_ptr<TextureCooker>;
+        using Key = SHA1::MD;
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;      ///< Number of textures loaded from a cooked file.
+            uint64_t cookCount = 0;     ///< Number of textures cooked.
+            uint64_t skipCount = 0;     ///< Number of textures that could not be cooked and were loaded from the source file.
+        };
+
+        /** Create a texture cooker.
+            The directory is created on the first write.
+            \param[in] directory Cache directory.
+            \return New object.
+        */
+        static SharedPtr create(const std::filesystem::path& directory = getDefaultDirectory());
+
+        /** Get the default cache directory (subdirectory in the application data directory).
+        */
+        static std::filesystem::path getDefaultDirectory();
+
+        /** Choose the compression mode for an image.
+            \param[in] bitmap Source image.
+            \param[in] isSrgb True if the image holds sRGB color data.
+            \return Compression mode, or an empty optional if the image can't be cooked.
+        */
+        static std::optional<ImageIO::CompressionMode> chooseCompressionMode(const Bitmap& bitmap, bool isSrgb);
+
+        /** Compute the key of a cooked texture. The key is a hash over the content of the source file and the cooking options.
+            \param[in] path Full path of the source image.
+            \param[in] generateMipLevels Whether the full mip chain is generated.
+            \param[in] isSrgb True if the image holds sRGB color data.
+            \return Key, or an empty optional if the file can't be read.
+        */
+        static std::optional<Key> computeKey(const std::filesystem::path& path, bool generateMipLevels, bool isSrgb);
+
+        /** Load a texture, cooking it first if no cooked file exists.
+            The source path of the returned texture is set to the path of the source image.
+            \param[in] path File path of the source image. This can be a full path or a relative path from a data directory.
+            \param[in] generateMipLevels Whether the full mip chain should be generated.
+            \param[in] loadAsSrgb Load the texture as sRGB format if supported, otherwise linear color.
+            \param[in] bindFlags The bind flags for the texture resource. Only shader resources are cooked.
+            \return The texture, or nullptr if the image can't be loaded.
+        */
+        Texture::SharedPtr loadTexture(const std::filesystem::path& path, bool generateMipLevels, bool loadAsSrgb, Resource::BindFlags bindFlags = Resource::BindFlags::ShaderResource);
+
+        /** Get the path of the cooked file with the given key.
+        */
+        std::filesystem::path getEntryPath(const Key& key) const;
+
+        const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+        Stats getStats() const;
+        void resetStats();
+
+    private:
+        TextureCooker(const std::filesystem::path& directory);
+
+        /** Compress the image and store it as the given entry. Throws an exception if the image can't be saved.
+        */
+        void cook(const Bitmap& bitmap, ImageIO::CompressionMode mode, bool generateMipLevels, const std::filesystem::path& entryPath);
+
+        std::filesystem::path mDirectory;
+
+        std::atomic<uint64_t> mHitCount{0};
+        std::atomic<uint64_t> mCookCount{0};
+        std::atomic<uint64_t> mSkipCount{0};
+    };
+}
@@ -26,7 +26,10 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TextureManager.h"
+#include "Bitmap.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
@@ -39,6 +42,40 @@ namespace Falcor
     {
         const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
         static_assert(TextureManager::TextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+        // Tags to keep file and pixel hashes apart in the content hash map.
+        const uint8_t kFileHashTag = 0;
+        const uint8_t kPixelHashTag = 1;
+
+        void hashLoadOptions(SHA1& sha1, uint8_t tag, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags)
+        {
+            sha1.update(tag);
+            sha1.update(uint8_t(generateMipLevels));
+            sha1.update(uint8_t(loadAsSRGB));
+            uint32_t flags = (uint32_t)bindFlags;
+            sha1.update(&flags, sizeof(flags));
+        }
+
+        std::optional<SHA1::MD> computeFileHash(const std::filesystem::path& path, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags)
+        {
+            MemoryMappedFile file;
+            if (!file.open(path, MemoryMappedFile::AccessHint::SequentialScan)) return {};
+
+            SHA1 sha1;
+            hashLoadOptions(sha1, kFileHashTag, generateMipLevels, loadAsSRGB, bindFlags);
+            sha1.update(file.getData(), file.getSize());
+            return sha1.finalize();
+        }
+
+        SHA1::MD computePixelHash(const Bitmap& bitmap, bool generateMipLevels, bool loadAsSRGB, Resource::BindFlags bindFlags)
+        {
+            SHA1 sha1;
+            hashLoadOptions(sha1, kPixelHashTag, generateMipLevels, loadAsSRGB, bindFlags);
+            uint32_t header[] = { bitmap.getWidth(), bitmap.getHeight(), (uint32_t)bitmap.getFormat() };
+            sha1.update(header, sizeof(header));
+            sha1.update(bitmap.getData(), bitmap.getSize());
+            return sha1.finalize();
+        }
     }
 
     TextureManager::SharedPtr TextureManager::create(size_t maxTextureCount, size_t threadCount)
@@ -118,11 +155,19 @@ namespace Falcor
         std::unique_lock<std::mutex> lock(mMutex);
         const TextureKey textureKey(fullPath, generateMipLevels, loadAsSRGB, bindFlags);
 
+        // Hash the file contents to find identical textures loaded from other paths.
+        std::optional<SHA1::MD> fileHash;
+
         if (auto it = mKeyToHandle.find(textureKey); it != mKeyToHandle.end())
         {
             // Texture is already managed. Return its handle.
             handle = it->second;
         }
+        else if (mDeduplicationEnabled && (fileHash = computeFileHash(fullPath, generateMipLevels, loadAsSRGB, bindFlags)) && (handle = findContentHash(*fileHash)))
+        {
+            // Texture with identical file contents is already managed. Alias it.
+            addAlias(textureKey, handle);
+        }
         else
         {
 #ifndef DISABLE_ASYNC_TEXTURE_LOADER
@@ -134,6 +179,7 @@ namespace Falcor
 
             // Add to key-to-handle map.
             mKeyToHandle[textureKey] = handle;
+            if (fileHash) mContentHashToHandle[*fileHash] = handle;
 
             // Function called by the async texture loader when loading finishes.
             // It's called by a worker thread so needs to acquire the mutex before changing any state.
@@ -157,17 +203,56 @@ namespace Falcor
             mAsyncTextureLoader.loadFromFile(fullPath, generateMipLevels, loadAsSRGB, bindFlags, callback);
 #else
             // Load texture from main thread.
-            Texture::SharedPtr pTexture = Texture::createFromFile(fullPath, generateMipLevels, loadAsSRGB, bindFlags);
+            // With deduplication enabled, decode the image ourselves and hash the pixels to catch files that only differ in their headers.
+            // The decoded bitmap is reused to create the texture. This is skipped when cooking as the cooker avoids decoding on cache hits.
+            Texture::SharedPtr pTexture;
+            std::optional<SHA1::MD> pixelHash;
+            bool decoded = false;
+            if (mDeduplicationEnabled && !mpTextureCooker && !hasExtension(fullPath, "dds"))
+            {
+                decoded = true;
+                if (Bitmap::UniqueConstPtr pBitmap = Texture::loadBitmapFromFile(fullPath))
+                {
+                    pixelHash = computePixelHash(*pBitmap, generateMipLevels, loadAsSRGB, bindFlags);
+                    handle = findContentHash(*pixelHash);
+                    if (!handle)
+                    {
+                        pTexture = Texture::createFromBitmap(*pBitmap, generateMipLevels, loadAsSRGB, bindFlags);
+                        if (pTexture) pTexture->setSourcePath(fullPath);
+                    }
+                }
+            }
 
-            // Add new texture desc.
-            TextureDesc desc = { TextureState::Loaded, pTexture };
-            handle = addDesc(desc);
+            if (handle)
+            {
+                // Texture with identical pixels is already managed. Alias it.
+                addAlias(textureKey, handle);
+                if (fileHash) mContentHashToHandle[*fileHash] = handle;
+            }
+            else
+            {
+                if (!decoded)
+                {
+                    pTexture = mpTextureCooker
+                        ? mpTextureCooker->loadTexture(fullPath, generateMipLevels, loadAsSRGB, bindFlags)
+                        : Texture::createFromFile(fullPath, generateMipLevels, loadAsSRGB, bindFlags);
+                }
 
-            // Add to key-to-handle map.
-            mKeyToHandle[textureKey] = handle;
+                // Add new texture desc.
+                TextureDesc desc = { TextureState::Loaded, pTexture };
+                handle = addDesc(desc);
 
-            // Add to texture-to-handle map.
-            if (pTexture) mTextureToHandle[pTexture.get()] = handle;
+                // Add to key-to-handle map.
+                mKeyToHandle[textureKey] = handle;
+
+                // Add to texture-to-handle and content hash maps. Failed loads are not deduplicated.
+                if (pTexture)
+                {
+                    mTextureToHandle[pTexture.get()] = handle;
+                    if (fileHash) mContentHashToHandle[*fileHash] = handle;
+                    if (pixelHash) mContentHashToHandle[*pixelHash] = handle;
+                }
+            }
 
             mCondition.notify_all();
 #endif
@@ -216,9 +301,18 @@ namespace Falcor
         if (!desc.isValid()) return;
 
         // Remove handle from maps.
-        // Note not all handles exist in key-to-handle map so search for it. This can be optimized if needed.
-        auto it = std::find_if(mKeyToHandle.begin(), mKeyToHandle.end(), [handle](const auto& keyVal) { return keyVal.second == handle; });
-        if (it != mKeyToHandle.end()) mKeyToHandle.erase(it);
+        // Note not all handles exist in key-to-handle map and deduplicated handles may have several keys, so search for them. This can be optimized if needed.
+        auto eraseHandle = [handle](auto& map)
+        {
+            for (auto it = map.begin(); it != map.end();)
+            {
+                if (it->second == handle) it = map.erase(it);
+                else ++it;
+            }
+        };
+        eraseHandle(mKeyToHandle);
+        eraseHandle(mContentHashToHandle);
+        mAliasCounts.erase(handle.id);
 
         if (desc.pTexture)
         {
@@ -248,6 +342,45 @@ namespace Falcor
         return mTextureDescs.size();
     }
 
+    void TextureManager::setTextureCooker(const TextureCooker::SharedPtr& pTextureCooker)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mpTextureCooker = pTextureCooker;
+        mAsyncTextureLoader.setTextureCooker(pTextureCooker);
+    }
+
+    TextureCooker::SharedPtr TextureManager::getTextureCooker() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mpTextureCooker;
+    }
+
+    void TextureManager::setDeduplicationEnabled(bool enabled)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mDeduplicationEnabled = enabled;
+    }
+
+    bool TextureManager::isDeduplicationEnabled() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mDeduplicationEnabled;
+    }
+
+    TextureManager::Stats TextureManager::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        Stats stats;
+        for (const auto& [id, count] : mAliasCounts)
+        {
+            stats.deduplicatedTextureCount += count;
+            FALCOR_ASSERT(id < mTextureDescs.size());
+            if (const auto& pTexture = mTextureDescs[id].pTexture) stats.deduplicatedMemoryInBytes += count * pTexture->getTextureSizeInBytes();
+        }
+        return stats;
+    }
+
     void TextureManager::setShaderData(const ShaderVar& var, const size_t descCount) const
     {
         std::lock_guard<std::mutex> lock(mMutex);
@@ -268,6 +401,19 @@ namespace Falcor
         }
     }
 
+    TextureManager::TextureHandle TextureManager::findContentHash(const SHA1::MD& hash) const
+    {
+        auto it = mContentHashToHandle.find(hash);
+        return it != mContentHashToHandle.end() ? it->second : TextureHandle{};
+    }
+
+    void TextureManager::addAlias(const TextureKey& textureKey, const TextureHandle& handle)
+    {
+        FALCOR_ASSERT(handle && mKeyToHandle.find(textureKey) == mKeyToHandle.end());
+        mKeyToHandle[textureKey] = handle;
+        mAliasCounts[handle.id]++;
+    }
+
     TextureManager::TextureHandle TextureManager::addDesc(const TextureDesc& desc)
     {
         TextureHandle handle;
@@ -27,10 +27,12 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "TextureCooker.h"
 #include "Core/Macros.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
 #include "Core/Program/ShaderVar.h"
+#include "Utils/CryptoUtils.h"
 #include <condition_variable>
 #include <limits>
 #include <map>
@@ -88,6 +90,14 @@ namespace Falcor
             bool isValid() const { return state != TextureState::Invalid; }
         };
 
+        /** Texture deduplication statistics.
+        */
+        struct Stats
+        {
+            size_t deduplicatedTextureCount = 0;        ///< Number of texture loads that were aliased to an identical, already managed texture.
+            uint64_t deduplicatedMemoryInBytes = 0;     ///< Texture memory saved by deduplication in bytes.
+        };
+
         /** Create a texture manager.
             \param[in] maxTextureCount Maximum number of textures that can be simultaneously managed.
             \param[in] threadCount Number of worker threads.
@@ -147,6 +157,37 @@ namespace Falcor
         */
         size_t getTextureDescCount() const;
 
+        /** Set the texture cooker used for loading textures from file.
+            When set, source images are converted to block-compressed DDS files with precomputed mips on first load
+            and the cooked files are loaded directly afterwards. This only affects textures loaded after the call.
+            \param[in] pTextureCooker Texture cooker, or nullptr to load textures from their source files.
+        */
+        void setTextureCooker(const TextureCooker::SharedPtr& pTextureCooker);
+
+        /** Get the texture cooker.
+            \return The texture cooker, or nullptr if textures are loaded from their source files.
+        */
+        TextureCooker::SharedPtr getTextureCooker() const;
+
+        /** Enable/disable content-based texture deduplication.
+            By default, textures are only shared if they are loaded from the same path. When deduplication is enabled,
+            textures loaded from different paths are aliased to a single handle if their file contents are identical.
+            If no texture cooker is set, the decoded pixels are hashed as well, which also catches image files that
+            only differ in their headers (e.g. metadata or timestamps). This only affects textures loaded after the call.
+            \param[in] enabled True to enable deduplication.
+        */
+        void setDeduplicationEnabled(bool enabled);
+
+        /** Check if content-based texture deduplication is enabled.
+            \return True if deduplication is enabled.
+        */
+        bool isDeduplicationEnabled() const;
+
+        /** Get texture deduplication statistics.
+            \return Statistics for the currently managed textures.
+        */
+        Stats getStats() const;
+
         /** Bind all textures into a shader var.
             The shader var should refer to a Texture2D descriptor array of fixed size.
             The array must be large enough, otherwise an exception is thrown.
@@ -181,6 +222,8 @@ namespace Falcor
             }
         };
 
+        TextureHandle findContentHash(const SHA1::MD& hash) const;
+        void addAlias(const TextureKey& textureKey, const TextureHandle& handle);
         TextureHandle addDesc(const TextureDesc& desc);
         TextureDesc& getDesc(const TextureHandle& handle);
 
@@ -192,8 +235,12 @@ namespace Falcor
         std::vector<TextureHandle> mFreeList;                       ///< List of unused handles.
         std::map<TextureKey, TextureHandle> mKeyToHandle;           ///< Map from texture key to handle.
         std::map<const Texture*, TextureHandle> mTextureToHandle;   ///< Map from texture ptr to handle.
+        std::map<SHA1::MD, TextureHandle> mContentHashToHandle;     ///< Map from content hash to handle. Only used when deduplication is enabled.
+        std::map<uint32_t, size_t> mAliasCounts;                    ///< Number of texture keys aliased to a handle by deduplication, indexed by handle ID.
 
         AsyncTextureLoader mAsyncTextureLoader;                     ///< Utility for asynchronous texture loading.
+        TextureCooker::SharedPtr mpTextureCooker;                   ///< Texture cooker, or nullptr if textures are loaded from their source files.
+        bool mDeduplicationEnabled = false;                         ///< True if textures with identical content are aliased to a single handle.
         size_t mLoadRequestsInProgress = 0;                         ///< Number of load requests currently in progress.
 
         const size_t mMaxTextureCount;                              ///< Maximum number of textures that can be simultaneously managed.
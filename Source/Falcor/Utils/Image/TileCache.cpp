@@ -0,0 +1,281 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TileCache.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include <algorithm>
+
+namespace Falcor
+{
+    TileCache::SharedPtr TileCache::create(uint64_t memoryBudget, size_t threadCount)
+    {
+        return SharedPtr(new TileCache(memoryBudget, threadCount));
+    }
+
+    TileCache::TileCache(uint64_t memoryBudget, size_t threadCount)
+        : mMemoryBudget(memoryBudget)
+    {
+        checkArgument(threadCount > 0, "'threadCount' must be greater than zero.");
+
+        // Tile reads block on disk I/O, so they run on dedicated threads rather than the shared thread pool.
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            mThreads.emplace_back(&TileCache::runWorker, this);
+        }
+    }
+
+    TileCache::~TileCache()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+            mRequestQueue.clear();
+        }
+
+        mWorkCondition.notify_all();
+
+        for (auto& thread : mThreads) thread.join();
+    }
+
+    TileCache::TextureID TileCache::addTexture(const TiledTexture::SharedPtr& pTexture)
+    {
+        checkArgument(pTexture != nullptr, "'pTexture' is missing");
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mTextures.size() >= kMaxTextureCount)
+        {
+            throw RuntimeError("Out of tile cache texture IDs");
+        }
+        mTextures.push_back(pTexture);
+        return TextureID(mTextures.size() - 1);
+    }
+
+    void TileCache::removeTexture(TextureID textureID)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (textureID >= mTextures.size() || !mTextures[textureID]) return;
+
+        mTextures[textureID] = nullptr;
+
+        // Drop queued requests. Tiles currently being read are discarded by the worker.
+        auto isTextureTile = [textureID](const TileKey& key) { return key.getTextureID() == textureID; };
+        for (const auto& key : mRequestQueue)
+        {
+            if (isTextureTile(key)) mPendingTiles.erase(key.value);
+        }
+        mRequestQueue.erase(std::remove_if(mRequestQueue.begin(), mRequestQueue.end(), isTextureTile), mRequestQueue.end());
+
+        for (auto it = mResidentTiles.begin(); it != mResidentTiles.end();)
+        {
+            auto next = std::next(it);
+            if (isTextureTile(TileKey(it->first))) evictTile(it);
+            it = next;
+        }
+
+        mIdleCondition.notify_all();
+    }
+
+    TiledTexture::SharedPtr TileCache::getTexture(TextureID textureID) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return textureID < mTextures.size() ? mTextures[textureID] : nullptr;
+    }
+
+    void TileCache::processFeedback(const TileKey* pKeys, size_t count)
+    {
+        std::vector<TileKey> requests;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < count; i++)
+        {
+            const TileKey& key = pKeys[i];
+            if (!isValidKey(key)) continue;
+
+            if (auto it = mResidentTiles.find(key.value); it != mResidentTiles.end())
+            {
+                // Move to the front of the LRU list.
+                mLRU.splice(mLRU.begin(), mLRU, it->second.lruIt);
+                mStats.hitCount++;
+            }
+            else
+            {
+                mStats.missCount++;
+                if (mPendingTiles.insert(key.value).second) requests.push_back(key);
+            }
+        }
+
+        // Load coarser mip levels first, so a lower resolution fallback becomes available as early as possible.
+        std::stable_sort(requests.begin(), requests.end(), [](const TileKey& a, const TileKey& b) { return a.getTile().mip > b.getTile().mip; });
+        mRequestQueue.insert(mRequestQueue.end(), requests.begin(), requests.end());
+
+        if (!requests.empty()) mWorkCondition.notify_all();
+    }
+
+    TileCache::TileData TileCache::getTile(const TileKey& key)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mResidentTiles.find(key.value);
+        if (it == mResidentTiles.end()) return nullptr;
+        mLRU.splice(mLRU.begin(), mLRU, it->second.lruIt);
+        return it->second.pData;
+    }
+
+    bool TileCache::isResident(const TileKey& key) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mResidentTiles.find(key.value) != mResidentTiles.end();
+    }
+
+    TileCache::Update TileCache::fetchUpdates()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Compare the current residency with the residency at the last fetch. Tiles that were loaded and evicted in between
+        // (or vice versa) are back in their previous state and not reported.
+        Update update;
+        for (const auto& [value, wasResident] : mChangedTiles)
+        {
+            bool isResident = mResidentTiles.find(value) != mResidentTiles.end();
+            if (isResident == wasResident) continue;
+            if (isResident) update.loaded.emplace_back(value);
+            else update.evicted.emplace_back(value);
+        }
+        mChangedTiles.clear();
+
+        std::sort(update.loaded.begin(), update.loaded.end());
+        std::sort(update.evicted.begin(), update.evicted.end());
+        return update;
+    }
+
+    void TileCache::waitForPendingTiles()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mIdleCondition.wait(lock, [&]() { return mPendingTiles.empty(); });
+    }
+
+    uint64_t TileCache::getMemoryBudget() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mMemoryBudget;
+    }
+
+    void TileCache::setMemoryBudget(uint64_t memoryBudget)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mMemoryBudget = memoryBudget;
+        evictToBudget(mMemoryBudget);
+    }
+
+    uint64_t TileCache::getResidentMemory() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mResidentTiles.size() * uint64_t(TiledTexture::kTileSizeInBytes);
+    }
+
+    TileCache::Stats TileCache::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Stats stats = mStats;
+        stats.residentTileCount = mResidentTiles.size();
+        stats.pendingTileCount = mPendingTiles.size();
+        return stats;
+    }
+
+    void TileCache::resetStats()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStats = {};
+    }
+
+    void TileCache::runWorker()
+    {
+        while (true)
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWorkCondition.wait(lock, [&]() { return mTerminate || !mRequestQueue.empty(); });
+            if (mTerminate) break;
+
+            TileKey key = mRequestQueue.front();
+            mRequestQueue.pop_front();
+            TiledTexture::SharedPtr pTexture = mTextures[key.getTextureID()];
+            FALCOR_ASSERT(pTexture);
+
+            lock.unlock();
+
+            // Read the tile (this part is running in parallel).
+            auto pData = std::make_shared<std::vector<uint8_t>>(TiledTexture::kTileSizeInBytes);
+            pTexture->readTile(key.getTile(), pData->data());
+
+            lock.lock();
+
+            // Discard the tile if its texture has been removed in the meantime.
+            if (mPendingTiles.erase(key.value) > 0 && mTextures[key.getTextureID()] == pTexture)
+            {
+                mStats.loadCount++;
+                insertTile(key, std::move(pData));
+            }
+
+            if (mPendingTiles.empty()) mIdleCondition.notify_all();
+        }
+    }
+
+    void TileCache::insertTile(const TileKey& key, TileData pData)
+    {
+        FALCOR_ASSERT(mResidentTiles.find(key.value) == mResidentTiles.end());
+
+        // Make room for the new tile. If the budget can't hold a single tile, the tile is dropped.
+        evictToBudget(mMemoryBudget >= TiledTexture::kTileSizeInBytes ? mMemoryBudget - TiledTexture::kTileSizeInBytes : 0);
+        if (mMemoryBudget < TiledTexture::kTileSizeInBytes) return;
+
+        mLRU.push_front(key);
+        mResidentTiles[key.value] = ResidentTile{ std::move(pData), mLRU.begin() };
+        mChangedTiles.emplace(key.value, false);
+    }
+
+    void TileCache::evictTile(std::unordered_map<uint64_t, ResidentTile>::iterator it)
+    {
+        mLRU.erase(it->second.lruIt);
+        mChangedTiles.emplace(it->first, true);
+        mResidentTiles.erase(it);
+        mStats.evictionCount++;
+    }
+
+    void TileCache::evictToBudget(uint64_t budget)
+    {
+        while (!mLRU.empty() && mResidentTiles.size() * uint64_t(TiledTexture::kTileSizeInBytes) > budget)
+        {
+            evictTile(mResidentTiles.find(mLRU.back().value));
+        }
+    }
+
+    bool TileCache::isValidKey(const TileKey& key) const
+    {
+        TextureID textureID = key.getTextureID();
+        return textureID < mTextures.size() && mTextures[textureID] && mTextures[textureID]->isValidTile(key.getTile());
+    }
+}
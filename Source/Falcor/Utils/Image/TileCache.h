@@ -0,0 +1,207 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "TiledTexture.h"
+#include "Core/Macros.h"
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU-side tile cache for texture streaming.
+
+        Keeps tiles of tiled textures (see TiledTexture) resident in CPU memory within a global
+        memory budget. Tiles are requested through a stream of tile keys, typically read back
+        from a tile usage feedback buffer written by the renderer. Requested tiles that are not
+        resident are queued and read from disk asynchronously by dedicated I/O worker threads.
+        When the budget is exceeded, the least recently used tiles are evicted.
+
+        The cache only manages CPU memory. Clients call fetchUpdates() to get the residency
+        changes since the last call and mirror them in GPU memory.
+
+        All operations are thread-safe.
+    */
+    class FALCOR_API TileCache
+    {
+    public:
+        using SharedPtr = std::shared_ptr<TileCache>;
+        using TextureID = uint32_t;
+        using TileData = std::shared_ptr<const std::vector<uint8_t>>;
+
+        static constexpr TextureID kMaxTextureCount = 1u << 24;
+
+        /** Packed key identifying a tile of a texture managed by the cache.
+            Bits 0-15 hold the tile x coordinate, bits 16-31 the tile y coordinate,
+            bits 32-39 the mip level and bits 40-63 the texture ID.
+        */
+        struct TileKey
+        {
+            uint64_t value = 0;
+
+            TileKey() = default;
+            explicit TileKey(uint64_t value) : value(value) {}
+            TileKey(TextureID textureID, const TiledTexture::TileID& tile)
+                : value((uint64_t(textureID) << 40) | (uint64_t(tile.mip & 0xff) << 32) | (uint64_t(tile.y & 0xffff) << 16) | uint64_t(tile.x & 0xffff))
+            {}
+
+            TextureID getTextureID() const { return TextureID(value >> 40); }
+            TiledTexture::TileID getTile() const { return { uint32_t(value >> 32) & 0xff, uint32_t(value) & 0xffff, uint32_t(value >> 16) & 0xffff }; }
+
+            bool operator==(const TileKey& other) const { return value == other.value; }
+            bool operator!=(const TileKey& other) const { return value != other.value; }
+            bool operator<(const TileKey& other) const { return value < other.value; }
+        };
+
+        /** Residency changes since the last call to fetchUpdates().
+        */
+        struct Update
+        {
+            std::vector<TileKey> loaded;    ///< Tiles that have become resident.
+            std::vector<TileKey> evicted;   ///< Tiles that have been evicted.
+        };
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;          ///< Number of feedback entries referring to resident tiles.
+            uint64_t missCount = 0;         ///< Number of feedback entries referring to non-resident tiles.
+            uint64_t loadCount = 0;         ///< Number of tiles read from disk.
+            uint64_t evictionCount = 0;     ///< Number of tiles evicted.
+            uint64_t residentTileCount = 0; ///< Number of tiles currently resident.
+            uint64_t pendingTileCount = 0;  ///< Number of tiles currently queued or being read.
+        };
+
+        /** Create a tile cache.
+            \param[in] memoryBudget Maximum amount of memory used for resident tiles in bytes.
+            \param[in] threadCount Number of I/O worker threads.
+            \return New object.
+        */
+        static SharedPtr create(uint64_t memoryBudget, size_t threadCount = 2);
+
+        ~TileCache();
+
+        /** Add a texture to the cache.
+            \param[in] pTexture Tiled texture.
+            \return ID of the texture, used in tile keys.
+        */
+        TextureID addTexture(const TiledTexture::SharedPtr& pTexture);
+
+        /** Remove a texture. All of its tiles are evicted and pending requests are dropped.
+            \param[in] textureID Texture ID.
+        */
+        void removeTexture(TextureID textureID);
+
+        /** Get a texture.
+            \param[in] textureID Texture ID.
+            \return The texture, or nullptr if the ID is invalid.
+        */
+        TiledTexture::SharedPtr getTexture(TextureID textureID) const;
+
+        /** Process tile usage feedback.
+            Resident tiles are marked as used. Non-resident tiles are queued for loading, coarser mip levels first.
+            Keys referring to unknown textures or tiles are ignored.
+            \param[in] pKeys Tile keys.
+            \param[in] count Number of keys.
+        */
+        void processFeedback(const TileKey* pKeys, size_t count);
+        void processFeedback(const std::vector<TileKey>& keys) { processFeedback(keys.data(), keys.size()); }
+
+        /** Get the data of a resident tile and mark it as used.
+            The returned data stays valid even if the tile is evicted later.
+            \param[in] key Tile key.
+            \return Tile data of TiledTexture::kTileSizeInBytes bytes, or nullptr if the tile is not resident.
+        */
+        TileData getTile(const TileKey& key);
+
+        /** Check if a tile is resident without marking it as used.
+        */
+        bool isResident(const TileKey& key) const;
+
+        /** Get the residency changes since the last call.
+            Only tiles whose residency differs from the last call are reported, i.e., a tile that was loaded and evicted again
+            in between (or evicted and loaded again) is not reported.
+        */
+        Update fetchUpdates();
+
+        /** Block until all queued tiles are loaded.
+        */
+        void waitForPendingTiles();
+
+        uint64_t getMemoryBudget() const;
+
+        /** Set the memory budget. Tiles are evicted immediately if the new budget is exceeded.
+        */
+        void setMemoryBudget(uint64_t memoryBudget);
+
+        /** Get the amount of memory used by resident tiles in bytes.
+        */
+        uint64_t getResidentMemory() const;
+
+        Stats getStats() const;
+        void resetStats();
+
+    private:
+        TileCache(uint64_t memoryBudget, size_t threadCount);
+
+        struct ResidentTile
+        {
+            TileData pData;
+            std::list<TileKey>::iterator lruIt;
+        };
+
+        void runWorker();
+        void insertTile(const TileKey& key, TileData pData);
+        void evictTile(std::unordered_map<uint64_t, ResidentTile>::iterator it);
+        void evictToBudget(uint64_t budget);
+        bool isValidKey(const TileKey& key) const;
+
+        mutable std::mutex mMutex;                              ///< Mutex for synchronizing access to shared resources.
+        std::condition_variable mWorkCondition;                 ///< Condition variable for workers to wait on.
+        std::condition_variable mIdleCondition;                 ///< Condition variable to wait on for pending tiles to load.
+        std::vector<std::thread> mThreads;                      ///< I/O worker threads.
+
+        // Internal state. Do not access outside of critical section.
+        std::vector<TiledTexture::SharedPtr> mTextures;         ///< Textures indexed by ID, nullptr for removed textures.
+        std::unordered_map<uint64_t, ResidentTile> mResidentTiles; ///< Resident tiles.
+        std::list<TileKey> mLRU;                                ///< Resident tiles ordered from most to least recently used.
+        std::deque<TileKey> mRequestQueue;                      ///< Tiles waiting to be loaded.
+        std::unordered_set<uint64_t> mPendingTiles;             ///< Tiles queued or being read.
+        std::unordered_map<uint64_t, bool> mChangedTiles;       ///< Tiles whose residency changed since the last fetchUpdates(), mapped to their residency at that time.
+        uint64_t mMemoryBudget = 0;
+        bool mTerminate = false;
+
+        Stats mStats;
+    };
+}
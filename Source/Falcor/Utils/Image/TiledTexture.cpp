@@ -0,0 +1,299 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TiledTexture.h"
+#include "Bitmap.h"
+#include "ImageIO.h"
+#include "TextureCooker.h"
+#include "Core/Assert.h"
+#include "Core/Errors.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/Math/Common.h"
+
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current file version.
+            This needs to be incremented every time the file format changes!
+        */
+        const uint32_t kVersion = 1;
+
+        const char* kMagic = "FalcorT$";
+
+        /** Tile data starts at a page aligned offset so that tile reads are page aligned.
+        */
+        const uint64_t kDataAlignment = 4096;
+
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t format{};
+            uint32_t width{};
+            uint32_t height{};
+            uint32_t mipCount{};
+            uint32_t tileSize{};
+            uint64_t dataOffset{};
+        };
+
+        static_assert(sizeof(Header) == 40);
+
+        uint32_t getMaxMipCount(uint32_t width, uint32_t height)
+        {
+            return bitScanReverse(width | height) + 1;
+        }
+
+        /** Compute the index of the first tile of each mip level, with the total tile count appended.
+        */
+        std::vector<uint32_t> computeMipTileOffsets(uint32_t width, uint32_t height, uint32_t mipCount, uint2 tileExtent)
+        {
+            std::vector<uint32_t> offsets(mipCount + 1, 0);
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+            {
+                uint32_t tilesX = div_round_up(std::max(1u, width >> mip), tileExtent.x);
+                uint32_t tilesY = div_round_up(std::max(1u, height >> mip), tileExtent.y);
+                offsets[mip + 1] = offsets[mip] + tilesX * tilesY;
+            }
+            return offsets;
+        }
+    }
+
+    TiledTexture::SharedPtr TiledTexture::open(const std::filesystem::path& path)
+    {
+        std::filesystem::path fullPath;
+        if (!findFileInDataDirectories(path, fullPath))
+        {
+            throw RuntimeError("Failed to open tiled texture '{}': Can't find file.", path);
+        }
+        return SharedPtr(new TiledTexture(fullPath));
+    }
+
+    TiledTexture::TiledTexture(const std::filesystem::path& path)
+        : mPath(path)
+    {
+        if (!mFile.open(path, MemoryMappedFile::AccessHint::RandomAccess))
+        {
+            throw RuntimeError("Failed to open tiled texture '{}'.", path);
+        }
+
+        if (mFile.getSize() < sizeof(Header))
+        {
+            throw RuntimeError("Failed to open tiled texture '{}': File is too small.", path);
+        }
+
+        Header header;
+        std::memcpy(&header, mFile.getData(), sizeof(Header));
+        if (std::memcmp(header.magic, kMagic, sizeof(Header::magic)) != 0 || header.version != kVersion)
+        {
+            throw RuntimeError("Failed to open tiled texture '{}': Invalid header.", path);
+        }
+
+        mFormat = ResourceFormat(header.format);
+        mWidth = header.width;
+        mHeight = header.height;
+        mMipCount = header.mipCount;
+        mDataOffset = header.dataOffset;
+
+        if (header.format >= (uint32_t)ResourceFormat::Count || !isFormatSupported(mFormat) || header.tileSize != kTileSizeInBytes ||
+            mWidth == 0 || mHeight == 0 || mMipCount == 0 || mMipCount > getMaxMipCount(mWidth, mHeight))
+        {
+            throw RuntimeError("Failed to open tiled texture '{}': Invalid header.", path);
+        }
+
+        mTileExtent = getTileExtent(mFormat);
+        mMipTileOffsets = computeMipTileOffsets(mWidth, mHeight, mMipCount, mTileExtent);
+
+        if (mDataOffset + uint64_t(getTotalTileCount()) * kTileSizeInBytes > mFile.getSize())
+        {
+            throw RuntimeError("Failed to open tiled texture '{}': File is truncated.", path);
+        }
+    }
+
+    void TiledTexture::write(const std::filesystem::path& path, ResourceFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& mips)
+    {
+        checkArgument(isFormatSupported(format), "Format {} is not supported in tiled textures.", to_string(format));
+        checkArgument(width > 0 && height > 0, "Invalid texture size {}x{}.", width, height);
+        checkArgument(!mips.empty() && mips.size() <= getMaxMipCount(width, height), "Invalid mip count {}.", mips.size());
+
+        const uint32_t mipCount = (uint32_t)mips.size();
+        const uint2 tileExtent = getTileExtent(format);
+        const uint32_t blockWidth = getFormatWidthCompressionRatio(format);
+        const uint32_t blockHeight = getFormatHeightCompressionRatio(format);
+        const uint32_t bytesPerBlock = getFormatBytesPerBlock(format);
+        const uint32_t tileRowPitch = tileExtent.x / blockWidth * bytesPerBlock;
+        const uint32_t tileBlockRows = tileExtent.y / blockHeight;
+        FALCOR_ASSERT(tileRowPitch * tileBlockRows == kTileSizeInBytes);
+
+        std::ofstream fs(path, std::ios_base::binary);
+        if (!fs.good())
+        {
+            throw RuntimeError("Failed to write tiled texture '{}'.", path);
+        }
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+        header.version = kVersion;
+        header.format = (uint32_t)format;
+        header.width = width;
+        header.height = height;
+        header.mipCount = mipCount;
+        header.tileSize = kTileSizeInBytes;
+        header.dataOffset = align_to(kDataAlignment, uint64_t(sizeof(Header)));
+
+        std::vector<uint8_t> tile(kTileSizeInBytes, 0);
+        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        fs.write(reinterpret_cast<const char*>(tile.data()), header.dataOffset - sizeof(header));
+
+        for (uint32_t mip = 0; mip < mipCount; mip++)
+        {
+            const uint32_t mipBlocksX = div_round_up(std::max(1u, width >> mip), blockWidth);
+            const uint32_t mipBlocksY = div_round_up(std::max(1u, height >> mip), blockHeight);
+            const size_t mipRowPitch = size_t(mipBlocksX) * bytesPerBlock;
+            checkArgument(mips[mip].size() == mipRowPitch * mipBlocksY, "Mip level {} has size {}, expected {}.", mip, mips[mip].size(), mipRowPitch * mipBlocksY);
+
+            const uint32_t tilesX = div_round_up(mipBlocksX * blockWidth, tileExtent.x);
+            const uint32_t tilesY = div_round_up(mipBlocksY * blockHeight, tileExtent.y);
+            for (uint32_t tileY = 0; tileY < tilesY; tileY++)
+            {
+                for (uint32_t tileX = 0; tileX < tilesX; tileX++)
+                {
+                    // Copy the rows of blocks covered by the tile, the remainder of edge tiles stays zero.
+                    std::fill(tile.begin(), tile.end(), uint8_t(0));
+                    const uint32_t firstBlockX = tileX * (tileRowPitch / bytesPerBlock);
+                    const uint32_t firstBlockY = tileY * tileBlockRows;
+                    const uint32_t rowBlocks = std::min(tileRowPitch / bytesPerBlock, mipBlocksX - firstBlockX);
+                    const uint32_t rows = std::min(tileBlockRows, mipBlocksY - firstBlockY);
+                    for (uint32_t row = 0; row < rows; row++)
+                    {
+                        const uint8_t* pSrc = mips[mip].data() + (firstBlockY + row) * mipRowPitch + size_t(firstBlockX) * bytesPerBlock;
+                        std::memcpy(tile.data() + size_t(row) * tileRowPitch, pSrc, size_t(rowBlocks) * bytesPerBlock);
+                    }
+                    fs.write(reinterpret_cast<const char*>(tile.data()), tile.size());
+                }
+            }
+        }
+
+        if (!fs.good())
+        {
+            throw RuntimeError("Failed to write tiled texture '{}'.", path);
+        }
+    }
+
+    void TiledTexture::convert(const std::filesystem::path& srcPath, const std::filesystem::path& dstPath, bool compress, bool isSrgb)
+    {
+        if (hasExtension(srcPath, "dds"))
+        {
+            auto mipChain = ImageIO::loadMipChainFromDDS(srcPath);
+            write(dstPath, mipChain.format, mipChain.width, mipChain.height, mipChain.mips);
+            return;
+        }
+
+        Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(srcPath, true);
+        if (!pBitmap)
+        {
+            throw RuntimeError("Failed to load image '{}'.", srcPath);
+        }
+
+        auto mode = ImageIO::CompressionMode::None;
+        if (compress)
+        {
+            auto compressionMode = TextureCooker::chooseCompressionMode(*pBitmap, isSrgb);
+            if (!compressionMode)
+            {
+                throw RuntimeError("Image '{}' with format {} and size {}x{} can't be block compressed.", srcPath, to_string(pBitmap->getFormat()), pBitmap->getWidth(), pBitmap->getHeight());
+            }
+            mode = *compressionMode;
+        }
+
+        // Use ImageIO to generate the mip chain (and compress) through an intermediate DDS file.
+        auto tempPath = dstPath;
+        tempPath += ".tmp.dds";
+        std::error_code ec;
+        try
+        {
+            ImageIO::saveToDDS(tempPath, *pBitmap, mode, true);
+            auto mipChain = ImageIO::loadMipChainFromDDS(tempPath);
+            write(dstPath, mipChain.format, mipChain.width, mipChain.height, mipChain.mips);
+        }
+        catch (const std::exception&)
+        {
+            std::filesystem::remove(tempPath, ec);
+            throw;
+        }
+        std::filesystem::remove(tempPath, ec);
+    }
+
+    bool TiledTexture::isFormatSupported(ResourceFormat format)
+    {
+        if (format == ResourceFormat::Unknown || isDepthStencilFormat(format)) return false;
+        uint32_t bytesPerBlock = getFormatBytesPerBlock(format);
+        return bytesPerBlock > 0 && bytesPerBlock <= 16 && isPowerOf2(bytesPerBlock);
+    }
+
+    uint2 TiledTexture::getTileExtent(ResourceFormat format)
+    {
+        checkArgument(isFormatSupported(format), "Format {} is not supported in tiled textures.", to_string(format));
+
+        // Tiles are square or twice as wide as high in blocks, matching the D3D standard tile shapes.
+        const uint32_t blockCount = kTileSizeInBytes / getFormatBytesPerBlock(format);
+        const uint32_t blocksX = 1u << ((bitScanReverse(blockCount) + 1) / 2);
+        const uint32_t blocksY = blockCount / blocksX;
+        return uint2(blocksX * getFormatWidthCompressionRatio(format), blocksY * getFormatHeightCompressionRatio(format));
+    }
+
+    uint2 TiledTexture::getTileCount(uint32_t mip) const
+    {
+        FALCOR_ASSERT(mip < mMipCount);
+        return uint2(div_round_up(getWidth(mip), mTileExtent.x), div_round_up(getHeight(mip), mTileExtent.y));
+    }
+
+    bool TiledTexture::isValidTile(const TileID& tile) const
+    {
+        if (tile.mip >= mMipCount) return false;
+        uint2 tileCount = getTileCount(tile.mip);
+        return tile.x < tileCount.x && tile.y < tileCount.y;
+    }
+
+    uint32_t TiledTexture::getTileIndex(const TileID& tile) const
+    {
+        FALCOR_ASSERT(isValidTile(tile));
+        return mMipTileOffsets[tile.mip] + tile.y * getTileCount(tile.mip).x + tile.x;
+    }
+
+    void TiledTexture::readTile(const TileID& tile, void* pDst) const
+    {
+        FALCOR_ASSERT(isValidTile(tile));
+        const uint8_t* pSrc = static_cast<const uint8_t*>(mFile.getData()) + mDataOffset + uint64_t(getTileIndex(tile)) * kTileSizeInBytes;
+        std::memcpy(pDst, pSrc, kTileSizeInBytes);
+    }
+}
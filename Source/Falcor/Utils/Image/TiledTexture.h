@@ -0,0 +1,155 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    /** Tiled, mip-mapped texture container used for texture streaming.
+
+        Each mip level is split into fixed size tiles of 64KB that can be loaded individually.
+        The tile dimensions follow the D3D standard tile shapes, e.g. 128x128 texels for 32-bit
+        formats or 256x256 texels for BC7. Tiles store rows of blocks in linear order. Tiles
+        on the right and bottom edge of a mip level, and mip levels smaller than a tile, are
+        padded with zeros so that every tile has the same size and can be read with a single
+        aligned read.
+
+        Block-compressed formats are supported, the converter optionally compresses the source
+        image. Formats with a block size that is not a power of two are not supported.
+
+        Files are memory mapped. Reading tiles is thread-safe.
+    */
+    class FALCOR_API TiledTexture
+    {
+    public:
+        using SharedPtr = std::shared_ptr<TiledTexture>;
+
+        static constexpr uint32_t kTileSizeInBytes = 64 * 1024;
+
+        /** Identifies a tile within a texture.
+        */
+        struct TileID
+        {
+            uint32_t mip = 0;
+            uint32_t x = 0;
+            uint32_t y = 0;
+
+            bool operator==(const TileID& other) const { return mip == other.mip && x == other.x && y == other.y; }
+            bool operator!=(const TileID& other) const { return !(*this == other); }
+        };
+
+        /** Open a tiled texture file.
+            Throws an exception if the file can't be opened or is malformed.
+            \param[in] path File path. This can be a full path or a relative path from a data directory.
+            \return New object.
+        */
+        static SharedPtr open(const std::filesystem::path& path);
+
+        /** Write a tiled texture file.
+            Throws an exception if the format is not supported or the file can't be written.
+            \param[in] path File path.
+            \param[in] format Texture format.
+            \param[in] width Width of the base mip level in texels.
+            \param[in] height Height of the base mip level in texels.
+            \param[in] mips Data for each mip level, stored as tightly packed rows of blocks.
+        */
+        static void write(const std::filesystem::path& path, ResourceFormat format, uint32_t width, uint32_t height, const std::vector<std::vector<uint8_t>>& mips);
+
+        /** Convert an image to a tiled texture file with a full mip chain.
+            DDS files are tiled as-is using the mips stored in the file. Other images are loaded using Bitmap and mips are generated.
+            Throws an exception if the conversion fails.
+            \param[in] srcPath Source image path.
+            \param[in] dstPath Destination path.
+            \param[in] compress Block compress the image. The compression mode is chosen as in TextureCooker.
+            \param[in] isSrgb True if the image holds sRGB color data. This is only used to choose the compression mode.
+        */
+        static void convert(const std::filesystem::path& srcPath, const std::filesystem::path& dstPath, bool compress, bool isSrgb);
+
+        /** Check if a format can be stored in a tiled texture.
+        */
+        static bool isFormatSupported(ResourceFormat format);
+
+        /** Get the tile dimensions in texels for a format.
+        */
+        static uint2 getTileExtent(ResourceFormat format);
+
+        ResourceFormat getFormat() const { return mFormat; }
+        uint32_t getWidth(uint32_t mip = 0) const { return std::max(1u, mWidth >> mip); }
+        uint32_t getHeight(uint32_t mip = 0) const { return std::max(1u, mHeight >> mip); }
+        uint32_t getMipCount() const { return mMipCount; }
+
+        /** Get the tile dimensions in texels.
+        */
+        uint2 getTileExtent() const { return mTileExtent; }
+
+        /** Get the number of tiles in each dimension of a mip level.
+        */
+        uint2 getTileCount(uint32_t mip) const;
+
+        /** Get the total number of tiles in all mip levels.
+        */
+        uint32_t getTotalTileCount() const { return mMipTileOffsets.back(); }
+
+        /** Check if a tile ID refers to a tile in this texture.
+        */
+        bool isValidTile(const TileID& tile) const;
+
+        /** Get the linear index of a tile, in range [0, getTotalTileCount()).
+        */
+        uint32_t getTileIndex(const TileID& tile) const;
+
+        /** Read a tile.
+            \param[in] tile Tile to read. Must be a valid tile.
+            \param[out] pDst Destination buffer of kTileSizeInBytes bytes.
+        */
+        void readTile(const TileID& tile, void* pDst) const;
+
+        const std::filesystem::path& getPath() const { return mPath; }
+
+    private:
+        TiledTexture(const std::filesystem::path& path);
+
+        std::filesystem::path mPath;
+        MemoryMappedFile mFile;
+        ResourceFormat mFormat = ResourceFormat::Unknown;
+        uint32_t mWidth = 0;
+        uint32_t mHeight = 0;
+        uint32_t mMipCount = 0;
+        uint2 mTileExtent;
+        std::vector<uint32_t> mMipTileOffsets;  ///< Index of the first tile of each mip level, with the total tile count appended.
+        uint64_t mDataOffset = 0;               ///< Offset of the first tile in the file.
+    };
+}
@@ -28,7 +28,17 @@
 #include "Logger.h"
 #include "Core/Assert.h"
 #include "Core/Platform/OS.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 
 namespace Falcor
 {
@@ -39,6 +49,7 @@ namespace Falcor
         std::filesystem::path sLogFilePath;
 
 #if FALCOR_ENABLE_LOGGER
+        std::mutex sOutputMutex; ///< Guards the outputs and the log file.
         bool sInitialized = false;
         FILE* sLogFile = nullptr;
 
@@ -80,25 +91,13 @@ namespace Falcor
 
             if (sLogFile)
             {
-                std::fprintf(sLogFile, "%s", s.c_str());
+                std::fwrite(s.data(), 1, s.size(), sLogFile);
                 std::fflush(sLogFile);
             }
         }
 #endif
     }
 
-    void Logger::shutdown()
-    {
-#if FALCOR_ENABLE_LOGGER
-        if(sLogFile)
-        {
-            fclose(sLogFile);
-            sLogFile = nullptr;
-            sInitialized = false;
-        }
-#endif
-    }
-
     const char* getLogLevelString(Logger::Level level)
     {
         switch (level)
@@ -119,38 +118,482 @@ namespace Falcor
         }
     }
 
-    void Logger::log(Level level, const std::string_view msg)
-    {
 #if FALCOR_ENABLE_LOGGER
-        if (level <= sVerbosity)
+    namespace
+    {
+        constexpr size_t kQueueCapacity = 1024;                         ///< Number of messages per thread queue.
+        constexpr size_t kQueueByteCapacity = 1 << 20;                  ///< Number of message bytes per thread queue. A single larger message is accepted by an empty queue.
+        constexpr size_t kMaxTrackedMessages = 4096;                    ///< Max number of distinct messages tracked for rate limiting.
+        constexpr auto kWriterInterval = std::chrono::milliseconds(10); ///< Interval at which the writer thread polls the queues.
+
+        /** Formatted output of one or more messages, written to all outputs at once.
+        */
+        struct OutputBatch
         {
-            std::string s = fmt::format("{} {}\n", getLogLevelString(level), msg);
+            std::string console;
+            std::string consoleError;
+            std::string text;
 
-            // Write to console.
-            if (is_set(sOutputs, OutputFlags::Console))
+            void append(Logger::Level level, const std::string_view msg)
             {
-                if (level > Logger::Level::Error) std::cout << s;
-                else std::cerr << s;
+                std::string s = fmt::format("{} {}\n", getLogLevelString(level), msg);
+                if (level > Logger::Level::Error) console += s;
+                else consoleError += s;
+                text += s;
+            }
+
+            bool empty() const { return text.empty(); }
+
+            /** Write to the outputs. Must be called with sOutputMutex held.
+            */
+            void write() const
+            {
+                // Write to console.
+                if (is_set(sOutputs, Logger::OutputFlags::Console))
+                {
+                    if (!console.empty()) std::cout << console;
+                    if (!consoleError.empty()) std::cerr << consoleError;
+                }
+
+                // Write to file.
+                if (is_set(sOutputs, Logger::OutputFlags::File))
+                {
+                    printToLogFile(text);
+                }
+
+                // Write to debug window if debugger is attached.
+                if (is_set(sOutputs, Logger::OutputFlags::DebugWindow) && isDebuggerPresent())
+                {
+                    printToDebugWindow(text);
+                }
             }
+        };
 
-            // Write to file.
-            if (is_set(sOutputs, OutputFlags::File))
+        struct Message
+        {
+            Logger::Level level = Logger::Level::Info;
+            uint64_t sequence = 0;
+            std::string text;
+        };
+
+        /** Fixed size single-producer single-consumer lock-free ring buffer of messages.
+            The producer is the owning thread, the consumer is the writer thread.
+            The queue is bounded both by the number of messages and by the total size of the message text.
+        */
+        class MessageQueue
+        {
+        public:
+            /** Push a message. The message is only moved from if the push succeeded.
+                \return Returns false if the queue is full.
+            */
+            bool tryPush(Message& message)
             {
-                printToLogFile(s);
+                size_t head = mHead.load(std::memory_order_relaxed);
+                size_t count = head - mTail.load(std::memory_order_acquire);
+                size_t size = message.text.size();
+                if (count == kQueueCapacity) return false;
+                if (count > 0 && mBytes.load(std::memory_order_acquire) + size > kQueueByteCapacity) return false;
+                mSlots[head % kQueueCapacity] = std::move(message);
+                mBytes.fetch_add(size, std::memory_order_relaxed);
+                mHead.store(head + 1, std::memory_order_release);
+                return true;
             }
 
-            // Write to debug window if debugger is attached.
-            if (is_set(sOutputs, OutputFlags::DebugWindow) && isDebuggerPresent())
+            /** Pop all queued messages.
+            */
+            template<typename F>
+            void consume(F func)
             {
-                printToDebugWindow(s);
+                size_t tail = mTail.load(std::memory_order_relaxed);
+                size_t head = mHead.load(std::memory_order_acquire);
+                size_t size = 0;
+                for (; tail != head; ++tail)
+                {
+                    Message& message = mSlots[tail % kQueueCapacity];
+                    size += message.text.size();
+                    func(message);
+                }
+                mBytes.fetch_sub(size, std::memory_order_release);
+                mTail.store(tail, std::memory_order_release);
             }
+
+            bool empty() const { return mHead.load(std::memory_order_acquire) == mTail.load(std::memory_order_acquire); }
+
+            std::atomic<bool> orphaned{false}; ///< True once the owning thread has exited.
+
+        private:
+            std::array<Message, kQueueCapacity> mSlots;
+            alignas(64) std::atomic<size_t> mHead{0};
+            alignas(64) std::atomic<size_t> mTail{0};
+            std::atomic<size_t> mBytes{0};
+        };
+
+        /** Handle to the message queue of a thread. Marks the queue as orphaned on thread exit,
+            it is released by the writer thread once drained.
+        */
+        struct QueueHandle
+        {
+            std::shared_ptr<MessageQueue> pQueue;
+            ~QueueHandle() { if (pQueue) pQueue->orphaned.store(true, std::memory_order_release); }
+        };
+
+        /** Rate limiting state of a distinct message.
+        */
+        struct RepeatInfo
+        {
+            Logger::Level level = Logger::Level::Info;
+            uint32_t count = 0;             ///< Number of times the message was written.
+            uint64_t suppressedCount = 0;   ///< Number of times the message was suppressed since the last report.
+        };
+
+        struct AsyncState
+        {
+            std::atomic<bool> enabled{false};
+            std::atomic<uint32_t> activeProducers{0};   ///< Number of threads currently queueing a message. Used to stop the writer thread without losing messages.
+            std::atomic<Logger::OverflowPolicy> overflowPolicy{Logger::OverflowPolicy::Block};
+            std::atomic<uint32_t> maxRepeatCount{100};
+            std::atomic<uint64_t> sequence{0};
+            std::atomic<uint64_t> droppedCount{0};
+
+            std::mutex modeMutex;                       ///< Serializes starting and stopping the writer thread.
+
+            std::mutex queuesMutex;
+            std::vector<std::shared_ptr<MessageQueue>> queues;
+
+            std::mutex writerMutex;                     ///< Guards the writer thread state below.
+            std::condition_variable writerCondition;
+            std::condition_variable flushCondition;
+            std::thread writerThread;
+            bool running = false;
+            bool stop = false;
+            uint64_t flushRequested = 0;
+            uint64_t flushCompleted = 0;
+
+            // State owned by the thread draining the queues.
+            std::vector<Message> batch;
+            std::unordered_map<std::string, RepeatInfo> repeatInfos;
+            std::vector<std::string> suppressedMessages;    ///< Messages with suppressed repetitions since the last report, in order of first suppression.
+            uint64_t reportedDroppedCount = 0;
+
+            ~AsyncState();
+        };
+
+        AsyncState& getAsyncState()
+        {
+            static AsyncState sState;
+            return sState;
         }
+
+        MessageQueue& getThreadQueue(AsyncState& state)
+        {
+            thread_local QueueHandle tHandle;
+            if (!tHandle.pQueue)
+            {
+                tHandle.pQueue = std::make_shared<MessageQueue>();
+                std::lock_guard<std::mutex> lock(state.queuesMutex);
+                state.queues.push_back(tHandle.pQueue);
+            }
+            return *tHandle.pQueue;
+        }
+
+        /** Queue a message for the writer thread.
+            Must only be called while registered in activeProducers, which keeps the writer thread running until the message is queued.
+        */
+        void enqueue(AsyncState& state, Logger::Level level, const std::string_view msg)
+        {
+            MessageQueue& queue = getThreadQueue(state);
+            Message message{level, state.sequence.fetch_add(1, std::memory_order_relaxed), std::string(msg)};
+            while (!queue.tryPush(message))
+            {
+                if (state.overflowPolicy.load(std::memory_order_relaxed) == Logger::OverflowPolicy::Drop)
+                {
+                    state.droppedCount.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                state.writerCondition.notify_one();
+                std::this_thread::yield();
+            }
+        }
+
+        /** Append a summary of the suppressed repetitions of each message.
+        */
+        void reportSuppressedMessages(AsyncState& state, OutputBatch& output)
+        {
+            for (const auto& text : state.suppressedMessages)
+            {
+                RepeatInfo& info = state.repeatInfos[text];
+                output.append(info.level, fmt::format("Suppressed {} repetitions of message: {}", info.suppressedCount, text));
+                info.suppressedCount = 0;
+            }
+            state.suppressedMessages.clear();
+        }
+
+        /** Write all queued messages. Only called from one thread at a time.
+            \param[in] reportSuppressed Write a summary of suppressed repeated messages.
+        */
+        void drainQueues(AsyncState& state, bool reportSuppressed)
+        {
+            std::vector<std::shared_ptr<MessageQueue>> queues;
+            {
+                std::lock_guard<std::mutex> lock(state.queuesMutex);
+                // Release queues of exited threads once they have been drained.
+                state.queues.erase(std::remove_if(state.queues.begin(), state.queues.end(),
+                    [](const auto& pQueue) { return pQueue->orphaned.load(std::memory_order_acquire) && pQueue->empty(); }), state.queues.end());
+                queues = state.queues;
+            }
+
+            state.batch.clear();
+            for (auto& pQueue : queues)
+            {
+                pQueue->consume([&](Message& message) { state.batch.push_back(std::move(message)); });
+            }
+            std::sort(state.batch.begin(), state.batch.end(), [](const Message& a, const Message& b) { return a.sequence < b.sequence; });
+
+            OutputBatch output;
+            uint32_t maxRepeatCount = state.maxRepeatCount.load(std::memory_order_relaxed);
+            for (const auto& message : state.batch)
+            {
+                if (maxRepeatCount > 0)
+                {
+                    // Bound the memory used for rate limiting by forgetting all messages once the limit is reached.
+                    if (state.repeatInfos.size() >= kMaxTrackedMessages && state.repeatInfos.count(message.text) == 0)
+                    {
+                        reportSuppressedMessages(state, output);
+                        state.repeatInfos.clear();
+                    }
+                    RepeatInfo& info = state.repeatInfos[message.text];
+                    info.level = message.level;
+                    if (info.count >= maxRepeatCount)
+                    {
+                        if (info.suppressedCount++ == 0) state.suppressedMessages.push_back(message.text);
+                        continue;
+                    }
+                    info.count++;
+                }
+                output.append(message.level, message.text);
+            }
+            state.batch.clear();
+
+            uint64_t droppedCount = state.droppedCount.load(std::memory_order_relaxed);
+            if (droppedCount != state.reportedDroppedCount)
+            {
+                output.append(Logger::Level::Warning, fmt::format("Dropped {} log messages because the message queue was full.", droppedCount - state.reportedDroppedCount));
+                state.reportedDroppedCount = droppedCount;
+            }
+            if (reportSuppressed) reportSuppressedMessages(state, output);
+
+            if (!output.empty())
+            {
+                std::lock_guard<std::mutex> lock(sOutputMutex);
+                output.write();
+            }
+        }
+
+        void writerMain(AsyncState& state)
+        {
+            std::unique_lock<std::mutex> lock(state.writerMutex);
+            while (true)
+            {
+                state.writerCondition.wait_for(lock, kWriterInterval, [&] { return state.stop || state.flushRequested != state.flushCompleted; });
+                bool stop = state.stop;
+                uint64_t flushRequest = state.flushRequested;
+                lock.unlock();
+
+                drainQueues(state, stop || flushRequest != state.flushCompleted);
+
+                lock.lock();
+                state.flushCompleted = flushRequest;
+                state.flushCondition.notify_all();
+                if (stop) break;
+            }
+        }
+
+        void startWriter(AsyncState& state)
+        {
+            std::lock_guard<std::mutex> modeLock(state.modeMutex);
+            {
+                std::lock_guard<std::mutex> lock(state.writerMutex);
+                if (state.running) return;
+                state.running = true;
+            }
+            state.writerThread = std::thread(writerMain, std::ref(state));
+            state.enabled.store(true, std::memory_order_release);
+        }
+
+        void stopWriter(AsyncState& state)
+        {
+            std::lock_guard<std::mutex> modeLock(state.modeMutex);
+            state.enabled.store(false);
+            {
+                std::lock_guard<std::mutex> lock(state.writerMutex);
+                if (!state.running) return;
+            }
+
+            // Wait for threads that saw the logger enabled to finish queueing their message.
+            // The writer thread keeps draining the queues meanwhile, so blocked producers make progress.
+            // Its final drain after the stop request then writes all queued messages.
+            while (state.activeProducers.load() != 0) std::this_thread::yield();
+
+            {
+                std::lock_guard<std::mutex> lock(state.writerMutex);
+                state.stop = true;
+            }
+            state.writerCondition.notify_one();
+            state.writerThread.join();
+
+            {
+                std::lock_guard<std::mutex> lock(state.writerMutex);
+                state.running = false;
+                state.stop = false;
+                state.flushCompleted = state.flushRequested;
+            }
+            state.flushCondition.notify_all();
+        }
+
+        AsyncState::~AsyncState()
+        {
+            // Stop the writer thread if the logger was not shut down explicitly.
+            if (writerThread.joinable())
+            {
+#if FALCOR_WINDOWS
+                // Joining threads from static destructors can deadlock when the library is unloaded on Windows.
+                enabled.store(false);
+                writerThread.detach();
+#else
+                stopWriter(*this);
+#endif
+            }
+        }
+
+        void writeSynchronous(Logger::Level level, const std::string_view msg)
+        {
+            OutputBatch output;
+            output.append(level, msg);
+            std::lock_guard<std::mutex> lock(sOutputMutex);
+            output.write();
+        }
+    }
+#endif
+
+    void Logger::shutdown()
+    {
+#if FALCOR_ENABLE_LOGGER
+        stopWriter(getAsyncState());
+
+        std::lock_guard<std::mutex> lock(sOutputMutex);
+        std::cout.flush();
+        if (sLogFile)
+        {
+            fclose(sLogFile);
+            sLogFile = nullptr;
+            sInitialized = false;
+        }
+#endif
+    }
+
+    void Logger::log(Level level, const std::string_view msg)
+    {
+#if FALCOR_ENABLE_LOGGER
+        if (level <= sVerbosity)
+        {
+            AsyncState& state = getAsyncState();
+
+            // Register as producer before checking the mode, stopWriter() waits for registered producers before the final drain.
+            // Both use sequentially consistent operations, so either the message is queued before the final drain or it is written synchronously.
+            state.activeProducers.fetch_add(1);
+            bool queued = state.enabled.load();
+            if (queued) enqueue(state, level, msg);
+            state.activeProducers.fetch_sub(1, std::memory_order_release);
+
+            if (!queued) writeSynchronous(level, msg);
+            else if (level == Level::Fatal) flush(); // Make sure fatal errors are written before the application terminates.
+        }
+#endif
+    }
+
+    void Logger::setMode(Mode mode)
+    {
+#if FALCOR_ENABLE_LOGGER
+        if (mode == Mode::Asynchronous) startWriter(getAsyncState());
+        else stopWriter(getAsyncState());
+#endif
+    }
+
+    Logger::Mode Logger::getMode()
+    {
+#if FALCOR_ENABLE_LOGGER
+        return getAsyncState().enabled.load() ? Mode::Asynchronous : Mode::Synchronous;
+#else
+        return Mode::Synchronous;
+#endif
+    }
+
+    void Logger::setOverflowPolicy(OverflowPolicy policy)
+    {
+#if FALCOR_ENABLE_LOGGER
+        getAsyncState().overflowPolicy.store(policy);
+#endif
+    }
+
+    Logger::OverflowPolicy Logger::getOverflowPolicy()
+    {
+#if FALCOR_ENABLE_LOGGER
+        return getAsyncState().overflowPolicy.load();
+#else
+        return OverflowPolicy::Block;
+#endif
+    }
+
+    void Logger::setMaxRepeatCount(uint32_t count)
+    {
+#if FALCOR_ENABLE_LOGGER
+        getAsyncState().maxRepeatCount.store(count);
+#endif
+    }
+
+    uint32_t Logger::getMaxRepeatCount()
+    {
+#if FALCOR_ENABLE_LOGGER
+        return getAsyncState().maxRepeatCount.load();
+#else
+        return 0;
+#endif
+    }
+
+    void Logger::flush()
+    {
+#if FALCOR_ENABLE_LOGGER
+        AsyncState& state = getAsyncState();
+        {
+            std::unique_lock<std::mutex> lock(state.writerMutex);
+            if (state.running)
+            {
+                uint64_t request = ++state.flushRequested;
+                state.writerCondition.notify_one();
+                state.flushCondition.wait(lock, [&] { return state.flushCompleted >= request; });
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(sOutputMutex);
+        std::cout.flush();
+        std::cerr.flush();
+        if (sLogFile) std::fflush(sLogFile);
+#endif
+    }
+
+    uint64_t Logger::getDroppedMessageCount()
+    {
+#if FALCOR_ENABLE_LOGGER
+        return getAsyncState().droppedCount.load();
+#else
+        return 0;
 #endif
     }
 
     bool Logger::setLogFilePath(const std::filesystem::path& path)
     {
 #if FALCOR_ENABLE_LOGGER
+        std::lock_guard<std::mutex> lock(sOutputMutex);
         if (sLogFile)
         {
             return false;
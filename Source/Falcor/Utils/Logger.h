@@ -32,12 +32,19 @@
 #include <fmt/core.h>
 #include <string_view>
 #include <filesystem>
+#include <cstdint>
 
 namespace Falcor
 {
     /** Container class for logging messages.
         To enable log messages, make sure FALCOR_ENABLE_LOGGER is set to `1` in FalcorConfig.h.
         Messages are only printed to the selected outputs if they match the verbosity level.
+
+        By default messages are written synchronously on the calling thread.
+        In asynchronous mode, messages are pushed to a lock-free per-thread ring buffer
+        and written in batches by a background writer thread. The ring buffers are bounded both
+        in number of messages and in bytes. The log is guaranteed to be flushed on fatal errors,
+        when calling flush(), when switching to synchronous mode and when calling shutdown().
     */
     class FALCOR_API Logger
     {
@@ -65,10 +72,67 @@ namespace Falcor
             DebugWindow     = 0x4,  ///< Output to debug window (if debugger is attached).
         };
 
-        /** Shutdown the logger and close the log file.
+        /** Logger mode.
+        */
+        enum class Mode
+        {
+            Synchronous,    ///< Messages are written immediately on the calling thread.
+            Asynchronous,   ///< Messages are queued and written by a background thread.
+        };
+
+        /** Policy used in asynchronous mode when the message queue of a thread is full.
+        */
+        enum class OverflowPolicy
+        {
+            Block,          ///< Wait until the writer thread has made space in the queue.
+            Drop,           ///< Drop the message. The number of dropped messages is reported in the log.
+        };
+
+        /** Shutdown the logger. This flushes all pending messages, stops the writer thread and closes the log file.
         */
         static void shutdown();
 
+        /** Set the logger mode.
+            Switching to synchronous mode flushes all pending messages and stops the writer thread.
+            \param[in] mode Logger mode.
+        */
+        static void setMode(Mode mode);
+
+        /** Get the logger mode.
+            \return Return the logger mode.
+        */
+        static Mode getMode();
+
+        /** Set the policy used in asynchronous mode when the message queue of a thread is full.
+            \param[in] policy Overflow policy.
+        */
+        static void setOverflowPolicy(OverflowPolicy policy);
+
+        /** Get the overflow policy.
+            \return Return the overflow policy.
+        */
+        static OverflowPolicy getOverflowPolicy();
+
+        /** Set the maximum number of times an identical message is written in asynchronous mode.
+            Further repetitions are suppressed and counted per message, and a summary for each message is written on flush.
+            \param[in] count Maximum repeat count, 0 disables rate limiting.
+        */
+        static void setMaxRepeatCount(uint32_t count);
+
+        /** Get the maximum number of times an identical message is written in asynchronous mode.
+            \return Return the maximum repeat count.
+        */
+        static uint32_t getMaxRepeatCount();
+
+        /** Block until all messages logged before this call have been written.
+        */
+        static void flush();
+
+        /** Get the number of messages dropped due to full message queues.
+            \return Return the number of dropped messages.
+        */
+        static uint64_t getDroppedMessageCount();
+
         /** Set the logger verbosity.
             \param level Log level.
         */
@@ -27,68 +27,379 @@
  **************************************************************************/
 #include "Threading.h"
 #include "Core/Assert.h"
+#include <atomic>
+#include <deque>
 
 namespace Falcor
 {
     namespace
     {
+        /** Number of chunks a range is split into by default in parallelFor()/parallelReduce().
+            This is independent of the thread count so that reductions are deterministic.
+        */
+        const size_t kDefaultChunkCount = 256;
+
+        using TaskState = Threading::Task::State;
+        using TaskStatePtr = std::shared_ptr<TaskState>;
+    }
+
+    struct Threading::Task::State
+    {
+        std::function<void(void)> func;
+        std::exception_ptr exception;
+        std::atomic<bool> done{false};
+        std::mutex mutex;                       ///< Protects continuations.
+        std::vector<TaskStatePtr> continuations;
+
+        State(std::function<void(void)> func_) : func(std::move(func_)) {}
+    };
+
+    namespace
+    {
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<TaskStatePtr> tasks;
+        };
+
         struct ThreadingData
         {
-            bool initialized = false;
+            std::mutex startMutex;                  ///< Protects starting and shutting down the pool.
+            std::atomic<bool> initialized{false};
             std::vector<std::thread> threads;
-            uint32_t current;
+            std::vector<std::unique_ptr<WorkerQueue>> queues;
+            std::atomic<uint32_t> nextQueue{0};     ///< Queue used for the next task dispatched from a non-worker thread.
+
+            std::mutex wakeMutex;
+            std::condition_variable wakeCondition;  ///< Notified when tasks are dispatched or finished.
+            std::atomic<size_t> queuedCount{0};     ///< Number of tasks in the queues.
+            std::atomic<size_t> activeCount{0};     ///< Number of dispatched tasks that have not finished.
+            bool stop = false;
+
+            ~ThreadingData()
+            {
+                // Stop the worker threads if the pool was not shut down explicitly.
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                    stop = true;
+                }
+                wakeCondition.notify_all();
+                for (auto& t : threads)
+                {
+#if FALCOR_WINDOWS
+                    // Joining threads from static destructors can deadlock when the library is unloaded on Windows.
+                    t.detach();
+#else
+                    t.join();
+#endif
+                }
+            }
         } gData;
+
+        /** Index of the worker queue owned by the current thread, or -1 if not a worker thread.
+        */
+        thread_local int tWorkerIndex = -1;
+
+        void notify(bool all)
+        {
+            // Lock to avoid lost wake-ups of threads that are about to wait.
+            { std::lock_guard<std::mutex> lock(gData.wakeMutex); }
+            if (all) gData.wakeCondition.notify_all();
+            else gData.wakeCondition.notify_one();
+        }
+
+        void submit(TaskStatePtr pTask)
+        {
+            FALCOR_ASSERT(gData.initialized);
+
+            size_t queueIndex = tWorkerIndex >= 0 ? (size_t)tWorkerIndex : gData.nextQueue++ % gData.queues.size();
+            auto& queue = *gData.queues[queueIndex];
+
+            gData.activeCount++;
+            gData.queuedCount++;
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.tasks.push_back(std::move(pTask));
+            }
+            notify(false);
+        }
+
+        /** Find a task to execute. Takes the most recently added task from the own queue,
+            or steals the oldest task from another queue.
+        */
+        TaskStatePtr findTask()
+        {
+            if (gData.queuedCount == 0) return nullptr;
+
+            size_t queueCount = gData.queues.size();
+            if (tWorkerIndex >= 0)
+            {
+                auto& queue = *gData.queues[tWorkerIndex];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty())
+                {
+                    auto pTask = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                    gData.queuedCount--;
+                    return pTask;
+                }
+            }
+
+            size_t start = tWorkerIndex >= 0 ? (size_t)tWorkerIndex + 1 : 0;
+            for (size_t i = 0; i < queueCount; ++i)
+            {
+                auto& queue = *gData.queues[(start + i) % queueCount];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty())
+                {
+                    auto pTask = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                    gData.queuedCount--;
+                    return pTask;
+                }
+            }
+
+            return nullptr;
+        }
+
+        void execute(const TaskStatePtr& pTask)
+        {
+            try
+            {
+                pTask->func();
+            }
+            catch (...)
+            {
+                pTask->exception = std::current_exception();
+            }
+            pTask->func = nullptr;
+
+            std::vector<TaskStatePtr> continuations;
+            {
+                std::lock_guard<std::mutex> lock(pTask->mutex);
+                pTask->done = true;
+                continuations.swap(pTask->continuations);
+            }
+            for (auto& pContinuation : continuations) submit(std::move(pContinuation));
+
+            gData.activeCount--;
+            notify(true);
+        }
+
+        /** Execute pending tasks until the condition is met.
+        */
+        template<typename Condition>
+        void helpUntil(Condition condition)
+        {
+            while (!condition())
+            {
+                if (auto pTask = findTask())
+                {
+                    execute(pTask);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(gData.wakeMutex);
+                gData.wakeCondition.wait(lock, [&]() { return condition() || gData.queuedCount > 0; });
+            }
+        }
+
+        void workerThread(int workerIndex)
+        {
+            tWorkerIndex = workerIndex;
+
+            while (true)
+            {
+                if (auto pTask = findTask())
+                {
+                    execute(pTask);
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock(gData.wakeMutex);
+                gData.wakeCondition.wait(lock, []() { return gData.stop || gData.queuedCount > 0; });
+                if (gData.stop && gData.queuedCount == 0) break;
+            }
+        }
+
+        void ensureStarted()
+        {
+            if (!gData.initialized) Threading::start();
+        }
     }
 
     void Threading::start(uint32_t threadCount)
     {
+        std::lock_guard<std::mutex> lock(gData.startMutex);
         if (gData.initialized) return;
 
-        gData.threads.resize(threadCount);
+        if (threadCount == 0) threadCount = getLogicalThreadCount();
+
+        gData.stop = false;
+        gData.queues.resize(threadCount);
+        for (auto& pQueue : gData.queues) pQueue = std::make_unique<WorkerQueue>();
+        gData.threads.reserve(threadCount);
+        for (uint32_t i = 0; i < threadCount; ++i) gData.threads.emplace_back(workerThread, (int)i);
         gData.initialized = true;
     }
 
     void Threading::shutdown()
     {
-        for (auto& t : gData.threads)
+        std::lock_guard<std::mutex> lock(gData.startMutex);
+        if (!gData.initialized) return;
+
+        FALCOR_ASSERT(tWorkerIndex < 0);
+        helpUntil([]() { return gData.activeCount == 0; });
+
         {
-            if (t.joinable()) t.join();
+            std::lock_guard<std::mutex> wakeLock(gData.wakeMutex);
+            gData.stop = true;
         }
+        gData.wakeCondition.notify_all();
 
+        for (auto& t : gData.threads) t.join();
+        gData.threads.clear();
+        gData.queues.clear();
         gData.initialized = false;
     }
 
-    Threading::Task Threading::dispatchTask(const std::function<void(void)>& func)
+    void Threading::finish()
     {
-        FALCOR_ASSERT(gData.initialized);
+        FALCOR_ASSERT(tWorkerIndex < 0);
+        if (!gData.initialized) return;
+        helpUntil([]() { return gData.activeCount == 0; });
+    }
 
-        std::thread& t = gData.threads[gData.current];
-        if (t.joinable()) t.join();
-        t = std::thread(func);
-        gData.current = (gData.current + 1) % gData.threads.size();
+    uint32_t Threading::getThreadCount()
+    {
+        ensureStarted();
+        return (uint32_t)gData.threads.size();
+    }
+
+    Threading::Task Threading::dispatchTask(std::function<void(void)> func)
+    {
+        ensureStarted();
 
-        return Task();
+        auto pState = std::make_shared<Task::State>(std::move(func));
+        submit(pState);
+        return Task(pState);
     }
 
-    void Threading::finish()
+    size_t Threading::getDefaultGrainSize(size_t count)
     {
-        for (auto& t : gData.threads)
+        return std::max<size_t>(1, (count + kDefaultChunkCount - 1) / kDefaultChunkCount);
+    }
+
+    void Threading::parallelForChunks(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func)
+    {
+        if (count == 0) return;
+        if (grainSize == 0) grainSize = getDefaultGrainSize(count);
+        size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+        if (chunkCount == 1)
         {
-            if (t.joinable()) t.join();
+            func(0, count);
+            return;
         }
+
+        std::atomic<size_t> nextChunk{0};
+        std::atomic<bool> failed{false};
+        std::mutex exceptionMutex;
+        std::exception_ptr exception;
+
+        auto processChunks = [&]()
+        {
+            while (!failed)
+            {
+                size_t chunk = nextChunk++;
+                if (chunk >= chunkCount) break;
+                size_t chunkBegin = chunk * grainSize;
+                size_t chunkEnd = std::min(chunkBegin + grainSize, count);
+                try
+                {
+                    func(chunkBegin, chunkEnd);
+                }
+                catch (...)
+                {
+                    std::lock_guard<std::mutex> lock(exceptionMutex);
+                    if (!exception) exception = std::current_exception();
+                    failed = true;
+                }
+            }
+        };
+
+        // Dispatch helper tasks pulling chunks from the shared counter. The calling thread participates as well.
+        size_t helperCount = std::min<size_t>(chunkCount, getThreadCount()) - 1;
+        TaskGroup group;
+        for (size_t i = 0; i < helperCount; ++i) group.run(processChunks);
+        processChunks();
+        group.wait();
+
+        if (exception) std::rethrow_exception(exception);
     }
 
-    Threading::Task::Task()
+    bool Threading::Task::isRunning() const
     {
+        return mpState && !mpState->done;
     }
 
-    bool Threading::Task::isRunning()
+    void Threading::Task::finish()
     {
-        FALCOR_UNIMPLEMENTED();
+        if (!mpState) return;
+        auto pState = mpState;
+        helpUntil([&pState]() { return pState->done.load(); });
+        if (pState->exception) std::rethrow_exception(pState->exception);
     }
 
-    void Threading::Task::finish()
+    Threading::Task Threading::Task::then(std::function<void(void)> func)
+    {
+        FALCOR_ASSERT(mpState);
+
+        auto pContinuation = std::make_shared<State>(std::move(func));
+        {
+            std::lock_guard<std::mutex> lock(mpState->mutex);
+            if (!mpState->done)
+            {
+                mpState->continuations.push_back(pContinuation);
+                return Task(pContinuation);
+            }
+        }
+        submit(pContinuation);
+        return Task(pContinuation);
+    }
+
+    Threading::TaskGroup::~TaskGroup()
+    {
+        try
+        {
+            wait();
+        }
+        catch (...)
+        {
+        }
+    }
+
+    void Threading::TaskGroup::run(std::function<void(void)> func)
     {
-        FALCOR_UNIMPLEMENTED();
+        mTasks.push_back(Threading::dispatchTask(std::move(func)));
+    }
+
+    void Threading::TaskGroup::wait()
+    {
+        // Wait for all tasks before rethrowing, as tasks may reference state owned by the caller.
+        std::exception_ptr exception;
+        for (auto& task : mTasks)
+        {
+            try
+            {
+                task.finish();
+            }
+            catch (...)
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+        mTasks.clear();
+        if (exception) std::rethrow_exception(exception);
     }
 }
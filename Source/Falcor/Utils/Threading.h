@@ -27,60 +27,178 @@
  **************************************************************************/
 #pragma once
 #include "Core/Macros.h"
+#include <algorithm>
 #include <condition_variable>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 #include <cstdint>
 
 namespace Falcor
 {
+    /** Global work-stealing thread pool.
+        Each worker thread owns a task queue. Workers execute their own tasks in LIFO order and steal
+        tasks from other workers in FIFO order when they run out of work. Threads waiting for a task
+        to finish execute pending tasks in the meantime, so it is safe to wait on tasks (or use the
+        parallel helpers) from within tasks.
+        The pool is started lazily on first use if start() has not been called.
+    */
     class FALCOR_API Threading
     {
     public:
-        const static uint32_t kDefaultThreadCount = 16;
-
-        /** Handle to a dispatched task
-
-            TODO: Implementation
+        /** Handle to a dispatched task.
         */
-        class Task
+        class FALCOR_API Task
         {
         public:
-            /** Check if task is still executing
+            Task() = default;
+
+            /** Check if the handle refers to a task.
+            */
+            bool isValid() const { return mpState != nullptr; }
+
+            /** Check if task is still pending or executing.
             */
-            bool isRunning();
+            bool isRunning() const;
 
-            /** Wait for task to finish executing
+            /** Wait for task to finish executing.
+                The calling thread executes other pending tasks while waiting.
+                Exceptions thrown by the task are rethrown.
             */
             void finish();
 
+            /** Add a continuation that is dispatched once this task has finished executing.
+                The continuation is dispatched even if this task throws an exception.
+                \param[in] func Function to execute.
+                \return Handle to the continuation task.
+            */
+            Task then(std::function<void(void)> func);
+
+            struct State; ///< Internal task state.
+
         private:
-            Task();
+            Task(std::shared_ptr<State> pState) : mpState(std::move(pState)) {}
+
+            std::shared_ptr<State> mpState;
             friend class Threading;
         };
 
-        /** Initializes the global thread pool
-            \param[in] threadCount Number of threads in the pool
+        /** Group of tasks that are waited on together.
+        */
+        class FALCOR_API TaskGroup
+        {
+        public:
+            TaskGroup() = default;
+            TaskGroup(const TaskGroup&) = delete;
+            TaskGroup& operator=(const TaskGroup&) = delete;
+
+            /** Waits for all tasks in the group to finish. Exceptions are discarded.
+            */
+            ~TaskGroup();
+
+            /** Dispatch a task as part of the group.
+                \param[in] func Function to execute.
+            */
+            void run(std::function<void(void)> func);
+
+            /** Wait for all tasks in the group to finish.
+                If any of the tasks threw an exception, the first one (in order of dispatch) is rethrown.
+            */
+            void wait();
+
+        private:
+            std::vector<Task> mTasks;
+        };
+
+        /** Initializes the global thread pool.
+            \param[in] threadCount Number of worker threads in the pool. If zero, the number of logical threads is used.
         */
-        static void start(uint32_t threadCount = kDefaultThreadCount);
+        static void start(uint32_t threadCount = 0);
 
-        /** Waits for all currently executing threads to finish
+        /** Waits for all dispatched tasks to finish.
+            Must not be called from within a task.
         */
         static void finish();
 
-        /** Waits for all currently executing threads to finish and shuts down the thread pool
+        /** Waits for all dispatched tasks to finish and shuts down the thread pool.
         */
         static void shutdown();
 
         /** Returns the maximum number of concurrent threads supported by the hardware
         */
-        static uint32_t getLogicalThreadCount() { return std::thread::hardware_concurrency(); }
+        static uint32_t getLogicalThreadCount() { return std::max(1u, std::thread::hardware_concurrency()); }
+
+        /** Returns the number of worker threads in the pool (starting the pool if necessary).
+        */
+        static uint32_t getThreadCount();
 
         /** Starts a task on an available thread.
             \return Handle to the task
         */
-        static Task dispatchTask(const std::function<void(void)>& func);
+        static Task dispatchTask(std::function<void(void)> func);
+
+        /** Execute a function for all indices in a range in parallel and wait for completion.
+            The range is split into chunks that are distributed dynamically among the worker threads and the calling thread.
+            If any invocation throws an exception, remaining chunks are skipped and the exception is rethrown.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] func Function to execute, called as func(Index i).
+            \param[in] grainSize Number of indices per chunk. If zero, a chunk size is chosen automatically.
+        */
+        template<typename Index, typename Func>
+        static void parallelFor(Index begin, Index end, Func&& func, size_t grainSize = 0)
+        {
+            if (!(begin < end)) return;
+            size_t count = (size_t)(end - begin);
+            parallelForChunks(count, grainSize, [&](size_t chunkBegin, size_t chunkEnd)
+            {
+                for (size_t i = chunkBegin; i < chunkEnd; ++i) func((Index)(begin + (Index)i));
+            });
+        }
+
+        /** Compute a reduction over all indices in a range in parallel.
+            The range is split into chunks independently of the number of threads. Each chunk is reduced
+            sequentially and the partial results are reduced in chunk order, making the result deterministic.
+            \param[in] begin First index.
+            \param[in] end One past the last index.
+            \param[in] identity Identity value of the reduction.
+            \param[in] func Function returning the value for an index, called as func(Index i).
+            \param[in] reduce Function combining two values, called as reduce(T a, T b).
+            \param[in] grainSize Number of indices per chunk. If zero, a chunk size is chosen automatically.
+            \return The reduced value.
+        */
+        template<typename T, typename Index, typename Func, typename Reduce>
+        static T parallelReduce(Index begin, Index end, const T& identity, Func&& func, Reduce&& reduce, size_t grainSize = 0)
+        {
+            if (!(begin < end)) return identity;
+            size_t count = (size_t)(end - begin);
+            if (grainSize == 0) grainSize = getDefaultGrainSize(count);
+            size_t chunkCount = (count + grainSize - 1) / grainSize;
+
+            std::vector<T> partials(chunkCount, identity);
+            parallelForChunks(count, grainSize, [&](size_t chunkBegin, size_t chunkEnd)
+            {
+                T value = identity;
+                for (size_t i = chunkBegin; i < chunkEnd; ++i) value = reduce(value, func((Index)(begin + (Index)i)));
+                partials[chunkBegin / grainSize] = value;
+            });
+
+            T result = identity;
+            for (const auto& partial : partials) result = reduce(result, partial);
+            return result;
+        }
+
+    private:
+        /** Get the chunk size used if no grain size is specified.
+        */
+        static size_t getDefaultGrainSize(size_t count);
+
+        /** Execute func(chunkBegin, chunkEnd) for consecutive chunks of 'grainSize' indices in [0, count) in parallel.
+        */
+        static void parallelForChunks(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& func);
     };
 
     /** Simple thread barrier class.
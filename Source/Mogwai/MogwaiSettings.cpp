@@ -231,9 +231,23 @@ namespace Mogwai
                 << "Program kernels time (total): " << s.programKernelsTotalTime << " s" << std::endl
                 << "Program version time (max): " << s.programVersionMaxTime << " s" << std::endl
                 << "Program kernels time (max): " << s.programKernelsMaxTime << " s" << std::endl;
+
+            const auto& pCache = Program::getProgramCache();
+            if (pCache)
+            {
+                const auto cs = pCache->getStats();
+                oss << "Program cache hits: " << cs.hitCount << std::endl
+                    << "Program cache misses: " << cs.missCount << std::endl
+                    << "Program cache writes: " << cs.writeCount << std::endl
+                    << "Program cache evictions: " << cs.evictionCount << std::endl;
+            }
             g.text(oss.str());
 
-            if (g.button("Reset")) Program::resetGlobalCompilationStats();
+            if (g.button("Reset"))
+            {
+                Program::resetGlobalCompilationStats();
+                if (pCache) pCache->resetStats();
+            }
         }
 
         // Scene UI
@@ -0,0 +1,128 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Program/ProgramCache.h"
+#include <chrono>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        ProgramCache::Key makeKey(const std::string& str)
+        {
+            return SHA1::compute(str.data(), str.size());
+        }
+
+        ProgramCache::Entry makeEntry(size_t size, uint8_t value)
+        {
+            ProgramCache::Entry entry;
+            entry.code.resize(size, value);
+            entry.diagnostics = "warning " + std::to_string(value);
+            return entry;
+        }
+    }
+
+    CPU_TEST(ProgramCache)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "FalcorTestProgramCache";
+        std::filesystem::remove_all(directory);
+
+        auto pCache = ProgramCache::create(directory);
+        const auto keyA = makeKey("A");
+        const auto keyB = makeKey("B");
+
+        // Lookups in an empty cache miss.
+        EXPECT(!pCache->read(keyA));
+        EXPECT_EQ(pCache->getStats().missCount, 1ull);
+
+        // Stored entries are returned unmodified.
+        auto entryA = makeEntry(1000, 1);
+        pCache->write(keyA, entryA);
+        auto readA = pCache->read(keyA);
+        EXPECT(readA.has_value());
+        if (readA)
+        {
+            EXPECT(readA->code == entryA.code);
+            EXPECT_EQ(readA->diagnostics, entryA.diagnostics);
+        }
+        EXPECT(!pCache->read(keyB));
+
+        auto stats = pCache->getStats();
+        EXPECT_EQ(stats.hitCount, 1ull);
+        EXPECT_EQ(stats.missCount, 2ull);
+        EXPECT_EQ(stats.writeCount, 1ull);
+
+        // Entries are visible to other cache instances sharing the directory.
+        EXPECT(ProgramCache::create(directory)->read(keyA).has_value());
+
+        // Truncated entries are rejected.
+        {
+            auto path = pCache->getEntryPath(keyA);
+            auto size = std::filesystem::file_size(path);
+            std::filesystem::resize_file(path, size - 1);
+            EXPECT(!pCache->read(keyA));
+        }
+
+        // Entries stored under a different key are rejected.
+        pCache->write(keyB, makeEntry(1000, 2));
+        std::filesystem::copy_file(pCache->getEntryPath(keyB), pCache->getEntryPath(keyA), std::filesystem::copy_options::overwrite_existing);
+        EXPECT(!pCache->read(keyA));
+
+        // Least recently used entries are evicted first.
+        pCache->clear();
+        EXPECT_EQ(pCache->getSize(), 0ull);
+        pCache->resetStats();
+
+        std::vector<ProgramCache::Key> keys;
+        auto time = std::filesystem::file_time_type::clock::now() - std::chrono::hours(1);
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            keys.push_back(makeKey("Entry" + std::to_string(i)));
+            pCache->write(keys[i], makeEntry(1000, (uint8_t)i));
+            std::filesystem::last_write_time(pCache->getEntryPath(keys[i]), time + std::chrono::seconds(i));
+        }
+        EXPECT(pCache->read(keys[0]).has_value()); // Marks entry 0 as most recently used.
+
+        uint64_t entrySize = std::filesystem::file_size(pCache->getEntryPath(keys[0]));
+        pCache->evict(4 * entrySize);
+        EXPECT_EQ(pCache->getSize(), 4 * entrySize);
+        EXPECT(pCache->read(keys[0]).has_value());
+        for (uint32_t i = 1; i < 5; i++) EXPECT(!pCache->read(keys[i])) << "i = " << i;
+        for (uint32_t i = 5; i < 8; i++) EXPECT(pCache->read(keys[i]).has_value()) << "i = " << i;
+        EXPECT_EQ(pCache->getStats().evictionCount, 4ull);
+
+        // Writes evict automatically when exceeding the maximum size.
+        pCache->setMaxSize(2 * entrySize);
+        pCache->write(keyA, makeEntry(1000, 1));
+        EXPECT_LE(pCache->getSize(), 2 * entrySize);
+        EXPECT(pCache->read(keyA).has_value());
+
+        std::filesystem::remove_all(directory);
+    }
+}
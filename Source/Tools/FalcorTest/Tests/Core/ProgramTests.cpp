@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const char kShaderFile[] = "Tests/Core/ProgramTests.cs.slang";
+
+        const uint32_t kPassCount = 8;
+    }
+
+    GPU_TEST(ProgramCompileVersions)
+    {
+        // Create passes without vars, which would compile their programs.
+        std::vector<ComputePass::SharedPtr> passes;
+        std::vector<std::pair<Program::SharedPtr, Program::DefineList>> versions;
+        for (uint32_t i = 0; i < kPassCount; i++)
+        {
+            auto pPass = ComputePass::create(kShaderFile, "main", { { "VALUE", std::to_string(i) } }, false);
+            versions.emplace_back(pPass->getProgram(), pPass->getProgram()->getDefineList());
+            // Request another version of the same program and a duplicate.
+            versions.emplace_back(pPass->getProgram(), Program::DefineList{ { "VALUE", std::to_string(i + 100) } });
+            versions.emplace_back(pPass->getProgram(), pPass->getProgram()->getDefineList());
+            passes.push_back(pPass);
+        }
+
+        auto stats = Program::getGlobalCompilationStats();
+        Program::compileVersions(versions);
+        EXPECT_EQ(Program::getGlobalCompilationStats().programVersionCount, stats.programVersionCount + 2 * kPassCount);
+        EXPECT_EQ(Program::getGlobalCompilationStats().programKernelsCount, stats.programKernelsCount + 2 * kPassCount);
+
+        // Requesting compiled versions again is a no-op.
+        Program::compileVersions(versions);
+        EXPECT_EQ(Program::getGlobalCompilationStats().programVersionCount, stats.programVersionCount + 2 * kPassCount);
+
+        // Running the passes uses the precompiled versions and kernels.
+        auto pResult = Buffer::createStructured(sizeof(uint32_t), 1, ResourceBindFlags::UnorderedAccess);
+        for (uint32_t i = 0; i < kPassCount; i++)
+        {
+            auto& pPass = passes[i];
+            pPass->setVars(nullptr);
+            pPass->getRootVar()["result"] = pResult;
+            pPass->execute(ctx.getRenderContext(), 1, 1);
+
+            const uint32_t* pData = (const uint32_t*)pResult->map(Buffer::MapType::Read);
+            EXPECT_EQ(pData[0], i);
+            pResult->unmap();
+
+            // Switch to the second version.
+            pPass->addDefine("VALUE", std::to_string(i + 100), true);
+            pPass->getRootVar()["result"] = pResult;
+            pPass->execute(ctx.getRenderContext(), 1, 1);
+
+            pData = (const uint32_t*)pResult->map(Buffer::MapType::Read);
+            EXPECT_EQ(pData[0], i + 100);
+            pResult->unmap();
+        }
+        EXPECT_EQ(Program::getGlobalCompilationStats().programVersionCount, stats.programVersionCount + 2 * kPassCount);
+        EXPECT_EQ(Program::getGlobalCompilationStats().programKernelsCount, stats.programKernelsCount + 2 * kPassCount);
+    }
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/BasePasses/ComputePass.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        constexpr ShaderVarName kValue("gValue");
+        static_assert(kValue.getHash() == ShaderVarName::hash("gValue"));
+        static_assert(ShaderVarName("gValue").getHash() != ShaderVarName("gValues").getHash());
+
+        void testHandles(GPUUnitTestContext& ctx, bool swapLayout)
+        {
+            Program::DefineList defines = { { "SWAP_LAYOUT", swapLayout ? "1" : "0" } };
+            ctx.createProgram("Tests/Core/ShaderVarTests.cs.slang", "main", defines, Shader::CompilerFlags::None);
+            ctx.allocateStructuredBuffer("result", 4);
+
+            // Lookups by name hash and by handle find the same variables as lookups by string.
+            ShaderVar var = ctx.vars().getRootVar();
+            EXPECT_EQ(var["CB"][kValue].getByteOffset(), var["CB"]["gValue"].getByteOffset());
+
+            // The path through the constant buffer is looked up by name after the constant buffer.
+            ShaderVarHandle innerX{ ShaderVarName("CB"), ShaderVarName("gOuter"), ShaderVarName("inner"), ShaderVarName("x") };
+            EXPECT_EQ(var[innerX].getByteOffset(), var["CB"]["gOuter"]["inner"]["x"].getByteOffset());
+
+            // Applying the handle to the constant buffer resolves the whole path in the struct type.
+            ShaderVarHandle innerY{ ShaderVarName("gOuter"), ShaderVarName("inner"), ShaderVarName("y") };
+            EXPECT_EQ(var["CB"][innerY].getByteOffset(), var["CB"]["gOuter"]["inner"]["y"].getByteOffset());
+
+            ShaderVarHandle value(kValue);
+            var[innerX] = 1.5f;
+            var["CB"][innerY] = 7u;
+            var["CB"][value] = 3u;
+
+            auto pBlock = ParameterBlock::create(ctx.getProgram()->getReflector()->getParameterBlock("gBlock"));
+            ShaderVarHandle b(ShaderVarName("b"));
+            pBlock[b] = 2.5f;
+            var["gBlock"] = pBlock;
+
+            // Using the handles again returns the cached results.
+            EXPECT_EQ(var["CB"][innerY].getByteOffset(), var["CB"]["gOuter"]["inner"]["y"].getByteOffset());
+            EXPECT(!var["CB"].findMember(ShaderVarName("gMissing")).isValid());
+
+            ctx.runProgram(1, 1, 1);
+
+            const float* result = ctx.mapBuffer<const float>("result");
+            EXPECT_EQ(result[0], 1.5f);
+            EXPECT_EQ(result[1], 7.f);
+            EXPECT_EQ(result[2], 3.f);
+            EXPECT_EQ(result[3], 2.5f);
+            ctx.unmapBuffer("result");
+        }
+    }
+
+    GPU_TEST(ShaderVarHandle)
+    {
+        testHandles(ctx, false);
+        testHandles(ctx, true);
+    }
+
+    GPU_TEST(ShaderVarHandleRecompile)
+    {
+        // A handle resolved for one program version is resolved again for another with a different layout.
+        ShaderVarHandle innerX{ ShaderVarName("gOuter"), ShaderVarName("inner"), ShaderVarName("x") };
+        for (bool swapLayout : { false, true, false })
+        {
+            Program::DefineList defines = { { "SWAP_LAYOUT", swapLayout ? "1" : "0" } };
+            ctx.createProgram("Tests/Core/ShaderVarTests.cs.slang", "main", defines, Shader::CompilerFlags::None);
+            ctx.allocateStructuredBuffer("result", 4);
+
+            ShaderVar cb = ctx["CB"];
+            EXPECT_EQ(cb[innerX].getByteOffset(), cb["gOuter"]["inner"]["x"].getByteOffset());
+            cb[innerX] = swapLayout ? 4.f : 5.f;
+            ctx.runProgram(1, 1, 1);
+
+            const float* result = ctx.mapBuffer<const float>("result");
+            EXPECT_EQ(result[0], swapLayout ? 4.f : 5.f);
+            ctx.unmapBuffer("result");
+        }
+    }
+
+    GPU_TEST(ShaderVarHandleMultiplePrograms)
+    {
+        // A handle shared by program versions with different layouts finds the right variable in each of them.
+        ShaderVarHandle innerX{ ShaderVarName("gOuter"), ShaderVarName("inner"), ShaderVarName("x") };
+        auto pPassA = ComputePass::create("Tests/Core/ShaderVarTests.cs.slang", "main", { { "SWAP_LAYOUT", "0" } });
+        auto pPassB = ComputePass::create("Tests/Core/ShaderVarTests.cs.slang", "main", { { "SWAP_LAYOUT", "1" } });
+
+        for (int i = 0; i < 3; ++i)
+        {
+            for (const auto& pPass : { pPassA, pPassB })
+            {
+                ShaderVar cb = pPass->getRootVar()["CB"];
+                EXPECT_EQ(cb[innerX].getByteOffset(), cb["gOuter"]["inner"]["x"].getByteOffset());
+            }
+        }
+        EXPECT_NE(pPassA->getRootVar()["CB"][innerX].getByteOffset(), pPassB->getRootVar()["CB"][innerX].getByteOffset());
+    }
+}
@@ -0,0 +1,138 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/ResourceCache.h"
+
+namespace Falcor
+{
+    namespace
+    {
+        const ResourceCache::DefaultProperties kDefaultProps = { uint2(1920, 1080), ResourceFormat::RGBA16Float };
+        const ResourceBindFlags kBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+        const uint64_t kFullResSize = 1920ull * 1080ull * 8ull;
+    }
+
+    CPU_TEST(ResourceCacheAliasing)
+    {
+        RenderPassReflection reflection;
+        const auto output = reflection.addOutput("output", "").bindFlags(kBindFlags);
+        const auto input = reflection.addInput("input", "").bindFlags(kBindFlags);
+        const auto output8 = reflection.addOutput("output8", "").format(ResourceFormat::RGBA8Unorm).bindFlags(kBindFlags);
+        const auto persistent = reflection.addOutput("persistent", "").flags(RenderPassReflection::Field::Flags::Persistent).bindFlags(kBindFlags);
+        const auto internal = reflection.addInternal("internal", "").bindFlags(kBindFlags);
+
+        auto registerChain = [&](ResourceCache* pCache)
+        {
+            // A chain of passes where each output is consumed by the next pass: A [0,1], B [1,2], C [2,3], D [3,4], E [4,5].
+            const char* names[] = { "A", "B", "C", "D", "E" };
+            for (uint32_t i = 0; i < 5; i++)
+            {
+                pCache->registerField(std::string(names[i]) + ".output", output, i);
+                pCache->registerField(std::string(i < 4 ? names[i + 1] : "Final") + ".input", input, i + 1, std::string(names[i]) + ".output");
+            }
+            // Transient with a different format, overlapping only with A.
+            pCache->registerField("F.output8", output8, 0);
+            pCache->registerField("G.output8", output8, 3);
+            // Resources that must not share memory, although their lifetimes don't overlap with A.
+            pCache->registerField("H.persistent", persistent, 3);
+            pCache->registerField("I.internal", internal, 3);
+            pCache->registerField("J.output", output, uint32_t(-1));
+        };
+
+        auto pCache = ResourceCache::create();
+        registerChain(pCache.get());
+        const auto& stats = pCache->planAllocations(kDefaultProps);
+
+        EXPECT_EQ(stats.resourceCount, 10);
+        EXPECT_EQ(stats.transientCount, 7);
+
+        // The chain only needs two alternating allocations, the RGBA8 outputs share a single one.
+        EXPECT_EQ(pCache->getAllocationIndex("A.output"), pCache->getAllocationIndex("C.output"));
+        EXPECT_EQ(pCache->getAllocationIndex("A.output"), pCache->getAllocationIndex("E.output"));
+        EXPECT_EQ(pCache->getAllocationIndex("B.output"), pCache->getAllocationIndex("D.output"));
+        EXPECT_NE(pCache->getAllocationIndex("A.output"), pCache->getAllocationIndex("B.output"));
+        EXPECT_EQ(pCache->getAllocationIndex("B.input"), pCache->getAllocationIndex("A.output"));
+        EXPECT_EQ(pCache->getAllocationIndex("F.output8"), pCache->getAllocationIndex("G.output8"));
+        EXPECT_NE(pCache->getAllocationIndex("F.output8"), pCache->getAllocationIndex("A.output"));
+
+        // Persistent, internal and graph output resources get their own allocation.
+        for (const char* name : { "H.persistent", "I.internal", "J.output" })
+        {
+            uint32_t allocation = pCache->getAllocationIndex(name);
+            EXPECT_NE(allocation, ResourceCache::kInvalidAllocation);
+            for (const char* other : { "A.output", "B.output", "F.output8", "H.persistent", "I.internal", "J.output" })
+            {
+                if (std::string(name) != other) EXPECT_NE(allocation, pCache->getAllocationIndex(other));
+            }
+        }
+        EXPECT_EQ(pCache->getAllocationIndex("Unknown.output"), ResourceCache::kInvalidAllocation);
+
+        EXPECT_EQ(stats.allocationCount, 6);
+        EXPECT_EQ(stats.requiredMemory, 8 * kFullResSize + 2 * kFullResSize / 2);
+        EXPECT_EQ(stats.allocatedMemory, 5 * kFullResSize + kFullResSize / 2);
+        EXPECT_EQ(stats.getSavedMemory(), 3 * kFullResSize + kFullResSize / 2);
+
+        // Without aliasing every resource gets its own allocation.
+        auto pUnaliased = ResourceCache::create();
+        pUnaliased->setAliasingEnabled(false);
+        registerChain(pUnaliased.get());
+        const auto& unaliasedStats = pUnaliased->planAllocations(kDefaultProps);
+        EXPECT_EQ(unaliasedStats.allocationCount, 10);
+        EXPECT_EQ(unaliasedStats.requiredMemory, stats.requiredMemory);
+        EXPECT_EQ(unaliasedStats.getSavedMemory(), 0);
+    }
+
+    CPU_TEST(ResourceCacheAliasingSizeClasses)
+    {
+        RenderPassReflection reflection;
+        const auto full = reflection.addOutput("full", "").bindFlags(kBindFlags);
+        const auto half = reflection.addOutput("half", "").texture2D(960, 540).bindFlags(kBindFlags);
+        const auto explicitFull = reflection.addOutput("explicitFull", "").texture2D(1920, 1080).format(ResourceFormat::RGBA16Float).bindFlags(kBindFlags);
+        const auto mips = reflection.addOutput("mips", "").texture2D(4, 4, 1, RenderPassReflection::Field::kMaxMipLevels).format(ResourceFormat::RGBA8Unorm).bindFlags(kBindFlags);
+        const auto buffer = reflection.addOutput("buffer", "").rawBuffer(1024).bindFlags(kBindFlags);
+
+        auto pCache = ResourceCache::create();
+        pCache->registerField("A.full", full, 0);
+        pCache->registerField("B.half", half, 1);
+        pCache->registerField("C.explicitFull", explicitFull, 2);
+        pCache->registerField("D.mips", mips, 3);
+        pCache->registerField("E.buffer", buffer, 4);
+        pCache->registerField("F.buffer", buffer, 5);
+        const auto& stats = pCache->planAllocations(kDefaultProps);
+
+        // Fields resolving to the same description share memory even when specified differently.
+        EXPECT_EQ(pCache->getAllocationIndex("A.full"), pCache->getAllocationIndex("C.explicitFull"));
+        EXPECT_NE(pCache->getAllocationIndex("A.full"), pCache->getAllocationIndex("B.half"));
+        EXPECT_EQ(pCache->getAllocationIndex("E.buffer"), pCache->getAllocationIndex("F.buffer"));
+        EXPECT_EQ(stats.allocationCount, 4);
+
+        // A full mip chain of a 4x4 RGBA8 texture is 64 + 16 + 4 bytes.
+        EXPECT_EQ(stats.requiredMemory, 2 * kFullResSize + kFullResSize / 4 + 84 + 2 * 1024);
+        EXPECT_EQ(stats.getSavedMemory(), kFullResSize + 1024);
+    }
+}
@@ -0,0 +1,296 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/Animation.h"
+#include "Scene/Animation/AnimationBatch.h"
+#include "Scene/Animation/KeyframeStreamer.h"
+#include "Scene/Animation/VertexCacheCodec.h"
+#include "Scene/Animation/VertexCacheFile.h"
+#include <atomic>
+#include <random>
+#include <cmath>
+#include <cstring>
+
+namespace Falcor
+{
+    namespace
+    {
+        void testKeyframeSearch(CPUUnitTestContext& ctx, size_t keyframeCount)
+        {
+            // Translation is linear in time, so the expected translation is known at any time.
+            auto pAnimation = Animation::create("test", NodeID{ 0 }, (double)keyframeCount);
+            for (size_t i = 0; i < keyframeCount; i++)
+            {
+                Animation::Keyframe keyframe;
+                keyframe.time = (double)i;
+                keyframe.translation = float3(2.f * i, 0.f, 0.f);
+                pAnimation->addKeyframe(keyframe);
+            }
+
+            auto checkTime = [&](double time)
+            {
+                rmcv::mat4 transform = pAnimation->animate(time);
+                float expected = 2.f * (float)std::clamp(time, 0.0, (double)(keyframeCount - 1));
+                EXPECT(std::abs(transform[0][3] - expected) < 1e-3f) << "time=" << time << " keyframes=" << keyframeCount;
+            };
+
+            // Play forward, backward and at random times to exercise the cached frame and the searches.
+            const double endTime = (double)(keyframeCount - 1);
+            for (double t = 0.0; t <= endTime; t += 0.25) checkTime(t);
+            for (double t = endTime; t >= 0.0; t -= 0.25) checkTime(t);
+
+            std::mt19937 rng;
+            std::uniform_real_distribution<double> dist(-1.0, endTime + 1.0);
+            for (size_t i = 0; i < 100; i++) checkTime(dist(rng));
+        }
+    }
+
+    CPU_TEST(AnimationKeyframeSearch)
+    {
+        // Short animations use a linear search, long ones a binary search.
+        testKeyframeSearch(ctx, 2);
+        testKeyframeSearch(ctx, 10);
+        testKeyframeSearch(ctx, 1000);
+    }
+
+    CPU_TEST(AnimationBatchEvaluation)
+    {
+        std::mt19937 rng;
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        auto randomRotation = [&]()
+        {
+            glm::quat q(dist(rng), dist(rng), dist(rng), dist(rng));
+            return glm::normalize(q);
+        };
+
+        // Create animations with all combinations of interpolation modes, behaviors and warping.
+        const Animation::Behavior kBehaviors[] = { Animation::Behavior::Constant, Animation::Behavior::Linear, Animation::Behavior::Cycle, Animation::Behavior::Oscillate };
+        std::vector<Animation::SharedPtr> animations;
+        for (uint32_t i = 0; i < 300; i++)
+        {
+            const size_t keyframeCount = 2 + (i * 7) % 80;
+            auto pAnimation = Animation::create("test", NodeID{ i }, (double)keyframeCount);
+            pAnimation->setInterpolationMode(i % 2 == 0 ? Animation::InterpolationMode::Linear : Animation::InterpolationMode::Hermite);
+            pAnimation->setPreInfinityBehavior(kBehaviors[i % 4]);
+            pAnimation->setPostInfinityBehavior(kBehaviors[(i / 4) % 4]);
+            pAnimation->setEnableWarping(i % 3 == 0);
+
+            glm::quat rotation = randomRotation();
+            for (size_t k = 0; k < keyframeCount; k++)
+            {
+                // Repeat and negate some rotations to exercise both branches of the slerp.
+                if (k % 3 == 0) rotation = randomRotation();
+                else if (k % 5 == 0) rotation = -rotation;
+
+                Animation::Keyframe keyframe;
+                keyframe.time = (double)k + 0.5 * dist(rng) * (k > 0 ? 1.0 : 0.0);
+                keyframe.translation = float3(dist(rng), dist(rng), dist(rng));
+                keyframe.scaling = float3(1.f + dist(rng), 1.f, 1.f);
+                keyframe.rotation = rotation;
+                pAnimation->addKeyframe(keyframe);
+            }
+            animations.push_back(pAnimation);
+        }
+
+        // The batched evaluation must give bit-identical results to evaluating each animation.
+        AnimationBatch batch;
+        auto checkTime = [&](double time)
+        {
+            batch.animate(animations, time);
+            const auto& transforms = batch.getTransforms();
+            EXPECT_EQ(transforms.size(), animations.size());
+            for (size_t i = 0; i < animations.size(); i++)
+            {
+                rmcv::mat4 expected = animations[i]->animate(time);
+                EXPECT(std::memcmp(&transforms[i], &expected, sizeof(expected)) == 0) << "animation=" << i << " time=" << time;
+            }
+        };
+
+        for (double t = -20.0; t < 100.0; t += 0.37) checkTime(t);
+        for (double t = 100.0; t > -20.0; t -= 1.13) checkTime(t);
+
+        // Changes to the animations are picked up.
+        animations[0]->setInterpolationMode(Animation::InterpolationMode::Hermite);
+        animations[1]->addKeyframe({ 0.25, float3(1.f), float3(2.f), randomRotation() });
+        animations.pop_back();
+        for (double t = -2.0; t < 10.0; t += 0.37) checkTime(t);
+    }
+
+    CPU_TEST(VertexCacheFile)
+    {
+        const uint32_t kChunkCount = 16;
+
+        auto pFile = VertexCacheFile::create();
+        std::vector<uint32_t> chunks(kChunkCount);
+        Threading::parallelFor<uint32_t>(0, kChunkCount, [&](uint32_t i)
+        {
+            std::vector<float> data(100 + i, (float)i);
+            chunks[i] = pFile->writeChunk(data);
+        });
+        pFile->finalize();
+
+        // Read back through a second instance to test the chunk table.
+        auto pReader = VertexCacheFile::open(pFile->getPath());
+        EXPECT_EQ(pReader->getChunkCount(), kChunkCount);
+        for (uint32_t i = 0; i < kChunkCount; i++)
+        {
+            std::vector<float> data;
+            pReader->readChunk(chunks[i], data);
+            EXPECT_EQ(data.size(), 100 + i);
+            EXPECT(std::all_of(data.begin(), data.end(), [&](float v) { return v == (float)i; })) << "chunk=" << i;
+        }
+    }
+
+    CPU_TEST(KeyframeStreamer)
+    {
+        const uint32_t kKeyframeCount = 50;
+        const uint32_t kCapacity = 5;
+
+        std::atomic<uint32_t> loadCount{0};
+        KeyframeStreamer streamer(kKeyframeCount, kCapacity, [&](uint32_t keyframe, std::vector<uint8_t>& data)
+        {
+            loadCount++;
+            data.assign(16, (uint8_t)keyframe);
+        });
+
+        // Play forward twice, wrapping around at the end.
+        for (uint32_t frame = 0; frame < 2 * kKeyframeCount; frame++)
+        {
+            uint32_t a = frame % kKeyframeCount;
+            uint32_t b = (a + 1) % kKeyframeCount;
+            streamer.update(a, b, true, true);
+            EXPECT_LE(streamer.getResidentCount(), kCapacity);
+            EXPECT_EQ(streamer.getKeyframe(a)[0], (uint8_t)a);
+            EXPECT_EQ(streamer.getKeyframe(b)[0], (uint8_t)b);
+        }
+
+        // Each keyframe is loaded once per loop when prefetching works.
+        EXPECT_LE(loadCount.load(), 2 * kKeyframeCount + kCapacity);
+
+        // Play backward without looping.
+        for (uint32_t a = kKeyframeCount - 1; a > 0; a--)
+        {
+            streamer.update(a, a - 1, false, false);
+            EXPECT_LE(streamer.getResidentCount(), kCapacity);
+            EXPECT_EQ(streamer.getKeyframe(a - 1)[0], (uint8_t)(a - 1));
+        }
+    }
+
+    CPU_TEST(VertexCacheCodec)
+    {
+        const uint32_t kKeyframeCount = 40;
+        const uint32_t kVertexCount = 1000;
+
+        // Create smoothly animated mesh keyframes.
+        std::mt19937 rng;
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        std::vector<StaticVertexData> baseVertices(kVertexCount);
+        for (auto& v : baseVertices)
+        {
+            v.position = float3(dist(rng), dist(rng), dist(rng)) * 10.f;
+            v.normal = glm::normalize(float3(dist(rng), dist(rng), dist(rng)));
+            v.tangent = float4(glm::normalize(float3(dist(rng), dist(rng), dist(rng))), 1.f);
+            v.texCrd = float2(dist(rng), dist(rng));
+            v.curveRadius = 0.f;
+        }
+
+        std::vector<std::vector<PackedStaticVertexData>> keyframes(kKeyframeCount);
+        for (uint32_t i = 0; i < kKeyframeCount; i++)
+        {
+            for (auto v : baseVertices)
+            {
+                v.position += float3(0.01f * i, std::sin(0.1f * i), 0.f);
+                keyframes[i].push_back(PackedStaticVertexData(v));
+            }
+        }
+
+        VertexCacheCodec::Params params;
+        auto compressed = VertexCacheCodec::compress(keyframes, params);
+        EXPECT_EQ(compressed.size(), kKeyframeCount);
+        EXPECT_EQ(params.vertexCount, kVertexCount);
+
+        size_t compressedSize = 0;
+        for (const auto& data : compressed) compressedSize += data.size();
+        EXPECT_LT(compressedSize, kKeyframeCount * kVertexCount * sizeof(PackedStaticVertexData) / 2);
+
+        auto readFunc = [&](uint32_t keyframe, std::vector<uint8_t>& data) { data = compressed[keyframe]; };
+        const float3 maxError = params.getMaxPositionError() + 1e-5f;
+
+        // Decode in order.
+        VertexCacheCodec::Decoder decoder(params, readFunc);
+        std::vector<std::vector<PackedStaticVertexData>> decoded(kKeyframeCount);
+        for (uint32_t i = 0; i < kKeyframeCount; i++)
+        {
+            decoder.decode(i, decoded[i]);
+            EXPECT_EQ(decoded[i].size(), kVertexCount);
+            for (uint32_t j = 0; j < kVertexCount; j++)
+            {
+                auto ref = keyframes[i][j];
+                auto res = decoded[i][j];
+                for (int c = 0; c < 3; c++) EXPECT_LE(std::abs(res.position[c] - ref.position[c]), maxError[c]);
+                for (int c = 0; c < 3; c++) EXPECT_LE(std::abs(res.unpack().normal[c] - ref.unpack().normal[c]), 1e-3f);
+                EXPECT(res.unpack().tangent == ref.unpack().tangent);
+                EXPECT_EQ(asuint(res.texCrd.x), asuint(ref.texCrd.x));
+                EXPECT_EQ(asuint(res.texCrd.y), asuint(ref.texCrd.y));
+            }
+        }
+
+        // Decode in random order and compare against the sequential results.
+        VertexCacheCodec::Decoder randomDecoder(params, readFunc);
+        std::vector<PackedStaticVertexData> vertices;
+        for (uint32_t i : { 37u, 3u, 16u, 15u, 0u, 39u, 17u })
+        {
+            randomDecoder.decode(i, vertices);
+            EXPECT(std::memcmp(vertices.data(), decoded[i].data(), kVertexCount * sizeof(PackedStaticVertexData)) == 0);
+        }
+
+        // Curve keyframes.
+        std::vector<std::vector<DynamicCurveVertexData>> curveKeyframes(kKeyframeCount);
+        for (uint32_t i = 0; i < kKeyframeCount; i++)
+        {
+            for (const auto& v : baseVertices) curveKeyframes[i].push_back({ v.position * (1.f + 0.01f * i) });
+        }
+
+        VertexCacheCodec::Params curveParams;
+        auto curveCompressed = VertexCacheCodec::compress(curveKeyframes, curveParams);
+        EXPECT(curveParams.type == VertexCacheCodec::Type::Curve);
+        const float3 maxCurveError = curveParams.getMaxPositionError() + 1e-5f;
+
+        VertexCacheCodec::Decoder curveDecoder(curveParams, [&](uint32_t keyframe, std::vector<uint8_t>& data) { data = curveCompressed[keyframe]; });
+        std::vector<DynamicCurveVertexData> curveVertices;
+        for (uint32_t i : { 0u, 1u, 2u, 30u, 5u })
+        {
+            curveDecoder.decode(i, curveVertices);
+            EXPECT_EQ(curveVertices.size(), kVertexCount);
+            for (uint32_t j = 0; j < kVertexCount; j++)
+            {
+                for (int c = 0; c < 3; c++) EXPECT_LE(std::abs(curveVertices[j].position[c] - curveKeyframes[i][j].position[c]), maxCurveError[c]);
+            }
+        }
+    }
+}
@@ -0,0 +1,178 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Importers/PBRTImporter/PLYReader.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        struct PLYVertex
+        {
+            float3 position;
+            float3 normal;
+            float2 uv;
+        };
+
+        // A quad followed by a triangle, with per-vertex normals and texture coordinates.
+        const std::vector<PLYVertex> kVertices =
+        {
+            { float3(0.f, 0.f, 0.f), float3(0.f, 0.f, 1.f), float2(0.f, 0.f) },
+            { float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f), float2(1.f, 0.f) },
+            { float3(1.f, 1.f, 0.f), float3(1.f, 0.f, 0.f), float2(1.f, 1.f) },
+            { float3(0.f, 1.f, 0.f), float3(0.f, 0.f, -1.f), float2(0.f, 1.f) },
+            { float3(2.f, 0.f, 0.f), float3(0.f, -1.f, 0.f), float2(0.5f, 0.25f) },
+        };
+        const std::vector<std::vector<uint32_t>> kFaces = { { 0, 1, 2, 3 }, { 1, 4, 2 } };
+
+        // Quads are triangulated as triangle fans.
+        const std::vector<uint32_t> kExpectedIndices = { 0, 1, 2, 0, 2, 3, 1, 4, 2 };
+
+        std::string getHeader(const std::string& format)
+        {
+            return
+                "ply\n"
+                "format " + format + " 1.0\n"
+                "comment Falcor test mesh\n"
+                "element vertex " + std::to_string(kVertices.size()) + "\n"
+                "property float x\n"
+                "property float y\n"
+                "property float z\n"
+                "property float nx\n"
+                "property float ny\n"
+                "property float nz\n"
+                "property float u\n"
+                "property float v\n"
+                "property uchar red\n"
+                "element face " + std::to_string(kFaces.size()) + "\n"
+                "property list uchar int vertex_indices\n"
+                "end_header\n";
+        }
+
+        std::string createAsciiPLY()
+        {
+            std::string data = getHeader("ascii");
+            for (const auto& v : kVertices)
+            {
+                data += fmt::format("{} {} {} {} {} {} {} {} 255\n", v.position.x, v.position.y, v.position.z, v.normal.x, v.normal.y, v.normal.z, v.uv.x, v.uv.y);
+            }
+            for (const auto& face : kFaces)
+            {
+                data += std::to_string(face.size());
+                for (uint32_t index : face) data += " " + std::to_string(index);
+                data += "\n";
+            }
+            return data;
+        }
+
+        template<typename T>
+        void appendValue(std::string& data, T value, bool bigEndian)
+        {
+            char bytes[sizeof(T)];
+            std::memcpy(bytes, &value, sizeof(T));
+            if (bigEndian) std::reverse(bytes, bytes + sizeof(T));
+            data.append(bytes, sizeof(T));
+        }
+
+        std::string createBinaryPLY(bool bigEndian)
+        {
+            std::string data = getHeader(bigEndian ? "binary_big_endian" : "binary_little_endian");
+            for (const auto& v : kVertices)
+            {
+                for (float value : { v.position.x, v.position.y, v.position.z, v.normal.x, v.normal.y, v.normal.z, v.uv.x, v.uv.y }) appendValue(data, value, bigEndian);
+                appendValue(data, (uint8_t)255, bigEndian);
+            }
+            for (const auto& face : kFaces)
+            {
+                appendValue(data, (uint8_t)face.size(), bigEndian);
+                for (uint32_t index : face) appendValue(data, (int32_t)index, bigEndian);
+            }
+            return data;
+        }
+
+        TriangleMesh::SharedPtr loadPLY(const std::string& name, const std::string& content)
+        {
+            auto path = std::filesystem::temp_directory_path() / name;
+            {
+                std::ofstream fs(path, std::ios_base::binary);
+                fs.write(content.data(), content.size());
+            }
+            auto pMesh = pbrt::loadPLYMesh(path);
+            std::filesystem::remove(path);
+            return pMesh;
+        }
+
+        bool isVertexEqual(const TriangleMesh::Vertex& vertex, const PLYVertex& expected)
+        {
+            // Texture coordinates are flipped to match TriangleMesh::createFromFile().
+            return vertex.position == expected.position && vertex.normal == expected.normal && vertex.texCoord == float2(expected.uv.x, 1.f - expected.uv.y);
+        }
+    }
+
+    CPU_TEST(PLYReaderBinary)
+    {
+        for (bool bigEndian : { false, true })
+        {
+            auto pMesh = loadPLY("FalcorTestPLYReaderBinary.ply", createBinaryPLY(bigEndian));
+            EXPECT(pMesh != nullptr);
+            if (!pMesh) continue;
+
+            // Binary files are decoded directly, so the vertices and indices are the ones in the file.
+            EXPECT(pMesh->getIndices() == kExpectedIndices);
+            EXPECT_EQ(pMesh->getVertices().size(), kVertices.size());
+            if (pMesh->getVertices().size() != kVertices.size()) continue;
+            for (size_t i = 0; i < kVertices.size(); ++i) EXPECT(isVertexEqual(pMesh->getVertices()[i], kVertices[i]));
+        }
+    }
+
+    CPU_TEST(PLYReaderAscii)
+    {
+        auto pMesh = loadPLY("FalcorTestPLYReaderAscii.ply", createAsciiPLY());
+        EXPECT(pMesh != nullptr);
+        if (!pMesh) return;
+
+        // ASCII files are loaded with assimp, which may duplicate vertices. Compare the triangles by their vertices instead of indices.
+        const auto& indices = pMesh->getIndices();
+        const auto& vertices = pMesh->getVertices();
+        EXPECT_EQ(indices.size(), kExpectedIndices.size());
+        if (indices.size() != kExpectedIndices.size()) return;
+
+        for (size_t i = 0; i < indices.size(); ++i)
+        {
+            EXPECT(indices[i] < vertices.size());
+            if (indices[i] >= vertices.size()) return;
+            EXPECT(isVertexEqual(vertices[indices[i]], kVertices[kExpectedIndices[i]]));
+        }
+    }
+}
@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFBrickFile.h"
+#include "Scene/SDFs/SDFMeshBuilder.h"
+#include "Scene/TriangleMesh.h"
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Returns the signed distance to a unit cube centered at the origin.
+        */
+        float cubeDistance(const float3& p)
+        {
+            float3 q = glm::abs(p) - 0.5f;
+            return glm::length(glm::max(q, float3(0.f))) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.f);
+        }
+    }
+
+    CPU_TEST(SDFMeshBuilder)
+    {
+        auto pCube = TriangleMesh::createCube();
+
+        SDFMeshBuilder::Options options;
+        options.gridWidth = 32;
+        options.brickWidth = 7;
+        options.margin = 4;
+        auto result = SDFMeshBuilder::build(*pCube, options);
+        const auto& bricks = result.bricks;
+
+        EXPECT_EQ(bricks.gridWidth, 32u);
+        EXPECT_EQ(bricks.brickWidth, 7u);
+        EXPECT_GT(bricks.getBrickCount(), 0u);
+        EXPECT_EQ(bricks.values.size(), bricks.getBrickCount() * bricks.getValueCountPerBrick());
+        EXPECT_EQ(result.meshScale, 0.75f);
+
+        // Compare against the analytic distances, allowing for rounding differences.
+        const uint32_t w = bricks.getBrickWidthInValues();
+        for (uint32_t brickID = 0; brickID < bricks.getBrickCount(); brickID++)
+        {
+            const int8_t* pValues = bricks.getBrickValues(brickID);
+            for (uint32_t z = 0; z < w; z++)
+            {
+                for (uint32_t y = 0; y < w; y++)
+                {
+                    for (uint32_t x = 0; x < w; x++)
+                    {
+                        uint3 corner = bricks.brickCoords[brickID] * bricks.brickWidth + uint3(x, y, z);
+                        if (glm::any(glm::greaterThan(corner, uint3(options.gridWidth)))) continue;
+
+                        float3 p = (float3(corner) / float(options.gridWidth) - 0.5f) / result.meshScale + result.meshCenter;
+                        float distanceInVoxels = cubeDistance(p) * result.meshScale * options.gridWidth;
+                        int8_t expected = SDFBrickData::quantize(distanceInVoxels * 2.f / std::sqrt(3.f));
+                        EXPECT_LE(std::abs(expected - pValues[x + w * (y + w * z)]), 1) << "corner = " << to_string(corner);
+                    }
+                }
+            }
+        }
+
+        // Flipping the winding order flips the sign of all unsaturated values.
+        const std::vector<float3> positions = { float3(-1, -1, -1), float3(1, -1, -1), float3(0, 1, -1), float3(0, 0, 1) };
+        const std::vector<uint32_t> indices = { 0, 2, 1, 0, 1, 3, 1, 2, 3, 2, 0, 3 };
+        auto ccw = SDFMeshBuilder::build(positions, indices, false, options);
+        auto cw = SDFMeshBuilder::build(positions, indices, true, options);
+        EXPECT_GT(ccw.bricks.getBrickCount(), 0u);
+
+        // The inverted mesh has additional surface crossings at the grid boundary, so compare the bricks present in both.
+        for (uint32_t brickID = 0; brickID < ccw.bricks.getBrickCount(); brickID++)
+        {
+            auto it = std::find(cw.bricks.brickCoords.begin(), cw.bricks.brickCoords.end(), ccw.bricks.brickCoords[brickID]);
+            if (it == cw.bricks.brickCoords.end())
+            {
+                EXPECT(false) << "brick " << to_string(ccw.bricks.brickCoords[brickID]) << " missing for clockwise winding";
+                continue;
+            }
+
+            const int8_t* pCCW = ccw.bricks.getBrickValues(brickID);
+            const int8_t* pCW = cw.bricks.getBrickValues(uint32_t(it - cw.bricks.brickCoords.begin()));
+            for (uint32_t i = 0; i < ccw.bricks.getValueCountPerBrick(); i++)
+            {
+                if (std::abs(pCCW[i]) == INT8_MAX) continue;
+                EXPECT_EQ(pCCW[i], -pCW[i]);
+            }
+        }
+    }
+
+    CPU_TEST(SDFBrickFile)
+    {
+        // Create bricks for a sphere from a dense grid.
+        const uint32_t gridWidth = 32;
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        std::vector<float> cornerValues(gridWidthInValues * gridWidthInValues * gridWidthInValues);
+        for (uint32_t z = 0; z < gridWidthInValues; z++)
+        {
+            for (uint32_t y = 0; y < gridWidthInValues; y++)
+            {
+                for (uint32_t x = 0; x < gridWidthInValues; x++)
+                {
+                    float3 p = float3(x, y, z) / float(gridWidth) - 0.5f;
+                    cornerValues[x + gridWidthInValues * (y + gridWidthInValues * z)] = glm::length(p) - 0.3f;
+                }
+            }
+        }
+
+        SDFBrickData bricks = SDFBrickData::createFromValues(cornerValues, gridWidth, 7);
+        EXPECT_GT(bricks.getBrickCount(), 0u);
+        EXPECT_LT(bricks.getBrickCount(), 125u);
+        for (uint32_t brickID = 0; brickID < bricks.getBrickCount(); brickID++)
+        {
+            EXPECT(SDFBrickData::containsSurface(bricks.getBrickValues(brickID), bricks.brickWidth));
+        }
+
+        std::filesystem::path path = std::filesystem::temp_directory_path() / "FalcorTestSDFBrickFile.sdfb";
+        EXPECT(SDFBrickFile::isBrickFile(path));
+
+        // Uncompressed bricks are stored exactly.
+        SDFBrickFile::write(path, bricks, false);
+        SDFBrickData loaded = SDFBrickFile::read(path);
+        EXPECT_EQ(loaded.gridWidth, bricks.gridWidth);
+        EXPECT_EQ(loaded.brickWidth, bricks.brickWidth);
+        EXPECT(loaded.brickCoords == bricks.brickCoords);
+        EXPECT(loaded.values == bricks.values);
+
+        // Compressed bricks are smaller and preserve the sign of all values.
+        auto uncompressedSize = std::filesystem::file_size(path);
+        SDFBrickFile::write(path, bricks, true);
+        EXPECT_LT(std::filesystem::file_size(path), uncompressedSize);
+        loaded = SDFBrickFile::read(path);
+        EXPECT(loaded.brickCoords == bricks.brickCoords);
+        EXPECT_EQ(loaded.values.size(), bricks.values.size());
+        for (size_t i = 0; i < std::min(loaded.values.size(), bricks.values.size()); i++)
+        {
+            EXPECT_EQ(loaded.values[i] > 0, bricks.values[i] > 0) << "i = " << i;
+            EXPECT_EQ(loaded.values[i] < 0, bricks.values[i] < 0) << "i = " << i;
+            EXPECT_LE(std::abs(loaded.values[i] - bricks.values[i]), 24) << "i = " << i;
+        }
+
+        std::filesystem::remove(path);
+    }
+}
@@ -0,0 +1,125 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneCache.h"
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        void writeFile(const std::filesystem::path& path, const std::string& content)
+        {
+            std::ofstream fs(path, std::ios_base::binary);
+            fs.write(content.data(), content.size());
+        }
+
+        void touchFile(const std::filesystem::path& path, std::chrono::seconds offset)
+        {
+            std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + offset);
+        }
+    }
+
+    CPU_TEST(SceneCacheDependencies)
+    {
+        auto path = std::filesystem::temp_directory_path() / "FalcorTestSceneCacheDependency.txt";
+        writeFile(path, "content");
+
+        auto dependency = SceneCache::createDependency(path, false);
+        auto hashedDependency = SceneCache::createDependency(path, true);
+        EXPECT(dependency.has_value());
+        EXPECT(hashedDependency.has_value());
+        if (!dependency || !hashedDependency) return;
+
+        EXPECT_EQ(dependency->size, 7);
+        EXPECT(!dependency->hash.has_value());
+        EXPECT(hashedDependency->hash.has_value());
+        EXPECT(SceneCache::isDependencyUpToDate(*dependency));
+        EXPECT(SceneCache::isDependencyUpToDate(*hashedDependency));
+
+        // A changed write time invalidates the dependency, unless the content hash shows the file is unchanged.
+        touchFile(path, std::chrono::seconds(10));
+        EXPECT(!SceneCache::isDependencyUpToDate(*dependency));
+        EXPECT(SceneCache::isDependencyUpToDate(*hashedDependency));
+
+        // Content changes are detected, even if the size doesn't change.
+        writeFile(path, "CONTENT");
+        touchFile(path, std::chrono::seconds(20));
+        EXPECT(!SceneCache::isDependencyUpToDate(*hashedDependency));
+        writeFile(path, "more content");
+        EXPECT(!SceneCache::isDependencyUpToDate(*hashedDependency));
+
+        // Missing files are never up-to-date.
+        std::filesystem::remove(path);
+        EXPECT(!SceneCache::isDependencyUpToDate(*dependency));
+        EXPECT(!SceneCache::createDependency(path, false).has_value());
+    }
+
+    CPU_TEST(SceneCacheMeshCache)
+    {
+        const std::string keyString = "SceneCacheMeshCache";
+        const auto key = SHA1::compute(keyString.data(), keyString.size());
+
+        auto pMesh = TriangleMesh::createSphere(1.f, 8, 4);
+        pMesh->setName("sphere");
+        pMesh->setFrontFaceCW(true);
+        SceneCache::writeMeshCache(key, pMesh);
+
+        auto pCached = SceneCache::readMeshCache(key);
+        EXPECT(pCached != nullptr);
+        if (pCached)
+        {
+            EXPECT_EQ(pCached->getName(), "sphere");
+            EXPECT_EQ(pCached->getFrontFaceCW(), true);
+            EXPECT(pCached->getIndices() == pMesh->getIndices());
+            EXPECT_EQ(pCached->getVertices().size(), pMesh->getVertices().size());
+            bool verticesEqual = pCached->getVertices().size() == pMesh->getVertices().size() &&
+                std::memcmp(pCached->getVertices().data(), pMesh->getVertices().data(), pMesh->getVertices().size() * sizeof(TriangleMesh::Vertex)) == 0;
+            EXPECT(verticesEqual);
+        }
+
+        // Unknown keys miss.
+        const std::string otherKeyString = "SceneCacheMeshCacheMissing";
+        EXPECT(SceneCache::readMeshCache(SHA1::compute(otherKeyString.data(), otherKeyString.size())) == nullptr);
+
+        // All bytes are zero padded, so keys with the same digits in a different grouping map to different files.
+        SceneCache::Key keyA{}, keyB{};
+        keyA[18] = 0x01;
+        keyA[19] = 0x11;
+        keyB[18] = 0x11;
+        keyB[19] = 0x01;
+        EXPECT(SceneCache::getMeshCachePath(keyA) != SceneCache::getMeshCachePath(keyB));
+
+        // Don't leave the entry in the user's mesh cache.
+        std::filesystem::remove(SceneCache::getMeshCachePath(key));
+        EXPECT(SceneCache::readMeshCache(key) == nullptr);
+    }
+}
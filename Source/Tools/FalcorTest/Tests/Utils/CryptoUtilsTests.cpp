@@ -54,5 +54,11 @@ namespace Falcor
             SHA1::MD md{0xcd, 0x36, 0xb3, 0x70, 0x75, 0x8a, 0x25, 0x9b, 0x34, 0x84, 0x50, 0x84, 0xa6, 0xcc, 0x38, 0x47, 0x3c, 0xb9, 0x5e, 0x27};
             EXPECT(SHA1::compute(str.data(), str.size()) == md);
         }
+
+        {
+            // Every byte is written as two digits, including leading zeros.
+            SHA1::MD md{0x2e, 0xf7, 0xbd, 0xe6, 0x08, 0xce, 0x54, 0x04, 0xe9, 0x7d, 0x5f, 0x04, 0x2f, 0x95, 0xf8, 0x9f, 0x1c, 0x23, 0x28, 0x71};
+            EXPECT_EQ(SHA1::toHexString(md), "2ef7bde608ce5404e97d5f042f95f89f1c232871");
+        }
     }
 }
@@ -0,0 +1,139 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Sets up the logger to write to the log file only and restores the previous settings on destruction.
+        */
+        struct LoggerScope
+        {
+            Logger::Mode mode = Logger::getMode();
+            Logger::OutputFlags outputs = Logger::getOutputs();
+            Logger::Level verbosity = Logger::getVerbosity();
+            Logger::OverflowPolicy overflowPolicy = Logger::getOverflowPolicy();
+            uint32_t maxRepeatCount = Logger::getMaxRepeatCount();
+
+            LoggerScope(uint32_t repeatCount)
+            {
+                Logger::setOutputs(Logger::OutputFlags::File);
+                Logger::setVerbosity(Logger::Level::Info);
+                Logger::setOverflowPolicy(Logger::OverflowPolicy::Block);
+                Logger::setMaxRepeatCount(repeatCount);
+            }
+
+            ~LoggerScope()
+            {
+                Logger::setMode(mode);
+                Logger::setOutputs(outputs);
+                Logger::setVerbosity(verbosity);
+                Logger::setOverflowPolicy(overflowPolicy);
+                Logger::setMaxRepeatCount(maxRepeatCount);
+            }
+        };
+
+        /** Count the lines in the log file containing a string.
+        */
+        size_t countLogLines(const std::string& str)
+        {
+            std::ifstream file(Logger::getLogFilePath());
+            size_t count = 0;
+            std::string line;
+            while (std::getline(file, line)) if (line.find(str) != std::string::npos) count++;
+            return count;
+        }
+
+        /** Create a string that is unique for each test run, as tests may be repeated and the log file is shared.
+        */
+        std::string makeTag(const std::string& name)
+        {
+            static std::atomic<uint32_t> sRun{0};
+            return fmt::format("{} run {}:", name, sRun++);
+        }
+    }
+
+    CPU_TEST(LoggerConcurrentModeSwitch)
+    {
+        if (!Logger::enabled()) return;
+        LoggerScope scope(0);
+
+        // Log from multiple threads while switching between modes and flushing. No message may be lost.
+        const std::string tag = makeTag("LoggerConcurrentModeSwitch");
+        const uint32_t threadCount = 8;
+        const uint32_t messageCount = 2000;
+
+        std::atomic<uint32_t> runningCount{threadCount};
+        std::vector<std::thread> threads;
+        for (uint32_t t = 0; t < threadCount; ++t)
+        {
+            threads.emplace_back([&, t]()
+            {
+                for (uint32_t i = 0; i < messageCount; ++i) logInfo("{} thread {} message {}", tag, t, i);
+                runningCount--;
+            });
+        }
+
+        for (uint32_t i = 0; runningCount > 0; ++i)
+        {
+            Logger::setMode(i % 2 == 0 ? Logger::Mode::Asynchronous : Logger::Mode::Synchronous);
+            if (i % 3 == 0) Logger::flush();
+            std::this_thread::yield();
+        }
+        for (auto& thread : threads) thread.join();
+
+        Logger::setMode(Logger::Mode::Synchronous);
+        EXPECT_EQ(countLogLines(tag), (size_t)threadCount * messageCount);
+    }
+
+    CPU_TEST(LoggerRepeatSuppression)
+    {
+        if (!Logger::enabled()) return;
+        LoggerScope scope(2);
+
+        // Repetitions are suppressed and reported per message.
+        const std::string tagA = makeTag("LoggerRepeatSuppression") + " A";
+        const std::string tagB = makeTag("LoggerRepeatSuppression") + " B";
+
+        Logger::setMode(Logger::Mode::Asynchronous);
+        for (uint32_t i = 0; i < 5; ++i) logInfo(tagA);
+        for (uint32_t i = 0; i < 3; ++i) logInfo(tagB);
+        Logger::flush();
+        Logger::setMode(Logger::Mode::Synchronous);
+
+        EXPECT_EQ(countLogLines(tagA), (size_t)3);
+        EXPECT_EQ(countLogLines(tagB), (size_t)3);
+        EXPECT_EQ(countLogLines("Suppressed 3 repetitions of message: " + tagA), (size_t)1);
+        EXPECT_EQ(countLogLines("Suppressed 1 repetitions of message: " + tagB), (size_t)1);
+    }
+}
@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/Bitmap.h"
+#include "Utils/Image/PixelConversion.h"
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+    CPU_TEST(PixelConversion)
+    {
+        // Test odd pixel counts to cover both the vectorized loops and the remainder.
+        for (size_t count : { 0, 1, 3, 4, 5, 6, 7, 8, 13, 64, 65 })
+        {
+            std::vector<uint8_t> src(count * 3);
+            for (size_t i = 0; i < src.size(); i++) src[i] = uint8_t(i * 31 + 7);
+            std::vector<uint8_t> dst(count * 4, 0);
+            expand24To32Bit(src.data(), dst.data(), count);
+            for (size_t i = 0; i < count; i++)
+            {
+                for (size_t c = 0; c < 3; c++) EXPECT_EQ(dst[i * 4 + c], src[i * 3 + c]);
+                EXPECT_EQ(dst[i * 4 + 3], 0xff);
+            }
+
+            std::vector<float> srcFloat(count * 3);
+            for (size_t i = 0; i < srcFloat.size(); i++) srcFloat[i] = float(i) * 1.5f - 3.f;
+            std::vector<float> dstFloat(count * 4, 0.f);
+            expandRGB32FloatToRGBA32Float(srcFloat.data(), dstFloat.data(), count);
+            for (size_t i = 0; i < count; i++)
+            {
+                for (size_t c = 0; c < 3; c++) EXPECT_EQ(dstFloat[i * 4 + c], srcFloat[i * 3 + c]);
+                EXPECT_EQ(dstFloat[i * 4 + 3], 1.f);
+            }
+        }
+    }
+
+    CPU_TEST(BitmapLoadConversion)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "FalcorTestBitmapLoad";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        // 24-bit images are expanded to BGRX.
+        {
+            const uint32_t width = 37, height = 19;
+            std::vector<uint8_t> data(size_t(width) * height * 4);
+            for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 13);
+            std::vector<uint8_t> expected = data;
+            for (size_t i = 0; i < expected.size(); i += 4)
+            {
+                std::swap(expected[i], expected[i + 2]);
+                expected[i + 3] = 0xff;
+            }
+
+            auto path = directory / "rgb.png";
+            Bitmap::saveImage(path, width, height, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA8Unorm, true, data.data());
+            auto pBitmap = Bitmap::createFromFile(path, true);
+            EXPECT(pBitmap != nullptr);
+            if (pBitmap)
+            {
+                EXPECT(pBitmap->getFormat() == ResourceFormat::BGRX8Unorm);
+                EXPECT(std::memcmp(pBitmap->getData(), expected.data(), expected.size()) == 0);
+            }
+        }
+
+        // RGB float images are expanded to RGBA float. The image is large enough to be copied on multiple threads.
+        {
+            const uint32_t width = 1024, height = 1100;
+            std::vector<float> data(size_t(width) * height * 3);
+            for (size_t i = 0; i < data.size(); i++) data[i] = float(i % 1000) * 0.25f;
+
+            auto path = directory / "rgb.pfm";
+            Bitmap::saveImage(path, width, height, Bitmap::FileFormat::PfmFile, Bitmap::ExportFlags::None, ResourceFormat::RGB32Float, true, data.data());
+            auto pBitmap = Bitmap::createFromFile(path, true);
+            EXPECT(pBitmap != nullptr);
+            if (pBitmap)
+            {
+                EXPECT(pBitmap->getFormat() == ResourceFormat::RGBA32Float);
+                const float* pData = reinterpret_cast<const float*>(pBitmap->getData());
+                size_t mismatchCount = 0;
+                for (size_t i = 0; i < size_t(width) * height; i++)
+                {
+                    for (size_t c = 0; c < 3; c++) mismatchCount += pData[i * 4 + c] != data[i * 3 + c];
+                    mismatchCount += pData[i * 4 + 3] != 1.f;
+                }
+                EXPECT_EQ(mismatchCount, 0u);
+            }
+        }
+
+        std::filesystem::remove_all(directory);
+    }
+}
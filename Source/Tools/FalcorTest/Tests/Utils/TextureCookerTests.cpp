@@ -0,0 +1,120 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureCooker.h"
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        using CompressionMode = ImageIO::CompressionMode;
+
+        Bitmap::UniqueConstPtr createBitmap(uint32_t width, uint32_t height, ResourceFormat format, uint8_t value = 0xff)
+        {
+            std::vector<uint8_t> data(size_t(width) * height * getFormatBytesPerBlock(format), value);
+            return Bitmap::create(width, height, format, data.data());
+        }
+
+        std::filesystem::path writeImage(const std::filesystem::path& directory, const std::string& name, uint32_t width, uint32_t height)
+        {
+            std::vector<uint8_t> data(size_t(width) * height * 4);
+            for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 7);
+            auto path = directory / name;
+            Bitmap::saveImage(path, width, height, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA8Unorm, true, data.data());
+            return path;
+        }
+    }
+
+    CPU_TEST(TextureCookerCompressionMode)
+    {
+        auto check = [&](const Bitmap& bitmap, bool isSrgb, std::optional<CompressionMode> expected)
+        {
+            EXPECT(TextureCooker::chooseCompressionMode(bitmap, isSrgb) == expected);
+        };
+
+        check(*createBitmap(64, 64, ResourceFormat::R8Unorm), false, CompressionMode::BC4);
+        check(*createBitmap(64, 64, ResourceFormat::RG8Unorm), false, CompressionMode::BC5);
+
+        // Opaque color data uses BC1, everything else BC7.
+        check(*createBitmap(64, 64, ResourceFormat::BGRX8Unorm), true, CompressionMode::BC1);
+        check(*createBitmap(64, 64, ResourceFormat::BGRA8Unorm, 0xff), true, CompressionMode::BC1);
+        check(*createBitmap(64, 64, ResourceFormat::BGRA8Unorm, 0x80), true, CompressionMode::BC7);
+        check(*createBitmap(64, 64, ResourceFormat::BGRX8Unorm), false, CompressionMode::BC7);
+
+        // HDR data uses BC6H unless it has alpha.
+        check(*createBitmap(64, 64, ResourceFormat::RGB32Float), false, CompressionMode::BC6);
+        check(*createBitmap(64, 64, ResourceFormat::RGBA32Float, 0), false, CompressionMode::None);
+
+        // Unsupported formats and sizes are not cooked.
+        check(*createBitmap(64, 64, ResourceFormat::R16Unorm), false, {});
+        check(*createBitmap(30, 64, ResourceFormat::BGRA8Unorm), true, {});
+    }
+
+    GPU_TEST(TextureCooker)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "FalcorTestTextureCooker";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        auto pCooker = TextureCooker::create(directory / "Cache");
+        auto colorPath = writeImage(directory, "color.png", 64, 32);
+        auto oddPath = writeImage(directory, "odd.png", 30, 30);
+
+        // The first load cooks the texture with a full mip chain.
+        auto pTexture = pCooker->loadTexture(colorPath, true, true);
+        EXPECT(pTexture != nullptr);
+        if (!pTexture) return;
+        EXPECT(pTexture->getFormat() == ResourceFormat::BC1UnormSrgb);
+        EXPECT_EQ(pTexture->getMipCount(), 7u);
+        EXPECT(pTexture->getSourcePath() == colorPath);
+        EXPECT_EQ(pCooker->getStats().cookCount, 1ull);
+
+        auto key = TextureCooker::computeKey(colorPath, true, true);
+        EXPECT(key.has_value());
+        if (key) EXPECT(std::filesystem::exists(pCooker->getEntryPath(*key)));
+
+        // Later loads read the cooked file.
+        pTexture = pCooker->loadTexture(colorPath, true, true);
+        EXPECT(pTexture && pTexture->getFormat() == ResourceFormat::BC1UnormSrgb);
+        EXPECT_EQ(pCooker->getStats().hitCount, 1ull);
+
+        // Loading the same image as non-color data cooks a separate entry.
+        pTexture = pCooker->loadTexture(colorPath, false, false);
+        EXPECT(pTexture && pTexture->getFormat() == ResourceFormat::BC7Unorm);
+        EXPECT(pTexture && pTexture->getMipCount() == 1);
+        EXPECT_EQ(pCooker->getStats().cookCount, 2ull);
+
+        // Images that can't be block compressed are loaded from the source file.
+        pTexture = pCooker->loadTexture(oddPath, false, true);
+        EXPECT(pTexture && !isCompressedFormat(pTexture->getFormat()));
+        EXPECT_EQ(pCooker->getStats().skipCount, 1ull);
+
+        std::filesystem::remove_all(directory);
+    }
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureManager.h"
+#include <fstream>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::filesystem::path writeImage(const std::filesystem::path& directory, const std::string& name, uint8_t seed)
+        {
+            const uint32_t width = 32, height = 32;
+            std::vector<uint8_t> data(size_t(width) * height * 4);
+            for (size_t i = 0; i < data.size(); i++) data[i] = uint8_t(i * 7 + seed);
+            auto path = directory / name;
+            Bitmap::saveImage(path, width, height, Bitmap::FileFormat::PngFile, Bitmap::ExportFlags::None, ResourceFormat::RGBA8Unorm, true, data.data());
+            return path;
+        }
+    }
+
+    GPU_TEST(TextureManagerDeduplication)
+    {
+        std::filesystem::path directory = std::filesystem::temp_directory_path() / "FalcorTestTextureManager";
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+
+        auto path = writeImage(directory, "a.png", 0);
+        auto otherPath = writeImage(directory, "other.png", 1);
+
+        // Identical file under a different name.
+        auto copyPath = directory / "copy.png";
+        std::filesystem::copy_file(path, copyPath);
+
+        // Identical pixels but different file contents. Decoders ignore data after the end of the PNG stream.
+        auto paddedPath = directory / "padded.png";
+        std::filesystem::copy_file(path, paddedPath);
+        std::ofstream(paddedPath, std::ios::binary | std::ios::app) << "padding";
+
+        // Without deduplication every path gets its own texture.
+        {
+            auto pManager = TextureManager::create(16);
+            auto handle = pManager->loadTexture(path, false, false, Resource::BindFlags::ShaderResource, false);
+            auto copyHandle = pManager->loadTexture(copyPath, false, false, Resource::BindFlags::ShaderResource, false);
+            EXPECT(handle && copyHandle && !(handle == copyHandle));
+            EXPECT_EQ(pManager->getStats().deduplicatedTextureCount, 0u);
+        }
+
+        auto pManager = TextureManager::create(16);
+        pManager->setDeduplicationEnabled(true);
+
+        auto handle = pManager->loadTexture(path, false, false, Resource::BindFlags::ShaderResource, false);
+        EXPECT(handle.isValid());
+        auto pTexture = pManager->getTexture(handle);
+        EXPECT(pTexture != nullptr);
+        if (!pTexture) return;
+
+        EXPECT(pManager->loadTexture(copyPath, false, false, Resource::BindFlags::ShaderResource, false) == handle);
+        EXPECT(pManager->loadTexture(paddedPath, false, false, Resource::BindFlags::ShaderResource, false) == handle);
+
+        // Different pixels or load options are not aliased.
+        EXPECT(!(pManager->loadTexture(otherPath, false, false, Resource::BindFlags::ShaderResource, false) == handle));
+        EXPECT(!(pManager->loadTexture(copyPath, true, false, Resource::BindFlags::ShaderResource, false) == handle));
+
+        auto stats = pManager->getStats();
+        EXPECT_EQ(stats.deduplicatedTextureCount, 2u);
+        EXPECT_EQ(stats.deduplicatedMemoryInBytes, 2 * pTexture->getTextureSizeInBytes());
+
+        // Removing the texture removes all its aliases.
+        pManager->removeTexture(handle);
+        EXPECT_EQ(pManager->getStats().deduplicatedTextureCount, 0u);
+        auto newHandle = pManager->loadTexture(copyPath, false, false, Resource::BindFlags::ShaderResource, false);
+        EXPECT(newHandle.isValid());
+        EXPECT(pManager->getTexture(newHandle) != nullptr);
+
+        std::filesystem::remove_all(directory);
+    }
+}
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Threading.h"
+#include <atomic>
+#include <stdexcept>
+
+namespace Falcor
+{
+    CPU_TEST(ThreadingParallelFor)
+    {
+        std::vector<uint32_t> values(100000, 0);
+        Threading::parallelFor<size_t>(0, values.size(), [&](size_t i) { values[i] += (uint32_t)i; });
+        for (size_t i = 0; i < values.size(); ++i) EXPECT_EQ(values[i], (uint32_t)i);
+
+        // Nested loops must not deadlock.
+        std::atomic<uint32_t> count{0};
+        Threading::parallelFor(0, 64, [&](int) { Threading::parallelFor(0, 64, [&](int) { count++; }); });
+        EXPECT_EQ(count.load(), 64u * 64u);
+
+        // Exceptions are propagated to the caller.
+        bool caught = false;
+        try
+        {
+            Threading::parallelFor(0, 1000, [](int i) { if (i == 500) throw std::runtime_error("error"); });
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+    }
+
+    CPU_TEST(ThreadingParallelReduce)
+    {
+        const uint64_t n = 1000000;
+        uint64_t sum = Threading::parallelReduce<uint64_t>(uint64_t(0), n, uint64_t(0), [](uint64_t i) { return i; }, [](uint64_t a, uint64_t b) { return a + b; });
+        EXPECT_EQ(sum, n * (n - 1) / 2);
+
+        // Floating-point reductions are deterministic.
+        auto reduceFloat = [](size_t grainSize)
+        {
+            return Threading::parallelReduce<float>(0, 100000, 0.f, [](int i) { return 1.f / (float)(i + 1); }, [](float a, float b) { return a + b; }, grainSize);
+        };
+        float result = reduceFloat(0);
+        for (int i = 0; i < 10; ++i) EXPECT_EQ(reduceFloat(0), result);
+        EXPECT_EQ(reduceFloat(100), reduceFloat(100));
+    }
+
+    CPU_TEST(ThreadingTasks)
+    {
+        std::atomic<uint32_t> value{0};
+        auto task = Threading::dispatchTask([&]() { value = 1; });
+        auto continuation = task.then([&]() { value = value * 10; });
+        continuation.finish();
+        EXPECT(!task.isRunning());
+        EXPECT(!continuation.isRunning());
+        EXPECT_EQ(value.load(), 10u);
+
+        auto failingTask = Threading::dispatchTask([]() { throw std::runtime_error("error"); });
+        bool caught = false;
+        try
+        {
+            failingTask.finish();
+        }
+        catch (const std::runtime_error&)
+        {
+            caught = true;
+        }
+        EXPECT(caught);
+
+        std::atomic<uint32_t> count{0};
+        Threading::TaskGroup group;
+        for (uint32_t i = 0; i < 100; ++i) group.run([&]() { count++; });
+        group.wait();
+        EXPECT_EQ(count.load(), 100u);
+    }
+}
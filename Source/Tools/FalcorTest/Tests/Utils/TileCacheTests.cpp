@@ -0,0 +1,225 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TileCache.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        using TileID = TiledTexture::TileID;
+        using TileKey = TileCache::TileKey;
+
+        const std::filesystem::path kDirectory = std::filesystem::temp_directory_path() / "FalcorTestTileCache";
+
+        /** Texel value used for synthetic RGBA8 textures. Encodes the mip level and texel coordinates.
+        */
+        uint32_t getTexel(uint32_t mip, uint32_t x, uint32_t y)
+        {
+            return (mip << 28) | (y << 14) | x;
+        }
+
+        std::filesystem::path writeTexture(const std::string& name, uint32_t width, uint32_t height, uint32_t mipCount)
+        {
+            std::vector<std::vector<uint8_t>> mips(mipCount);
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+            {
+                uint32_t w = std::max(1u, width >> mip);
+                uint32_t h = std::max(1u, height >> mip);
+                mips[mip].resize(size_t(w) * h * 4);
+                uint32_t* pTexels = reinterpret_cast<uint32_t*>(mips[mip].data());
+                for (uint32_t y = 0; y < h; y++)
+                {
+                    for (uint32_t x = 0; x < w; x++) pTexels[y * w + x] = getTexel(mip, x, y);
+                }
+            }
+
+            std::filesystem::create_directories(kDirectory);
+            auto path = kDirectory / name;
+            TiledTexture::write(path, ResourceFormat::RGBA8Unorm, width, height, mips);
+            return path;
+        }
+
+        /** Check that a tile holds the expected texels and that the padding is zero.
+        */
+        bool checkTile(const TiledTexture& texture, const TileID& tile, const uint8_t* pData)
+        {
+            const uint2 extent = texture.getTileExtent();
+            const uint32_t width = texture.getWidth(tile.mip);
+            const uint32_t height = texture.getHeight(tile.mip);
+            const uint32_t* pTexels = reinterpret_cast<const uint32_t*>(pData);
+            for (uint32_t y = 0; y < extent.y; y++)
+            {
+                for (uint32_t x = 0; x < extent.x; x++)
+                {
+                    uint32_t texelX = tile.x * extent.x + x;
+                    uint32_t texelY = tile.y * extent.y + y;
+                    uint32_t expected = texelX < width && texelY < height ? getTexel(tile.mip, texelX, texelY) : 0;
+                    if (pTexels[y * extent.x + x] != expected) return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    CPU_TEST(TiledTexture)
+    {
+        // Tile shapes are 64KB and match the D3D standard tile shapes.
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::RGBA8Unorm) == uint2(128, 128));
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::RGBA16Float) == uint2(128, 64));
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::RGBA32Float) == uint2(64, 64));
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::R8Unorm) == uint2(256, 256));
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::BC1Unorm) == uint2(512, 256));
+        EXPECT(TiledTexture::getTileExtent(ResourceFormat::BC7Unorm) == uint2(256, 256));
+        EXPECT(!TiledTexture::isFormatSupported(ResourceFormat::RGB32Float));
+
+        auto path = writeTexture("texture.bin", 300, 200, 9);
+        auto pTexture = TiledTexture::open(path);
+        EXPECT(pTexture->getFormat() == ResourceFormat::RGBA8Unorm);
+        EXPECT_EQ(pTexture->getMipCount(), 9u);
+        EXPECT(pTexture->getTileCount(0) == uint2(3, 2));
+        EXPECT(pTexture->getTileCount(1) == uint2(2, 1));
+        EXPECT(pTexture->getTileCount(8) == uint2(1, 1));
+        EXPECT_EQ(pTexture->getTotalTileCount(), 6u + 2u + 7u);
+        EXPECT(!pTexture->isValidTile({ 0, 3, 0 }));
+        EXPECT(!pTexture->isValidTile({ 9, 0, 0 }));
+
+        // Every tile round trips, including the padding of edge tiles.
+        std::vector<uint8_t> data(TiledTexture::kTileSizeInBytes);
+        for (uint32_t mip = 0; mip < pTexture->getMipCount(); mip++)
+        {
+            uint2 tileCount = pTexture->getTileCount(mip);
+            for (uint32_t y = 0; y < tileCount.y; y++)
+            {
+                for (uint32_t x = 0; x < tileCount.x; x++)
+                {
+                    TileID tile{ mip, x, y };
+                    pTexture->readTile(tile, data.data());
+                    EXPECT(checkTile(*pTexture, tile, data.data())) << "mip " << mip << " tile " << x << "," << y;
+                }
+            }
+        }
+
+        // Truncated files are rejected.
+        pTexture = nullptr;
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        bool threw = false;
+        try
+        {
+            TiledTexture::open(path);
+        }
+        catch (const RuntimeError&)
+        {
+            threw = true;
+        }
+        EXPECT(threw);
+
+        std::filesystem::remove_all(kDirectory);
+    }
+
+    CPU_TEST(TileCache)
+    {
+        auto pTexture = TiledTexture::open(writeTexture("cache.bin", 512, 512, 10));
+
+        // Use a single worker so that tiles are loaded in request order.
+        auto pCache = TileCache::create(4 * TiledTexture::kTileSizeInBytes, 1);
+        auto id = pCache->addTexture(pTexture);
+        auto key = [id](uint32_t mip, uint32_t x, uint32_t y) { return TileKey(id, TileID{ mip, x, y }); };
+
+        // Keys round trip.
+        EXPECT(key(3, 1, 2).getTextureID() == id);
+        EXPECT(key(3, 1, 2).getTile() == TileID({ 3, 1, 2 }));
+
+        // Synthetic feedback for the four tiles in the top left corner of mip 0. Invalid keys are ignored.
+        pCache->processFeedback({ key(0, 0, 0), key(0, 1, 0), key(0, 0, 1), key(0, 1, 1), key(0, 4, 0), TileKey(id + 1, TileID{}) });
+        pCache->waitForPendingTiles();
+
+        auto stats = pCache->getStats();
+        EXPECT_EQ(stats.missCount, 4ull);
+        EXPECT_EQ(stats.loadCount, 4ull);
+        EXPECT_EQ(stats.residentTileCount, 4ull);
+        EXPECT_EQ(pCache->getResidentMemory(), 4ull * TiledTexture::kTileSizeInBytes);
+
+        auto update = pCache->fetchUpdates();
+        EXPECT(update.loaded == std::vector<TileKey>({ key(0, 0, 0), key(0, 1, 0), key(0, 0, 1), key(0, 1, 1) }));
+        EXPECT(update.evicted.empty());
+
+        auto pData = pCache->getTile(key(0, 1, 1));
+        EXPECT(pData != nullptr);
+        if (pData) EXPECT(checkTile(*pTexture, { 0, 1, 1 }, pData->data()));
+
+        // Mark (0,0) as used, then request a new tile. The least recently used tile (1,0) is evicted.
+        pCache->processFeedback({ key(0, 0, 0) });
+        EXPECT_EQ(pCache->getStats().hitCount, 1ull);
+        pCache->processFeedback({ key(0, 2, 0) });
+        pCache->waitForPendingTiles();
+
+        EXPECT(pCache->isResident(key(0, 0, 0)));
+        EXPECT(pCache->isResident(key(0, 2, 0)));
+        EXPECT(!pCache->isResident(key(0, 1, 0)));
+        EXPECT_EQ(pCache->getStats().residentTileCount, 4ull);
+        EXPECT_EQ(pCache->getStats().evictionCount, 1ull);
+
+        update = pCache->fetchUpdates();
+        EXPECT(update.loaded == std::vector<TileKey>({ key(0, 2, 0) }));
+        EXPECT(update.evicted == std::vector<TileKey>({ key(0, 1, 0) }));
+
+        // Evicted tile data handed out earlier stays valid.
+        pData = pCache->getTile(key(0, 0, 1));
+        pCache->setMemoryBudget(TiledTexture::kTileSizeInBytes);
+        EXPECT_EQ(pCache->getStats().residentTileCount, 1ull);
+        EXPECT(pCache->isResident(key(0, 0, 1)));
+        if (pData) EXPECT(checkTile(*pTexture, { 0, 0, 1 }, pData->data()));
+
+        // Coarser mips are loaded first. With room for a single tile only the last loaded tile (mip 0) remains.
+        pCache->processFeedback({ key(0, 3, 3), key(9, 0, 0) });
+        pCache->waitForPendingTiles();
+        EXPECT(pCache->isResident(key(0, 3, 3)));
+        EXPECT(!pCache->isResident(key(9, 0, 0)));
+
+        // The mip 9 tile was loaded and evicted again since the last fetch and is not reported.
+        update = pCache->fetchUpdates();
+        EXPECT(update.loaded == std::vector<TileKey>({ key(0, 3, 3) }));
+        EXPECT_EQ(update.evicted.size(), size_t(4));
+        EXPECT(std::find(update.evicted.begin(), update.evicted.end(), key(9, 0, 0)) == update.evicted.end());
+
+        // Removing the texture evicts its tiles.
+        pCache->removeTexture(id);
+        EXPECT_EQ(pCache->getStats().residentTileCount, 0ull);
+        EXPECT(pCache->getTexture(id) == nullptr);
+        pCache->processFeedback({ key(0, 0, 0) });
+        EXPECT_EQ(pCache->getStats().pendingTileCount, 0ull);
+
+        pCache = nullptr;
+        pTexture = nullptr;
+        std::filesystem::remove_all(kDirectory);
+    }
+}
@@ -0,0 +1,73 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/UniqueElements.h"
+#include <random>
+
+namespace Falcor
+{
+    CPU_TEST(UniqueElements)
+    {
+        std::vector<uint32_t> values = { 5, 3, 5, 7, 3, 3, 9, 5 };
+
+        std::vector<size_t> idMap;
+        auto uniqueIDs = findUniqueElements(values.size(),
+            [&](size_t i) { return (size_t)values[i]; },
+            [&](size_t i, size_t j) { return values[i] == values[j]; },
+            idMap);
+
+        // First occurrences are kept in the original order.
+        EXPECT(uniqueIDs == std::vector<size_t>({ 0, 1, 3, 6 }));
+        EXPECT(idMap == std::vector<size_t>({ 0, 1, 0, 2, 1, 1, 3, 0 }));
+    }
+
+    CPU_TEST(UniqueElementsHashCollisions)
+    {
+        // Use a hash function with many collisions to test that equality is checked within buckets.
+        std::mt19937 rng;
+        std::vector<uint32_t> values(1000);
+        for (auto& v : values) v = rng() % 100;
+
+        std::vector<size_t> idMap;
+        auto uniqueIDs = findUniqueElements(values.size(),
+            [&](size_t i) { return (size_t)(values[i] % 7); },
+            [&](size_t i, size_t j) { return values[i] == values[j]; },
+            idMap);
+
+        // Compare against brute force search.
+        std::vector<size_t> expectedIDs;
+        for (size_t i = 0; i < values.size(); ++i)
+        {
+            auto it = std::find_if(expectedIDs.begin(), expectedIDs.end(), [&](size_t j) { return values[i] == values[j]; });
+            size_t expectedID = std::distance(expectedIDs.begin(), it);
+            if (it == expectedIDs.end()) expectedIDs.push_back(i);
+            EXPECT_EQ(idMap[i], expectedID);
+        }
+        EXPECT(uniqueIDs == expectedIDs);
+    }
+}
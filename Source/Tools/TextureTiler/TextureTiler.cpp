@@ -0,0 +1,92 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Utils/Image/TiledTexture.h"
+#include <args.hxx>
+
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace Falcor;
+
+int main(int argc, char** argv)
+{
+    args::ArgumentParser parser("Utility to convert images to tiled textures for texture streaming.");
+    parser.helpParams.programName = "TextureTiler";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::Flag compressFlag(parser, "", "Block compress the image (BC1/BC4/BC5/BC6H/BC7 depending on the image channels).", {'c'});
+    args::Flag srgbFlag(parser, "", "The image holds sRGB color data. Used to choose the compression mode.", {'s'});
+    args::Positional<std::string> input(parser, "input", "The source image. DDS files are tiled as-is, including their mips.", args::Options::Required);
+    args::Positional<std::string> output(parser, "output", "The tiled texture file to write.", args::Options::Required);
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+    catch (const args::RequiredError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    try
+    {
+        TiledTexture::convert(args::get(input), args::get(output), compressFlag ? args::get(compressFlag) : false, srgbFlag ? args::get(srgbFlag) : false);
+
+        auto pTexture = TiledTexture::open(args::get(output));
+        std::cout << "Wrote '" << args::get(output) << "': " << to_string(pTexture->getFormat()) << ", "
+            << pTexture->getWidth() << "x" << pTexture->getHeight() << ", " << pTexture->getMipCount() << " mips, "
+            << pTexture->getTotalTileCount() << " tiles." << std::endl;
+    }
+    catch (const std::exception& e)
+    {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}